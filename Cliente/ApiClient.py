@@ -206,7 +206,7 @@ class APIClient:
         except Fault as e:
             return {"success": False, "error": e.faultString}
 
-    def robot_upload_file(self, filename, file_path):
+    def robot_upload_file(self, filename, file_path, optimize=False, tolerance=None, reorder=False, arcs=False):
         """Sube un archivo gcode al servidor (como texto plano)"""
         try:
             # 1. Abrir en modo texto ('r'), no binario ('rb')
@@ -214,44 +214,102 @@ class APIClient:
                 file_content = f.read() # Leer como un string simple
            
             # 2. Enviar el contenido (texto) en el parámetro 'contenido'
-            r = self.api.__getattr__("robot.uploadFile")({
+            payload = {
                 "token": self.token,
                 "nombre": filename,
                 "contenido": file_content
-            })
+            }
+            # 3. Optimización opcional antes de guardar
+            if optimize:
+                payload["optimizar"] = True
+                if tolerance is not None:
+                    payload["tolerancia"] = tolerance
+            if reorder:
+                payload["reordenar"] = True
+            if arcs:
+                payload["arcos"] = True
+            r = self.api.__getattr__("robot.uploadFile")(payload)
             return {"success": True, "data": r}
         except FileNotFoundError:
             return {"success": False, "error": f"Archivo no encontrado: {file_path}"}
         except Fault as e:
             return {"success": False, "error": e.faultString}
         
-    def robot_run_file(self, filename):
-        """Ejecuta un archivo gcode en el servidor"""
+    def robot_optimize_file(self, filename, tolerance=None, min_distance=None, arcs=False):
+        """Crea una copia optimizada (<nombre>_opt) de un archivo gcode del servidor"""
+        try:
+            payload = {"token": self.token, "nombre": filename}
+            if tolerance is not None:
+                payload["tolerancia"] = tolerance
+            if min_distance is not None:
+                payload["distancia_minima"] = min_distance
+            if arcs:
+                payload["arcos"] = True
+            r = self.api.__getattr__("robot.optimizeFile")(payload)
+            return {"success": True, "data": r}
+        except Fault as e:
+            return {"success": False, "error": e.faultString}
+
+    def robot_run_file(self, filename, reorder=False):
+        """Ejecuta un archivo gcode en el servidor (opcionalmente reordenando pick-and-place)"""
         try:
-            r = self.api.__getattr__("robot.runFile")({
+            payload = {"token": self.token, "nombre": filename}
+            if reorder:
+                payload["reordenar"] = True
+            r = self.api.__getattr__("robot.runFile")(payload)
+            return {"success": True, "data": r}
+        except Fault as e:
+            return {"success": False, "error": e.faultString}
+
+    def robot_resume_file(self, filename):
+        """Reanuda un archivo gcode desde la línea en la que falló"""
+        try:
+            r = self.api.__getattr__("robot.resumeFile")({
                 "token": self.token, "nombre": filename
             })
             return {"success": True, "data": r}
         except Fault as e:
             return {"success": False, "error": e.faultString}
 
-    def robot_list_files(self):
-        """Obtiene la lista de archivos de trayectoria del usuario."""
+    def robot_list_files(self, offset=None, limit=None, sort=None, order=None, query=None, owner_id=None):
+        """
+        Obtiene la lista de archivos de trayectoria del usuario.
+        - offset/limit (int, opcionales): paginación.
+        - sort (str, opcional): nombre|creado|tamano|lineas|duracion.
+        - order (str, opcional): asc|desc.
+        - query (str, opcional): subcadena del nombre.
+        - owner_id (int, opcional): archivos de otro usuario (solo Admin).
+        """
         try:
-            # Llama al nuevo método RPC que creamos en el servidor
-            r = self.api.__getattr__("robot.listMyFiles")({
-                "token": self.token
-            })
-            # El servidor C++ devuelve {ok: bool, files: array}
-            return {"success": True, "files": r["files"]}
+            payload = {"token": self.token}
+            if offset is not None:
+                payload["offset"] = offset
+            if limit is not None:
+                payload["limit"] = limit
+            if sort:
+                payload["sort"] = sort
+            if order:
+                payload["order"] = order
+            if query:
+                payload["q"] = query
+            if owner_id is not None:
+                payload["owner_id"] = owner_id
+
+            r = self.api.__getattr__("robot.listMyFiles")(payload)
+            # El servidor C++ devuelve {ok, files, items, total, offset}
+            return {"success": True, "files": r["files"],
+                    "items": r.get("items", []), "total": r.get("total", len(r["files"]))}
         except Fault as e:
             return {"success": False, "error": e.faultString}
     
-    def robot_get_report(self, filter_user=None, filter_error=None):
+    def robot_get_report(self, filter_user=None, filter_error=None, limit=None, cursor=None, order=None):
         """
-        Obtiene el historial de comandos.
+        Obtiene una página del historial de comandos.
         - filter_user (str, opcional): Filtra por un nombre de usuario (solo Admin).
         - filter_error (bool, opcional): True=solo errores, False=solo éxitos (solo Admin).
+        - limit (int, opcional): Entradas por página (el servidor usa 200 por defecto).
+        - cursor (str, opcional): 'next_cursor' de la página anterior.
+        - order (str, opcional): 'asc' (más viejas primero) o 'desc'.
         """
         try:
             # 1. Construir el payload base
@@ -265,6 +323,14 @@ class APIClient:
             if filter_error is not None:
                 payload["filter_error"] = filter_error
 
+            # Paginado
+            if limit is not None:
+                payload["limit"] = limit
+            if cursor:
+                payload["cursor"] = cursor
+            if order:
+                payload["order"] = order
+
             # 3. Llamar al método RPC con el payload dinámico
             r = self.api.__getattr__("robot.getReport")(payload)
             
@@ -272,12 +338,24 @@ class APIClient:
         except Fault as e:
             return {"success": False, "error": e.faultString}
 
+    def robot_get_stats(self):
+        """
+        Obtiene los contadores del historial (solo Admin): totales, por usuario,
+        por servicio, por error y por minuto/hora. No descarga entradas.
+        """
+        try:
+            r = self.api.__getattr__("robot.getStats")({"token": self.token})
+            return {"success": True, "data": r}
+        except Fault as e:
+            return {"success": False, "error": e.faultString}
+
     # --- NUEVO MÉTODO ---
-    def admin_get_log_report(self, filter_user=None, filter_response=None):
+    def admin_get_log_report(self, filter_user=None, filter_response=None, date_from=None, date_to=None):
         """
         Obtiene el log de auditoría CSV.
         - filter_user (str, opcional): Filtra por un nombre de usuario.
         - filter_response (str, opcional): Filtra si la respuesta contiene este texto.
+        - date_from / date_to (int epoch o 'YYYY-MM-DDTHH:MM:SS', opcionales): Rango de fechas, inclusive.
         """
         try:
             # 1. Construir el payload base
@@ -288,6 +366,10 @@ class APIClient:
                 payload["filter_user"] = filter_user
             if filter_response:
                 payload["filter_response"] = filter_response
+            if date_from is not None:
+                payload["from"] = date_from
+            if date_to is not None:
+                payload["to"] = date_to
 
             # 3. Llamar al nuevo método RPC admin.getLogReport
             r = self.api.__getattr__("admin.getLogReport")(payload)
@@ -378,8 +378,8 @@ class RobotApp:
                                                        parent=self.root)
                 filter_error = err_choice
             
-            # 2. Llamar a la API con los filtros
-            result = self.cliente.robot_get_report(filter_user, filter_error)
+            # 2. Llamar a la API con los filtros (solo la última página: los 15 más nuevos)
+            result = self.cliente.robot_get_report(filter_user, filter_error, limit=15, order="desc")
 
             if not result.get("success"):
                  raise Exception(result.get("error", "Error desconocido del cliente"))
@@ -391,7 +391,7 @@ class RobotApp:
 
             total_cmds = r.get('total_comandos', 0)
             total_errs = r.get('total_errores', 0)
-            entries = r.get('entries', [])
+            entries = list(reversed(r.get('entries', [])))  # Llegan del más nuevo al más viejo
 
             # 4. Formatear el mensaje para mostrar
             report_title = self.cliente.user
@@ -407,7 +407,7 @@ class RobotApp:
             if not entries:
                 report_msg += "\n(No hay comandos que coincidan con el filtro)"
             else:
-                for entry in entries[-15:]: # Mostrar últimos 15
+                for entry in entries: # Últimos 15
                     status = "ERROR" if entry.get('error') else "OK"
                     details = entry.get('details', 'N/A')
                     service = entry.get('service', 'N/A')
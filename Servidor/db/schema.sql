@@ -21,3 +21,23 @@ CREATE TABLE IF NOT EXISTS sessions (
 
 CREATE INDEX IF NOT EXISTS idx_users_username ON users(username);
 
+
+-- Catálogo de trayectorias (lo crea/actualiza TrajectoryCatalogSqlite al arrancar)
+CREATE TABLE IF NOT EXISTS trajectories (
+  archivo       TEXT PRIMARY KEY,
+  owner_id      INTEGER NOT NULL,
+  nombre_logico TEXT NOT NULL,
+  creado_en     INTEGER NOT NULL,
+  mtime         INTEGER NOT NULL,
+  bytes         INTEGER NOT NULL,
+  lineas        INTEGER NOT NULL,
+  movimientos   INTEGER NOT NULL,
+  min_x REAL, min_y REAL, min_z REAL,
+  max_x REAL, max_y REAL, max_z REAL,
+  distancia_mm  REAL NOT NULL,
+  duracion_seg  REAL NOT NULL
+);
+
+CREATE INDEX IF NOT EXISTS idx_traj_owner_creado_archivo ON trajectories(owner_id, creado_en, archivo);
+CREATE INDEX IF NOT EXISTS idx_traj_creado_archivo ON trajectories(creado_en, archivo);
+CREATE INDEX IF NOT EXISTS idx_traj_owner_archivo ON trajectories(owner_id, archivo);
@@ -33,6 +33,7 @@ public:
      * - 'token' (string): Token de sesión del Admin.
      * - 'filter_user' (string, opcional): Filtra por nombre de usuario.
      * - 'filter_response' (string, opcional): Filtra si la respuesta contiene este texto.
+     * - 'from' / 'to' (epoch o YYYY-MM-DDTHH:MM:SS, opcionales): Rango de fechas, inclusive.
      * * Respuesta en 'result':
      * - 'ok' (bool): true
      * - 'log_entries' (array): Una lista de structs con los datos del CSV.
@@ -0,0 +1,34 @@
+#ifndef ROBOT_GET_STATS_METHOD_H
+#define ROBOT_GET_STATS_METHOD_H
+
+#include "../../lib/xmlrpc/XmlRpc.h" 
+#include "../session/SessionManager.h"
+#include "../utils/PALogger.h"
+#include "../common/AuthZ.h"
+#include "../core/CommandHistory.h"
+
+namespace robot_service_methods {
+
+/**
+ * @brief robot.getStats: contadores del historial (solo Admin).
+ * No recorre entradas: lee los agregados que CommandHistory mantiene en cada alta.
+ */
+class RobotGetStatsMethod : public XmlRpc::XmlRpcServerMethod {
+private:
+    SessionManager& sessions_;
+    PALogger&       logger_;
+    CommandHistory& history_;
+
+public:
+    RobotGetStatsMethod(XmlRpc::XmlRpcServer* server,
+                        SessionManager& sm,
+                        PALogger& L,
+                        CommandHistory& ch);
+
+    void execute(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result) override;
+    std::string help() override;
+};
+
+} // namespace robot_service_methods
+
+#endif // ROBOT_GET_STATS_METHOD_H
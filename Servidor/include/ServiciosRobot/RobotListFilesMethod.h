@@ -32,9 +32,17 @@ public:
      * @brief Ejecución del método.
      * * Parámetros esperados en 'params':
      * - 'token' (string): Token de sesión del usuario.
+     * - 'offset', 'limit' (int, opcionales): paginación (limit 0 = todos).
+     * - 'sort' (string, opcional): nombre|creado|tamano|lineas|duracion.
+     * - 'order' (string, opcional): asc|desc.
+     * - 'q' (string, opcional): subcadena del nombre de archivo.
+     * - 'owner_id' (int, opcional, solo Admin): archivos de un usuario.
+     * - 'totals' (bool, opcional): false para no contar el total (por defecto true).
      * * Respuesta en 'result':
      * - 'ok' (bool): true
      * - 'files' (array): Una lista de strings con los nombres de los archivos.
+     * - 'items' (array): Nombres + metadatos (tamaño, líneas, bbox, duración...).
+     * - 'total' (int): Total de archivos que cumplen el filtro (salvo totals=false).
      */
     void execute(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result) override;
 
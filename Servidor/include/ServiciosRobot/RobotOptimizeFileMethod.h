@@ -0,0 +1,104 @@
+#ifndef ROBOT_OPTIMIZE_FILE_METHOD_H
+#define ROBOT_OPTIMIZE_FILE_METHOD_H
+
+
+#include "../../lib/xmlrpc/XmlRpc.h" 
+#include "../session/SessionManager.h"
+#include "../utils/PALogger.h"
+#include "../robot_model/RobotService.h"
+#include "../common/AuthZ.h"
+
+namespace robot_service_methods {
+
+// Lee un número que puede llegar como int o double
+inline double rpc_double(XmlRpc::XmlRpcValue& v) {
+    if (v.getType() == XmlRpc::XmlRpcValue::TypeInt) return static_cast<double>(int(v));
+    return double(v);
+}
+
+// Opciones de optimización comunes a robot.optimizeFile y robot.uploadFile
+inline OpcionesOptimizacion leerOpcionesOptimizacion(XmlRpc::XmlRpcValue& args) {
+    OpcionesOptimizacion opciones;
+    if (args.hasMember("tolerancia")) {
+        opciones.toleranciaMm = rpc_double(args["tolerancia"]);
+        if (opciones.toleranciaMm < 0) {
+            throw XmlRpc::XmlRpcException("BAD_REQUEST: 'tolerancia' debe ser >= 0");
+        }
+    }
+    if (args.hasMember("distancia_minima")) {
+        opciones.distanciaMinimaMm = rpc_double(args["distancia_minima"]);
+        if (opciones.distanciaMinimaMm < 0) {
+            throw XmlRpc::XmlRpcException("BAD_REQUEST: 'distancia_minima' debe ser >= 0");
+        }
+    }
+    if (args.hasMember("simplificar")) {
+        opciones.simplificarColineales = bool(args["simplificar"]);
+    }
+    if (args.hasMember("colapsar_efector")) {
+        opciones.colapsarEfector = bool(args["colapsar_efector"]);
+    }
+    if (args.hasMember("reordenar")) {
+        opciones.reordenarPickAndPlace = bool(args["reordenar"]);
+    }
+    if (args.hasMember("arcos")) {
+        opciones.ajustarArcos = bool(args["arcos"]);
+    }
+    return opciones;
+}
+
+// Reducciones logradas, en el formato que devuelven ambos métodos
+inline void escribirReporteOptimizacion(const ResultadoOptimizacion& r, XmlRpc::XmlRpcValue& result) {
+    result["lines_before"] = static_cast<int>(r.lineasAntes);
+    result["lines_after"] = static_cast<int>(r.lineasDespues);
+    result["moves_removed"] = static_cast<int>(r.movimientosEliminados);
+    result["gripper_removed"] = static_cast<int>(r.efectorEliminados);
+    result["arcs_fitted"] = static_cast<int>(r.arcosAjustados);
+    result["duration_before_s"] = r.duracionAntesSeg;
+    result["duration_after_s"] = r.duracionDespuesSeg;
+    if (r.bloques > 0 || !r.motivoSinReorden.empty()) {
+        result["reordered"] = r.reordenado;
+        result["blocks"] = static_cast<int>(r.bloques);
+        result["travel_before_s"] = r.viajeAntesSeg;
+        result["travel_after_s"] = r.viajeDespuesSeg;
+        if (!r.reordenado) result["reorder_skipped"] = r.motivoSinReorden;
+    }
+}
+
+/**
+ * @brief Método RPC 'robot.optimizeFile'
+ * * Escribe una copia optimizada (<nombre>_opt) de una trayectoria: elimina
+ * * movimientos nulos/repetidos, fusiona tramos colineales y colapsa M3/M5
+ * * redundantes. Informa la reducción de líneas y de tiempo estimado.
+ * * Requiere token de Operador (solo archivos propios) o Admin.
+ */
+class RobotOptimizeFileMethod : public XmlRpc::XmlRpcServerMethod {
+private:
+    SessionManager& sessions_;
+    PALogger&       logger_;
+    RobotService&   robotService_; 
+
+public:
+    RobotOptimizeFileMethod(XmlRpc::XmlRpcServer* server,
+                            SessionManager& sm,
+                            PALogger& L,
+                            RobotService& rs);
+
+    /**
+     * @brief Ejecución del método.
+     * * Parámetros esperados en 'params':
+     * - 'token' (string), 'nombre' (string)
+     * - 'tolerancia', 'distancia_minima' (double, mm, opcionales)
+     * - 'simplificar', 'colapsar_efector', 'reordenar', 'arcos' (bool, opcionales)
+     * * Respuesta en 'result':
+     * - 'ok', 'filename', 'lines_before', 'lines_after', 'moves_removed',
+     *   'gripper_removed', 'arcs_fitted', 'duration_before_s', 'duration_after_s'
+     * - con 'reordenar': 'reordered', 'blocks', 'travel_before_s', 'travel_after_s'
+     */
+    void execute(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result) override;
+
+    std::string help() override;
+};
+
+} // namespace robot_service_methods
+
+#endif // ROBOT_OPTIMIZE_FILE_METHOD_H
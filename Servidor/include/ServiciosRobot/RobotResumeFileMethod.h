@@ -0,0 +1,47 @@
+#ifndef ROBOT_RESUME_FILE_METHOD_H
+#define ROBOT_RESUME_FILE_METHOD_H
+
+
+#include "../../lib/xmlrpc/XmlRpc.h" 
+#include "../session/SessionManager.h"
+#include "../utils/PALogger.h"
+#include "../robot_model/RobotService.h"
+#include "../common/AuthZ.h"
+
+namespace robot_service_methods {
+
+/**
+ * @brief Método RPC 'robot.resumeFile'
+ * * Reanuda una trayectoria .gcode cuya ejecución falló, desde la línea
+ * * guardada en su checkpoint (sin repetir homing ni las líneas ya confirmadas).
+ * * Requiere token de Operador o Admin.
+ */
+class RobotResumeFileMethod : public XmlRpc::XmlRpcServerMethod {
+private:
+    SessionManager& sessions_;
+    PALogger&       logger_;
+    RobotService&   robotService_; 
+
+public:
+    RobotResumeFileMethod(XmlRpc::XmlRpcServer* server,
+                       SessionManager& sm,
+                       PALogger& L,
+                       RobotService& rs);
+
+    /**
+     * @brief Ejecución del método.
+     * * Parámetros esperados en 'params':
+     * - 'token' (string): Token de sesión del usuario.
+     * - 'nombre' (string): Nombre del archivo .gcode a reanudar (ej. "2__mi_prueba__20250101_120000.gcode").
+     * * Respuesta en 'result':
+     * - 'ok' (bool): true si la ejecución reanudada terminó con éxito.
+     * - 'msg' (string): Mensaje de éxito o descripción del error.
+     */
+    void execute(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result) override;
+
+    std::string help() override;
+};
+
+} // namespace robot_service_methods
+
+#endif // ROBOT_RESUME_FILE_METHOD_H
\ No newline at end of file
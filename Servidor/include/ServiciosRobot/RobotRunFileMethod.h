@@ -33,6 +33,7 @@ public:
      * * Parámetros esperados en 'params':
      * - 'token' (string): Token de sesión del usuario.
      * - 'nombre' (string): Nombre del archivo .gcode a ejecutar (ej. "mi_prueba.gcode").
+     * - 'reordenar' (bool, opcional): reordena las operaciones pick-and-place antes de ejecutar.
      * * Respuesta en 'result':
      * - 'ok' (bool): true si la ejecución fue exitosa.
      * - 'msg' (string): Mensaje de éxito o descripción del error.
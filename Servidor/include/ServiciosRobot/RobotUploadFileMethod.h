@@ -6,6 +6,7 @@
 #include "../utils/PALogger.h"
 #include "../robot_model/RobotService.h"
 #include "../common/AuthZ.h"
+#include "RobotOptimizeFileMethod.h" // opciones y reporte de optimización
 
 namespace robot_service_methods {
 
@@ -33,6 +34,7 @@ public:
      * - 'token' (string): Token de sesión del usuario.
      * - 'nombre' (string): Nombre del archivo .gcode a crear (ej. "mi_pieza.gcode").
      * - 'contenido' (string): El contenido G-Code completo del archivo.
+     * - 'optimizar', 'reordenar', 'arcos' (bool, opcionales): ver robot.optimizeFile.
      * * Respuesta en 'result':
      * - 'ok' (bool): true si la subida fue exitosa.
      * - 'msg' (string): Mensaje de éxito o descripción del error.
@@ -4,6 +4,8 @@
 #include "XmlRpc.h"
 #include "session/SessionManager.h"
 #include "../session/CurrentUser.h"
+#include <cstdint>
+#include <ctime>
 #include <string>
 
 inline XmlRpc::XmlRpcValue rpc_norm(XmlRpc::XmlRpcValue& p) {
@@ -11,6 +13,24 @@ inline XmlRpc::XmlRpcValue rpc_norm(XmlRpc::XmlRpcValue& p) {
     return p;
 }
 
+// Epoch en segundos (int) o fecha ISO 8601 local "YYYY-MM-DDTHH:MM:SS" (string)
+inline int64_t rpc_epoch(XmlRpc::XmlRpcValue& v, const char* name) {
+    if (v.getType() == XmlRpc::XmlRpcValue::TypeInt) {
+        return (int)v;
+    }
+    if (v.getType() == XmlRpc::XmlRpcValue::TypeString) {
+        std::tm tm{};
+        const std::string text = std::string(v);
+        const char* end = strptime(text.c_str(), "%Y-%m-%dT%H:%M:%S", &tm);
+        if (end && *end == '\0') {
+            tm.tm_isdst = -1;
+            return static_cast<int64_t>(std::mktime(&tm));
+        }
+    }
+    throw XmlRpc::XmlRpcException(std::string("BAD_REQUEST: '") + name +
+                                  "' debe ser epoch (int) o YYYY-MM-DDTHH:MM:SS");
+}
+
 inline const SessionView& requireSession(const SessionManager& sm, const std::string& token) {
     auto s = sm.get(token);
     if (!s) throw XmlRpc::XmlRpcException("AUTH_INVALID: token");
@@ -1,39 +1,232 @@
 #ifndef COMMANDHISTORY_H
 #define COMMANDHISTORY_H
 
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 #include <mutex>
 #include "utils/PALogger.h" // <-- AÑADIR ESTE INCLUDE
+#include "core/HistoryStats.h"
 
 struct CommandEntry {
-    std::string timestamp;
+    uint64_t id = 0;            // Número de secuencia (creciente, no se reutiliza)
+    int64_t epoch = 0;          // Segundos desde epoch
+    std::string timestamp;      // ISO 8601 local, armado al consultar
     std::string username;
     std::string service_name;
     std::string details;
-    bool was_error;
+    bool was_error = false;
 };
 
+/**
+ * @brief Criterios de consulta del historial
+ */
+struct HistoryFilter {
+    std::string username;               // "" = todos
+    std::string service_name;           // "" = todos
+    std::optional<bool> was_error;      // vacío = errores y éxitos
+    std::optional<int64_t> from_epoch;  // Inclusive
+    std::optional<int64_t> to_epoch;    // Inclusive
+};
+
+/**
+ * @brief Una página de consulta. Para la siguiente, pasar next_cursor
+ * como cursor (0 = no hay más).
+ */
+struct HistoryPage {
+    std::vector<CommandEntry> entries;
+    uint64_t next_cursor = 0;
+};
+
+struct HistoryTotals {
+    uint64_t commands = 0;
+    uint64_t errors = 0;
+};
+
+class CommandHistorySqlite;
+
+/**
+ * @brief Historial de comandos en memoria, acotado.
+ *
+ * Las entradas se guardan compactas (fecha como entero, usuario y servicio
+ * internados) en un anillo de segmentos: al llenarse se descarta el
+ * segmento más viejo.
+ *
+ * Lecturas estilo RCU: los lectores toman una instantánea inmutable (la
+ * lista de segmentos, compartida con shared_ptr) y la recorren sin el
+ * mutex, así un reporte largo no frena a addEntry(). El escritor agrega al
+ * segmento activo y publica la cantidad con un store release; solo arma
+ * una instantánea nueva al sellar un segmento, al internar un nombre o al
+ * borrar un usuario. Un segmento descartado sigue vivo mientras algún
+ * lector lo tenga. Los segmentos sellados llevan un índice por usuario.
+ *
+ * Con un almacén persistente (attachStore), las entradas además se
+ * guardan en SQLite por lotes y las consultas se resuelven en SQL; lo que
+ * todavía no se confirmó se completa desde memoria.
+ */
 class CommandHistory {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 100000;
+    static constexpr size_t MAX_SEGMENT_SIZE = 1024;
+
 private:
+    // Inmutable una vez publicada (se agrega, nunca se modifica)
+    struct StoredEntry {
+        int64_t epoch = 0;
+        uint32_t user = 0;
+        uint32_t service = 0;
+        bool was_error = false;
+        std::string details;
+    };
+
+    struct Segment {
+        Segment(uint64_t first, size_t capacity);
+
+        const uint64_t firstId;
+        std::unique_ptr<StoredEntry[]> entries;     // Tamaño fijo: no se realoja
+        std::atomic<size_t> count{0};               // Entradas publicadas
+        // Posiciones por usuario; se arma al sellar y solo se lee desde
+        // instantáneas donde el segmento ya no es el activo
+        std::unordered_map<uint32_t, std::vector<uint32_t>> byUser;
+    };
+
+    struct Snapshot {
+        std::vector<std::shared_ptr<Segment>> segments;             // front: el más viejo; back: el activo
+        std::shared_ptr<const std::vector<uint64_t>> hiddenBefore;  // Por usuario: ids menores borrados
+    };
+
+    // Nombres internados: los agrega el escritor y se leen sin lock
+    class NamePool {
+    public:
+        static constexpr size_t CHUNK = 256;
+        static constexpr size_t MAX_CHUNKS = 4096;
+
+        ~NamePool();
+        uint32_t intern(const std::string& name);                   // Con mtx_
+        bool find(const std::string& name, uint32_t& id) const;     // Cualquier hilo
+        const std::string& name(uint32_t id) const;                 // Cualquier hilo (id publicado)
+
+    private:
+        std::array<std::atomic<std::string*>, MAX_CHUNKS> chunks_{};
+        std::atomic<uint32_t> size_{0};
+        std::unordered_map<std::string_view, uint32_t> ids_;       // Solo el escritor
+    };
+
+    // Filtro con usuario y servicio ya convertidos a ids
+    struct ResolvedFilter {
+        const HistoryFilter& filter;
+        std::optional<uint32_t> user;
+        std::optional<uint32_t> service;
+    };
+
     PALogger& logger_; // <-- AÑADIR REFERENCIA AL LOGGER
-    std::vector<CommandEntry> entries_;
-    mutable std::mutex mtx_;
-    std::string get_current_timestamp() const;
+    mutable std::mutex mtx_;    // Serializa a los escritores; los lectores no lo toman
+
+    size_t capacity_;
+    size_t segmentSize_;
+    size_t maxSegments_;
+
+    // Estado del escritor (con mtx_)
+    std::shared_ptr<Snapshot> current_;                // La última publicada
+    std::shared_ptr<Segment> active_;
+    uint64_t nextId_ = 1;
+    std::vector<uint64_t> hiddenBefore_;
+    std::vector<size_t> userLive_;                     // Entradas no borradas por usuario
+
+    // Leído sin lock
+    std::shared_ptr<const Snapshot> snapshot_;         // std::atomic_load / std::atomic_store
+    std::atomic<size_t> size_{0};                      // Entradas no borradas
+    NamePool users_;
+    NamePool services_;
+
+    std::unique_ptr<CommandHistorySqlite> store_;
+    HistoryStats stats_;        // Se escribe con mtx_ tomado; se lee sin lock
+
+    std::shared_ptr<const Snapshot> acquireSnapshot() const;
+    void publish(std::shared_ptr<Snapshot> next);
+    void rollSegment();
+    void evictSegment(const Segment& segment);
+    CommandEntry materialize(uint64_t id, const StoredEntry& entry) const;
+    bool resolve(const HistoryFilter& filter, std::optional<ResolvedFilter>& out) const;
+    static bool matches(const Snapshot& snap, uint64_t id, const StoredEntry& entry, const ResolvedFilter& filter);
+    // Recorre las entradas con id en (lo, hi] que cumplen el filtro; fn devuelve false para cortar
+    template <typename Fn>
+    void forEachMatch(const Snapshot& snap, const ResolvedFilter& filter, uint64_t lo, uint64_t hi,
+                      bool newestFirst, Fn&& fn) const;
+    // Hasta @p limit entradas en memoria con id en (lo, hi] que cumplen el filtro
+    void collect(const HistoryFilter& filter, uint64_t lo, uint64_t hi, size_t limit,
+                 bool newestFirst, std::vector<CommandEntry>& out) const;
 
 public:
-    // Modificar el constructor para recibir el logger
-    CommandHistory(PALogger& logger) : logger_(logger) {} // <-- MODIFICAR CONSTRUCTOR
+    /**
+     * @param logger Logger (la auditoría CSV se registra desde addEntry)
+     * @param capacity Entradas a conservar como máximo
+     */
+    explicit CommandHistory(PALogger& logger, size_t capacity = DEFAULT_CAPACITY);
+    ~CommandHistory();
+
+    /**
+     * @brief Persiste el historial en @p store. Llamar antes de registrar
+     * comandos: los ids continúan desde el último guardado y las estadísticas
+     * parten de lo que ya tiene la base.
+     * @throws std::logic_error si el historial ya tiene entradas
+     */
+    void attachStore(std::unique_ptr<CommandHistorySqlite> store);
 
-    void addEntry(const std::string& user, const std::string& service, 
+    void addEntry(const std::string& user, const std::string& service,
                   const std::string& details, bool is_error);
 
+    /**
+     * @brief Entradas que cumplen el filtro, de la más vieja a la más nueva
+     */
+    std::vector<CommandEntry> getEntries(const HistoryFilter& filter) const;
+
+    /**
+     * @brief Una página de entradas, recorriendo por id sin copiar el resto.
+     * @param cursor 0 para empezar; si no, el next_cursor de la página anterior
+     * @param limit Entradas como máximo (0 = sin límite)
+     * @param newestFirst true: de la más nueva a la más vieja
+     */
+    HistoryPage getPage(const HistoryFilter& filter, uint64_t cursor, size_t limit,
+                        bool newestFirst = false) const;
+
+    /**
+     * @brief Cantidad de entradas y de errores que cumplen el filtro
+     */
+    HistoryTotals countEntries(const HistoryFilter& filter) const;
+
     std::vector<CommandEntry> getEntriesForUser(const std::string& username) const;
     std::vector<CommandEntry> getAllEntries() const;
     void clearUserHistory(const std::string& username);
 
+    /**
+     * @brief Contadores por usuario, servicio, error y minuto/hora, mantenidos
+     * en cada addEntry(). No toma el mutex del historial.
+     */
+    HistoryStatsSnapshot getStats() const;
+
+    /**
+     * @brief Entradas conservadas (sin las borradas)
+     */
+    size_t size() const;
+    size_t capacity() const { return capacity_; }
+
+    /**
+     * @brief Espera a que lo registrado esté guardado (si hay almacén)
+     */
+    void flush();
+
+    // Formato ISO 8601 local (YYYY-MM-DDTHH:MM:SS)
+    static std::string format_timestamp(int64_t epoch);
+
     CommandHistory(const CommandHistory&) = delete;
     CommandHistory& operator=(const CommandHistory&) = delete;
 };
 
-#endif // COMMANDHISTORY_H
\ No newline at end of file
+#endif // COMMANDHISTORY_H
@@ -0,0 +1,123 @@
+#ifndef HISTORYSTATS_H
+#define HISTORYSTATS_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+struct StatsCounter {
+    uint64_t commands = 0;
+    uint64_t errors = 0;
+};
+
+struct StatsBucket {
+    int64_t start = 0;          // Epoch del inicio del minuto/hora
+    uint64_t commands = 0;
+    uint64_t errors = 0;
+};
+
+struct HistoryStatsSnapshot {
+    StatsCounter total;
+    std::vector<std::pair<std::string, StatsCounter>> byUser;
+    std::vector<std::pair<std::string, StatsCounter>> byService;
+    std::vector<StatsBucket> byMinute;      // Última hora, del más viejo al más nuevo (sin vacíos)
+    std::vector<StatsBucket> byHour;        // Últimas 48 horas, ídem
+};
+
+/**
+ * @brief Contadores del historial de comandos, mantenidos en cada alta.
+ *
+ * Un solo escritor (CommandHistory, con su mutex tomado) y lectores sin
+ * lock: los contadores son atómicos que el escritor actualiza con
+ * load/store relajados (sin RMW), los nombres se publican con un contador
+ * de slots (release/acquire) y cada balde de tiempo es un seqlock: leer
+ * las estadísticas nunca bloquea ni hace esperar a addEntry().
+ *
+ * Cuentan lo registrado: no se descuentan al borrar el historial de un
+ * usuario ni al descartar entradas viejas de memoria.
+ */
+class HistoryStats {
+public:
+    static constexpr size_t MINUTE_BUCKETS = 60;
+    static constexpr size_t HOUR_BUCKETS = 48;
+
+    HistoryStats();
+    ~HistoryStats();
+
+    HistoryStats(const HistoryStats&) = delete;
+    HistoryStats& operator=(const HistoryStats&) = delete;
+
+    // --- Escritor (uno solo a la vez) ---
+
+    /**
+     * @param user Id interno del usuario (consecutivos desde 0, como los de CommandHistory)
+     * @param service Id interno del servicio, ídem
+     */
+    void record(uint32_t user, const std::string& userName,
+                uint32_t service, const std::string& serviceName,
+                int64_t epoch, bool isError);
+
+    // Acumulados ya agrupados (carga inicial desde la base)
+    void addUser(uint32_t id, const std::string& name, uint64_t commands, uint64_t errors);
+    void addService(uint32_t id, const std::string& name, uint64_t commands, uint64_t errors);
+    void addMinute(int64_t epoch, uint64_t commands, uint64_t errors);
+    void addHour(int64_t epoch, uint64_t commands, uint64_t errors);
+
+    // --- Lectores (cualquier hilo) ---
+
+    StatsCounter total() const;
+
+    /**
+     * @brief Copia de los contadores. Costo proporcional a la cantidad de
+     * usuarios y servicios distintos, no al tamaño del historial.
+     * @param now Epoch actual (define la ventana de los baldes)
+     */
+    HistoryStatsSnapshot snapshot(int64_t now) const;
+
+private:
+    struct NamedCounter {
+        std::string name;                       // Escrito antes de publicar el slot
+        std::atomic<uint64_t> commands{0};
+        std::atomic<uint64_t> errors{0};
+    };
+
+    // Slots por id, en bloques que no se mueven: publicar no invalida lectores
+    class CounterTable {
+    public:
+        static constexpr size_t CHUNK = 256;
+        static constexpr size_t MAX_CHUNKS = 1024;
+
+        ~CounterTable();
+        NamedCounter* get(uint32_t id, const std::string& name);   // Escritor
+        void read(std::vector<std::pair<std::string, StatsCounter>>& out) const;
+
+    private:
+        std::array<std::atomic<NamedCounter*>, MAX_CHUNKS> chunks_{};
+        std::atomic<uint32_t> published_{0};
+    };
+
+    struct Bucket {
+        std::atomic<int64_t> start{-1};         // -1: vacío o actualizándose
+        std::atomic<uint64_t> commands{0};
+        std::atomic<uint64_t> errors{0};
+    };
+
+    template <size_t N>
+    static void addToBucket(std::array<Bucket, N>& ring, int64_t width,
+                            int64_t epoch, uint64_t commands, uint64_t errors);
+    template <size_t N>
+    static void readBuckets(const std::array<Bucket, N>& ring, int64_t width,
+                            int64_t now, std::vector<StatsBucket>& out);
+
+    std::atomic<uint64_t> commands_{0};
+    std::atomic<uint64_t> errors_{0};
+    CounterTable users_;
+    CounterTable services_;
+    std::array<Bucket, MINUTE_BUCKETS> minutes_;
+    std::array<Bucket, HOUR_BUCKETS> hours_;
+};
+
+#endif // HISTORYSTATS_H
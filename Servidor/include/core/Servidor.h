@@ -43,9 +43,12 @@
 #include "ServiciosRobot/RobotStartRecordingMethod.h" 
 #include "ServiciosRobot/RobotStopRecordingMethod.h"
 #include "ServiciosRobot/RobotRunFileMethod.h"  
+#include "ServiciosRobot/RobotResumeFileMethod.h"
 #include "ServiciosRobot/RobotUploadFileMethod.h"
+#include "ServiciosRobot/RobotOptimizeFileMethod.h"
 #include "ServiciosRobot/RobotListFilesMethod.h"
 #include "ServiciosRobot/RobotGetReportMethod.h"
+#include "ServiciosRobot/RobotGetStatsMethod.h"
 
 // Libreria
 #include "XmlRpc.h"
@@ -129,9 +132,12 @@ class Servidor {
         std::unique_ptr<robot_service_methods::RobotStartRecordingMethod> mRobotStartRecording_;
         std::unique_ptr<robot_service_methods::RobotStopRecordingMethod> mRobotStopRecording_;
         std::unique_ptr<robot_service_methods::RobotRunFileMethod> mRobotRunFile_;
+        std::unique_ptr<robot_service_methods::RobotResumeFileMethod> mRobotResumeFile_;
         std::unique_ptr<robot_service_methods::RobotUploadFileMethod> mRobotUploadFile_; 
+        std::unique_ptr<robot_service_methods::RobotOptimizeFileMethod> mRobotOptimizeFile_;
         std::unique_ptr<robot_service_methods::RobotListFilesMethod> mRobotListFiles_;
         std::unique_ptr<robot_service_methods::RobotGetReportMethod> mRobotGetReport_;
+        std::unique_ptr<robot_service_methods::RobotGetStatsMethod> mRobotGetStats_;
 
 
         //HASTA ACA LLEGAN LOS CAMBIOS
@@ -1,6 +1,7 @@
 #ifndef SERVIDOR_CONFIG_H
 #define SERVIDOR_CONFIG_H
 
+#include <cstdint>
 #include <string>
 
 struct ServidorConfig {
@@ -19,10 +20,27 @@ struct ServidorConfig {
     std::string archivoLog = "servidor.log";
     bool logEnConsola = true;
     std::string archivoAuditLog = "audit.csv";
+    // Escritura asincrónica: fsync cada N ms (0 = en cada lote, <0 = nunca)
+    int logIntervaloFsyncMs = 1000;
+    bool logDescartarSiLleno = false;  // true: con la cola llena se descarta (la auditoría nunca)
+    // Rotación de servidor.log y audit.csv (segmentos .gz comprimidos en segundo plano)
+    uint64_t logRotarMaxBytes = 64ull * 1024 * 1024;   // 0 = sin límite por tamaño
+    bool logRotarDiario = true;
+    size_t logSegmentosMax = 30;                       // Segmentos a conservar por archivo (0 = todos)
+    uint64_t logSegmentosMaxBytes = 0;                 // Total de segmentos por archivo (0 = sin límite)
+    // Log binario (ej. "servidor.plog"): reemplaza consola y servidor.log; "" = desactivado
+    std::string archivoLogBinario = "";
+    // === Historial de comandos ===
+    size_t historialCapacidad = 100000;   // Entradas en memoria (se descartan las más viejas)
+    bool historialPersistente = true;     // Guardar también en la tabla command_history de rutaBaseDatos
     // === Configuracion del robot ===
     std::string puertoSerial = "/dev/ttyUSB0";
-    int baudrate = 115200;
+    int baudrate = 115200;            // 9600 a 1000000 (por encima de 115200 conviene protocoloConChecksum)
+    bool protocoloConChecksum = false; // "N<linea> <comando>*<checksum>" con reenvío (LINE_CHECKSUM en el firmware)
     std::string directorioTrayectorias = "data/trayectorias/";
+    // Grabación: bytes acumulados / ms máximos antes de volcar al disco
+    size_t grabacionUmbralVolcadoBytes = 64 * 1024;
+    int grabacionIntervaloVolcadoMs = 200;
 
     // === Configuracion de modulos ===
     bool moduloRobotHabilitado = true;
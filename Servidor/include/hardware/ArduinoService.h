@@ -5,6 +5,8 @@
 #include <string>
 #include <memory>
 #include <chrono>
+#include <deque>
+#include <utility>
 
 #include <thread>
 #include <stdexcept>
@@ -18,6 +20,10 @@ class ArduinoService {
 private:
     void limpiarBuffer();
     bool verificarConexion();
+    bool sincronizarNumeroLinea(long numero);
+    std::string enviarComandoEnmarcado(const std::string& comando, int timeoutMs);
+    void guardarEnHistorial(long linea, const std::string& trama);
+    const std::string& tramaDelHistorial(long linea) const;
 
     std::unique_ptr<SerialCom> serialCom;
     bool conectado; // Estado
@@ -25,6 +31,15 @@ private:
     std::chrono::milliseconds timeoutEstabilizacion;
     std::chrono::milliseconds timeoutRespuesta;
 
+    // Protocolo "N<linea> <comando>*<checksum>" con reenvío ("RS <linea>")
+    bool protocoloConChecksum = false;
+    long numeroLinea = 0;           // Última línea confirmada por el firmware
+    int maxReenvios = 5;
+    size_t reenvios = 0;            // Total de reenvíos (pedidos o por timeout)
+    // Últimas tramas confirmadas, para reenviar desde la que pida "RS"
+    static constexpr size_t MAX_HISTORIAL_TRAMAS = 16;
+    std::deque<std::pair<long, std::string>> historialTramas;
+
 public:
     // Constructor
     ArduinoService(const std::string& puerto = "/dev/ttyUSB0",
@@ -46,10 +61,15 @@ public:
     // Configuracion
     void setTimeoutEstabilizacion(std::chrono::milliseconds timeout);
     void setTimeoutRespuesta(std::chrono::milliseconds timeout);
+    // Activar antes de conectar: al conectar se sincroniza el número de línea (M110)
+    void setProtocoloConChecksum(bool activo);
+    void setMaxReenvios(int maximo);
 
     // Getters
     std::string getPuerto() const;
     int getBaudrate() const;
+    bool getProtocoloConChecksum() const;
+    size_t getReenvios() const;
 };
 
 #endif // ARDUINOSERVICE_H
\ No newline at end of file
@@ -0,0 +1,56 @@
+#ifndef FIRMWARELOG_H
+#define FIRMWARELOG_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Respuesta del Arduino separada en un único recorrido
+ */
+struct RespuestaFirmware {
+    bool ok = false;                    // Se recibió la línea "OK"
+    bool tieneError = false;
+    std::string mensajeError;           // Último ERROR recibido
+    std::vector<std::string> mensajes;  // INFO y líneas sin prefijo (para el cliente)
+    std::vector<std::string> lineasLog; // INFO y ERROR en el orden recibido (para el log)
+};
+
+/**
+ * @brief Decodificador de los mensajes del firmware
+ *
+ * Con LOG_COMPACT el firmware envía "I<código> v1 v2 ..." o "E<código>" en
+ * lugar del texto completo; aquí se reconstruye el texto con la misma tabla
+ * que robotArm_v0.62sim/logCodes.h. Las líneas "INFO:" / "ERROR:" del
+ * formato antiguo se siguen aceptando.
+ */
+class FirmwareLog {
+public:
+    /**
+     * @brief Separa una respuesta completa en OK, errores y mensajes
+     * @param respuesta Texto recibido del Arduino (varias líneas)
+     */
+    static RespuestaFirmware parsear(std::string_view respuesta);
+
+    /**
+     * @brief Extrae la posición del mensaje "CURRENT POSITION" de un M114
+     * @return false si la respuesta no trae la posición
+     */
+    static bool posicionActual(const RespuestaFirmware& respuesta, double& x, double& y, double& z);
+
+    /**
+     * @brief Reconstruye el texto de un mensaje compacto
+     * @param codigo Código numérico del mensaje
+     * @param valores Valores tal como llegaron por el puerto serie
+     * @return Texto con los valores insertados, o "MSG <código> ..." si el código no existe
+     */
+    static std::string decodificar(int codigo, const std::vector<std::string_view>& valores);
+
+    /**
+     * @brief Plantilla asociada a un código ('%' decimal, '#' entero)
+     * @return nullptr si el código no está en la tabla
+     */
+    static const char* plantilla(int codigo);
+};
+
+#endif
@@ -2,6 +2,8 @@
 #define SERIALCOM_H
 
 #include <string>
+#include <vector>
+#include <cstdint>
 
 #include <termios.h>    // Manejo de puertos seriales en Linux
 #include <fcntl.h>      // open
@@ -19,6 +21,8 @@ class SerialCom {
 
         // Metodo para configurar el puerto serial
         bool configureSerialPort();
+        // Velocidades fuera de la tabla de termios (termios2 / BOTHER)
+        bool configureCustomBaudrate();
 
     public:
         /**
@@ -72,6 +76,35 @@ class SerialCom {
          */
         std::string readResponse(int timeoutMs = 2000);
 
+        /**
+         * @brief Lee hasta recibir una linea que empiece con alguno de los prefijos dados
+         * @param endPrefixes Prefijos que cierran la respuesta (ej. "OK", "RS ")
+         * @param timeoutMs Tiempo maximo de espera total en milisegundos
+         * @return Todo lo leido hasta esa linea inclusive, o lo que haya llegado al vencer el timeout
+         */
+        std::string readUntil(const std::vector<std::string>& endPrefixes, int timeoutMs);
+
+        //
+        // ===== PROTOCOLO CON NUMERO DE LINEA Y CHECKSUM =====
+        //
+
+        /**
+         * @brief Checksum del protocolo: XOR de todos los bytes
+         */
+        static uint8_t checksum(const std::string& data);
+
+        /**
+         * @brief Arma la linea "N<numero> <comando>*<checksum>\r\n"
+         * @param lineNumber Numero de linea
+         * @param command Comando G-code (se ignoran espacios y fin de linea al final)
+         */
+        static std::string frameLine(long lineNumber, const std::string& command);
+
+        /**
+         * @brief Indica si la velocidad esta soportada (9600 a 1000000 baudios)
+         */
+        static bool isSupportedBaudrate(int baudrate);
+
         //
         // ===== GETTERS Y SETTERS =====
         //
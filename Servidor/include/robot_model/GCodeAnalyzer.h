@@ -0,0 +1,85 @@
+#ifndef GCODEANALYZER_H
+#define GCODEANALYZER_H
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+// Una línea de G-code ya separada en sus campos (sin comentarios)
+struct LineaGCode {
+    char letra  = 0;       // 'G' o 'M' (0 si la línea no tiene comando)
+    int  numero = -1;
+    bool tieneX = false, tieneY = false, tieneZ = false, tieneF = false;
+    bool tieneI = false, tieneJ = false;  // centro de G2/G3 (relativo al inicio)
+    double x = 0, y = 0, z = 0, f = 0;
+    double i = 0, j = 0;
+};
+
+// Metadatos de una trayectoria completa
+struct MetadatosGCode {
+    size_t bytes = 0;
+    size_t lineas = 0;        // líneas con comando (sin vacías ni comentarios)
+    size_t movimientos = 0;   // G0/G1/G2/G3
+    bool   bboxValida = false;
+    double minX = 0, minY = 0, minZ = 0;
+    double maxX = 0, maxY = 0, maxZ = 0;
+    double distanciaMm = 0;
+    double duracionEstimadaSeg = 0;
+};
+
+/**
+ * @brief Analizador incremental de G-code.
+ *
+ * Recorre las líneas una sola vez y acumula tamaño, bounding box, distancia
+ * recorrida y una duración estimada que reproduce el perfil del firmware
+ * (Interpolation::setInterpolation): F en mm/s, y si F < 5 la velocidad es
+ * sqrt(distancia) * 10 con un mínimo de 5 mm/s. Los arcos G2/G3 (plano XY,
+ * centro con I/J) usan la longitud de la hélice como distancia.
+ */
+class GCodeAnalyzer {
+public:
+    // Pose de homing del firmware (INITIAL_X/Y/Z en config.h)
+    static constexpr double HOME_X = 0.0;
+    static constexpr double HOME_Y = 170.0;
+    static constexpr double HOME_Z = 120.0;
+
+    // Tiempos aproximados de los comandos que no son interpolaciones
+    static constexpr double TIEMPO_HOMING_SEG  = 3.0;
+    static constexpr double TIEMPO_EFECTOR_SEG = 1.0;
+
+    GCodeAnalyzer();
+
+    // Parseo de una línea suelta. Devuelve false si no contiene comando.
+    static bool parsearLinea(std::string_view linea, LineaGCode& out);
+
+    // Velocidad efectiva (mm/s) que usará el firmware para un tramo
+    static double velocidadEfectiva(double distancia, double f);
+
+    // Ángulo barrido (rad, negativo = horario) por un arco de (x0,y0) a (x1,y1)
+    // alrededor de (cx,cy). Inicio == fin es un círculo completo.
+    static double barridoArco(double x0, double y0, double x1, double y1,
+                              double cx, double cy, bool horario);
+
+    // Longitud recorrida por un G2/G3 de (x0,y0,z0) a (x1,y1,z1); sin centro
+    // válido el firmware lo trata como recta
+    static double longitudArco(double x0, double y0, double z0,
+                               double x1, double y1, double z1, const LineaGCode& arco);
+
+    // Procesa una línea (con o sin '\n' final)
+    void procesarLinea(std::string_view linea);
+
+    const MetadatosGCode& resultado() const { return meta; }
+
+    // Atajo: analiza un contenido completo en memoria
+    static MetadatosGCode analizar(const std::string& contenido);
+
+private:
+    MetadatosGCode meta;
+    double x, y, z;
+    bool relativo = false;
+
+    void extenderBBox(double px, double py, double pz);
+    void procesarArco(const LineaGCode& l);
+};
+
+#endif // GCODEANALYZER_H
@@ -0,0 +1,76 @@
+#ifndef GCODEOPTIMIZER_H
+#define GCODEOPTIMIZER_H
+
+#include "robot_model/GCodeAnalyzer.h"
+
+#include <string>
+#include <vector>
+
+struct OpcionesOptimizacion {
+    double toleranciaMm = 0.5;          // desvío máximo al fusionar tramos (RDP)
+    double distanciaMinimaMm = 0.01;    // movimientos más cortos se descartan
+    bool   simplificarColineales = true;
+    bool   colapsarEfector = true;      // M3/M5 consecutivos sin movimiento entre medio
+    bool   reordenarPickAndPlace = false; // ver PickPlaceReorderer (opt-in)
+    bool   ajustarArcos = false;        // polilíneas densas -> G2/G3 (opt-in)
+};
+
+struct ResultadoOptimizacion {
+    std::vector<std::string> lineas;    // trayectoria optimizada
+    size_t lineasAntes = 0;             // líneas con comando
+    size_t lineasDespues = 0;
+    size_t movimientosEliminados = 0;
+    size_t efectorEliminados = 0;
+    size_t arcosAjustados = 0;          // G2/G3 emitidos en lugar de varios G1
+    double duracionAntesSeg = 0;        // estimadas con GCodeAnalyzer
+    double duracionDespuesSeg = 0;
+
+    // Reordenamiento pick-and-place (si se pidió)
+    bool   reordenado = false;
+    size_t bloques = 0;
+    double viajeAntesSeg = 0;           // traslados entre operaciones
+    double viajeDespuesSeg = 0;
+    std::string motivoSinReorden;
+
+    std::string contenido() const;      // líneas unidas con '\n'
+};
+
+/**
+ * @brief Pasada de optimización sobre una trayectoria ya grabada/subida.
+ *
+ * - Descarta movimientos nulos o repetidos.
+ * - Fusiona tramos colineales (Ramer–Douglas–Peucker) dentro de la tolerancia.
+ *   Solo se simplifican corridas de G0/G1 absolutos con X, Y y Z explícitos
+ *   y el mismo F; cualquier otro comando actúa como barrera y se conserva.
+ * - Opcionalmente, ajusta arcos G2/G3 sobre tramos de al menos
+ *   MIN_SEGMENTOS_ARCO segmentos en un plano Z constante, cuando todos los
+ *   puntos y las cuerdas quedan dentro de la tolerancia del círculo.
+ * - Colapsa M3/M5 redundantes: de una racha sin movimientos queda la última,
+ *   y se omite si no cambia el estado conocido del efector.
+ * - Opcionalmente, antes de todo lo anterior, reordena las operaciones
+ *   pick-and-place independientes (PickPlaceReorderer).
+ */
+class GCodeOptimizer {
+public:
+    static ResultadoOptimizacion optimizar(const std::vector<std::string>& lineas,
+                                           const OpcionesOptimizacion& opciones);
+    static ResultadoOptimizacion optimizar(const std::string& contenido,
+                                           const OpcionesOptimizacion& opciones);
+
+    static constexpr size_t MIN_SEGMENTOS_ARCO = 4;
+    static constexpr double RADIO_MAXIMO_ARCO_MM = 2000.0;
+
+private:
+    struct Punto { double x, y, z; };
+    struct Arco { double cx, cy, barrido; };
+
+    static double distancia(const Punto& a, const Punto& b);
+    static double distanciaASegmento(const Punto& p, const Punto& a, const Punto& b);
+    static void   rdp(const std::vector<Punto>& pts, size_t i, size_t j,
+                      double tolerancia, std::vector<bool>& conservar);
+    // Mayor índice e > s tal que pts[s..e] se ajusta a un arco (s si no hay)
+    static size_t buscarArco(const std::vector<Punto>& pts, size_t s, double tolerancia, Arco& arco);
+    static std::string formatearArco(const Punto& desde, const Punto& hasta, const Arco& arco, double f);
+};
+
+#endif // GCODEOPTIMIZER_H
@@ -0,0 +1,73 @@
+#ifndef MOTIONPLANNER_H
+#define MOTIONPLANNER_H
+
+#include <cstddef>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Parámetros del planificador (por defecto, los de config.h del firmware)
+struct ParametrosPlanificador {
+    size_t ventana = 8;              // PLANNER_WINDOW
+    double aceleracion = 1000.0;     // MAX_ACCEL (mm/s²)
+    double desvioUnion = 0.05;       // JUNCTION_DEVIATION (mm)
+    bool   anticipacion = true;      // false = frena en cada vértice (ventana de 1)
+};
+
+/**
+ * @brief Réplica en el servidor del planificador look-ahead del firmware.
+ *
+ * Sirve para estimar la duración de una trayectoria tal como la ejecuta el
+ * firmware con LOOKAHEAD: los G0/G1 consecutivos se encadenan con perfiles
+ * trapezoidales y velocidades de unión según el ángulo entre tramos. Se
+ * asume que el servidor mantiene la ventana llena (envío sin pausas).
+ *
+ * Los comandos que no son G0/G1 vacían la ventana (el firmware los ejecuta
+ * recién con el brazo detenido). Los arcos G2/G3 siguen usando el perfil
+ * de Interpolation (duración = longitud / velocidad), y G28/M3/M5 suman los
+ * mismos tiempos fijos que GCodeAnalyzer.
+ */
+class MotionPlanner {
+public:
+    explicit MotionPlanner(ParametrosPlanificador parametros = {});
+
+    // Procesa una línea de G-code (con o sin '\n' final)
+    void procesarLinea(std::string_view linea);
+
+    // Vacía la ventana y devuelve la duración total estimada (s)
+    double finalizar();
+
+    size_t segmentos() const { return segmentos_; }
+
+    // Atajo: duración estimada de un conjunto de líneas
+    static double estimar(const std::vector<std::string>& lineas, ParametrosPlanificador parametros = {});
+
+    // Tiempo de un tramo de 'distancia' mm que entra a v0, cruza a vc y sale a v1
+    static double tiempoTrapecio(double distancia, double v0, double vc, double v1, double aceleracion);
+
+private:
+    struct Bloque {
+        double largo = 0;
+        double unidad[3] = {0, 0, 0};
+        double vNominal = 0;
+        double vEntradaMax = 0;
+        double vEntrada = 0;
+        bool   entradaFija = false;
+    };
+
+    void agregarTramo(double x, double y, double z, double f);
+    void despacharPrimero();
+    void vaciar();
+    void recalcular();
+    double velocidadUnion(const Bloque& previo, const Bloque& actual) const;
+
+    ParametrosPlanificador p_;
+    std::deque<Bloque> ventana_;
+    double x_, y_, z_;
+    bool relativo_ = false;
+    double duracion_ = 0;
+    size_t segmentos_ = 0;
+};
+
+#endif // MOTIONPLANNER_H
@@ -0,0 +1,53 @@
+#ifndef MOVIMIENTOSPENDIENTES_H
+#define MOVIMIENTOSPENDIENTES_H
+
+#include "robot_model/TrajectoryManager.h"
+
+#include <cstddef>
+#include <deque>
+
+/**
+ * @brief Movimientos aceptados por el firmware cuya ejecución no está confirmada.
+ *
+ * Con LOOKAHEAD el firmware responde OK a un G0/G1 cuando entra al
+ * planificador, no cuando termina, y a un G2/G3 cuando empieza. Cada
+ * movimiento queda aquí hasta que la posición leída con M114 muestra que el
+ * brazo ya lo recorrió. El checkpoint que se persiste apunta al primero sin
+ * confirmar: si un M410 o un corte vacían el planificador, reanudar no
+ * saltea movimientos que nunca se hicieron.
+ */
+class MovimientosPendientes {
+public:
+    // Distancia (mm) a la que se considera que el brazo está sobre un tramo
+    static constexpr double TOLERANCIA_MM = 0.5;
+
+    // 'antes' es el checkpoint previo a la línea (su lineaReanudacion es la del
+    // movimiento). 'lineal' = G0/G1. Un arco empieza recién con el
+    // planificador vacío, así que confirma todo lo anterior; él mismo solo se
+    // confirma al llegar a su destino.
+    void agregar(const CheckpointTrayectoria& antes, double x, double y, double z, bool lineal);
+
+    // Confirma los movimientos anteriores al tramo donde está el brazo, y ese
+    // tramo si ya llegó a su destino. Devuelve cuántos confirmó.
+    size_t confirmarConPosicion(double x, double y, double z);
+
+    // El firmware vació el planificador (respondió un M3/M5)
+    void confirmarTodos() { pendientes.clear(); }
+
+    bool   vacio() const { return pendientes.empty(); }
+    size_t cantidad() const { return pendientes.size(); }
+
+    // Checkpoint que se puede persistir: 'actual' si no hay pendientes; si no,
+    // el estado previo al primer movimiento sin confirmar (con el motivo de 'actual')
+    CheckpointTrayectoria checkpointConfirmado(const CheckpointTrayectoria& actual) const;
+
+private:
+    struct Movimiento {
+        CheckpointTrayectoria antes;
+        double x, y, z;
+        bool lineal;
+    };
+    std::deque<Movimiento> pendientes;
+};
+
+#endif // MOVIMIENTOSPENDIENTES_H
@@ -0,0 +1,44 @@
+#ifndef PICKPLACEREORDERER_H
+#define PICKPLACEREORDERER_H
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+struct ResultadoReorden {
+    std::vector<std::string> lineas;
+    size_t bloques = 0;             // operaciones pick-and-place reconocidas
+    bool   reordenado = false;      // false si el archivo no admite reordenarse
+    double viajeAntesSeg = 0;       // tiempo estimado de los traslados entre bloques
+    double viajeDespuesSeg = 0;
+    std::string motivo;             // por qué no se reordenó (si aplica)
+};
+
+/**
+ * @brief Reordena operaciones pick-and-place independientes para acortar el ciclo.
+ *
+ * Un bloque va desde el primer movimiento de aproximación hasta el M5 que
+ * suelta la pieza, incluyendo las subidas en Z que le siguen. El contenido de
+ * cada bloque no se toca; solo cambia el orden de los bloques. El prólogo
+ * (lo anterior al primer movimiento) y el epílogo (movimientos finales sin M5)
+ * quedan fijos.
+ *
+ * El costo entre bloques es el tiempo estimado del traslado (mismo modelo de
+ * velocidad que GCodeAnalyzer). Se construye un recorrido por vecino más
+ * cercano y se mejora con 2-opt; en trabajos grandes la búsqueda de 2-opt se
+ * reparte entre varios hilos.
+ *
+ * Solo se reordena si todos los bloques empiezan con un G0/G1 absoluto con
+ * X, Y y Z explícitos y no hay G28/G91/G92 después del prólogo. Los arcos
+ * G2/G3 se admiten dentro de un bloque, pero no como primer movimiento.
+ */
+class PickPlaceReorderer {
+public:
+    static constexpr size_t MIN_BLOQUES_PARALELO = 128;
+
+    static ResultadoReorden reordenar(const std::vector<std::string>& lineas,
+                                      unsigned hilos = 0,   // 0 = hardware_concurrency
+                                      std::chrono::milliseconds presupuesto = std::chrono::milliseconds(2000));
+};
+
+#endif // PICKPLACEREORDERER_H
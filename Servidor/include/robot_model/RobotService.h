@@ -2,8 +2,12 @@
 #define ROBOTSERVICE_H
 
 #include "hardware/ArduinoService.h"
+#include "hardware/FirmwareLog.h"
 #include "utils/PALogger.h"
 #include "robot_model/TrajectoryManager.h"
+#include "robot_model/MovimientosPendientes.h"
+#include "robot_model/GCodeOptimizer.h"
+#include "robot_model/PickPlaceReorderer.h"
 
 #include <memory>
 #include <string>
@@ -42,7 +46,8 @@ class RobotService {
 
         RobotService(shared_ptr<ArduinoService> arduinoService,
                     PALogger& logger,
-                    const string& directorioTrayectorias = "data/trayectorias/");
+                    const string& directorioTrayectorias = "data/trayectorias/",
+                    SqliteDb* dbCatalogo = nullptr);
 
         //? Porque destructor virtual? 
         virtual ~RobotService() = default;   
@@ -61,6 +66,8 @@ class RobotService {
         string homing();
         string mover(double x, double y, double z, double velocidad);
         string mover(double x, double y, double z);
+        // G2 (horario) / G3 (antihorario): arco en XY con centro (actual + i, actual + j)
+        string moverArco(double x, double y, double z, double i, double j, double velocidad, bool horario);
         
         // Efector Final
         string activarEfector();
@@ -84,11 +91,27 @@ class RobotService {
         bool iniciarGrabacionTrayectoria(const std::string& nombreLogico);
         bool finalizarGrabacionTrayectoria();
         bool estaGrabando() const;        
-        string ejecutarTrayectoria(const std::string& nombreArchivo);
+        void configurarGrabacion(size_t umbralBytes, std::chrono::milliseconds intervalo);
+        // reordenar: ejecuta una copia (<nombre>_reord) con las operaciones pick-and-place reordenadas
+        string ejecutarTrayectoria(const std::string& nombreArchivo, bool reordenar = false);
+        // Reanuda desde el checkpoint guardado cuando una ejecución falló
+        string reanudarTrayectoria(const std::string& nombreArchivo);
         std::string guardarTrayectoriaSubida(const std::string& nombreArchivo, const std::string& contenido);
+        // Igual que la anterior pero optimiza el contenido antes de guardarlo
+        std::string guardarTrayectoriaSubida(const std::string& nombreArchivo, const std::string& contenido,
+                                             const OpcionesOptimizacion& opciones,
+                                             ResultadoOptimizacion& resultado);
+        // Escribe (o sobrescribe) la copia optimizada <nombre>_opt, del mismo dueño
+        // que el original, y devuelve su nombre, o "" si falla
+        std::string optimizarTrayectoria(const std::string& nombreArchivo,
+                                         const OpcionesOptimizacion& opciones,
+                                         ResultadoOptimizacion& resultado);
 
         // Nuevo método para listar archivos
         std::vector<std::string> listarTrayectorias(int userId, const std::string& userRole);
+        // Listado con metadatos desde el catálogo (paginado, ordenado y filtrado)
+        PaginaCatalogo listarTrayectoriasPaginado(int userId, const std::string& userRole,
+                                                  const FiltroCatalogo& filtro);
 
     private:
         shared_ptr<ArduinoService> arduinoService_;
@@ -105,17 +128,49 @@ class RobotService {
         
         // Métodos privados de ayuda
         string formatearComandoG1(double x, double y, double z, double vel = 1);
+        string formatearComandoArco(double x, double y, double z, double i, double j, double vel, bool horario);
         // Procesamiento de respuestas
-        string procesarRespuesta(const string& respuestaCompleta);
-        void logRespuestaCompleta(const string& respuestaCompleta, const string& comando);
-
-        // Constantes para parsing
-        static const string PREFIX_INFO;
-        static const string PREFIX_ERROR;
-        static const string SUFFIX_OK;
+        string procesarRespuesta(const RespuestaFirmware& respuesta);
+        void logRespuestaCompleta(const RespuestaFirmware& respuesta, const string& comando);
+        void logResultadoOptimizacion(const std::string& nombreArchivo, const ResultadoOptimizacion& resultado);
+        string ejecutarTrayectoriaReordenada(const std::string& nombreArchivo);
 
         std::chrono::milliseconds getTimeoutParaComando(const std::string& lineaGCode) const;
 
+        // Ejecución de trayectorias (compartido por ejecutar y reanudar)
+        void prepararEjecucion(bool conHoming);
+        void aproximarAPose(const CheckpointTrayectoria& checkpoint);
+        void restaurarEfector(const CheckpointTrayectoria& checkpoint);
+        // Recorre el archivo mapeado desde la línea 'desde' sin cargarlo en memoria
+        void ejecutarLineas(MappedFile& archivo, size_t desde,
+                            CheckpointTrayectoria& checkpoint);
+        string ejecutarLineaGCode(const std::string& linea, CheckpointTrayectoria& checkpoint,
+                                  MovimientosPendientes& pendientes);
+        // Posición actual según M114 (comando inmediato: no espera al planificador)
+        bool leerPosicion(double& x, double& y, double& z);
+        // Descarta de 'pendientes' lo que el brazo ya recorrió
+        void confirmarMovimientos(MovimientosPendientes& pendientes);
+        // Concilia con M114 y persiste lo ya ejecutado de 'checkpoint'
+        void guardarCheckpointConfirmado(MovimientosPendientes& pendientes,
+                                         const CheckpointTrayectoria& checkpoint);
+        // Espera a que el firmware termine los movimientos aceptados; lanza si dejan de avanzar
+        void esperarMovimientos(MovimientosPendientes& pendientes, const CheckpointTrayectoria& checkpoint);
+
+        // Altura extra (mm) para la aproximación antes de reanudar
+        static constexpr double DESPEJE_Z_REANUDACION = 20.0;
+        // Consulta de posición mientras se esperan los movimientos pendientes
+        static constexpr std::chrono::milliseconds INTERVALO_CONSULTA_POSICION{100};
+        // Sin avance durante este tiempo, los pendientes se dan por descartados (p. ej. M410)
+        static constexpr std::chrono::milliseconds ESPERA_SIN_AVANCE{2000};
+        // Mientras se transmite, el checkpoint se persiste cada tantas líneas o
+        // cada tanto tiempo, lo que ocurra primero
+        static constexpr size_t LINEAS_ENTRE_CHECKPOINTS = 50;
+        static constexpr std::chrono::milliseconds INTERVALO_CHECKPOINT{1000};
+        // Sufijo de la copia que ejecuta robot.runFile con reordenar=true
+        static constexpr const char* SUFIJO_REORDENADA = "reord";
+        // Sufijo de la copia que escribe robot.optimizeFile
+        static constexpr const char* SUFIJO_OPTIMIZADA = "opt";
+
 };
 
 #endif // ROBOTSERVICE_H
\ No newline at end of file
@@ -2,16 +2,36 @@
 #define TRAJECTORYMANAGER_H
 
 #include "utils/File.h"
+#include "utils/BufferedFileWriter.h"
+#include "utils/MappedFile.h"
+#include "robot_model/GCodeAnalyzer.h"
+#include "storage/TrajectoryCatalogSqlite.h"
 #include <string>
 #include <vector>
 #include <memory>
+#include <optional>
+#include <chrono>
+#include <filesystem>
 
 using namespace std;
 
+// Punto de reanudación de una ejecución interrumpida (se persiste como <archivo>.ckpt)
+struct CheckpointTrayectoria {
+    std::string archivo;            // nombre final del .gcode
+    size_t      lineaReanudacion = 0; // índice (0-based) de la primera línea NO confirmada
+    double      x = 0, y = 0, z = 0;  // última pose confirmada por el firmware
+    double      f = 50;               // último feedrate utilizado
+    bool        poseValida = false;   // false si todavía no se ejecutó ningún G1
+    bool        efectorActivo = false;
+    std::string motivo;               // descripción del error que interrumpió la ejecución
+};
+
 class TrajectoryManager {
 public:
-    // Crea el gestor indicando el directorio base donde se guardan .gcode
-    explicit TrajectoryManager(const std::string& directorioBase = "data/trayectorias/");
+    // Crea el gestor indicando el directorio base donde se guardan .gcode.
+    // dbCatalogo: base donde persistir el catálogo (nullptr = catálogo en memoria).
+    explicit TrajectoryManager(const std::string& directorioBase = "data/trayectorias/",
+                               SqliteDb* dbCatalogo = nullptr);
 
     // Gestión de archivos de trayectorias
     bool existeTrayectoria(const std::string& nombreTrayectoria) const;
@@ -19,18 +39,48 @@ public:
     std::vector<std::string> listarTrayectorias(int userId, const std::string& userRole) const;
     bool eliminarTrayectoria(const std::string& nombreTrayectoria);
 
+    // Catálogo con metadatos: listado paginado/ordenado/filtrado.
+    // El rol fuerza el owner: "op" solo ve lo propio, "admin" respeta filtro.ownerId.
+    // Si el directorio cambió desde la última sincronización, se sincroniza antes.
+    PaginaCatalogo listarTrayectoriasPaginado(int userId, const std::string& userRole,
+                                              FiltroCatalogo filtro) const;
+    // Un archivo que está en disco pero no en el catálogo dispara una sincronización
+    std::optional<EntradaCatalogo> obtenerMetadatos(const std::string& nombreTrayectoria) const;
+    // Alinea el catálogo con el directorio (altas, cambios y bajas hechas por fuera).
+    // Devuelve la cantidad de archivos (re)analizados. Es const porque el
+    // catálogo solo indexa el directorio.
+    size_t sincronizarCatalogo() const;
+
     // Flujo de grabación
     bool iniciarGrabacion(const std::string& nombreTrayectoria);
     bool guardarComando(const std::string& comandoGCode);
     bool finalizarGrabacion();
 
+    // Parámetros del volcado en segundo plano de la grabación (aplican a la próxima grabación)
+    void configurarGrabacion(size_t umbralBytes, std::chrono::milliseconds intervalo);
+
     // Carga completa (línea por línea) de una trayectoria
     std::vector<std::string> cargarTrayectoria(const std::string& nombreTrayectoria) const;
+    // Abre la trayectoria mapeada en memoria para recorrerla sin copias.
+    // Lanza std::runtime_error si no existe.
+    std::unique_ptr<MappedFile> abrirTrayectoria(const std::string& nombreTrayectoria) const;
+
+    // Checkpoints de ejecución (para reanudar desde la línea que falló)
+    bool guardarCheckpoint(const CheckpointTrayectoria& checkpoint) const;
+    std::optional<CheckpointTrayectoria> cargarCheckpoint(const std::string& nombreTrayectoria) const;
+    bool eliminarCheckpoint(const std::string& nombreTrayectoria) const;
 
     // Guarda un archivo de trayectoria completo (para subidas)
     // Devuelve el nombre de archivo final (con ID y timestamp) o "" si falla.
     std::string guardarTrayectoriaCompleta(const std::string& nombreArchivo, const std::string& contenido);
 
+    // Copia derivada de un archivo (p. ej. sufijo "reord"): nombre fijo por
+    // original, con su mismo dueño y timestamp, así cada corrida la reutiliza
+    std::string nombreCopiaDerivada(const std::string& archivoOrigen, const std::string& sufijo) const;
+    // Guarda (o sobrescribe) la copia derivada. Devuelve su nombre o "" si falla.
+    std::string guardarCopiaDerivada(const std::string& archivoOrigen, const std::string& sufijo,
+                                     const std::string& contenido);
+
     // Info de estado
     std::string getDirectorioBase() const { return directorioBase; }
     bool        estaGrabando() const { return grabando; }
@@ -40,11 +90,24 @@ private:
     std::string directorioBase;
     bool grabando;
     std::string trayectoriaActual;             // nombre de archivo (no ruta)
-    std::unique_ptr<File> archivoActual;
+    std::unique_ptr<BufferedFileWriter> archivoActual;
+    size_t umbralVolcado = 64 * 1024;
+    std::chrono::milliseconds intervaloVolcado{200};
+    GCodeAnalyzer analizadorGrabacion;         // metadatos calculados mientras se graba
+
+    std::unique_ptr<SqliteDb> dbCatalogoPropio; // ":memory:" cuando no se provee una base
+    std::unique_ptr<TrajectoryCatalogSqlite> catalogo;
+    // mtime del directorio en la última sincronización (altas/bajas lo cambian)
+    mutable std::filesystem::file_time_type mtimeDirectorioSincronizado{};
 
     // Helpers
     void        crearDirectorioSiNoExiste() const;
     std::string normalizarNombreArchivo(const std::string& nombreTrayectoria) const;
+    std::string rutaCheckpoint(const std::string& nombreTrayectoria) const;
+    bool        registrarEnCatalogo(const std::string& archivo, const MetadatosGCode& meta) const;
+    void        sincronizarSiCambioDirectorio() const;
+    static bool parsearNombreConvencion(const std::string& archivo, int& ownerId,
+                                        std::string& nombreLogico, int64_t& creadoEn);
 
     // Helpers para convención de nombres
     static std::string slugify(const std::string& s);
@@ -0,0 +1,120 @@
+#ifndef COMMANDHISTORYSQLITE_H
+#define COMMANDHISTORYSQLITE_H
+
+#include "db/SqliteDb.h"
+#include "core/CommandHistory.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Conteos agrupados del historial guardado (carga inicial de HistoryStats)
+ */
+struct AgregadosHistorial {
+    struct Fila {
+        std::string nombre;     // Usuario o servicio
+        int64_t inicio = 0;     // Inicio del minuto/hora
+        uint64_t comandos = 0;
+        uint64_t errores = 0;
+    };
+    std::vector<Fila> porUsuario;
+    std::vector<Fila> porServicio;
+    std::vector<Fila> porMinuto;
+    std::vector<Fila> porHora;
+};
+
+/**
+ * @brief Historial de comandos persistente (tabla command_history).
+ *
+ * Las inserciones se acumulan en memoria y un hilo las confirma por lotes
+ * (una transacción por lote, con la sentencia preparada reutilizada). Usa
+ * conexiones propias a la base: el hilo escritor no compite con las
+ * consultas ni con la capa de autenticación más allá del lock de WAL.
+ */
+class CommandHistorySqlite {
+public:
+    /**
+     * @param rutaDb Base de datos (ej. data/db/poo.db); crea la tabla si no existe
+     * @param tamLote Filas por transacción como máximo
+     * @param intervalo Espera máxima antes de confirmar un lote incompleto
+     * @throws std::runtime_error si no se puede abrir la base
+     */
+    explicit CommandHistorySqlite(const std::string& rutaDb,
+                                  size_t tamLote = 512,
+                                  std::chrono::milliseconds intervalo = std::chrono::milliseconds(200));
+
+    // Confirma lo pendiente y detiene el hilo
+    ~CommandHistorySqlite();
+
+    CommandHistorySqlite(const CommandHistorySqlite&) = delete;
+    CommandHistorySqlite& operator=(const CommandHistorySqlite&) = delete;
+
+    // Encola una entrada (no bloquea por la base)
+    void encolar(CommandEntry entrada);
+
+    // Espera a que todo lo encolado hasta ahora esté confirmado
+    void vaciar();
+
+    // Id más alto confirmado en la tabla (0 si está vacía)
+    uint64_t ultimoConfirmado() const { return ultimoConfirmado_.load(); }
+
+    /**
+     * @brief Entradas confirmadas que cumplen el filtro con id en (desdeId, hastaId],
+     * en orden de id. Los índices de una columna incluyen el rowid, así que
+     * "columna = ? AND id > ? ORDER BY id LIMIT n" recorre el índice en orden
+     * sin ordenar ni leer de más.
+     * @param limite Filas como máximo (SIZE_MAX = sin límite)
+     */
+    std::vector<CommandEntry> consultar(const HistoryFilter& filtro, uint64_t desdeId, uint64_t hastaId,
+                                        size_t limite, bool descendente);
+
+    // Cantidad y errores de las entradas confirmadas hasta hastaId que cumplen el filtro
+    HistoryTotals contar(const HistoryFilter& filtro, uint64_t hastaId);
+
+    void borrarUsuario(const std::string& usuario);
+
+    /**
+     * @brief Conteos por usuario y servicio de toda la tabla, y por minuto y
+     * hora desde @p desdeMinuto / @p desdeHora. Recorre la tabla: solo al arrancar.
+     */
+    AgregadosHistorial agregados(int64_t desdeMinuto, int64_t desdeHora);
+
+    // Lotes confirmados desde el arranque (diagnóstico y benchmark)
+    uint64_t getLotesConfirmados() const { return lotes_.load(); }
+
+private:
+    void bucleEscritor();
+    void escribirLote(std::vector<CommandEntry>& lote);
+    static std::string armarWhere(const HistoryFilter& filtro);
+    static void enlazarFiltro(sqlite3_stmt* st, const HistoryFilter& filtro);
+
+    SqliteDb escritura_;                // Solo el hilo escritor
+    SqliteDb lectura_;
+    std::mutex mutexLectura_;
+    sqlite3_stmt* insert_ = nullptr;
+
+    size_t tamLote_;
+    std::chrono::milliseconds intervalo_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::condition_variable cvConfirmado_;
+    std::deque<CommandEntry> pendientes_;
+    uint64_t encolados_ = 0;
+    uint64_t procesados_ = 0;           // Confirmados o descartados por error
+    uint64_t objetivoVaciado_ = 0;      // vaciar() pide confirmar hasta aquí
+    bool detener_ = false;
+
+    std::atomic<uint64_t> ultimoConfirmado_{0};
+    std::atomic<uint64_t> lotes_{0};
+    std::thread hilo_;
+};
+
+#endif // COMMANDHISTORYSQLITE_H
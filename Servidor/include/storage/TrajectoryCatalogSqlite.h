@@ -0,0 +1,69 @@
+#ifndef TRAJECTORYCATALOGSQLITE_H
+#define TRAJECTORYCATALOGSQLITE_H
+
+#include "db/SqliteDb.h"
+#include "robot_model/GCodeAnalyzer.h"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Fila del catálogo: un archivo .gcode con sus metadatos
+struct EntradaCatalogo {
+    std::string archivo;        // <uid>__<slug>__YYYYMMDD_HHMMSS.gcode
+    int         ownerId = -1;
+    std::string nombreLogico;   // el slug
+    int64_t     creadoEn = 0;   // epoch (s)
+    int64_t     mtime = 0;      // para detectar cambios al sincronizar
+    MetadatosGCode meta;
+};
+
+// Criterios de listado
+struct FiltroCatalogo {
+    int         ownerId = -1;              // -1 = todos
+    std::string texto;                     // subcadena del nombre de archivo
+    std::string ordenarPor = "creado";     // nombre|creado|tamano|lineas|duracion
+    bool        descendente = true;
+    size_t      offset = 0;
+    size_t      limite = 0;                // 0 = sin límite
+    bool        conTotal = true;           // false = no contar (PaginaCatalogo::total queda en 0)
+};
+
+struct PaginaCatalogo {
+    std::vector<EntradaCatalogo> items;
+    size_t total = 0;                      // total que cumple el filtro (sin paginar), si se pidió
+};
+
+/**
+ * @brief Catálogo persistente de trayectorias (tabla trajectories).
+ *
+ * Los metadatos se calculan una vez al grabar o subir el archivo, y el
+ * listado es una única consulta indexada por owner_id.
+ */
+class TrajectoryCatalogSqlite {
+public:
+    // Crea la tabla y los índices si no existen
+    explicit TrajectoryCatalogSqlite(SqliteDb& db);
+
+    void upsert(const EntradaCatalogo& entrada);
+    void eliminar(const std::string& archivo);
+    std::optional<EntradaCatalogo> obtener(const std::string& archivo);
+    PaginaCatalogo listar(const FiltroCatalogo& filtro);
+
+    // (archivo, mtime) de todas las filas, para sincronizar con el directorio
+    std::vector<std::pair<std::string, int64_t>> listarArchivos();
+
+    // Agrupa varias escrituras en una transacción
+    void begin();
+    void commit();
+    void rollback();
+
+private:
+    SqliteDb& db_;
+    static EntradaCatalogo row(sqlite3_stmt*);
+    static const char* columnaOrden(const std::string& ordenarPor);
+};
+
+#endif // TRAJECTORYCATALOGSQLITE_H
@@ -0,0 +1,192 @@
+#ifndef ASYNC_LOG_WRITER_H
+#define ASYNC_LOG_WRITER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/uio.h>
+
+#include "utils/LogRotation.h"
+
+/**
+ * @brief Registro pendiente de escritura.
+ *
+ * El productor solo guarda el instante y el texto; el hilo escritor arma
+ * el timestamp y el prefijo (formato diferido).
+ */
+struct LogRecord {
+    enum class Format : uint8_t {
+        LINE,   // "[fecha hora] <tag><texto>"
+        CSV     // "fecha hora,<texto>"
+    };
+
+    uint8_t targets = 0;        // Máscara de AsyncLogWriter::Target
+    Format format = Format::LINE;
+    const char* tag = "";       // Literal estático (ej. "[INFO] ")
+    bool critical = false;      // true: nunca se descarta aunque la cola esté llena
+    std::time_t when = 0;
+    std::string text;
+};
+
+/**
+ * @brief Backend asincrónico de logging.
+ *
+ * Los productores (cualquier hilo) encolan registros en un anillo acotado
+ * MPSC sin locks; un único hilo escritor los toma por lotes y los escribe
+ * con writev() en cada destino. Ningún productor formatea fechas ni toca
+ * el disco.
+ *
+ * Con la cola llena, la política de desborde decide entre esperar (BLOCK)
+ * o descartar contando el registro (DROP). Los registros marcados como
+ * críticos (auditoría) siempre esperan.
+ *
+ * Los archivos con rotación se renombran y se reabren desde el propio hilo
+ * escritor, entre dos registros: ninguno se pierde ni queda partido entre
+ * segmentos. La compresión y la retención corren en otro hilo.
+ */
+class AsyncLogWriter {
+    public:
+        enum Target : uint8_t {
+            CONSOLE = 1 << 0,
+            DEBUG_FILE = 1 << 1,
+            AUDIT_FILE = 1 << 2
+        };
+
+        enum class FsyncPolicy {
+            NEVER,      // Solo write(): el SO decide cuándo llega al disco
+            PER_BATCH,  // fdatasync() después de cada lote
+            INTERVAL    // fdatasync() como mucho cada fsyncInterval
+        };
+
+        enum class OverflowPolicy {
+            BLOCK,      // El productor espera lugar en la cola
+            DROP        // El registro se descarta y se cuenta
+        };
+
+        /**
+         * @brief Arranca el hilo escritor.
+         * @param capacity Registros en la cola (se redondea a potencia de 2).
+         * @param fsyncPolicy Cuándo sincronizar los archivos con el disco.
+         * @param fsyncInterval Intervalo para FsyncPolicy::INTERVAL.
+         * @param overflowPolicy Qué hacer con la cola llena.
+         */
+        explicit AsyncLogWriter(size_t capacity = 4096,
+                                FsyncPolicy fsyncPolicy = FsyncPolicy::INTERVAL,
+                                std::chrono::milliseconds fsyncInterval = std::chrono::milliseconds(1000),
+                                OverflowPolicy overflowPolicy = OverflowPolicy::BLOCK);
+
+        /**
+         * @brief Escribe lo pendiente, detiene el hilo y cierra los archivos.
+         */
+        ~AsyncLogWriter();
+
+        AsyncLogWriter(const AsyncLogWriter&) = delete;
+        AsyncLogWriter& operator=(const AsyncLogWriter&) = delete;
+
+        /**
+         * @brief Asigna el descriptor de un destino (toma posesión si no es consola).
+         * Debe llamarse antes de encolar registros para ese destino.
+         */
+        void setTarget(Target target, int fd);
+
+        /**
+         * @brief Activa la rotación de un destino de archivo ya asignado.
+         * @param path Ruta con la que se abrió el archivo (se renombra y se recrea).
+         * @param header Texto a escribir al comienzo de cada archivo nuevo.
+         */
+        void setRotation(Target target, const std::string& path,
+                         const RotationPolicy& policy, const std::string& header = "");
+
+        /**
+         * @brief Espera a que los segmentos rotados hasta ahora estén comprimidos.
+         */
+        void waitForCompression();
+
+        /**
+         * @brief Encola un registro.
+         * @return false si se descartó por la política DROP.
+         */
+        bool push(LogRecord&& record);
+
+        /**
+         * @brief Espera a que todo lo encolado hasta ahora esté escrito.
+         */
+        void flush();
+
+        void setFsyncPolicy(FsyncPolicy policy, std::chrono::milliseconds interval);
+        void setOverflowPolicy(OverflowPolicy policy);
+
+        /**
+         * @brief Registros descartados por la política DROP desde el arranque.
+         */
+        uint64_t droppedCount() const;
+
+    private:
+        struct Cell {
+            std::atomic<size_t> sequence;
+            LogRecord record;
+        };
+
+        // Estado de rotación de un destino (solo lo toca el hilo escritor)
+        struct Rotation {
+            bool enabled = false;
+            std::string path;
+            std::string header;
+            RotationPolicy policy;
+            uint64_t bytes = 0;             // Tamaño actual del archivo
+            std::time_t nextDaily = 0;      // Próxima medianoche (policy.daily)
+        };
+
+        bool tryPush(LogRecord& record);
+        bool tryPop(LogRecord& record);
+        bool hasPending() const;
+        void wakeWriter();
+
+        void writerLoop();
+        void writeBatch(std::vector<LogRecord>& batch);
+        void writeAll(int fd, std::vector<struct iovec>& iov);
+        const std::string& timestamp(std::time_t when);
+        bool needsRotation(Rotation& rotation, size_t bytes, std::time_t when);
+        void rotate(int index, std::time_t when);
+
+        // Anillo acotado (secuencia por celda, estilo Vyukov)
+        std::unique_ptr<Cell[]> cells_;
+        size_t mask_;
+        alignas(64) std::atomic<size_t> enqueuePos_{0};
+        alignas(64) size_t dequeuePos_ = 0;   // Solo el hilo escritor
+
+        // Destinos: consola, depuración, auditoría
+        int fds_[3] = {-1, -1, -1};
+        Rotation rotation_[3];
+        std::unique_ptr<LogCompressor> compressor_;
+
+        std::atomic<FsyncPolicy> fsyncPolicy_;
+        std::atomic<int64_t> fsyncIntervalMs_;
+        std::atomic<OverflowPolicy> overflowPolicy_;
+        std::atomic<uint64_t> dropped_{0};
+
+        // Sincronización solo para dormir/despertar (no en el camino rápido)
+        std::mutex mutex_;
+        std::condition_variable writerCv_;      // Hay registros nuevos
+        std::condition_variable spaceCv_;       // Se liberó lugar / se escribió un lote
+        std::atomic<bool> writerSleeping_{false};
+        std::atomic<int> waitingProducers_{0};
+        std::atomic<uint64_t> written_{0};      // Registros procesados por el escritor
+        bool stop_ = false;
+
+        // Cache del timestamp (se repite dentro del mismo segundo)
+        std::time_t cachedWhen_ = -1;
+        std::string cachedTimestamp_;
+
+        std::thread writer_;
+};
+
+#endif // ASYNC_LOG_WRITER_H
@@ -1,10 +1,17 @@
 #ifndef AUDITLOGREADER_H
 #define AUDITLOGREADER_H
 
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 #include <fstream>
 #include <sstream>
+#include <sys/types.h>
 #include "utils/PALogger.h" // Lo usamos para el path
 
 /**
@@ -22,17 +29,70 @@ struct AuditEntry {
 /**
  * @brief Clase Helper para leer y filtrar el archivo audit.csv
  * Esta clase se encarga de todo el I/O y parsing del CSV.
+ * Si el log rota, lee también los segmentos (audit.csv.<fecha>[.gz]),
+ * del más viejo al archivo activo.
+ *
+ * Mantiene un índice en memoria de cada archivo (posición de cada línea,
+ * fecha ya convertida a epoch y las filas de cada usuario). Cada reporte
+ * indexa solo los bytes agregados desde el anterior y después lee, por
+ * posición, las filas que pasan los filtros. Un segmento se indexa una sola
+ * vez; si el activo rota, su índice pasa al segmento y si se trunca se
+ * vuelve a indexar desde el principio.
  */
 class AuditLogReader {
 private:
+    // Una línea del CSV: dónde está y lo necesario para filtrar sin releerla
+    struct Row {
+        uint64_t offset;
+        uint32_t length;            // Sin el '\n'
+        uint32_t user;              // Id en userIds_
+        int64_t epoch;              // -1 si la fecha no se pudo leer
+    };
+
+    // Índice de un archivo (el activo o un segmento rotado)
+    struct FileIndex {
+        std::vector<Row> rows;
+        std::unordered_map<uint32_t, std::vector<uint32_t>> byUser;    // Usuario -> filas
+        uint64_t indexedBytes = 0;  // Hasta el final de la última línea completa
+        bool headerSeen = false;
+        std::string lastLine;       // Para reconocer el archivo después de una rotación
+        dev_t dev = 0;              // Identidad del activo (para detectar la rotación)
+        ino_t ino = 0;
+    };
+
+    class ByteSource;
+
     std::string auditFilePath_; // Ruta al archivo audit.csv
     PALogger& logger_;          // Para loguear errores si el archivo no existe
 
+    std::mutex mtx_;                                // Un reporte a la vez sobre el índice
+    std::map<std::string, FileIndex> segments_;     // Por nombre del segmento, sin ".gz"
+    FileIndex active_;
+    bool hasActiveIndex_ = false;
+    std::unordered_map<std::string, uint32_t> userIds_;
+    std::string cachedHour_;                        // "YYYY-MM-DD HH" de la última conversión
+    int64_t cachedHourEpoch_ = -1;
+
     /**
      * @brief Helper interno para parsear una sola línea de CSV.
      * Maneja comillas y comas.
      */
-    AuditEntry parseCsvLine(const std::string& line) const;
+    AuditEntry parseCsvLine(std::string_view line) const;
+
+    /**
+     * @brief Indexa desde index.indexedBytes hasta el final de @p source.
+     * @param complete true si el archivo ya no crece (segmento): la última
+     *        línea cuenta aunque no termine en '\n'.
+     */
+    void indexFrom(ByteSource& source, FileIndex& index, bool complete);
+    void addRow(FileIndex& index, uint64_t offset, std::string_view line);
+    int64_t parseTimestamp(std::string_view timestamp);
+
+    /**
+     * @brief El activo indexado rotó: su índice pasa al segmento en que se
+     * convirtió (si se lo identifica) y se completa hasta el final.
+     */
+    void adoptRotated(const std::vector<std::string>& segments);
 
 public:
     /**
@@ -43,14 +103,25 @@ public:
     AuditLogReader(const std::string& auditFilename, PALogger& logger)
         : auditFilePath_(auditFilename), logger_(logger) {}
 
+    AuditLogReader(const AuditLogReader&) = delete;
+    AuditLogReader& operator=(const AuditLogReader&) = delete;
+
     /**
      * @brief Obtiene las entradas del log, aplicando filtros.
      * @param filter_user Filtra por este usuario (si no está vacío).
      * @param filter_response_contains Filtra si la respuesta contiene este texto (si no está vacío).
+     * @param from_epoch / to_epoch Rango de fechas, inclusive (opcionales).
      * @return Un vector de entradas de auditoría que coinciden.
      */
     std::vector<AuditEntry> getEntries(const std::string& filter_user,
-                                     const std::string& filter_response_contains) const;
+                                       const std::string& filter_response_contains,
+                                       std::optional<int64_t> from_epoch = std::nullopt,
+                                       std::optional<int64_t> to_epoch = std::nullopt);
+
+    /**
+     * @brief Filas indexadas en memoria (segmentos y activo).
+     */
+    size_t indexedRows();
 };
 
-#endif // AUDITLOGREADER_H
\ No newline at end of file
+#endif // AUDITLOGREADER_H
@@ -0,0 +1,252 @@
+#ifndef BINARY_LOG_H
+#define BINARY_LOG_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Formato binario de log (segmentos "<base>.000001", "<base>.000002", ...).
+ *
+ * Cada segmento es un archivo preasignado y mapeado en memoria:
+ *
+ *   BinaryLogFileHeader (64 bytes)
+ *   registro, registro, ...      (alineados a 8 bytes; size == 0 marca el final)
+ *
+ * Registro: BinaryLogRecordHeader (24 bytes) + fieldCount campos
+ * "tipo (u8) | largo (u32) | datos". Los registros FORMAT asocian un
+ * eventId con su texto ("Respuesta '{}': {}"); los EVENT llevan solo los
+ * argumentos, y el texto se arma al decodificar (tools/decodificar_log).
+ * Cada segmento repite al comienzo los FORMAT conocidos, así se puede
+ * decodificar solo.
+ *
+ * Todos los enteros en el orden de bytes de la máquina que escribe.
+ */
+
+struct BinaryLogFileHeader {
+    char magic[8];                  // "PABLOG1\0"
+    uint32_t version;
+    uint32_t headerSize;            // Offset del primer registro
+    uint64_t capacity;              // Tamaño preasignado del segmento
+    int64_t realtimeOffsetNs;       // CLOCK_REALTIME - CLOCK_MONOTONIC al crearlo
+    uint64_t sequence;              // Número de segmento
+    uint8_t reserved[24];
+};
+static_assert(sizeof(BinaryLogFileHeader) == 64, "cabecera de 64 bytes");
+
+struct BinaryLogRecordHeader {
+    uint32_t size;                  // Bytes del registro con relleno; se escribe último
+    uint8_t kind;                   // BinaryLogSink::Kind
+    uint8_t level;                  // LogLevel
+    uint16_t fieldCount;
+    uint32_t eventId;
+    uint32_t threadId;
+    uint64_t monotonicNs;           // CLOCK_MONOTONIC
+};
+static_assert(sizeof(BinaryLogRecordHeader) == 24, "cabecera de registro de 24 bytes");
+
+/**
+ * @brief Valor de un campo listo para copiar (sin formatear).
+ */
+struct BinaryLogField {
+    enum Type : uint8_t {
+        I64 = 1,
+        U64 = 2,
+        F64 = 3,
+        BOOL = 4,
+        STR = 5
+    };
+
+    Type type = STR;
+    union {
+        int64_t i;
+        uint64_t u;
+        double f;
+    } value{};
+    const char* data = nullptr;     // STR
+    uint32_t length = 0;            // STR
+};
+
+/**
+ * @brief Destino binario: agregar un registro es reservar con un
+ * fetch_add y copiar la cabecera y los campos al mapeo.
+ *
+ * Seguro para varios hilos. El texto de formato se registra una sola vez
+ * por segmento; los argumentos se guardan con su tipo, sin convertir a
+ * texto (salvo tipos sin representación binaria, que usan operator<<).
+ */
+class BinaryLogSink {
+    public:
+        enum Kind : uint8_t {
+            EVENT = 1,
+            FORMAT = 2
+        };
+
+        // eventId de los mensajes ya armados (un único campo STR)
+        static constexpr uint32_t TEXT_EVENT = 0;
+        static constexpr size_t DEFAULT_SEGMENT_BYTES = 16 * 1024 * 1024;
+
+        /**
+         * @brief Crea el siguiente segmento de @p basePath (continúa la numeración).
+         * @throws std::runtime_error si no se puede crear o mapear.
+         */
+        explicit BinaryLogSink(const std::string& basePath,
+                               size_t segmentBytes = DEFAULT_SEGMENT_BYTES);
+
+        /**
+         * @brief Recorta el segmento activo a lo usado y lo cierra.
+         */
+        ~BinaryLogSink();
+
+        BinaryLogSink(const BinaryLogSink&) = delete;
+        BinaryLogSink& operator=(const BinaryLogSink&) = delete;
+
+        /**
+         * @brief Registra un evento con formato diferido.
+         * @param fmt Literal de formato: se identifica por su dirección.
+         */
+        template <typename... Args>
+        void write(uint8_t level, const char* fmt, const Args&... args) {
+            BinaryLogField fields[sizeof...(Args) + 1];
+            std::string owned[sizeof...(Args) + 1];     // Solo para tipos con operator<<
+            size_t i = 0;
+            ((toField(fields[i], owned[i], args), ++i), ...);
+            append(EVENT, level, eventId(fmt), fields, sizeof...(Args));
+        }
+
+        /**
+         * @brief Registra un mensaje ya armado.
+         */
+        void writeText(uint8_t level, std::string_view message);
+
+        /**
+         * @brief Sincroniza el segmento activo con el disco (msync).
+         */
+        void sync();
+
+        /**
+         * @brief Registros descartados (no entran en un segmento o no se pudo crear el siguiente).
+         */
+        uint64_t droppedCount() const { return dropped_.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Segmentos de @p basePath existentes, en orden.
+         */
+        static std::vector<std::string> segments(const std::string& basePath);
+
+    private:
+        struct Segment {
+            int fd = -1;
+            char* base = nullptr;
+            size_t capacity = 0;
+            uint64_t sequence = 0;
+            std::atomic<size_t> offset{0};
+            std::atomic<int> writers{0};
+        };
+
+        template <typename T>
+        static void toField(BinaryLogField& field, std::string& owned, const T& value) {
+            if constexpr (std::is_same_v<T, bool>) {
+                field.type = BinaryLogField::BOOL;
+                field.value.u = value ? 1 : 0;
+            } else if constexpr (std::is_same_v<T, char>) {
+                owned.assign(1, value);
+                field.type = BinaryLogField::STR;
+                field.data = owned.data();
+                field.length = 1;
+            } else if constexpr (std::is_enum_v<T>) {
+                field.type = BinaryLogField::I64;
+                field.value.i = static_cast<int64_t>(value);
+            } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+                field.type = BinaryLogField::I64;
+                field.value.i = value;
+            } else if constexpr (std::is_integral_v<T>) {
+                field.type = BinaryLogField::U64;
+                field.value.u = value;
+            } else if constexpr (std::is_floating_point_v<T>) {
+                field.type = BinaryLogField::F64;
+                field.value.f = value;
+            } else if constexpr (std::is_pointer_v<T> && std::is_convertible_v<T, const char*>) {
+                setText(field, value ? std::string_view(value) : std::string_view("(null)"));
+            } else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+                setText(field, std::string_view(value));
+            } else {
+                std::ostringstream ss;
+                ss << value;
+                owned = ss.str();
+                setText(field, owned);
+            }
+        }
+
+        static void setText(BinaryLogField& field, std::string_view text);
+
+        uint32_t eventId(const char* fmt);
+        uint32_t registerFormat(const char* fmt);
+        void append(uint8_t kind, uint8_t level, uint32_t eventId,
+                    const BinaryLogField* fields, size_t count, bool locked = false);
+        static size_t recordSize(const BinaryLogField* fields, size_t count);
+        static void encode(char* out, size_t size, uint8_t kind, uint8_t level, uint32_t eventId,
+                           const BinaryLogField* fields, size_t count);
+
+        Segment* acquire();
+        void release(Segment* segment);
+        bool tryAppend(Segment* segment, size_t size, uint8_t kind, uint8_t level,
+                       uint32_t eventId, const BinaryLogField* fields, size_t count);
+        void roll(Segment* full);       // Requiere mutex_
+        Segment* openSegment(uint64_t sequence);
+        void closeSegment(Segment* segment);
+
+        std::string basePath_;
+        size_t segmentBytes_;
+        const uint64_t serial_;         // Identifica al sink en la cache por hilo
+        std::atomic<Segment*> current_{nullptr};
+        std::atomic<uint64_t> dropped_{0};
+
+        std::mutex mutex_;              // Rotación de segmento y registro de formatos
+        // Los Segment cerrados se conservan (sin mapeo): un hilo puede tener
+        // todavía el puntero viejo hasta notar el cambio en acquire()
+        std::vector<std::unique_ptr<Segment>> segments_;
+        std::vector<std::string> formats_;  // formats_[id - 1]
+        std::unordered_map<const char*, uint32_t> formatIds_;
+};
+
+/**
+ * @brief Registro decodificado.
+ */
+struct BinaryLogEntry {
+    int64_t wallNs = 0;             // Hora (epoch) en ns
+    uint64_t monotonicNs = 0;
+    uint8_t level = 0;
+    uint32_t eventId = 0;
+    uint32_t threadId = 0;
+    std::string message;            // Formato con los argumentos ya reemplazados
+};
+
+/**
+ * @brief Lector de segmentos binarios (herramienta de decodificación y tests).
+ */
+class BinaryLogReader {
+    public:
+        /**
+         * @brief Recorre los registros EVENT de un segmento.
+         * Los formatos leídos se conservan para los segmentos siguientes.
+         * @return false si el archivo no es un segmento válido.
+         */
+        bool read(const std::string& path, const std::function<void(const BinaryLogEntry&)>& callback);
+
+        static const char* levelName(uint8_t level);
+
+    private:
+        std::map<uint32_t, std::string> formats_;
+};
+
+#endif // BINARY_LOG_H
@@ -0,0 +1,90 @@
+#ifndef BUFFERED_FILE_WRITER_H
+#define BUFFERED_FILE_WRITER_H
+
+#include <string>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <cstdint>
+
+/**
+ * @brief Escritor de archivos con buffer en memoria y volcado en segundo plano.
+ *
+ * append() solo copia los datos a un buffer en memoria (sin syscalls).
+ * Un hilo escritor vuelca el buffer al disco cuando supera un umbral de
+ * tamaño o cuando pasa el intervalo de flush, lo que ocurra primero.
+ * Ante una caída del proceso se pierde como máximo un intervalo de datos.
+ */
+class BufferedFileWriter {
+    public:
+        /**
+         * @brief Abre (o crea) el archivo y arranca el hilo escritor.
+         * @param filePath Ruta completa del archivo.
+         * @param truncate true para truncar el archivo, false para agregar al final.
+         * @param flushThreshold Bytes acumulados que disparan un volcado inmediato.
+         * @param flushInterval Tiempo máximo que un dato queda solo en memoria.
+         * @throws std::runtime_error si el archivo no puede abrirse.
+         */
+        BufferedFileWriter(const std::string& filePath,
+                           bool truncate = true,
+                           size_t flushThreshold = 64 * 1024,
+                           std::chrono::milliseconds flushInterval = std::chrono::milliseconds(200));
+
+        /**
+         * @brief Vuelca lo pendiente y cierra el archivo.
+         */
+        ~BufferedFileWriter();
+
+        // No copiable
+        BufferedFileWriter(const BufferedFileWriter&) = delete;
+        BufferedFileWriter& operator=(const BufferedFileWriter&) = delete;
+
+        /**
+         * @brief Agrega datos al buffer en memoria.
+         * @throws std::runtime_error si el archivo está cerrado o falló un volcado previo.
+         */
+        void append(const std::string& data);
+
+        /**
+         * @brief Agrega una línea (data + '\n') al buffer en memoria.
+         */
+        void appendLine(const std::string& line);
+
+        /**
+         * @brief Vuelca todo lo pendiente y lo sincroniza con el disco (fdatasync).
+         * @throws std::runtime_error si falla la escritura.
+         */
+        void sync();
+
+        /**
+         * @brief Sincroniza, detiene el hilo escritor y cierra el archivo.
+         */
+        void close();
+
+        bool isOpen() const;
+        std::string getFilePath() const;
+
+    private:
+        void writerLoop();
+        bool writeAll(const std::string& data);
+
+        std::string filePath_;
+        int fd_;
+        size_t flushThreshold_;
+        std::chrono::milliseconds flushInterval_;
+
+        mutable std::mutex mtx_;
+        std::condition_variable cvWriter_;   // despierta al hilo escritor
+        std::condition_variable cvFlushed_;  // avisa a sync() que se volcó
+        std::string pending_;                // datos aún no entregados al kernel
+        uint64_t bytesAccepted_ = 0;         // total agregado con append()
+        uint64_t bytesWritten_ = 0;          // total entregado con write()
+        bool flushRequested_ = false;
+        bool stopping_ = false;
+        bool failed_ = false;
+
+        std::thread writer_;
+};
+
+#endif // BUFFERED_FILE_WRITER_H
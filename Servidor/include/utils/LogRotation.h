@@ -0,0 +1,104 @@
+#ifndef LOG_ROTATION_H
+#define LOG_ROTATION_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <ctime>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Cuándo rotar un archivo de log y cuántos segmentos conservar.
+ */
+struct RotationPolicy {
+    uint64_t maxBytes = 0;          // Rotar al superar este tamaño (0 = sin límite)
+    bool daily = false;             // Rotar al cambiar el día (hora local)
+    bool compress = true;           // Comprimir los segmentos con gzip
+    size_t maxSegments = 0;         // Segmentos a conservar (0 = todos)
+    uint64_t maxTotalBytes = 0;     // Tamaño total de los segmentos (0 = sin límite)
+
+    bool enabled() const { return maxBytes > 0 || daily; }
+};
+
+/**
+ * @brief Nombres de los segmentos rotados de un archivo de log.
+ *
+ * "audit.csv" rota a "audit.csv.20261019-143000" (instante de la rotación,
+ * con "-1", "-2"... si coincide el segundo) y, ya comprimido, a
+ * "audit.csv.20261019-143000.gz". El orden de los nombres es el cronológico.
+ */
+class LogSegments {
+    public:
+        /**
+         * @brief Nombre libre para el segmento que se cierra en @p when.
+         */
+        static std::string nextName(const std::string& activePath, std::time_t when);
+
+        /**
+         * @brief Segmentos existentes, del más viejo al más nuevo (sin el activo).
+         * Si un segmento está en ambas formas se devuelve el .gz (el otro es un
+         * resto de una compresión interrumpida).
+         */
+        static std::vector<std::string> list(const std::string& activePath);
+
+        static bool isCompressed(const std::string& segment);
+};
+
+/**
+ * @brief Comprime en segundo plano los segmentos rotados y aplica la
+ * retención.
+ *
+ * La compresión escribe "<segmento>.gz.tmp" y lo renombra a ".gz" antes de
+ * borrar el original, así un lector nunca ve un .gz a medias. Lo que quede
+ * pendiente al cerrar se retoma con recover() en el próximo arranque.
+ */
+class LogCompressor {
+    public:
+        LogCompressor();
+        ~LogCompressor();
+
+        LogCompressor(const LogCompressor&) = delete;
+        LogCompressor& operator=(const LogCompressor&) = delete;
+
+        /**
+         * @brief Registra un archivo activo: encola los segmentos sin comprimir
+         * que hayan quedado y aplica la retención.
+         */
+        void recover(const std::string& activePath, const RotationPolicy& policy);
+
+        /**
+         * @brief Encola un segmento recién rotado de @p activePath.
+         */
+        void enqueue(const std::string& activePath, const std::string& segment);
+
+        /**
+         * @brief Espera a que no quede nada en la cola.
+         */
+        void waitIdle();
+
+    private:
+        struct Job {
+            std::string activePath;
+            std::string segment;     // Vacío: solo aplicar retención
+        };
+
+        void workerLoop();
+        void process(const Job& job, const RotationPolicy& policy);
+        void applyRetention(const std::string& activePath, const RotationPolicy& policy);
+        static bool compressFile(const std::string& segment);
+
+        std::mutex mutex_;
+        std::condition_variable cv_;
+        std::condition_variable idleCv_;
+        std::deque<Job> jobs_;
+        std::map<std::string, RotationPolicy> policies_;
+        bool busy_ = false;
+        bool stop_ = false;
+        std::thread worker_;
+};
+
+#endif // LOG_ROTATION_H
@@ -0,0 +1,77 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+/**
+ * @brief Lectura de archivos mapeados en memoria (mmap) línea por línea.
+ *
+ * Las líneas se entregan como std::string_view apuntando al mapeo, sin
+ * copias. Se quita el '\n' final y el '\r' de los finales CRLF.
+ *
+ * La lectura es secuencial (madvise SEQUENTIAL): cada vez que se avanza una
+ * ventana completa, las páginas ya leídas se devuelven al kernel
+ * (MADV_DONTNEED), así que la memoria residente no crece con el tamaño del
+ * archivo. Los string_view siguen siendo válidos mientras viva el objeto
+ * (si se vuelven a tocar, el kernel relee esas páginas del archivo).
+ */
+class MappedFile {
+    public:
+        static constexpr size_t VENTANA_POR_DEFECTO = 4 * 1024 * 1024;
+
+        /**
+         * @brief Mapea el archivo completo en modo lectura.
+         * @param filePath Ruta del archivo.
+         * @param ventanaBytes Bytes leídos antes de liberar las páginas ya consumidas.
+         * @throws std::runtime_error si el archivo no existe o no puede mapearse.
+         */
+        explicit MappedFile(const std::string& filePath, size_t ventanaBytes = VENTANA_POR_DEFECTO);
+        ~MappedFile();
+
+        // No copiable
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        /**
+         * @brief Devuelve la siguiente línea.
+         * @param linea Salida; vista sobre el mapeo, sin '\n' ni '\r' final.
+         * @return false al llegar al final del archivo.
+         */
+        bool siguienteLinea(std::string_view& linea);
+
+        /**
+         * @brief Saltea líneas hasta dejar el cursor en el índice indicado (0-based).
+         * @return false si el archivo tiene menos líneas.
+         */
+        bool saltarA(size_t indiceLinea);
+
+        /**
+         * @brief Vuelve al principio del archivo.
+         */
+        void reiniciar();
+
+        // Índice (0-based) de la próxima línea que devolverá siguienteLinea()
+        size_t lineaActual() const { return lineaActual_; }
+
+        size_t size() const { return size_; }
+        bool empty() const { return size_ == 0; }
+        const std::string& getFilePath() const { return filePath_; }
+
+    private:
+        void liberarLeido();
+
+        std::string filePath_;
+        int fd_;
+        const char* data_;
+        size_t size_;
+        size_t ventana_;
+        size_t pageSize_;
+
+        size_t offset_ = 0;        // próximo byte a leer
+        size_t liberadoHasta_ = 0; // bytes ya devueltos con MADV_DONTNEED
+        size_t lineaActual_ = 0;
+};
+
+#endif // MAPPED_FILE_H
@@ -7,6 +7,15 @@
 #include <sstream>
 #include <ctime>
 #include <iomanip>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "utils/AsyncLogWriter.h"
+#include "utils/BinaryLog.h"
 
 enum class LogLevel {
     DEBUG = 0,
@@ -15,12 +24,60 @@ enum class LogLevel {
     ERROR = 3
 };
 
+// Nivel mínimo en compilación (make LOG_MIN_LEVEL=1 elimina los DEBUG):
+// las llamadas por debajo no formatean nada y el compilador las descarta.
+#ifndef PALOGGER_MIN_LEVEL
+#define PALOGGER_MIN_LEVEL 0
+#endif
+
+namespace palogger_detail {
+
+    inline void appendArg(std::string& out, const std::string& value) { out += value; }
+    inline void appendArg(std::string& out, std::string_view value) { out += value; }
+    inline void appendArg(std::string& out, const char* value) { out += value ? value : "(null)"; }
+    inline void appendArg(std::string& out, char value) { out += value; }
+    inline void appendArg(std::string& out, bool value) { out += value ? "true" : "false"; }
+
+    template <typename T>
+    void appendArg(std::string& out, const T& value) {
+        if constexpr (std::is_arithmetic_v<T>) {
+            out += std::to_string(value);
+        } else if constexpr (std::is_enum_v<T>) {
+            out += std::to_string(static_cast<std::underlying_type_t<T>>(value));
+        } else {
+            std::ostringstream ss;
+            ss << value;
+            out += ss.str();
+        }
+    }
+
+    inline void format(std::string& out, const char* fmt) { out += fmt; }
+
+    // Cada "{}" se reemplaza por el siguiente argumento; si sobran, se ignoran
+    template <typename T, typename... Rest>
+    void format(std::string& out, const char* fmt, const T& first, const Rest&... rest) {
+        const char* marca = std::strstr(fmt, "{}");
+        if (marca == nullptr) {
+            out += fmt;
+            return;
+        }
+        out.append(fmt, marca - fmt);
+        appendArg(out, first);
+        format(out, marca + 2, rest...);
+    }
+}
+
 class PALogger {
     private:
         LogLevel level_;
         bool logToFile_;
-        std::ofstream logFile_;      // Para servidor.log
-        std::ofstream auditFile_;  // Para audit.csv
+        bool auditOpen_ = false;     // audit.csv abierto
+        std::string debugFilename_;
+        std::string auditFilename_;
+        // Escritura asincrónica a consola, servidor.log y audit.csv
+        AsyncLogWriter writer_;
+        // Opcional: reemplaza consola y servidor.log (la auditoría sigue en CSV)
+        std::unique_ptr<BinaryLogSink> binary_;
 
     public:
         
@@ -47,6 +104,27 @@ class PALogger {
         void warning(const std::string& message);
         void error(const std::string& message);
 
+        /**
+         * @brief Variante con formato diferido: logger_.info("Respuesta '{}': {}", cmd, msg)
+         * El mensaje solo se arma si el nivel está habilitado.
+         */
+        template <typename... Args>
+        void debug(const char* fmt, const Args&... args) { logFormat<LogLevel::DEBUG>(fmt, args...); }
+        template <typename... Args>
+        void info(const char* fmt, const Args&... args) { logFormat<LogLevel::INFO>(fmt, args...); }
+        template <typename... Args>
+        void warning(const char* fmt, const Args&... args) { logFormat<LogLevel::WARNING>(fmt, args...); }
+        template <typename... Args>
+        void error(const char* fmt, const Args&... args) { logFormat<LogLevel::ERROR>(fmt, args...); }
+
+        /**
+         * @brief Indica si un mensaje de este nivel se registraría
+         */
+        bool isEnabled(LogLevel level) const {
+            return static_cast<int>(level) >= PALOGGER_MIN_LEVEL &&
+                   static_cast<int>(level) >= static_cast<int>(level_);
+        }
+
         /**
          * @brief Metodo para registrar peticiones de auditoría (Formato 1 - CSV)
          */
@@ -55,12 +133,70 @@ class PALogger {
                         const std::string& respuesta,
                         const std::string& nodo = "N/A");
 
+        /**
+         * @brief Espera a que todo lo registrado hasta ahora esté escrito
+         * (ej. antes de leer audit.csv)
+         */
+        void flush();
+
+        /**
+         * @brief Cuándo sincronizar los archivos con el disco (por defecto, cada 1 s)
+         */
+        void setFsyncPolicy(AsyncLogWriter::FsyncPolicy policy,
+                            std::chrono::milliseconds interval = std::chrono::milliseconds(1000));
+
+        /**
+         * @brief Con la cola llena: esperar (por defecto) o descartar. La
+         * auditoría nunca se descarta.
+         */
+        void setOverflowPolicy(AsyncLogWriter::OverflowPolicy policy);
+
+        /**
+         * @brief Rota servidor.log y audit.csv por tamaño y/o por día. Los
+         * segmentos se comprimen en segundo plano (ver LogRotation.h).
+         */
+        void setRotation(const RotationPolicy& policy);
+
+        /**
+         * @brief Espera a que los segmentos rotados estén comprimidos
+         */
+        void waitForCompression();
+
+        const std::string& getAuditFilename() const { return auditFilename_; }
+
+        /**
+         * @brief Envía los mensajes de depuración a un log binario en lugar de
+         * consola y servidor.log (se lee con bin/decodificar_log). Llamar antes
+         * de empezar a registrar.
+         * @return false si no se pudo crear el segmento.
+         */
+        bool enableBinaryLog(const std::string& basePath,
+                             size_t segmentBytes = BinaryLogSink::DEFAULT_SEGMENT_BYTES);
+
+        /**
+         * @brief Mensajes de depuración descartados (cola llena o log binario sin lugar)
+         */
+        uint64_t getDroppedCount() const;
+
     private:
-        // Método interno para log de depuración
-        void log(LogLevel level, const std::string& message);
-        
-        // Helper para el timestamp del CSV
-        std::string getTimestampCsv() const; // <-- NUEVO HELPER
+        // Método interno para log de depuración (el nivel ya fue verificado)
+        void log(LogLevel level, std::string message);
+
+        template <LogLevel Level, typename... Args>
+        void logFormat(const char* fmt, const Args&... args) {
+            if constexpr (static_cast<int>(Level) >= PALOGGER_MIN_LEVEL) {
+                if (static_cast<int>(Level) < static_cast<int>(level_)) {
+                    return;
+                }
+                if (binary_) {
+                    binary_->write(static_cast<uint8_t>(Level), fmt, args...);
+                    return;
+                }
+                std::string message;
+                palogger_detail::format(message, fmt, args...);
+                log(Level, std::move(message));
+            }
+        }
 };
 
 #endif // PALOGGER_H
\ No newline at end of file
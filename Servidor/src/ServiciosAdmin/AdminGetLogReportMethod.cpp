@@ -1,4 +1,5 @@
 #include "../../include/ServiciosAdmin/AdminGetLogReportMethod.h" // Ajusta la ruta si es necesario
+#include <optional>
 #include <stdexcept> 
 
 namespace admin_service_methods {
@@ -39,12 +40,21 @@ void AdminGetLogReportMethod::execute(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRp
         if (args.hasMember("filter_response")) {
             filter_response = std::string(args["filter_response"]);
         }
+        std::optional<int64_t> from_epoch;
+        std::optional<int64_t> to_epoch;
+        if (args.hasMember("from")) {
+            from_epoch = rpc_epoch(args["from"], "from");
+        }
+        if (args.hasMember("to")) {
+            to_epoch = rpc_epoch(args["to"], "to");
+        }
         
         logger_.info(std::string("[") + METHOD_NAME + "] Solicitud de reporte CSV por: " + session.user);
 
         // 3. Llamar a la Lógica de Negocio (AuditLogReader)
         // ¡El lector hace todo el trabajo pesado de I/O y filtrado!
-        std::vector<AuditEntry> entries = logReader_.getEntries(filter_user, filter_response);
+        // (con su índice, solo lee lo nuevo del log y las filas que coinciden)
+        std::vector<AuditEntry> entries = logReader_.getEntries(filter_user, filter_response, from_epoch, to_epoch);
         
         // 4. Procesar Respuesta y Armar Resultado
         XmlRpc::XmlRpcValue logArray;
@@ -79,10 +89,11 @@ void AdminGetLogReportMethod::execute(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRp
 
 // --- Help ---
 std::string AdminGetLogReportMethod::help() {
-    return "admin.getLogReport({token:string, [filter_user:string], [filter_response:string]}) -> {ok:bool, log_entries:[...]}\n"
+    return "admin.getLogReport({token:string, [filter_user:string], [filter_response:string], [from], [to]}) -> {ok:bool, log_entries:[...]}\n"
            "Devuelve el historial del log de auditoría (audit.csv).\n"
            " - filter_user (string): Filtra por nombre de usuario exacto.\n"
-           " - filter_response (string): Filtra si la respuesta 'contiene' este texto (ej. 'ERROR' o 'OK').";
+           " - filter_response (string): Filtra si la respuesta 'contiene' este texto (ej. 'ERROR' o 'OK').\n"
+           " - from / to: epoch (int) o YYYY-MM-DDTHH:MM:SS, inclusive.";
 }
 
 } // namespace admin_service_methods
\ No newline at end of file
@@ -34,7 +34,7 @@ void RobotConnectMethod::execute(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValu
         // Usamos guardAdmin, que ya loguea y lanza excepción si no es Admin
         const SessionView& session = guardAdmin(METHOD_NAME, sessions_, token, logger_);
         user_for_history = session.user; // Guardamos el usuario real
-        logger_.info(std::string("[") + METHOD_NAME + "] Solicitud de conexión por Admin: " + session.user);
+        logger_.info("[{}] Solicitud de conexión por Admin: {}", METHOD_NAME, session.user);
 
         // 3. Llamar a la Lógica de Negocio (RobotService)
         history_.addEntry(session.user, METHOD_NAME, details, false);
@@ -46,23 +46,23 @@ void RobotConnectMethod::execute(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValu
         // 4. Procesar Respuesta y Armar Resultado
         if (!exito) {
              // Si falla la conexión, lanzamos una excepción
-             logger_.warning(std::string("[") + METHOD_NAME + "] Falló la conexión para " + session.user);
+             logger_.warning("[{}] Falló la conexión para {}", METHOD_NAME, session.user);
              throw XmlRpc::XmlRpcException("CONNECT_FAILED: No se pudo conectar al robot.");
         }
 
         result["ok"] = true;
         result["msg"] = "Robot conectado exitosamente.";
-        logger_.info(std::string("[") + METHOD_NAME + "] Éxito para " + session.user);
+        logger_.info("[{}] Éxito para {}", METHOD_NAME, session.user);
 
     } catch (const XmlRpc::XmlRpcException& e) {
         throw;
     } catch (const std::runtime_error& e) {
         history_.addEntry(user_for_history, METHOD_NAME, e.what(), true);
-        logger_.error(std::string("[") + METHOD_NAME + "] Error de runtime: " + std::string(e.what()));
+        logger_.error("[{}] Error de runtime: {}", METHOD_NAME, e.what());
         throw XmlRpc::XmlRpcException("INTERNAL_ERROR: " + std::string(e.what()));
     } catch (...) {
         history_.addEntry(user_for_history, METHOD_NAME, "Error inesperado", true);
-        logger_.error(std::string("[") + METHOD_NAME + "] Error inesperado.");
+        logger_.error("[{}] Error inesperado.", METHOD_NAME);
         throw XmlRpc::XmlRpcException("INTERNAL_ERROR: Ocurrió un error inesperado en " + std::string(METHOD_NAME));
     }
 }
@@ -33,7 +33,7 @@ void RobotDisconnectMethod::execute(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcV
         // 2. Validar Sesión y Permisos (¡SOLO ADMIN!)
         const SessionView& session = guardAdmin(METHOD_NAME, sessions_, token, logger_);
         user_for_history = session.user; // Guardamos el usuario real
-        logger_.info(std::string("[") + METHOD_NAME + "] Solicitud de desconexión por Admin: " + session.user);
+        logger_.info("[{}] Solicitud de desconexión por Admin: {}", METHOD_NAME, session.user);
 
         // 3. Llamar a la Lógica de Negocio (RobotService)
         history_.addEntry(session.user, METHOD_NAME, details, false);
@@ -44,17 +44,17 @@ void RobotDisconnectMethod::execute(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcV
         // 4. Armar Resultado
         result["ok"] = true;
         result["msg"] = "Robot desconectado.";
-        logger_.info(std::string("[") + METHOD_NAME + "] Éxito para " + session.user);
+        logger_.info("[{}] Éxito para {}", METHOD_NAME, session.user);
 
     } catch (const XmlRpc::XmlRpcException& e) {
         throw;
     } catch (const std::runtime_error& e) {
         history_.addEntry(user_for_history, METHOD_NAME, e.what(), true);
-        logger_.error(std::string("[") + METHOD_NAME + "] Error de runtime: " + std::string(e.what()));
+        logger_.error("[{}] Error de runtime: {}", METHOD_NAME, e.what());
         throw XmlRpc::XmlRpcException("INTERNAL_ERROR: " + std::string(e.what()));
     } catch (...) {
         history_.addEntry(user_for_history, METHOD_NAME, "Error inesperado", true);
-        logger_.error(std::string("[") + METHOD_NAME + "] Error inesperado.");
+        logger_.error("[{}] Error inesperado.", METHOD_NAME);
         throw XmlRpc::XmlRpcException("INTERNAL_ERROR: Ocurrió un error inesperado en " + std::string(METHOD_NAME));
     }
 }
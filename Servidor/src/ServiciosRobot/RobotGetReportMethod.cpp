@@ -1,6 +1,11 @@
 #include "../../include/ServiciosRobot/RobotGetReportMethod.h"
-#include <stdexcept> 
-#include <vector> // Necesario para el nuevo filtrado
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <ctime>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 namespace robot_service_methods {
 
@@ -14,12 +19,35 @@ RobotGetReportMethod::RobotGetReportMethod(XmlRpc::XmlRpcServer* server,
       logger_(L),
       history_(ch) {}
 
-// --- Execute (Modificado para filtros) ---
+namespace {
+
+constexpr int DEFAULT_LIMIT = 200;
+constexpr int MAX_LIMIT = 1000;
+
+// El cursor viaja como string: los ids pueden superar el int de XML-RPC
+uint64_t parseCursor(XmlRpc::XmlRpcValue& v) {
+    if (v.getType() == XmlRpc::XmlRpcValue::TypeInt && (int)v >= 0) {
+        return static_cast<uint64_t>((int)v);
+    }
+    if (v.getType() == XmlRpc::XmlRpcValue::TypeString) {
+        const std::string text = std::string(v);
+        if (text.empty()) return 0;
+        char* end = nullptr;
+        errno = 0;
+        unsigned long long id = std::strtoull(text.c_str(), &end, 10);
+        if (errno == 0 && *end == '\0' && text[0] != '-') return id;
+    }
+    throw XmlRpc::XmlRpcException("BAD_REQUEST: 'cursor' inválido");
+}
+
+} // namespace
+
+// --- Execute (filtros, paginado por cursor) ---
 void RobotGetReportMethod::execute(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result) {
     const char* const METHOD_NAME = "robot.getReport";
     
     try {
-        // 1. Validar Parámetros (token + filtros opcionales)
+        // 1. Validar Parámetros (token + filtros y paginado opcionales)
         XmlRpc::XmlRpcValue args = rpc_norm(params);
         if (!args.hasMember("token")) {
             throw XmlRpc::XmlRpcException("BAD_REQUEST: Falta parámetro 'token'");
@@ -29,85 +57,71 @@ void RobotGetReportMethod::execute(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcVa
         // 2. Validar Sesión
         const SessionView& session = guardSession(METHOD_NAME, sessions_, token, logger_);
         
-        // --- LÓGICA DE FILTROS (Solo para Admin) ---
-        std::string filter_user = "";
-        bool filter_error_only = false;
-        bool filter_success_only = false;
-
+        // --- LÓGICA DE FILTROS ---
+        // El operador solo ve lo suyo; el filtro se resuelve en el historial
+        // (en SQL cuando es persistente) en vez de filtrar la copia completa
+        HistoryFilter filter;
         if (session.privilegio == "admin") {
             // Criterio 1: Filtrar por usuario
             if (args.hasMember("filter_user")) {
-                filter_user = std::string(args["filter_user"]);
+                filter.username = std::string(args["filter_user"]);
             }
             // Criterio 2: Filtrar por error (true=solo errores, false=solo éxito)
-            if (args.hasMember("filter_error")) {
-                if (args["filter_error"].getType() == XmlRpc::XmlRpcValue::TypeBoolean) {
-                     if ((bool)args["filter_error"] == true) {
-                         filter_error_only = true;
-                     } else {
-                         filter_success_only = true;
-                     }
-                }
+            if (args.hasMember("filter_error") &&
+                args["filter_error"].getType() == XmlRpc::XmlRpcValue::TypeBoolean) {
+                filter.was_error = (bool)args["filter_error"];
             }
+        } else {
+            filter.username = session.user;
+        }
+        // Criterios 3 y 4: servicio y rango de fechas (para todos)
+        if (args.hasMember("filter_service")) {
+            filter.service_name = std::string(args["filter_service"]);
+        }
+        if (args.hasMember("from")) {
+            filter.from_epoch = rpc_epoch(args["from"], "from");
+        }
+        if (args.hasMember("to")) {
+            filter.to_epoch = rpc_epoch(args["to"], "to");
         }
         // --- FIN LÓGICA DE FILTROS ---
 
-
-        // 3. Llamar a la Lógica de Negocio (Obtener datos base)
-        std::vector<CommandEntry> entries;
-        std::string log_msg = "[";
-        log_msg += METHOD_NAME;
-        log_msg += "] Solicitud de reporte por: " + session.user;
-
-        if (session.privilegio == "admin") {
-            log_msg += " (Admin)";
-            entries = history_.getAllEntries(); // Admin obtiene todo
-        } else {
-            log_msg += " (Operador)";
-            entries = history_.getEntriesForUser(session.user); // Op obtiene solo lo suyo
+        // --- PAGINADO ---
+        int limit = DEFAULT_LIMIT;
+        if (args.hasMember("limit")) {
+            if (args["limit"].getType() != XmlRpc::XmlRpcValue::TypeInt || (int)args["limit"] <= 0) {
+                throw XmlRpc::XmlRpcException("BAD_REQUEST: 'limit' debe ser un entero positivo");
+            }
+            limit = std::min((int)args["limit"], MAX_LIMIT);
         }
-        logger_.info(log_msg);
-
-        // 3.5 Aplicar filtros (si es necesario)
-        std::vector<CommandEntry> filtered_entries;
-
-        if (filter_user.empty() && !filter_error_only && !filter_success_only) {
-            filtered_entries = entries; // Sin filtros, usar la lista completa
-        } else {
-            // Aplicar filtros
-            for (const auto& entry : entries) {
-                bool pass_user_filter = true;
-                bool pass_error_filter = true;
-
-                // Criterio 1: Usuario
-                if (!filter_user.empty()) {
-                    pass_user_filter = (entry.username == filter_user);
-                }
-
-                // Criterio 2: Error
-                if (filter_error_only) {
-                    pass_error_filter = entry.was_error;
-                } else if (filter_success_only) {
-                    pass_error_filter = !entry.was_error;
-                }
-
-                if (pass_user_filter && pass_error_filter) {
-                    filtered_entries.push_back(entry);
-                }
+        uint64_t cursor = args.hasMember("cursor") ? parseCursor(args["cursor"]) : 0;
+        bool newestFirst = false;
+        if (args.hasMember("order")) {
+            const std::string order = std::string(args["order"]);
+            if (order != "asc" && order != "desc") {
+                throw XmlRpc::XmlRpcException("BAD_REQUEST: 'order' debe ser 'asc' o 'desc'");
             }
+            newestFirst = (order == "desc");
+        }
+        bool withTotals = true;
+        if (args.hasMember("totals") && args["totals"].getType() == XmlRpc::XmlRpcValue::TypeBoolean) {
+            withTotals = (bool)args["totals"];
         }
-        // --- FIN APLICACIÓN DE FILTROS ---
+
+
+        // 3. Llamar a la Lógica de Negocio (solo la página pedida)
+        logger_.info("[{}] Solicitud de reporte por: {} ({}) limit={} cursor={}", METHOD_NAME, session.user,
+                     session.privilegio == "admin" ? "Admin" : "Operador", limit, cursor);
+
+        const HistoryPage page = history_.getPage(filter, cursor, static_cast<size_t>(limit), newestFirst);
 
         
-        // 4. Procesar Respuesta (¡Usando la lista filtrada!)
+        // 4. Procesar Respuesta
         XmlRpc::XmlRpcValue reportArray;
-        reportArray.setSize(filtered_entries.size()); // <-- CAMBIO
-        
-        int total_comandos = 0;
-        int total_errores = 0;
+        reportArray.setSize(page.entries.size());
 
-        for (size_t i = 0; i < filtered_entries.size(); ++i) { // <-- CAMBIO
-            const auto& entry = filtered_entries[i]; // <-- CAMBIO
+        for (size_t i = 0; i < page.entries.size(); ++i) {
+            const auto& entry = page.entries[i];
             
             XmlRpc::XmlRpcValue entryStruct;
             entryStruct["timestamp"] = entry.timestamp;
@@ -117,37 +131,49 @@ void RobotGetReportMethod::execute(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcVa
             entryStruct["error"] = entry.was_error;
             
             reportArray[i] = entryStruct;
-            
-            total_comandos++;
-            if (entry.was_error) {
-                total_errores++;
-            }
         }
 
         result["ok"] = true;
-        result["total_comandos"] = total_comandos;
-        result["total_errores"] = total_errores;
         result["entries"] = reportArray;
+        result["count"] = static_cast<int>(page.entries.size());
+        result["has_more"] = page.next_cursor != 0;
+        result["next_cursor"] = page.next_cursor ? std::to_string(page.next_cursor) : std::string();
+
+        // Totales del filtro completo (no de la página), contados aparte
+        if (withTotals) {
+            const HistoryTotals totals = history_.countEntries(filter);
+            result["total_comandos"] = static_cast<int>(totals.commands);
+            result["total_errores"] = static_cast<int>(totals.errors);
+        }
 
     } catch (const XmlRpc::XmlRpcException& e) {
         throw;
     } catch (const std::runtime_error& e) {
-        logger_.error(std::string("[") + METHOD_NAME + "] Error de runtime: " + std::string(e.what()));
+        logger_.error("[{}] Error de runtime: {}", METHOD_NAME, e.what());
         throw XmlRpc::XmlRpcException("INTERNAL_ERROR: " + std::string(e.what()));
     } catch (...) {
-        logger_.error(std::string("[") + METHOD_NAME + "] Error inesperado.");
+        logger_.error("[{}] Error inesperado.", METHOD_NAME);
         throw XmlRpc::XmlRpcException("INTERNAL_ERROR: Ocurrió un error inesperado en " + std::string(METHOD_NAME));
     }
 }
 
 // --- Help (Actualizado) ---
 std::string RobotGetReportMethod::help() {
-    return "robot.getReport({token:string, [filter_user:string], [filter_error:bool]}) -> {ok:bool, ...}\n"
-           "Devuelve el historial de comandos. \n"
-           " - Operador: Devuelve solo su historial.\n"
-           " - Admin: Devuelve todo el historial. Puede usar filtros opcionales:\n"
+    return "robot.getReport({token:string, [filter_user:string], [filter_error:bool], [filter_service:string],\n"
+           "                 [from], [to], [limit:int], [cursor:string], [order:'asc'|'desc'], [totals:bool]})\n"
+           "  -> {ok, entries, count, has_more, next_cursor, [total_comandos], [total_errores]}\n"
+           "Devuelve una página del historial de comandos. \n"
+           " - Operador: Solo su historial.\n"
+           " - Admin: Todo el historial. Filtros opcionales:\n"
            "     - filter_user (string): Filtra por nombre de usuario.\n"
-           "     - filter_error (bool): 'true' para ver solo errores, 'false' para ver solo éxitos.";
+           "     - filter_error (bool): 'true' para ver solo errores, 'false' para ver solo éxitos.\n"
+           " - Ambos:\n"
+           "     - filter_service (string): Filtra por servicio (ej. robot.move).\n"
+           "     - from / to: epoch (int) o YYYY-MM-DDTHH:MM:SS, inclusive.\n"
+           "     - limit: entradas por página (200 por defecto, 1000 como máximo).\n"
+           "     - cursor: next_cursor de la página anterior ('' o ausente = desde el principio).\n"
+           "     - order: 'asc' (más viejas primero, por defecto) o 'desc'.\n"
+           "     - totals: false para omitir total_comandos/total_errores (cuentan el filtro completo).";
 }
 
 } // namespace robot_service_methods
\ No newline at end of file
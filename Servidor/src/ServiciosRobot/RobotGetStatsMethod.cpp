@@ -0,0 +1,105 @@
+#include "../../include/ServiciosRobot/RobotGetStatsMethod.h"
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace robot_service_methods {
+
+namespace {
+
+XmlRpc::XmlRpcValue counterStruct(const StatsCounter& c) {
+    XmlRpc::XmlRpcValue v;
+    v["comandos"] = static_cast<int>(c.commands);
+    v["errores"] = static_cast<int>(c.errors);
+    return v;
+}
+
+XmlRpc::XmlRpcValue namedCounters(const std::vector<std::pair<std::string, StatsCounter>>& counters) {
+    XmlRpc::XmlRpcValue v;
+    v.setSize(counters.size());
+    for (size_t i = 0; i < counters.size(); ++i) {
+        XmlRpc::XmlRpcValue c = counterStruct(counters[i].second);
+        c["nombre"] = counters[i].first;
+        v[i] = c;
+    }
+    return v;
+}
+
+XmlRpc::XmlRpcValue bucketArray(const std::vector<StatsBucket>& buckets) {
+    XmlRpc::XmlRpcValue v;
+    v.setSize(buckets.size());
+    for (size_t i = 0; i < buckets.size(); ++i) {
+        XmlRpc::XmlRpcValue b;
+        b["inicio"] = CommandHistory::format_timestamp(buckets[i].start);
+        b["epoch"] = static_cast<int>(buckets[i].start);
+        b["comandos"] = static_cast<int>(buckets[i].commands);
+        b["errores"] = static_cast<int>(buckets[i].errors);
+        v[i] = b;
+    }
+    return v;
+}
+
+} // namespace
+
+RobotGetStatsMethod::RobotGetStatsMethod(XmlRpc::XmlRpcServer* server,
+                                         SessionManager& sm,
+                                         PALogger& L,
+                                         CommandHistory& ch)
+    : XmlRpc::XmlRpcServerMethod("robot.getStats", server),
+      sessions_(sm),
+      logger_(L),
+      history_(ch) {}
+
+void RobotGetStatsMethod::execute(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result) {
+    const char* const METHOD_NAME = "robot.getStats";
+
+    try {
+        XmlRpc::XmlRpcValue args = rpc_norm(params);
+        if (!args.hasMember("token")) {
+            throw XmlRpc::XmlRpcException("BAD_REQUEST: Falta parámetro 'token'");
+        }
+        const SessionView& session = guardAdmin(METHOD_NAME, sessions_, std::string(args["token"]), logger_);
+        logger_.debug("[{}] Solicitud de estadísticas por: {}", METHOD_NAME, session.user);
+
+        // Sin lock del historial: los dashboards pueden consultar seguido
+        const HistoryStatsSnapshot stats = history_.getStats();
+
+        StatsCounter ok;
+        ok.commands = stats.total.commands - stats.total.errors;
+        StatsCounter failed;
+        failed.commands = failed.errors = stats.total.errors;
+        XmlRpc::XmlRpcValue byError;
+        byError["ok"] = counterStruct(ok);
+        byError["error"] = counterStruct(failed);
+
+        result["ok"] = true;
+        result["total_comandos"] = static_cast<int>(stats.total.commands);
+        result["total_errores"] = static_cast<int>(stats.total.errors);
+        result["por_usuario"] = namedCounters(stats.byUser);
+        result["por_servicio"] = namedCounters(stats.byService);
+        result["por_error"] = byError;
+        result["por_minuto"] = bucketArray(stats.byMinute);
+        result["por_hora"] = bucketArray(stats.byHour);
+
+    } catch (const XmlRpc::XmlRpcException& e) {
+        throw;
+    } catch (const std::runtime_error& e) {
+        logger_.error("[{}] Error de runtime: {}", METHOD_NAME, e.what());
+        throw XmlRpc::XmlRpcException("INTERNAL_ERROR: " + std::string(e.what()));
+    } catch (...) {
+        logger_.error("[{}] Error inesperado.", METHOD_NAME);
+        throw XmlRpc::XmlRpcException("INTERNAL_ERROR: Ocurrió un error inesperado en " + std::string(METHOD_NAME));
+    }
+}
+
+std::string RobotGetStatsMethod::help() {
+    return "robot.getStats({token:string}) -> {ok, total_comandos, total_errores, por_usuario, por_servicio,\n"
+           "                                   por_error, por_minuto, por_hora}\n"
+           "Contadores del historial de comandos (solo Admin), sin recorrer las entradas:\n"
+           " - por_usuario / por_servicio: [{nombre, comandos, errores}]\n"
+           " - por_error: {ok: {...}, error: {...}}\n"
+           " - por_minuto (última hora) / por_hora (últimas 48 h): [{inicio, epoch, comandos, errores}]\n"
+           "Cuentan lo registrado: no bajan al borrar historial ni al descartar entradas viejas.";
+}
+
+} // namespace robot_service_methods
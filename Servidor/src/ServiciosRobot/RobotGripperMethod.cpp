@@ -44,10 +44,10 @@ void RobotGripperMethod::execute(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValu
         user_for_history = session.user;
 
         if (session.privilegio != "admin" && session.privilegio != "op") {
-            logger_.warning(std::string("[") + METHOD_NAME + "] FORBIDDEN - Se requiere Op o Admin. Usuario: " + session.user);
+            logger_.warning("[{}] FORBIDDEN - Se requiere Op o Admin. Usuario: {}", METHOD_NAME, session.user);
             throw XmlRpc::XmlRpcException("FORBIDDEN: privilegios insuficientes (se requiere Op o Admin)");
         }
-        logger_.info(std::string("[") + METHOD_NAME + "] Solicitud de gripper (" + (estado ? "ON" : "OFF") + ") por: " + session.user); // <-- CAMBIO
+        logger_.info("[{}] Solicitud de gripper ({}) por: {}", METHOD_NAME, (estado ? "ON" : "OFF"), session.user); // <-- CAMBIO
 
         // 3. Llamar a la Lógica de Negocio (RobotService)
         history_.addEntry(session.user, METHOD_NAME, details_for_history, false);
@@ -61,23 +61,23 @@ void RobotGripperMethod::execute(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValu
 
         // 4. Procesar Respuesta y Armar Resultado
         if (respuestaRobot.rfind("ERROR:", 0) == 0) {
-             logger_.warning(std::string("[") + METHOD_NAME + "] Falló para " + session.user + ". Robot dijo: " + respuestaRobot);
+             logger_.warning("[{}] Falló para {}. Robot dijo: {}", METHOD_NAME, session.user, respuestaRobot);
              throw XmlRpc::XmlRpcException(respuestaRobot);
         }
 
         result["ok"] = true;
         result["msg"] = respuestaRobot;
-        logger_.info(std::string("[") + METHOD_NAME + "] Éxito para " + session.user + ". Respuesta: " + respuestaRobot);
+        logger_.info("[{}] Éxito para {}. Respuesta: {}", METHOD_NAME, session.user, respuestaRobot);
 
     } catch (const XmlRpc::XmlRpcException& e) {
         throw;
     } catch (const std::runtime_error& e) {
         history_.addEntry(user_for_history, METHOD_NAME, e.what(), true);
-        logger_.error(std::string("[") + METHOD_NAME + "] Error de runtime: " + std::string(e.what()));
+        logger_.error("[{}] Error de runtime: {}", METHOD_NAME, e.what());
         throw XmlRpc::XmlRpcException("INTERNAL_ERROR: " + std::string(e.what()));
     } catch (...) {
         history_.addEntry(user_for_history, METHOD_NAME, "Error inesperado", true);
-        logger_.error(std::string("[") + METHOD_NAME + "] Error inesperado.");
+        logger_.error("[{}] Error inesperado.", METHOD_NAME);
         throw XmlRpc::XmlRpcException("INTERNAL_ERROR: Ocurrió un error inesperado en " + std::string(METHOD_NAME));
     }
 }
@@ -34,10 +34,10 @@ void RobotHomingMethod::execute(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue
 
         // Luego, verificamos el privilegio manualmente
         if (session.privilegio != "admin" && session.privilegio != "op") {
-            logger_.warning(std::string("[") + METHOD_NAME + "] FORBIDDEN - Se requiere Op o Admin. Usuario: " + session.user);
+            logger_.warning("[{}] FORBIDDEN - Se requiere Op o Admin. Usuario: {}", METHOD_NAME, session.user);
             throw XmlRpc::XmlRpcException("FORBIDDEN: privilegios insuficientes (se requiere Op o Admin)");
         }
-        logger_.info(std::string("[") + METHOD_NAME + "] Solicitud de homing por usuario: " + session.user);
+        logger_.info("[{}] Solicitud de homing por usuario: {}", METHOD_NAME, session.user);
 
         // 3. Llamar a la Lógica de Negocio (RobotService)
 
@@ -49,14 +49,14 @@ void RobotHomingMethod::execute(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue
         // 4. Procesar Respuesta y Armar Resultado
         // Chequeamos si la respuesta de RobotService indica un error
         if (respuestaRobot.rfind("ERROR:", 0) == 0) {
-             logger_.warning(std::string("[") + METHOD_NAME + "] Falló para " + session.user + ". Robot dijo: " + respuestaRobot);
+             logger_.warning("[{}] Falló para {}. Robot dijo: {}", METHOD_NAME, session.user, respuestaRobot);
              // Lanzamos una excepción que el cliente recibirá como Fault
              throw XmlRpc::XmlRpcException(respuestaRobot);
         }
 
         result["ok"] = true;
         result["msg"] = respuestaRobot; // El mensaje de éxito que devolvió RobotService
-        logger_.info(std::string("[") + METHOD_NAME + "] Éxito para " + session.user + ". Respuesta: " + respuestaRobot);
+        logger_.info("[{}] Éxito para {}. Respuesta: {}", METHOD_NAME, session.user, respuestaRobot);
 
     } catch (const XmlRpc::XmlRpcException& e) {
         // Errores específicos de XML-RPC (lanzados por nosotros o guardSession)
@@ -66,11 +66,11 @@ void RobotHomingMethod::execute(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue
     } catch (const std::runtime_error& e) {
         // Otros errores C++ (ej., de RobotService si no pudo conectar)
         history_.addEntry(user_for_history, METHOD_NAME, "Error inesperado", true);
-        logger_.error(std::string("[") + METHOD_NAME + "] Error de runtime: " + std::string(e.what()));
+        logger_.error("[{}] Error de runtime: {}", METHOD_NAME, e.what());
         throw XmlRpc::XmlRpcException("INTERNAL_ERROR: " + std::string(e.what()));
     } catch (...) {
         // Error inesperado
-        logger_.error(std::string("[") + METHOD_NAME + "] Error inesperado.");
+        logger_.error("[{}] Error inesperado.", METHOD_NAME);
         throw XmlRpc::XmlRpcException("INTERNAL_ERROR: Ocurrió un error inesperado en " + std::string(METHOD_NAME));
     }
 }
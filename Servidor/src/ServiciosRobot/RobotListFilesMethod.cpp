@@ -32,40 +32,106 @@ void RobotListFilesMethod::execute(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcVa
 
         // Validar que tengamos un usuario válido (op o admin)
         if (currentUserRole != "admin" && currentUserRole != "op") {
-            logger_.warning(std::string("[") + METHOD_NAME + "] FORBIDDEN - Se requiere Op o Admin. Usuario: " + session.user);
+            logger_.warning("[{}] FORBIDDEN - Se requiere Op o Admin. Usuario: {}", METHOD_NAME, session.user);
             throw XmlRpc::XmlRpcException("FORBIDDEN: privilegios insuficientes (se requiere Op o Admin)");
         }
         
-        logger_.info(std::string("[") + METHOD_NAME + "] Solicitud de listado por: " + session.user);
+        // 3. Parámetros opcionales de paginación, orden y filtro
+        FiltroCatalogo filtro;
+        filtro.ordenarPor = "nombre";
+        filtro.descendente = false;
+        if (args.hasMember("offset")) {
+            int offset = int(args["offset"]);
+            if (offset < 0) throw XmlRpc::XmlRpcException("BAD_REQUEST: 'offset' debe ser >= 0");
+            filtro.offset = static_cast<size_t>(offset);
+        }
+        if (args.hasMember("limit")) {
+            int limit = int(args["limit"]);
+            if (limit < 0) throw XmlRpc::XmlRpcException("BAD_REQUEST: 'limit' debe ser >= 0");
+            filtro.limite = static_cast<size_t>(limit);
+        }
+        if (args.hasMember("sort")) {
+            filtro.ordenarPor = std::string(args["sort"]);
+            if (filtro.ordenarPor != "nombre" && filtro.ordenarPor != "creado" &&
+                filtro.ordenarPor != "tamano" && filtro.ordenarPor != "lineas" &&
+                filtro.ordenarPor != "duracion") {
+                throw XmlRpc::XmlRpcException("BAD_REQUEST: 'sort' debe ser nombre|creado|tamano|lineas|duracion");
+            }
+        }
+        if (args.hasMember("order")) {
+            filtro.descendente = (std::string(args["order"]) == "desc");
+        }
+        if (args.hasMember("q")) {
+            filtro.texto = std::string(args["q"]);
+        }
+        if (args.hasMember("totals") && args["totals"].getType() == XmlRpc::XmlRpcValue::TypeBoolean) {
+            filtro.conTotal = (bool)args["totals"];
+        }
+        // Solo el admin puede pedir los archivos de otro usuario (el op siempre ve los propios)
+        if (currentUserRole == "admin" && args.hasMember("owner_id")) {
+            filtro.ownerId = int(args["owner_id"]);
+        }
+
+        logger_.info("[{}] Solicitud de listado por: {}", METHOD_NAME, session.user);
 
-        // 3. Llamar a la Lógica de Negocio (RobotService)
-        std::vector<std::string> archivos = robotService_.listarTrayectorias(currentUserId, currentUserRole);
+        // 4. Llamar a la Lógica de Negocio (RobotService)
+        PaginaCatalogo pagina = robotService_.listarTrayectoriasPaginado(currentUserId, currentUserRole, filtro);
 
-        // 4. Procesar Respuesta y Armar Resultado
+        // 5. Procesar Respuesta y Armar Resultado
         XmlRpc::XmlRpcValue fileArray;
-        fileArray.setSize(archivos.size());
-        for (size_t i = 0; i < archivos.size(); ++i) {
-            fileArray[i] = archivos[i];
+        XmlRpc::XmlRpcValue itemArray;
+        fileArray.setSize(pagina.items.size());
+        itemArray.setSize(pagina.items.size());
+        for (size_t i = 0; i < pagina.items.size(); ++i) {
+            const EntradaCatalogo& e = pagina.items[i];
+            fileArray[i] = e.archivo;
+
+            XmlRpc::XmlRpcValue item;
+            item["file"] = e.archivo;
+            item["owner_id"] = e.ownerId;
+            item["name"] = e.nombreLogico;
+            item["created"] = static_cast<int>(e.creadoEn);
+            item["size"] = static_cast<int>(e.meta.bytes);
+            item["lines"] = static_cast<int>(e.meta.lineas);
+            item["moves"] = static_cast<int>(e.meta.movimientos);
+            item["distance_mm"] = e.meta.distanciaMm;
+            item["duration_s"] = e.meta.duracionEstimadaSeg;
+            if (e.meta.bboxValida) {
+                XmlRpc::XmlRpcValue bbox;
+                bbox["min_x"] = e.meta.minX; bbox["max_x"] = e.meta.maxX;
+                bbox["min_y"] = e.meta.minY; bbox["max_y"] = e.meta.maxY;
+                bbox["min_z"] = e.meta.minZ; bbox["max_z"] = e.meta.maxZ;
+                item["bbox"] = bbox;
+            }
+            itemArray[i] = item;
         }
 
         result["ok"] = true;
-        result["files"] = fileArray; // Devolver el array de nombres
+        result["files"] = fileArray; // Nombres (compatibilidad con clientes anteriores)
+        result["items"] = itemArray; // Nombres + metadatos
+        if (filtro.conTotal) {
+            result["total"] = static_cast<int>(pagina.total);
+        }
+        result["offset"] = static_cast<int>(filtro.offset);
 
     } catch (const XmlRpc::XmlRpcException& e) {
         throw;
     } catch (const std::runtime_error& e) {
-        logger_.error(std::string("[") + METHOD_NAME + "] Error de runtime: " + std::string(e.what()));
+        logger_.error("[{}] Error de runtime: {}", METHOD_NAME, e.what());
         throw XmlRpc::XmlRpcException("INTERNAL_ERROR: " + std::string(e.what()));
     } catch (...) {
-        logger_.error(std::string("[") + METHOD_NAME + "] Error inesperado.");
+        logger_.error("[{}] Error inesperado.", METHOD_NAME);
         throw XmlRpc::XmlRpcException("INTERNAL_ERROR: Ocurrió un error inesperado en " + std::string(METHOD_NAME));
     }
 }
 
 std::string RobotListFilesMethod::help() {
-    return "robot.listMyFiles({token:string}) -> {ok:bool, files:array}\n"
-           "Lista los archivos de trayectoria disponibles.\n"
-           "Admin: ve todos. Operador: ve solo los propios.";
+    return "robot.listMyFiles({token:string, offset?:int, limit?:int, sort?:string, order?:string, q?:string, owner_id?:int, totals?:bool})"
+           " -> {ok:bool, files:array, items:array, total?:int, offset:int}\n"
+           "Lista los archivos de trayectoria disponibles con sus metadatos.\n"
+           "sort: nombre|creado|tamano|lineas|duracion. order: asc|desc. q: subcadena del nombre.\n"
+           "totals: false para omitir el conteo total (evita una consulta por página).\n"
+           "Admin: ve todos (owner_id filtra por usuario). Operador: ve solo los propios.";
 }
 
 } // namespace robot_service_methods
\ No newline at end of file
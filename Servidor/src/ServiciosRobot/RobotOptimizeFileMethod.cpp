@@ -0,0 +1,96 @@
+#include "../../include/ServiciosRobot/RobotOptimizeFileMethod.h"
+#include <stdexcept> 
+#include <string>
+#include "../../include/session/CurrentUser.h"
+
+namespace robot_service_methods {
+
+RobotOptimizeFileMethod::RobotOptimizeFileMethod(XmlRpc::XmlRpcServer* server,
+                                       SessionManager& sm,
+                                       PALogger& L,
+                                       RobotService& rs)
+    : XmlRpc::XmlRpcServerMethod("robot.optimizeFile", server), // <-- Nombre RPC del cliente
+      sessions_(sm),
+      logger_(L),
+      robotService_(rs) {}
+
+void RobotOptimizeFileMethod::execute(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result) {
+    const char* const METHOD_NAME = "robot.optimizeFile";
+    try {
+        // 1. Validar Parámetros (token + nombre + opciones)
+        // -----------------------------------------------------------------
+        XmlRpc::XmlRpcValue args = rpc_norm(params);
+        if (!args.hasMember("token") || !args.hasMember("nombre")) {
+            throw XmlRpc::XmlRpcException("BAD_REQUEST: Faltan parámetros (se requiere 'token' y 'nombre')");
+        }
+        std::string token = std::string(args["token"]);
+        std::string nombreArchivo = std::string(args["nombre"]);
+
+        if (nombreArchivo.empty()) {
+             throw XmlRpc::XmlRpcException("BAD_REQUEST: El parámetro 'nombre' no puede estar vacío.");
+        }
+        OpcionesOptimizacion opciones = leerOpcionesOptimizacion(args);
+        // -----------------------------------------------------------------
+
+        // 2. Validar Sesión y Permisos (Lógica de Admin vs. Operador)
+        // -----------------------------------------------------------------
+        const SessionView& session = guardSession(METHOD_NAME, sessions_, token, logger_);
+        
+        if (session.privilegio == "admin") {
+            logger_.info("[{}] [ADMIN] Solicitud para optimizar '{}' por: {}", METHOD_NAME, nombreArchivo, session.user);
+        
+        } else if (session.privilegio == "op") {
+            // El Operador solo puede optimizar sus propios archivos.
+            int currentUserId = CurrentUser::get();
+            if (currentUserId <= 0) {
+                 logger_.error("[{}] ERROR INTERNO: El usuario '{}' tiene un ID inválido ({}).", METHOD_NAME, session.user, currentUserId);
+                 throw XmlRpc::XmlRpcException("INTERNAL_ERROR: No se pudo verificar la propiedad del archivo.");
+            }
+
+            std::string prefijoRequerido = std::to_string(currentUserId) + "__";
+            if (nombreArchivo.rfind(prefijoRequerido, 0) != 0) {
+                logger_.warning("[{}] FORBIDDEN - El operador '{}' (id={}) intentó optimizar el archivo '{}' (no es de su propiedad).", METHOD_NAME, session.user, currentUserId, nombreArchivo);
+                throw XmlRpc::XmlRpcException("FORBIDDEN: Como operador, solo puedes optimizar archivos de tu propiedad.");
+            }
+            logger_.info("[{}] [OPERATOR] Solicitud para optimizar '{}' por: {}", METHOD_NAME, nombreArchivo, session.user);
+
+        } else {
+            logger_.warning("[{}] FORBIDDEN - Se requiere Op o Admin. Usuario: {}", METHOD_NAME, session.user);
+            throw XmlRpc::XmlRpcException("FORBIDDEN: privilegios insuficientes (se requiere Op o Admin)");
+        }
+
+        // 3. Llamar a la Lógica de Negocio (RobotService)
+        ResultadoOptimizacion reporte;
+        std::string nombreOptimizado = robotService_.optimizarTrayectoria(nombreArchivo, opciones, reporte);
+
+        // 4. Procesar Respuesta y Armar Resultado
+        if (nombreOptimizado.empty()) {
+             logger_.warning("[{}] Falló la optimización para {}", METHOD_NAME, session.user);
+             throw XmlRpc::XmlRpcException("ERROR: No se pudo optimizar el archivo '" + nombreArchivo + "'.");
+        }
+
+        result["ok"] = true;
+        result["filename"] = nombreOptimizado;
+        escribirReporteOptimizacion(reporte, result);
+        logger_.info("[{}] Éxito para {}. Guardado como: {}", METHOD_NAME, session.user, nombreOptimizado);
+
+    } catch (const XmlRpc::XmlRpcException& e) {
+        throw;
+    } catch (const std::runtime_error& e) {
+        logger_.error("[{}] Error de runtime: {}", METHOD_NAME, e.what());
+        throw XmlRpc::XmlRpcException("INTERNAL_ERROR: " + std::string(e.what()));
+    } catch (...) {
+        logger_.error("[{}] Error inesperado.", METHOD_NAME);
+        throw XmlRpc::XmlRpcException("INTERNAL_ERROR: Ocurrió un error inesperado en " + std::string(METHOD_NAME));
+    }
+}
+
+std::string RobotOptimizeFileMethod::help() {
+    return "robot.optimizeFile({token:string, nombre:string, tolerancia?:double, distancia_minima?:double,"
+           " simplificar?:bool, colapsar_efector?:bool, reordenar?:bool, arcos?:bool}) -> {ok:bool, filename:string, lines_before:int,"
+           " lines_after:int, duration_before_s:double, duration_after_s:double}\n"
+           "Escribe (o reemplaza) la copia optimizada <nombre>_opt, del mismo dueño que el original, sin tocarlo.\n"
+           "Requiere token de Operador (archivos propios) o Admin.";
+}
+
+} // namespace robot_service_methods
@@ -0,0 +1,103 @@
+#include "../../include/ServiciosRobot/RobotResumeFileMethod.h"
+#include <stdexcept> 
+#include <string>
+#include "../../include/session/CurrentUser.h"
+
+namespace robot_service_methods {
+
+RobotResumeFileMethod::RobotResumeFileMethod(XmlRpc::XmlRpcServer* server,
+                                       SessionManager& sm,
+                                       PALogger& L,
+                                       RobotService& rs)
+    : XmlRpc::XmlRpcServerMethod("robot.resumeFile", server), // <-- Nombre RPC del cliente
+      sessions_(sm),
+      logger_(L),
+      robotService_(rs) {}
+
+void RobotResumeFileMethod::execute(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result) {
+    const char* const METHOD_NAME = "robot.resumeFile";
+    try {
+        // 1. Validar Parámetros (token + nombre)
+        // -----------------------------------------------------------------
+        XmlRpc::XmlRpcValue args = rpc_norm(params);
+        if (!args.hasMember("token") || !args.hasMember("nombre")) {
+            throw XmlRpc::XmlRpcException("BAD_REQUEST: Faltan parámetros (se requiere 'token' y 'nombre')");
+        }
+        std::string token = std::string(args["token"]);
+        std::string nombreArchivo = std::string(args["nombre"]);
+
+        if (nombreArchivo.empty()) {
+             throw XmlRpc::XmlRpcException("BAD_REQUEST: El parámetro 'nombre' no puede estar vacío.");
+        }
+        // -----------------------------------------------------------------
+
+        // 2. Validar Sesión y Permisos (Lógica de Admin vs. Operador)
+        // -----------------------------------------------------------------
+        const SessionView& session = guardSession(METHOD_NAME, sessions_, token, logger_);
+        
+        if (session.privilegio == "admin") {
+            // El Admin puede ejecutar cualquier cosa.
+            logger_.info("[{}] [ADMIN] Solicitud para reanudar '{}' por: {}", METHOD_NAME, nombreArchivo, session.user);
+        
+        } else if (session.privilegio == "op") {
+            // El Operador solo puede ejecutar sus propios archivos.
+            
+            // ¡Esta es la forma correcta de obtener el ID del usuario actual!
+            int currentUserId = CurrentUser::get(); //
+
+            // El ID no debería ser -1 (default) si la sesión es válida, pero chequear por si acaso.
+            if (currentUserId <= 0) {
+                 logger_.error("[{}] ERROR INTERNO: El usuario '{}' tiene un ID inválido ({}).", METHOD_NAME, session.user, currentUserId);
+                 throw XmlRpc::XmlRpcException("INTERNAL_ERROR: No se pudo verificar la propiedad del archivo.");
+            }
+
+            std::string prefijoRequerido = std::to_string(currentUserId) + "__";
+
+            if (nombreArchivo.rfind(prefijoRequerido, 0) != 0) {
+                // El archivo no empieza con el prefijo del usuario. ¡Denegado!
+                logger_.warning("[{}] FORBIDDEN - El operador '{}' (id={}) intentó ejecutar el archivo '{}' (no es de su propiedad).", METHOD_NAME, session.user, currentUserId, nombreArchivo);
+                throw XmlRpc::XmlRpcException("FORBIDDEN: Como operador, solo puedes ejecutar archivos de tu propiedad.");
+            }
+            
+            // Si pasó el chequeo, registrar el éxito.
+            logger_.info("[{}] [OPERATOR] Solicitud para reanudar '{}' por: {}", METHOD_NAME, nombreArchivo, session.user);
+
+        } else {
+            // Ni admin ni "op" (ej. "viewer" o rol desconocido)
+            logger_.warning("[{}] FORDEN - Se requiere Op o Admin. Usuario: {}", METHOD_NAME, session.user);
+            throw XmlRpc::XmlRpcException("FORBIDDEN: privilegios insuficientes (se requiere Op o Admin)");
+        }
+
+        // 3. Llamar a la Lógica de Negocio (RobotService)
+        // (la reanudación usa el checkpoint que dejó la ejecución fallida)
+        std::string respuesta = robotService_.reanudarTrayectoria(nombreArchivo);
+
+        // 4. Procesar Respuesta y Armar Resultado
+        if (respuesta.rfind("ERROR:", 0) == 0) {
+             logger_.warning("[{}] Falló para {}. Robot dijo: {}", METHOD_NAME, session.user, respuesta);
+             throw XmlRpc::XmlRpcException(respuesta);
+        }
+
+        result["ok"] = true;
+        result["msg"] = respuesta; 
+        logger_.info("[{}] Éxito para {}. Respuesta: {}", METHOD_NAME, session.user, respuesta);
+
+    } catch (const XmlRpc::XmlRpcException& e) {
+        throw;
+    } catch (const std::runtime_error& e) {
+        logger_.error("[{}] Error de runtime: {}", METHOD_NAME, e.what());
+        throw XmlRpc::XmlRpcException("INTERNAL_ERROR: " + std::string(e.what()));
+    } catch (...) {
+        logger_.error("[{}] Error inesperado.", METHOD_NAME);
+        throw XmlRpc::XmlRpcException("INTERNAL_ERROR: Ocurrió un error inesperado en " + std::string(METHOD_NAME));
+    }
+}
+
+std::string RobotResumeFileMethod::help() {
+    return "robot.resumeFile({token:string, nombre:string}) -> {ok:bool, msg:string}\n"
+           "Reanuda una trayectoria .gcode desde la línea en la que falló su última ejecución.\n"
+           "Antes de continuar hace una aproximación segura a la última pose confirmada.\n"
+           "Requiere token de Operador o Admin.";
+}
+
+} // namespace robot_service_methods
\ No newline at end of file
@@ -29,6 +29,8 @@ void RobotRunFileMethod::execute(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValu
         if (nombreArchivo.empty()) {
              throw XmlRpc::XmlRpcException("BAD_REQUEST: El parámetro 'nombre' no puede estar vacío.");
         }
+        // Opcional: reordenar las operaciones pick-and-place antes de ejecutar
+        bool reordenar = args.hasMember("reordenar") && bool(args["reordenar"]);
         // -----------------------------------------------------------------
 
         // 2. Validar Sesión y Permisos (Lógica de Admin vs. Operador)
@@ -37,7 +39,7 @@ void RobotRunFileMethod::execute(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValu
         
         if (session.privilegio == "admin") {
             // El Admin puede ejecutar cualquier cosa.
-            logger_.info(std::string("[") + METHOD_NAME + "] [ADMIN] Solicitad para ejecutar '" + nombreArchivo + "' por: " + session.user);
+            logger_.info("[{}] [ADMIN] Solicitad para ejecutar '{}' por: {}", METHOD_NAME, nombreArchivo, session.user);
         
         } else if (session.privilegio == "op") {
             // El Operador solo puede ejecutar sus propios archivos.
@@ -47,7 +49,7 @@ void RobotRunFileMethod::execute(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValu
 
             // El ID no debería ser -1 (default) si la sesión es válida, pero chequear por si acaso.
             if (currentUserId <= 0) {
-                 logger_.error(std::string("[") + METHOD_NAME + "] ERROR INTERNO: El usuario '" + session.user + "' tiene un ID inválido (" + std::to_string(currentUserId) + ").");
+                 logger_.error("[{}] ERROR INTERNO: El usuario '{}' tiene un ID inválido ({}).", METHOD_NAME, session.user, currentUserId);
                  throw XmlRpc::XmlRpcException("INTERNAL_ERROR: No se pudo verificar la propiedad del archivo.");
             }
 
@@ -55,46 +57,49 @@ void RobotRunFileMethod::execute(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValu
 
             if (nombreArchivo.rfind(prefijoRequerido, 0) != 0) {
                 // El archivo no empieza con el prefijo del usuario. ¡Denegado!
-                logger_.warning(std::string("[") + METHOD_NAME + "] FORBIDDEN - El operador '" + session.user + "' (id=" + std::to_string(currentUserId) + ") intentó ejecutar el archivo '" + nombreArchivo + "' (no es de su propiedad).");
+                logger_.warning("[{}] FORBIDDEN - El operador '{}' (id={}) intentó ejecutar el archivo '{}' (no es de su propiedad).", METHOD_NAME, session.user, currentUserId, nombreArchivo);
                 throw XmlRpc::XmlRpcException("FORBIDDEN: Como operador, solo puedes ejecutar archivos de tu propiedad.");
             }
             
             // Si pasó el chequeo, registrar el éxito.
-            logger_.info(std::string("[") + METHOD_NAME + "] [OPERATOR] Solicitud para ejecutar '" + nombreArchivo + "' por: " + session.user);
+            logger_.info("[{}] [OPERATOR] Solicitud para ejecutar '{}' por: {}", METHOD_NAME, nombreArchivo, session.user);
 
         } else {
             // Ni admin ni "op" (ej. "viewer" o rol desconocido)
-            logger_.warning(std::string("[") + METHOD_NAME + "] FORDEN - Se requiere Op o Admin. Usuario: " + session.user);
+            logger_.warning("[{}] FORDEN - Se requiere Op o Admin. Usuario: {}", METHOD_NAME, session.user);
             throw XmlRpc::XmlRpcException("FORBIDDEN: privilegios insuficientes (se requiere Op o Admin)");
         }
 
         // 3. Llamar a la Lógica de Negocio (RobotService)
-        std::string respuesta = robotService_.ejecutarTrayectoria(nombreArchivo);
+        std::string respuesta = robotService_.ejecutarTrayectoria(nombreArchivo, reordenar);
 
         // 4. Procesar Respuesta y Armar Resultado
         if (respuesta.rfind("ERROR:", 0) == 0) {
-             logger_.warning(std::string("[") + METHOD_NAME + "] Falló para " + session.user + ". Robot dijo: " + respuesta);
+             logger_.warning("[{}] Falló para {}. Robot dijo: {}", METHOD_NAME, session.user, respuesta);
              throw XmlRpc::XmlRpcException(respuesta);
         }
 
         result["ok"] = true;
         result["msg"] = respuesta; 
-        logger_.info(std::string("[") + METHOD_NAME + "] Éxito para " + session.user + ". Respuesta: " + respuesta);
+        logger_.info("[{}] Éxito para {}. Respuesta: {}", METHOD_NAME, session.user, respuesta);
 
     } catch (const XmlRpc::XmlRpcException& e) {
         throw;
     } catch (const std::runtime_error& e) {
-        logger_.error(std::string("[") + METHOD_NAME + "] Error de runtime: " + std::string(e.what()));
+        logger_.error("[{}] Error de runtime: {}", METHOD_NAME, e.what());
         throw XmlRpc::XmlRpcException("INTERNAL_ERROR: " + std::string(e.what()));
     } catch (...) {
-        logger_.error(std::string("[") + METHOD_NAME + "] Error inesperado.");
+        logger_.error("[{}] Error inesperado.", METHOD_NAME);
         throw XmlRpc::XmlRpcException("INTERNAL_ERROR: Ocurrió un error inesperado en " + std::string(METHOD_NAME));
     }
 }
 
 std::string RobotRunFileMethod::help() {
-    return "robot.runFile({token:string, nombre:string}) -> {ok:bool, msg:string}\n"
+    return "robot.runFile({token:string, nombre:string, reordenar?:bool}) -> {ok:bool, msg:string}\n"
            "Carga y ejecuta un archivo de trayectoria .gcode desde el servidor.\n"
+           "Con reordenar=true ejecuta una copia (<nombre>_reord, una por archivo, se sobrescribe en cada corrida)\n"
+           "con las operaciones pick-and-place reordenadas para minimizar los traslados; msg informa el ahorro\n"
+           "estimado o, si falla, el nombre de la copia. robot.resumeFile acepta el original o la copia.\n"
            "Requiere token de Operador o Admin.";
 }
 
@@ -37,10 +37,10 @@ void RobotStartRecordingMethod::execute(XmlRpc::XmlRpcValue& params, XmlRpc::Xml
         // (Esta lógica es idéntica a RobotMoveMethod)
         const SessionView& session = guardSession(METHOD_NAME, sessions_, token, logger_);
         if (session.privilegio != "admin" && session.privilegio != "op") {
-            logger_.warning(std::string("[") + METHOD_NAME + "] FORBIDDEN - Se requiere Op o Admin. Usuario: " + session.user);
+            logger_.warning("[{}] FORBIDDEN - Se requiere Op o Admin. Usuario: {}", METHOD_NAME, session.user);
             throw XmlRpc::XmlRpcException("FORBIDDEN: privilegios insuficientes (se requiere Op o Admin)");
         }
-        logger_.info(std::string("[") + METHOD_NAME + "] Solicitud de '" + nombreTrayectoria + "' por usuario: " + session.user);
+        logger_.info("[{}] Solicitud de '{}' por usuario: {}", METHOD_NAME, nombreTrayectoria, session.user);
 
         // 3. Llamar a la Lógica de Negocio (RobotService)
         bool exito = robotService_.iniciarGrabacionTrayectoria(nombreTrayectoria);
@@ -48,23 +48,23 @@ void RobotStartRecordingMethod::execute(XmlRpc::XmlRpcValue& params, XmlRpc::Xml
         // 4. Procesar Respuesta y Armar Resultado
         if (!exito) {
              // Esto sucede si ya estaba grabando
-             logger_.warning(std::string("[") + METHOD_NAME + "] Falló para " + session.user + ". El robot ya estaba grabando.");
+             logger_.warning("[{}] Falló para {}. El robot ya estaba grabando.", METHOD_NAME, session.user);
              result["ok"] = false;
              result["msg"] = "ERROR: Ya hay una grabación en curso.";
         } else {
              // Éxito
              result["ok"] = true;
              result["msg"] = "Grabación iniciada para: " + nombreTrayectoria; 
-             logger_.info(std::string("[") + METHOD_NAME + "] Éxito para " + session.user);
+             logger_.info("[{}] Éxito para {}", METHOD_NAME, session.user);
         }
 
     } catch (const XmlRpc::XmlRpcException& e) {
         throw; // Re-lanzar excepciones RPC
     } catch (const std::runtime_error& e) {
-        logger_.error(std::string("[") + METHOD_NAME + "] Error de runtime: " + std::string(e.what()));
+        logger_.error("[{}] Error de runtime: {}", METHOD_NAME, e.what());
         throw XmlRpc::XmlRpcException("INTERNAL_ERROR: " + std::string(e.what()));
     } catch (...) {
-        logger_.error(std::string("[") + METHOD_NAME + "] Error inesperado.");
+        logger_.error("[{}] Error inesperado.", METHOD_NAME);
         throw XmlRpc::XmlRpcException("INTERNAL_ERROR: Ocurrió un error inesperado en " + std::string(METHOD_NAME));
     }
 }
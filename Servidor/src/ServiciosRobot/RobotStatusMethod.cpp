@@ -36,10 +36,10 @@ void RobotStatusMethod::execute(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue
 
 
         if (session.privilegio != "admin" && session.privilegio != "op") {
-            logger_.warning(std::string("[") + METHOD_NAME + "] FORBIDDEN - Se requiere Op o Admin. Usuario: " + session.user);
+            logger_.warning("[{}] FORBIDDEN - Se requiere Op o Admin. Usuario: {}", METHOD_NAME, session.user);
             throw XmlRpc::XmlRpcException("FORBIDDEN: privilegios insuficientes (se requiere Op o Admin)");
         }
-        logger_.info(std::string("[") + METHOD_NAME + "] Solicitud de estado por: " + session.user);
+        logger_.info("[{}] Solicitud de estado por: {}", METHOD_NAME, session.user);
 
         // 3. Llamar a la Lógica de Negocio (RobotService)
         // El método obtenerEstado() devuelve el string del robot (M114)
@@ -47,23 +47,23 @@ void RobotStatusMethod::execute(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue
         
         // 4. Procesar Respuesta y Armar Resultado
         if (respuestaRobot.rfind("ERROR:", 0) == 0) {
-             logger_.warning(std::string("[") + METHOD_NAME + "] Falló para " + session.user + ". Robot dijo: " + respuestaRobot);
+             logger_.warning("[{}] Falló para {}. Robot dijo: {}", METHOD_NAME, session.user, respuestaRobot);
              throw XmlRpc::XmlRpcException(respuestaRobot);
         }
 
         result["ok"] = true;
         result["status"] = respuestaRobot; // <-- CAMBIO CLAVE: Usamos "status"
-        logger_.info(std::string("[") + METHOD_NAME + "] Éxito para " + session.user);
+        logger_.info("[{}] Éxito para {}", METHOD_NAME, session.user);
 
     } catch (const XmlRpc::XmlRpcException& e) {
         throw;
     } catch (const std::runtime_error& e) {
         history_.addEntry(user_for_history, METHOD_NAME, e.what(), true);
-        logger_.error(std::string("[") + METHOD_NAME + "] Error de runtime: " + std::string(e.what()));
+        logger_.error("[{}] Error de runtime: {}", METHOD_NAME, e.what());
         throw XmlRpc::XmlRpcException("INTERNAL_ERROR: " + std::string(e.what()));
     } catch (...) {
         history_.addEntry(user_for_history, METHOD_NAME, "Error inesperado", true);
-        logger_.error(std::string("[") + METHOD_NAME + "] Error inesperado.");
+        logger_.error("[{}] Error inesperado.", METHOD_NAME);
         throw XmlRpc::XmlRpcException("INTERNAL_ERROR: Ocurrió un error inesperado en " + std::string(METHOD_NAME));
     }
 }
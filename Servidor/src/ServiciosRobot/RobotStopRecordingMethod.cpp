@@ -32,10 +32,10 @@ void RobotStopRecordingMethod::execute(XmlRpc::XmlRpcValue& params, XmlRpc::XmlR
         // (Idéntico a los otros métodos)
         const SessionView& session = guardSession(METHOD_NAME, sessions_, token, logger_);
         if (session.privilegio != "admin" && session.privilegio != "op") {
-            logger_.warning(std::string("[") + METHOD_NAME + "] FORBIDDEN - Se requiere Op o Admin. Usuario: " + session.user);
+            logger_.warning("[{}] FORBIDDEN - Se requiere Op o Admin. Usuario: {}", METHOD_NAME, session.user);
             throw XmlRpc::XmlRpcException("FORBIDDEN: privilegios insuficientes (se requiere Op o Admin)");
         }
-        logger_.info(std::string("[") + METHOD_NAME + "] Solicitud por usuario: " + session.user);
+        logger_.info("[{}] Solicitud por usuario: {}", METHOD_NAME, session.user);
 
         // 3. Llamar a la Lógica de Negocio (RobotService)
         bool exito = robotService_.finalizarGrabacionTrayectoria();
@@ -45,21 +45,21 @@ void RobotStopRecordingMethod::execute(XmlRpc::XmlRpcValue& params, XmlRpc::XmlR
         //
         if (!exito) {
              // Esto solo pasaría si hubiera un error al cerrar el archivo
-             logger_.error(std::string("[") + METHOD_NAME + "] Falló para " + session.user + ". Error al cerrar el archivo.");
+             logger_.error("[{}] Falló para {}. Error al cerrar el archivo.", METHOD_NAME, session.user);
              throw XmlRpc::XmlRpcException("INTERNAL_ERROR: No se pudo finalizar la grabación.");
         } 
 
         result["ok"] = true;
         result["msg"] = "Grabación finalizada."; 
-        logger_.info(std::string("[") + METHOD_NAME + "] Éxito para " + session.user);
+        logger_.info("[{}] Éxito para {}", METHOD_NAME, session.user);
 
     } catch (const XmlRpc::XmlRpcException& e) {
         throw; // Re-lanzar excepciones RPC
     } catch (const std::runtime_error& e) {
-        logger_.error(std::string("[") + METHOD_NAME + "] Error de runtime: " + std::string(e.what()));
+        logger_.error("[{}] Error de runtime: {}", METHOD_NAME, e.what());
         throw XmlRpc::XmlRpcException("INTERNAL_ERROR: " + std::string(e.what()));
     } catch (...) {
-        logger_.error(std::string("[") + METHOD_NAME + "] Error inesperado.");
+        logger_.error("[{}] Error inesperado.", METHOD_NAME);
         throw XmlRpc::XmlRpcException("INTERNAL_ERROR: Ocurrió un error inesperado en " + std::string(METHOD_NAME));
     }
 }
@@ -34,19 +34,39 @@ void RobotUploadFileMethod::execute(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcV
         // 2. Validar Sesión y Permisos (Op o Admin)
         const SessionView& session = guardSession(METHOD_NAME, sessions_, token, logger_);
         if (session.privilegio != "admin" && session.privilegio != "op") {
-            logger_.warning(std::string("[") + METHOD_NAME + "] FORBIDDEN - Se requiere Op o Admin. Usuario: " + session.user);
+            logger_.warning("[{}] FORBIDDEN - Se requiere Op o Admin. Usuario: {}", METHOD_NAME, session.user);
             throw XmlRpc::XmlRpcException("FORBIDDEN: privilegios insuficientes (se requiere Op o Admin)");
         }
-        logger_.info(std::string("[") + METHOD_NAME + "] Solicitud para subir '" + nombreArchivo + "' por: " + session.user);
+        logger_.info("[{}] Solicitud para subir '{}' por: {}", METHOD_NAME, nombreArchivo, session.user);
 
         // 3. Llamar a la Lógica de Negocio (RobotService)
         // La función ahora devuelve el nombre final del archivo o "" si falla.
-        std::string nombreArchivoFinal = robotService_.guardarTrayectoriaSubida(nombreArchivo, contenidoArchivo);
+        // Con 'optimizar' = true el contenido pasa antes por el optimizador.
+        // Con 'reordenar' = true se reordenan las operaciones pick-and-place y
+        // con 'arcos' = true las polilíneas densas se reemplazan por G2/G3
+        // (si no se pidió también 'optimizar', es lo único que se modifica).
+        bool optimizar = args.hasMember("optimizar") && bool(args["optimizar"]);
+        bool reordenar = args.hasMember("reordenar") && bool(args["reordenar"]);
+        bool arcos = args.hasMember("arcos") && bool(args["arcos"]);
+        OpcionesOptimizacion opciones = leerOpcionesOptimizacion(args);
+        if (!optimizar && (reordenar || arcos)) {
+            opciones.simplificarColineales = false;
+            opciones.colapsarEfector = false;
+            opciones.distanciaMinimaMm = 0;
+        }
+        opciones.reordenarPickAndPlace = reordenar;
+        opciones.ajustarArcos = arcos;
+        optimizar = optimizar || reordenar || arcos;
+
+        ResultadoOptimizacion reporte;
+        std::string nombreArchivoFinal = optimizar
+            ? robotService_.guardarTrayectoriaSubida(nombreArchivo, contenidoArchivo, opciones, reporte)
+            : robotService_.guardarTrayectoriaSubida(nombreArchivo, contenidoArchivo);
 
         // 4. Procesar Respuesta y Armar Resultado
         if (nombreArchivoFinal.empty()) {
              // Falló si la función devolvió un string vacío.
-             logger_.warning(std::string("[") + METHOD_NAME + "] Falló el guardado para " + session.user);
+             logger_.warning("[{}] Falló el guardado para {}", METHOD_NAME, session.user);
              throw XmlRpc::XmlRpcException("ERROR: No se pudo guardar el archivo en el servidor.");
         }
 
@@ -54,22 +74,29 @@ void RobotUploadFileMethod::execute(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcV
         result["ok"] = true;
         result["msg"] = "Archivo subido con éxito.";
         result["filename"] = nombreArchivoFinal; // <-- ¡LA NUEVA RESPUESTA!
+        if (optimizar) {
+            escribirReporteOptimizacion(reporte, result);
+        }
         
-        logger_.info(std::string("[") + METHOD_NAME + "] Éxito para " + session.user + ". Guardado como: " + nombreArchivoFinal);
+        logger_.info("[{}] Éxito para {}. Guardado como: {}", METHOD_NAME, session.user, nombreArchivoFinal);
     } catch (const XmlRpc::XmlRpcException& e) {
         throw;
     } catch (const std::runtime_error& e) {
-        logger_.error(std::string("[") + METHOD_NAME + "] Error de runtime: " + std::string(e.what()));
+        logger_.error("[{}] Error de runtime: {}", METHOD_NAME, e.what());
         throw XmlRpc::XmlRpcException("INTERNAL_ERROR: " + std::string(e.what()));
     } catch (...) {
-        logger_.error(std::string("[") + METHOD_NAME + "] Error inesperado.");
+        logger_.error("[{}] Error inesperado.", METHOD_NAME);
         throw XmlRpc::XmlRpcException("INTERNAL_ERROR: Ocurrió un error inesperado en " + std::string(METHOD_NAME));
     }
 }
 
 std::string RobotUploadFileMethod::help() {
-    return "robot.uploadFile({token:string, nombre:string, contenido:string}) -> {ok:bool, msg:string}\n"
+    return "robot.uploadFile({token:string, nombre:string, contenido:string, optimizar?:bool, tolerancia?:double, reordenar?:bool, arcos?:bool})"
+           " -> {ok:bool, msg:string, filename:string}\n"
            "Sube un archivo de trayectoria G-Code al servidor.\n"
+           "Con optimizar=true se guarda la versión optimizada (ver robot.optimizeFile) y se informan las reducciones.\n"
+           "Con reordenar=true se reordenan las operaciones pick-and-place para minimizar los traslados.\n"
+           "Con arcos=true las polilíneas densas se reemplazan por arcos G2/G3.\n"
            "Requiere token de Operador o Admin.";
 }
 
@@ -1,83 +1,413 @@
 #include "core/CommandHistory.h"
+#include "storage/CommandHistorySqlite.h"
+#include <algorithm>
 #include <chrono>   // Para obtener la hora actual
-#include <sstream>  // Para formatear el string de la hora
-#include <iomanip>  // Para formatear el string de la hora (setw, setfill)
-#include <iostream> // (Opcional, para debug)
+#include <ctime>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+
+//
+// ===== NOMBRES INTERNADOS =====
+//
+
+CommandHistory::NamePool::~NamePool() {
+    for (auto& chunk : chunks_) {
+        delete[] chunk.load(std::memory_order_relaxed);
+    }
+}
 
 /**
- * @brief Función helper privada para obtener un timestamp actual en formato ISO 8601 (YYYY-MM-DDTHH:MM:SS).
+ * @brief Id del nombre; si es nuevo, lo publica (el string queda escrito
+ * antes del store release del tamaño y no se modifica más).
  */
-std::string CommandHistory::get_current_timestamp() const {
-    auto now = std::chrono::system_clock::now();
-    auto in_time_t = std::chrono::system_clock::to_time_t(now);
-    
-    std::stringstream ss;
-    // std::put_time usa el 'struct tm' en formato local. 
-    // Usamos gmtime_s o gmtime (dependiendo del compilador) para UTC si fuera necesario,
-    // pero para un log local, la hora local suele ser más útil.
-    
-    // C++ moderno ofrece std::localtime, pero algunos compiladores pueden requerir
-    // una versión más segura (localtime_s). Para compatibilidad, usamos std::localtime.
-    
-    #pragma warning(suppress : 4996) // Suprime la advertencia de C4996 sobre std::localtime
-    ss << std::put_time(std::localtime(&in_time_t), "%Y-%m-%dT%H:%M:%S");
-    
-    return ss.str();
+uint32_t CommandHistory::NamePool::intern(const std::string& name) {
+    auto it = ids_.find(name);
+    if (it != ids_.end()) {
+        return it->second;
+    }
+
+    const uint32_t id = size_.load(std::memory_order_relaxed);
+    if (id >= CHUNK * MAX_CHUNKS) {
+        throw std::length_error("CommandHistory: demasiados nombres distintos");
+    }
+    std::string* chunk = chunks_[id / CHUNK].load(std::memory_order_relaxed);
+    if (!chunk) {
+        chunk = new std::string[CHUNK];
+        chunks_[id / CHUNK].store(chunk, std::memory_order_release);
+    }
+    chunk[id % CHUNK] = name;
+    ids_.emplace(chunk[id % CHUNK], id);
+    size_.store(id + 1, std::memory_order_release);
+    return id;
+}
+
+/**
+ * @brief Busca entre los nombres publicados. Lineal en la cantidad de
+ * nombres (usuarios o servicios distintos: pocos) y sin lock.
+ */
+bool CommandHistory::NamePool::find(const std::string& name, uint32_t& id) const {
+    const uint32_t size = size_.load(std::memory_order_acquire);
+    for (uint32_t i = 0; i < size; ++i) {
+        if (this->name(i) == name) {
+            id = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+const std::string& CommandHistory::NamePool::name(uint32_t id) const {
+    return chunks_[id / CHUNK].load(std::memory_order_acquire)[id % CHUNK];
+}
+
+//
+// ===== SEGMENTOS E INSTANTÁNEAS =====
+//
+
+CommandHistory::Segment::Segment(uint64_t first, size_t capacity)
+    : firstId(first), entries(new StoredEntry[capacity]) {}
+
+std::shared_ptr<const CommandHistory::Snapshot> CommandHistory::acquireSnapshot() const {
+    return std::atomic_load(&snapshot_);
+}
+
+// Requiere mtx_
+void CommandHistory::publish(std::shared_ptr<Snapshot> next) {
+    current_ = next;
+    std::atomic_store(&snapshot_, std::shared_ptr<const Snapshot>(std::move(next)));
 }
 
+/**
+ * @brief Sella el segmento activo (arma su índice por usuario), descarta el
+ * más viejo si no hay lugar y publica una instantánea con un activo nuevo.
+ * Requiere mtx_.
+ */
+void CommandHistory::rollSegment() {
+    auto next = std::make_shared<Snapshot>(*current_);
+
+    if (active_) {
+        const size_t n = active_->count.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < n; ++i) {
+            active_->byUser[active_->entries[i].user].push_back(static_cast<uint32_t>(i));
+        }
+    }
+    if (next->segments.size() == maxSegments_) {
+        evictSegment(*next->segments.front());
+        next->segments.erase(next->segments.begin());
+    }
+
+    active_ = std::make_shared<Segment>(nextId_, segmentSize_);
+    next->segments.push_back(active_);
+    publish(std::move(next));
+}
+
+/**
+ * @brief Descuenta las entradas del segmento que se descarta (O(tamaño del
+ * segmento)). La memoria se libera cuando ningún lector lo usa.
+ */
+void CommandHistory::evictSegment(const Segment& segment) {
+    const size_t n = segment.count.load(std::memory_order_relaxed);
+    size_t live = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const StoredEntry& entry = segment.entries[i];
+        if (entry.user < hiddenBefore_.size() && segment.firstId + i < hiddenBefore_[entry.user]) continue;
+        --userLive_[entry.user];
+        ++live;
+    }
+    size_.store(size_.load(std::memory_order_relaxed) - live, std::memory_order_relaxed);
+}
+
+//
+// ===== HISTORIAL =====
+//
+
+CommandHistory::CommandHistory(PALogger& logger, size_t capacity)
+    : logger_(logger),
+      capacity_(std::max<size_t>(capacity, 1)) {
+    // Se descarta de a un segmento: con ~16 segmentos o más, tras llenarse
+    // se conserva siempre al menos el 94% de la capacidad
+    segmentSize_ = std::clamp<size_t>(capacity_ / 16, 1, MAX_SEGMENT_SIZE);
+    maxSegments_ = capacity_ / segmentSize_;
+
+    auto initial = std::make_shared<Snapshot>();
+    initial->hiddenBefore = std::make_shared<const std::vector<uint64_t>>();
+    publish(std::move(initial));
+}
+
+// Definido aquí: CommandHistorySqlite es incompleto en el header
+CommandHistory::~CommandHistory() = default;
+
+void CommandHistory::attachStore(std::unique_ptr<CommandHistorySqlite> store) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (active_) {
+        throw std::logic_error("CommandHistory: attachStore con entradas ya registradas");
+    }
+    nextId_ = store->ultimoConfirmado() + 1;
+
+    // Estadísticas desde lo guardado
+    const int64_t now = std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    const AgregadosHistorial saved = store->agregados(
+        now - static_cast<int64_t>(HistoryStats::MINUTE_BUCKETS) * 60,
+        now - static_cast<int64_t>(HistoryStats::HOUR_BUCKETS) * 3600);
+    for (const auto& row : saved.porUsuario) {
+        stats_.addUser(users_.intern(row.nombre), row.nombre, row.comandos, row.errores);
+    }
+    for (const auto& row : saved.porServicio) {
+        stats_.addService(services_.intern(row.nombre), row.nombre, row.comandos, row.errores);
+    }
+    for (const auto& row : saved.porMinuto) stats_.addMinute(row.inicio, row.comandos, row.errores);
+    for (const auto& row : saved.porHora) stats_.addHour(row.inicio, row.comandos, row.errores);
+
+    store_ = std::move(store);
+}
+
+/**
+ * @brief Función helper privada para armar un timestamp en formato ISO 8601 (YYYY-MM-DDTHH:MM:SS).
+ * Para un log local, la hora local suele ser más útil que UTC.
+ */
+std::string CommandHistory::format_timestamp(int64_t epoch) {
+    std::time_t t = static_cast<std::time_t>(epoch);
+    std::tm timeinfo;
+    localtime_r(&t, &timeinfo);
+    char buffer[32];
+    size_t n = std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%S", &timeinfo);
+    return std::string(buffer, n);
+}
+
+CommandEntry CommandHistory::materialize(uint64_t id, const StoredEntry& entry) const {
+    CommandEntry out;
+    out.id = id;
+    out.epoch = entry.epoch;
+    out.timestamp = format_timestamp(entry.epoch);
+    out.username = users_.name(entry.user);
+    out.service_name = services_.name(entry.service);
+    out.details = entry.details;
+    out.was_error = entry.was_error;
+    return out;
+}
 
 /**
  * @brief Agrega una nueva entrada al historial de comandos.
  */
-void CommandHistory::addEntry(const std::string& user, const std::string& service, 
+void CommandHistory::addEntry(const std::string& user, const std::string& service,
                               const std::string& details, bool is_error) {
-    
-    // 1. Crear la entrada
-    CommandEntry new_entry;
-    new_entry.timestamp = get_current_timestamp();
-    new_entry.username = user;
-    new_entry.service_name = service;
-    new_entry.details = details;
-    new_entry.was_error = is_error;
+
+    const int64_t epoch = std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
 
     // --- ¡NUESTRA FUSIÓN! ---
-    // 2. Llamar a PALogger para que guarde en el CSV
+    // Llamar a PALogger para que guarde en el CSV
     std::string resultado = is_error ? ("ERROR: " + details) : "OK";
     // (Aún no tenemos el "nodo" (IP), así que lo dejamos default)
     logger_.logRequest(user, service, resultado);
     // --- FIN DE LA FUSIÓN ---
 
-    // 3. Bloquear el mutex
     std::lock_guard<std::mutex> lock(mtx_);
-    
-    // 4. Modificar el vector
-    entries_.push_back(new_entry);
-    
-    // 5. El mutex se desbloquea automáticamente
+
+    const uint32_t userId = users_.intern(user);
+    if (userId >= userLive_.size()) {
+        userLive_.resize(userId + 1, 0);
+    }
+    const uint32_t serviceId = services_.intern(service);
+
+    if (!active_ || active_->count.load(std::memory_order_relaxed) == segmentSize_) {
+        rollSegment();
+    }
+    // Escribir el lugar libre y recién entonces publicarlo
+    const size_t slot = active_->count.load(std::memory_order_relaxed);
+    StoredEntry& entry = active_->entries[slot];
+    entry.epoch = epoch;
+    entry.user = userId;
+    entry.service = serviceId;
+    entry.was_error = is_error;
+    entry.details = details;
+    active_->count.store(slot + 1, std::memory_order_release);
+
+    ++userLive_[userId];
+    size_.store(size_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    stats_.record(userId, user, serviceId, service, epoch, is_error);
+
+    if (store_) {
+        CommandEntry pending;
+        pending.id = nextId_;
+        pending.epoch = epoch;
+        pending.username = user;
+        pending.service_name = service;
+        pending.details = details;
+        pending.was_error = is_error;
+        store_->encolar(std::move(pending));
+    }
+    ++nextId_;
 }
 
+/**
+ * @brief Convierte usuario y servicio del filtro a ids. false si alguno no
+ * existe (no hay entradas que lo cumplan).
+ */
+bool CommandHistory::resolve(const HistoryFilter& filter, std::optional<ResolvedFilter>& out) const {
+    out.emplace(ResolvedFilter{filter, std::nullopt, std::nullopt});
+    uint32_t id;
+    if (!filter.username.empty()) {
+        if (!users_.find(filter.username, id)) return false;
+        out->user = id;
+    }
+    if (!filter.service_name.empty()) {
+        if (!services_.find(filter.service_name, id)) return false;
+        out->service = id;
+    }
+    return true;
+}
+
+bool CommandHistory::matches(const Snapshot& snap, uint64_t id, const StoredEntry& entry,
+                             const ResolvedFilter& resolved) {
+    const HistoryFilter& filter = resolved.filter;
+    const auto& hidden = *snap.hiddenBefore;
+    if (entry.user < hidden.size() && id < hidden[entry.user]) return false;
+    if (resolved.user && entry.user != *resolved.user) return false;
+    if (resolved.service && entry.service != *resolved.service) return false;
+    if (filter.was_error.has_value() && entry.was_error != *filter.was_error) return false;
+    if (filter.from_epoch.has_value() && entry.epoch < *filter.from_epoch) return false;
+    return !(filter.to_epoch.has_value() && entry.epoch > *filter.to_epoch);
+}
 
 /**
- * @brief Obtiene una copia de todas las entradas de un usuario específico.
+ * @brief Recorre una instantánea sin lock. En los segmentos sellados, con
+ * filtro de usuario, visita solo las posiciones de ese usuario.
  */
-std::vector<CommandEntry> CommandHistory::getEntriesForUser(const std::string& username) const {
-    
-    std::vector<CommandEntry> user_entries; // Lista de resultado
+template <typename Fn>
+void CommandHistory::forEachMatch(const Snapshot& snap, const ResolvedFilter& filter, uint64_t lo, uint64_t hi,
+                                  bool newestFirst, Fn&& fn) const {
+    const size_t segments = snap.segments.size();
+    for (size_t k = 0; k < segments; ++k) {
+        const Segment& segment = *snap.segments[newestFirst ? segments - 1 - k : k];
+        const bool sealed = &segment != snap.segments.back().get();
 
-    // 1. Bloquear el mutex antes de LEER el vector
-    // Usamos 'const_cast' si es necesario o 'mutable' en el .h (que ya hicimos)
-    std::lock_guard<std::mutex> lock(mtx_);
-    
-    // 2. Recorrer la lista y copiar solo las entradas del usuario
-    for (const auto& entry : entries_) {
-        if (entry.username == username) {
-            user_entries.push_back(entry);
+        // Rango de posiciones del segmento dentro de (lo, hi]
+        const size_t count = segment.count.load(std::memory_order_acquire);
+        const uint64_t first = segment.firstId;
+        const size_t begin = lo >= first ? static_cast<size_t>(std::min<uint64_t>(lo - first + 1, count)) : 0;
+        const size_t end = hi >= first ? static_cast<size_t>(std::min<uint64_t>(hi - first + 1, count)) : 0;
+        // Los segmentos están en orden de id: cortar al pasar el rango
+        if (!newestFirst && first > hi) break;
+        if (newestFirst && count > 0 && first + count - 1 <= lo) break;
+        if (begin >= end) continue;
+
+        auto visit = [&](size_t pos) {
+            const StoredEntry& entry = segment.entries[pos];
+            const uint64_t id = first + pos;
+            return !matches(snap, id, entry, filter) || fn(id, entry);
+        };
+
+        if (filter.user && sealed) {
+            auto it = segment.byUser.find(*filter.user);
+            if (it == segment.byUser.end()) continue;
+            const auto& positions = it->second;
+            auto from = std::lower_bound(positions.begin(), positions.end(), begin);
+            auto to = std::lower_bound(from, positions.end(), end);
+            if (newestFirst) {
+                for (auto p = to; p != from; --p) if (!visit(*(p - 1))) return;
+            } else {
+                for (auto p = from; p != to; ++p) if (!visit(*p)) return;
+            }
+        } else if (newestFirst) {
+            for (size_t pos = end; pos > begin; --pos) if (!visit(pos - 1)) return;
+        } else {
+            for (size_t pos = begin; pos < end; ++pos) if (!visit(pos)) return;
         }
     }
-    
-    // 3. El mutex se desbloquea.
-    
-    return user_entries; // Devolvemos la copia
+}
+
+void CommandHistory::collect(const HistoryFilter& filter, uint64_t lo, uint64_t hi, size_t limit,
+                             bool newestFirst, std::vector<CommandEntry>& out) const {
+    if (limit == 0 || lo >= hi) return;
+    std::optional<ResolvedFilter> resolved;
+    if (!resolve(filter, resolved)) return;
+
+    const auto snap = acquireSnapshot();
+    size_t taken = 0;
+    forEachMatch(*snap, *resolved, lo, hi, newestFirst, [&](uint64_t id, const StoredEntry& entry) {
+        out.push_back(materialize(id, entry));
+        return ++taken < limit;
+    });
+}
+
+/**
+ * @brief Entradas que cumplen el filtro: de SQLite si hay almacén (más lo
+ * que todavía no se confirmó, desde memoria) o solo de memoria.
+ */
+std::vector<CommandEntry> CommandHistory::getEntries(const HistoryFilter& filter) const {
+    return getPage(filter, 0, 0).entries;
+}
+
+/**
+ * @brief Página por id. Con almacén, lo confirmado (id <= ultimoConfirmado)
+ * sale de la base y lo posterior de memoria; se pide una entrada de más
+ * para saber si hay otra página.
+ */
+HistoryPage CommandHistory::getPage(const HistoryFilter& filter, uint64_t cursor, size_t limit,
+                                    bool newestFirst) const {
+    constexpr uint64_t NO_LIMIT = std::numeric_limits<uint64_t>::max();
+    const size_t wanted = limit ? limit + 1 : std::numeric_limits<size_t>::max();
+    const uint64_t watermark = store_ ? store_->ultimoConfirmado() : 0;
+
+    HistoryPage page;
+    std::vector<CommandEntry>& out = page.entries;
+    if (!newestFirst) {
+        // (cursor, watermark] de la base; después (watermark, ∞) de memoria
+        if (store_ && cursor < watermark) {
+            out = store_->consultar(filter, cursor, watermark, wanted, false);
+        }
+        if (out.size() < wanted) {
+            collect(filter, std::max(cursor, watermark), NO_LIMIT, wanted - out.size(), false, out);
+        }
+    } else {
+        // Primero lo más nuevo (memoria), después la base
+        const uint64_t hi = cursor ? cursor - 1 : NO_LIMIT;
+        collect(filter, watermark, hi, wanted, true, out);
+        if (store_ && out.size() < wanted && watermark > 0) {
+            auto older = store_->consultar(filter, 0, std::min(hi, watermark), wanted - out.size(), true);
+            out.insert(out.end(), std::make_move_iterator(older.begin()), std::make_move_iterator(older.end()));
+        }
+    }
+
+    if (limit && out.size() > limit) {
+        out.resize(limit);
+        page.next_cursor = out.back().id;
+    }
+    return page;
+}
+
+HistoryTotals CommandHistory::countEntries(const HistoryFilter& filter) const {
+    HistoryTotals totals;
+    uint64_t watermark = 0;
+    if (store_) {
+        watermark = store_->ultimoConfirmado();
+        totals = store_->contar(filter, watermark);
+    }
+
+    std::optional<ResolvedFilter> resolved;
+    if (!resolve(filter, resolved)) return totals;
+    const auto snap = acquireSnapshot();
+    forEachMatch(*snap, *resolved, watermark, std::numeric_limits<uint64_t>::max(), false,
+                 [&](uint64_t, const StoredEntry& entry) {
+        ++totals.commands;
+        if (entry.was_error) ++totals.errors;
+        return true;
+    });
+    return totals;
+}
+
+
+/**
+ * @brief Obtiene una copia de todas las entradas de un usuario específico.
+ * En los segmentos sellados recorre solo las posiciones de ese usuario.
+ */
+std::vector<CommandEntry> CommandHistory::getEntriesForUser(const std::string& username) const {
+    HistoryFilter filter;
+    filter.username = username;
+    return getEntries(filter);
 }
 
 
@@ -85,40 +415,54 @@ std::vector<CommandEntry> CommandHistory::getEntriesForUser(const std::string& u
  * @brief Obtiene una copia de TODAS las entradas (para el admin).
  */
 std::vector<CommandEntry> CommandHistory::getAllEntries() const {
-    // 1. Bloquear
-    std::lock_guard<std::mutex> lock(mtx_);
-    
-    // 2. Devolver una copia del vector completo
-    // Esto es seguro porque 'entries_' no se modificará mientras lo copiamos.
-    return entries_; 
-    
-    // 3. Desbloquear (automático)
+    return getEntries(HistoryFilter{});
 }
 
 
 /**
  * @brief Limpia el historial de un usuario.
+ * Oculta sus entradas hasta el id actual (el lugar se libera al descartar
+ * el segmento); los lectores con una instantánea previa todavía las ven.
  */
 void CommandHistory::clearUserHistory(const std::string& username) {
-    
-    // 1. Bloquear
+    if (store_) {
+        // Primero lo pendiente, para que el DELETE también lo alcance
+        store_->vaciar();
+        store_->borrarUsuario(username);
+    }
+
     std::lock_guard<std::mutex> lock(mtx_);
-    
-    // 2. Usar el patrón "erase-remove idiom" de C++ para borrar elementos
-    // entries_.erase(
-    //     std::remove_if(entries_.begin(), entries_.end(), 
-    //                    [&username](const CommandEntry& e) { return e.username == username; }),
-    //     entries_.end()
-    // );
-    
-    // O una forma más simple de entender (pero potencialmente menos eficiente):
-    std::vector<CommandEntry> new_entries;
-    for (const auto& entry : entries_) {
-        if (entry.username != username) {
-            new_entries.push_back(entry);
-        }
+    uint32_t userId;
+    if (!users_.find(username, userId)) {
+        return;
+    }
+    if (userId >= hiddenBefore_.size()) {
+        hiddenBefore_.resize(userId + 1, 0);
+    }
+    if (userId >= userLive_.size()) {
+        userLive_.resize(userId + 1, 0);    // Solo conocido por las estadísticas cargadas
+    }
+    hiddenBefore_[userId] = nextId_;
+    size_.store(size_.load(std::memory_order_relaxed) - userLive_[userId], std::memory_order_relaxed);
+    userLive_[userId] = 0;
+
+    auto next = std::make_shared<Snapshot>(*current_);
+    next->hiddenBefore = std::make_shared<const std::vector<uint64_t>>(hiddenBefore_);
+    publish(std::move(next));
+}
+
+HistoryStatsSnapshot CommandHistory::getStats() const {
+    const int64_t now = std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    return stats_.snapshot(now);
+}
+
+void CommandHistory::flush() {
+    if (store_) {
+        store_->vaciar();
     }
-    entries_ = new_entries; // Reemplazamos el vector
-    
-    // 3. Desbloquear (automático)
-}
\ No newline at end of file
+}
+
+size_t CommandHistory::size() const {
+    return size_.load(std::memory_order_relaxed);
+}
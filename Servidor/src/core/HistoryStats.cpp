@@ -0,0 +1,178 @@
+#include "core/HistoryStats.h"
+
+#include <algorithm>
+
+namespace {
+
+// Un solo escritor: load + store alcanza y evita el RMW con lock del bus
+inline void bump(std::atomic<uint64_t>& counter, uint64_t n) {
+    counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+} // namespace
+
+//
+// ===== TABLA DE CONTADORES POR NOMBRE =====
+//
+
+HistoryStats::CounterTable::~CounterTable() {
+    for (auto& chunk : chunks_) {
+        delete[] chunk.load(std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Slot del id (lo crea y publica si es el siguiente). nullptr si el
+ * id no es consecutivo o la tabla está llena: se cuenta solo en el total.
+ */
+HistoryStats::NamedCounter* HistoryStats::CounterTable::get(uint32_t id, const std::string& name) {
+    const uint32_t published = published_.load(std::memory_order_relaxed);
+    if (id > published || id >= CHUNK * MAX_CHUNKS) {
+        return nullptr;
+    }
+
+    NamedCounter* chunk = chunks_[id / CHUNK].load(std::memory_order_relaxed);
+    if (id < published) {
+        return &chunk[id % CHUNK];
+    }
+
+    if (!chunk) {
+        chunk = new NamedCounter[CHUNK];
+        chunks_[id / CHUNK].store(chunk, std::memory_order_release);
+    }
+    NamedCounter* slot = &chunk[id % CHUNK];
+    slot->name = name;
+    published_.store(id + 1, std::memory_order_release);
+    return slot;
+}
+
+void HistoryStats::CounterTable::read(std::vector<std::pair<std::string, StatsCounter>>& out) const {
+    const uint32_t published = published_.load(std::memory_order_acquire);
+    out.reserve(published);
+    for (uint32_t id = 0; id < published; ++id) {
+        const NamedCounter& slot = chunks_[id / CHUNK].load(std::memory_order_acquire)[id % CHUNK];
+        StatsCounter counter;
+        counter.commands = slot.commands.load(std::memory_order_relaxed);
+        counter.errors = slot.errors.load(std::memory_order_relaxed);
+        out.emplace_back(slot.name, counter);
+    }
+}
+
+//
+// ===== BALDES DE TIEMPO =====
+//
+
+/**
+ * @brief Suma al balde de [epoch/width*width, +width). El slot del anillo
+ * se reinicia al pasar a un balde nuevo; start = -1 mientras tanto para que
+ * un lector no mezcle contadores de dos baldes (seqlock).
+ */
+template <size_t N>
+void HistoryStats::addToBucket(std::array<Bucket, N>& ring, int64_t width,
+                               int64_t epoch, uint64_t commands, uint64_t errors) {
+    if (epoch < 0) return;
+    const int64_t start = epoch / width * width;
+    Bucket& bucket = ring[static_cast<size_t>(start / width) % N];
+
+    const int64_t current = bucket.start.load(std::memory_order_relaxed);
+    if (current == start) {
+        bump(bucket.commands, commands);
+        bump(bucket.errors, errors);
+        return;
+    }
+    if (current > start) {
+        return;     // El slot ya es de un balde más nuevo: este quedó fuera de la ventana
+    }
+
+    bucket.start.store(-1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    bucket.commands.store(commands, std::memory_order_relaxed);
+    bucket.errors.store(errors, std::memory_order_relaxed);
+    bucket.start.store(start, std::memory_order_release);
+}
+
+template <size_t N>
+void HistoryStats::readBuckets(const std::array<Bucket, N>& ring, int64_t width,
+                               int64_t now, std::vector<StatsBucket>& out) {
+    const int64_t newest = now / width * width;
+    const int64_t oldest = newest - static_cast<int64_t>(N - 1) * width;
+
+    for (const Bucket& bucket : ring) {
+        // Reintentar si el escritor reinició el slot mientras se leía
+        for (int attempt = 0; attempt < 4; ++attempt) {
+            const int64_t start = bucket.start.load(std::memory_order_acquire);
+            if (start < 0) break;
+            StatsBucket copy;
+            copy.start = start;
+            copy.commands = bucket.commands.load(std::memory_order_relaxed);
+            copy.errors = bucket.errors.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (bucket.start.load(std::memory_order_relaxed) != start) continue;
+
+            if (start >= oldest && start <= newest && copy.commands > 0) {
+                out.push_back(copy);
+            }
+            break;
+        }
+    }
+    std::sort(out.begin(), out.end(),
+              [](const StatsBucket& a, const StatsBucket& b) { return a.start < b.start; });
+}
+
+//
+// ===== ESTADÍSTICAS =====
+//
+
+HistoryStats::HistoryStats() = default;
+HistoryStats::~HistoryStats() = default;
+
+void HistoryStats::record(uint32_t user, const std::string& userName,
+                          uint32_t service, const std::string& serviceName,
+                          int64_t epoch, bool isError) {
+    const uint64_t errors = isError ? 1 : 0;
+    addUser(user, userName, 1, errors);
+    addService(service, serviceName, 1, errors);
+    addMinute(epoch, 1, errors);
+    addHour(epoch, 1, errors);
+}
+
+void HistoryStats::addUser(uint32_t id, const std::string& name, uint64_t commands, uint64_t errors) {
+    bump(commands_, commands);
+    bump(errors_, errors);
+    if (NamedCounter* slot = users_.get(id, name)) {
+        bump(slot->commands, commands);
+        bump(slot->errors, errors);
+    }
+}
+
+void HistoryStats::addService(uint32_t id, const std::string& name, uint64_t commands, uint64_t errors) {
+    if (NamedCounter* slot = services_.get(id, name)) {
+        bump(slot->commands, commands);
+        bump(slot->errors, errors);
+    }
+}
+
+void HistoryStats::addMinute(int64_t epoch, uint64_t commands, uint64_t errors) {
+    addToBucket(minutes_, 60, epoch, commands, errors);
+}
+
+void HistoryStats::addHour(int64_t epoch, uint64_t commands, uint64_t errors) {
+    addToBucket(hours_, 3600, epoch, commands, errors);
+}
+
+StatsCounter HistoryStats::total() const {
+    StatsCounter counter;
+    counter.commands = commands_.load(std::memory_order_relaxed);
+    counter.errors = errors_.load(std::memory_order_relaxed);
+    return counter;
+}
+
+HistoryStatsSnapshot HistoryStats::snapshot(int64_t now) const {
+    HistoryStatsSnapshot snap;
+    snap.total = total();
+    users_.read(snap.byUser);
+    services_.read(snap.byService);
+    readBuckets(minutes_, 60, now, snap.byMinute);
+    readBuckets(hours_, 3600, now, snap.byHour);
+    return snap;
+}
@@ -1,9 +1,32 @@
 #include "core/Servidor.h"
+#include "storage/CommandHistorySqlite.h"
 
 // CONSTRUCTOR
 Servidor::Servidor(const ServidorConfig& config) 
     : config_(config)
-    , logger_(LogLevel::INFO, config_.logEnConsola, config_.archivoLog) {
+    , logger_(LogLevel::INFO, config_.logEnConsola, config_.archivoLog, config_.archivoAuditLog) {
+    if (config_.logIntervaloFsyncMs < 0) {
+        logger_.setFsyncPolicy(AsyncLogWriter::FsyncPolicy::NEVER);
+    } else if (config_.logIntervaloFsyncMs == 0) {
+        logger_.setFsyncPolicy(AsyncLogWriter::FsyncPolicy::PER_BATCH);
+    } else {
+        logger_.setFsyncPolicy(AsyncLogWriter::FsyncPolicy::INTERVAL,
+                               std::chrono::milliseconds(config_.logIntervaloFsyncMs));
+    }
+    if (config_.logDescartarSiLleno) {
+        logger_.setOverflowPolicy(AsyncLogWriter::OverflowPolicy::DROP);
+    }
+
+    RotationPolicy rotacion;
+    rotacion.maxBytes = config_.logRotarMaxBytes;
+    rotacion.daily = config_.logRotarDiario;
+    rotacion.maxSegments = config_.logSegmentosMax;
+    rotacion.maxTotalBytes = config_.logSegmentosMaxBytes;
+    logger_.setRotation(rotacion);
+
+    if (!config_.archivoLogBinario.empty()) {
+        logger_.enableBinaryLog(config_.archivoLogBinario);
+    }
 }
 
 Servidor::~Servidor() {
@@ -18,7 +41,7 @@ bool Servidor::inicializar(){
         logger_.info("===== INICIALIZANDO SERVIDOR =====");
         
         //instancia del historial
-        commandHistory_ = std::make_shared<CommandHistory>(logger_);
+        commandHistory_ = std::make_shared<CommandHistory>(logger_, config_.historialCapacidad);
         logger_.info("✅ Historial de Comandos inicializado");
 
         // Instancia del lector de log CSV
@@ -81,6 +104,17 @@ bool Servidor::inicializarBaseDeDatos() {
             return false;
         }
 
+        // Historial persistente en la misma base (si falla, queda solo en memoria)
+        if (config_.historialPersistente) {
+            try {
+                commandHistory_->attachStore(
+                    std::make_unique<CommandHistorySqlite>(config_.rutaBaseDatos));
+                logger_.info("✅ Historial de Comandos persistente en {}", config_.rutaBaseDatos);
+            } catch (const std::exception& e) {
+                logger_.warning("Historial solo en memoria: {}", e.what());
+            }
+        }
+
         logger_.info("✅ Base de datos inicializada correctamente");
         return true;
     } catch (const std::exception& e) {
@@ -97,12 +131,18 @@ bool Servidor::inicializarServiciosRobot() {
             config_.puertoSerial, 
             config_.baudrate
         );
+        arduinoService_->setProtocoloConChecksum(config_.protocoloConChecksum);
         logger_.info("✅ ArduinoService inicializado correctamente");
         
         robotService_ = std::make_shared<RobotService>(
             arduinoService_, 
             logger_,
-            config_.directorioTrayectorias
+            config_.directorioTrayectorias,
+            auth_wiring().db   // catálogo de trayectorias en la misma base
+        );
+        robotService_->configurarGrabacion(
+            config_.grabacionUmbralVolcadoBytes,
+            std::chrono::milliseconds(config_.grabacionIntervaloVolcadoMs)
         );
         logger_.info("✅ RobotService inicializado correctamente");
         
@@ -233,6 +273,9 @@ void Servidor::registrarMetodosRobot() {
     mRobotGetReport_ = std::make_unique<robot_service_methods::RobotGetReportMethod>(
     servidorRpc_.get(), *sessionManager_, logger_, *commandHistory_
     );
+    mRobotGetStats_ = std::make_unique<robot_service_methods::RobotGetStatsMethod>(
+        servidorRpc_.get(), *sessionManager_, logger_, *commandHistory_
+    );
     mRobotStartRecording_ = std::make_unique<robot_service_methods::RobotStartRecordingMethod>(
         servidorRpc_.get(), *sessionManager_, logger_, *robotService_
     );
@@ -242,9 +285,15 @@ void Servidor::registrarMetodosRobot() {
     mRobotRunFile_ = std::make_unique<robot_service_methods::RobotRunFileMethod>(
         servidorRpc_.get(), *sessionManager_, logger_, *robotService_
     );
+    mRobotResumeFile_ = std::make_unique<robot_service_methods::RobotResumeFileMethod>(
+        servidorRpc_.get(), *sessionManager_, logger_, *robotService_
+    );
     mRobotUploadFile_ = std::make_unique<robot_service_methods::RobotUploadFileMethod>(
         servidorRpc_.get(), *sessionManager_, logger_, *robotService_
     );
+    mRobotOptimizeFile_ = std::make_unique<robot_service_methods::RobotOptimizeFileMethod>(
+        servidorRpc_.get(), *sessionManager_, logger_, *robotService_
+    );
     mRobotListFiles_ = std::make_unique<robot_service_methods::RobotListFilesMethod>(
         servidorRpc_.get(), *sessionManager_, logger_, *robotService_
     );
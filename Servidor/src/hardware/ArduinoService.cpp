@@ -1,5 +1,7 @@
 #include "hardware/ArduinoService.h"
 
+#include <cstdlib>
+
 ArduinoService::ArduinoService(const std::string& puerto, int baudrate)
     : serialCom(std::make_unique<SerialCom>(puerto, baudrate)),
       conectado(false),
@@ -23,6 +25,13 @@ bool ArduinoService::conectar(int maxReintentos) {
             limpiarBuffer();
 
             conectado = true;
+
+            // El firmware arranca esperando la línea 1 tras un reinicio, pero
+            // si no se reinició (USB nativo) hay que fijarla explícitamente
+            if (protocoloConChecksum && !sincronizarNumeroLinea(0)) {
+                desconectar();
+                continue;
+            }
             
             // Testear conexion con comando simple
             if (verificarConexion()) {
@@ -58,7 +67,7 @@ bool ArduinoService::estaConectado() const {
 bool ArduinoService::verificarConexion() {
     try {
         // Enviar comando de verificación (depende de tu firmware)
-        std::string respuesta = enviarComando("M114"); // Obtener POSICION/ESTADO
+        std::string respuesta = enviarComando("M114\r\n"); // Obtener POSICION/ESTADO
         return !respuesta.empty() && respuesta.find("error") == std::string::npos;
     } catch (...) {
         return false;
@@ -73,6 +82,15 @@ std::string ArduinoService::enviarComando(const std::string& comando,
         throw std::runtime_error("Arduino no conectado");
     }
 
+    // Usamos timeout personalizado si se especifico, si no el default
+    int timeoutMs = timeoutPersonalizado.count() > 0 ? 
+                   static_cast<int>(timeoutPersonalizado.count()) : 
+                   static_cast<int>(timeoutRespuesta.count());
+
+    if (protocoloConChecksum && comando.find_first_not_of(" \t\r\n") != std::string::npos) {
+        return enviarComandoEnmarcado(comando, timeoutMs);
+    }
+
     if (!serialCom->sendCommand(comando)) {
         throw std::runtime_error("Error enviando comando: " + comando);
     }
@@ -80,17 +98,119 @@ std::string ArduinoService::enviarComando(const std::string& comando,
     // Pequeña espera para procesamiento del Arduino
     std::this_thread::sleep_for(std::chrono::milliseconds(200));
     
-    // Usamos timeout personalizado si se especifico, si no el default
-    int timeoutMs = timeoutPersonalizado.count() > 0 ? 
-                   static_cast<int>(timeoutPersonalizado.count()) : 
-                   static_cast<int>(timeoutRespuesta.count());
-
     // Leer Respuesta
     std::string respuesta = serialCom->readResponse(timeoutMs);
 
     return respuesta;
 }
 
+// Posición de la última línea de la respuesta que empieza por el prefijo
+static size_t ultimaLineaConPrefijo(const std::string& respuesta, const std::string& prefijo) {
+    size_t pos = respuesta.rfind(prefijo);
+    while (pos != std::string::npos && pos != 0 && respuesta[pos - 1] != '\n') {
+        pos = respuesta.rfind(prefijo, pos - 1);
+    }
+    return pos;
+}
+
+// Con número de línea y checksum cada línea recibe exactamente un "OK" o un
+// "RS <linea>", así que no hace falta la espera fija: se lee hasta esa línea.
+// "RS" pide la primera línea que le falta al firmware: si es anterior a la
+// actual se reenvían desde el historial todas las que van de ella a la actual.
+// Sin respuesta no hay confirmación: se reenvía la misma trama (si ya había
+// llegado el firmware la toma como duplicada y solo responde "OK").
+std::string ArduinoService::enviarComandoEnmarcado(const std::string& comando, int timeoutMs) {
+    const long linea = numeroLinea + 1;
+    const std::string trama = SerialCom::frameLine(linea, comando);
+
+    long enviada = linea;
+    int fallos = 0;
+    while (true) {
+        const std::string& tramaEnviada = enviada == linea ? trama : tramaDelHistorial(enviada);
+        if (!serialCom->sendCommand(tramaEnviada)) {
+            throw std::runtime_error("Error enviando comando: " + comando);
+        }
+
+        std::string respuesta = serialCom->readUntil({"OK", "RS "}, timeoutMs);
+
+        size_t posReenvio = ultimaLineaConPrefijo(respuesta, "RS ");
+        if (posReenvio == std::string::npos) {
+            if (ultimaLineaConPrefijo(respuesta, "OK") == std::string::npos) {
+                // Timeout: la trama o su "OK" se perdieron
+                if (++fallos > maxReenvios) {
+                    throw std::runtime_error("El Arduino no respondió tras " +
+                                             std::to_string(maxReenvios) + " reenvíos: " + comando);
+                }
+                ++reenvios;
+                continue;
+            }
+            if (enviada == linea) {
+                numeroLinea = linea;
+                guardarEnHistorial(linea, trama);
+                return respuesta;
+            }
+            ++enviada;  // Línea perdida recuperada: seguir hacia la actual
+            continue;
+        }
+
+        ++reenvios;
+        if (++fallos > maxReenvios) {
+            break;
+        }
+
+        long pedida = std::atol(respuesta.c_str() + posReenvio + 3);
+        if (pedida == linea) {
+            enviada = linea;  // Trama actual dañada: se repite
+            continue;
+        }
+        if (pedida < linea) {
+            if (historialTramas.empty() || pedida < historialTramas.front().first) {
+                throw std::runtime_error("El Arduino pidió la línea " + std::to_string(pedida) +
+                                         ", que ya no está en el historial de reenvío");
+            }
+            enviada = pedida;
+            continue;
+        }
+        // El firmware va por delante (numeración de otra sesión): resincronizar
+        if (!sincronizarNumeroLinea(linea - 1)) {
+            break;
+        }
+        enviada = linea;
+    }
+
+    throw std::runtime_error("El Arduino rechazó el comando tras " +
+                             std::to_string(maxReenvios) + " reenvíos: " + comando);
+}
+
+void ArduinoService::guardarEnHistorial(long linea, const std::string& trama) {
+    historialTramas.emplace_back(linea, trama);
+    if (historialTramas.size() > MAX_HISTORIAL_TRAMAS) {
+        historialTramas.pop_front();
+    }
+}
+
+const std::string& ArduinoService::tramaDelHistorial(long linea) const {
+    // Las líneas del historial son consecutivas
+    return historialTramas[static_cast<size_t>(linea - historialTramas.front().first)].second;
+}
+
+// M110: el firmware toma el número de esta línea como el último recibido
+bool ArduinoService::sincronizarNumeroLinea(long numero) {
+    for (int intento = 0; intento <= maxReenvios; ++intento) {
+        if (!serialCom->sendCommand(SerialCom::frameLine(numero, "M110"))) {
+            return false;
+        }
+        std::string respuesta = serialCom->readUntil({"OK", "RS "}, static_cast<int>(timeoutRespuesta.count()));
+        if (respuesta.find("OK") != std::string::npos) {
+            numeroLinea = numero;
+            historialTramas.clear();  // Las tramas anteriores ya no son reenviables
+            return true;
+        }
+        ++reenvios;
+    }
+    return false;
+}
+
 void ArduinoService::limpiarBuffer() {
     if (conectado) {
         // Leer rápidamente cualquier dato residual
@@ -115,3 +235,19 @@ void ArduinoService::setTimeoutEstabilizacion(std::chrono::milliseconds timeout)
 void ArduinoService::setTimeoutRespuesta(std::chrono::milliseconds timeout) {
     timeoutRespuesta = timeout;
 }
+
+void ArduinoService::setProtocoloConChecksum(bool activo) {
+    protocoloConChecksum = activo;
+}
+
+void ArduinoService::setMaxReenvios(int maximo) {
+    maxReenvios = maximo;
+}
+
+bool ArduinoService::getProtocoloConChecksum() const {
+    return protocoloConChecksum;
+}
+
+size_t ArduinoService::getReenvios() const {
+    return reenvios;
+}
@@ -0,0 +1,204 @@
+#include "hardware/FirmwareLog.h"
+
+#include <cctype>
+#include <cstdio>
+
+namespace {
+
+    const std::string_view PREFIX_INFO = "INFO:";
+    const std::string_view PREFIX_ERROR = "ERROR:";
+    const std::string_view SUFFIX_OK = "OK";
+
+    struct CodigoFirmware {
+        int codigo;
+        const char* plantilla;
+    };
+
+    // Copia de robotArm_v0.62sim/logCodes.h (mantener ambas sincronizadas)
+    const CodigoFirmware TABLA_CODIGOS[] = {
+        // INFO
+        { 1, "ROBOT ONLINE" },
+        { 2, "SEND G28 TO CALIBRATE" },
+        { 3, "ROTATE ROBOT TO FACE FRONT CENTRE & SEND G28 TO CALIBRATE" },
+        { 4, "HOME ROBOT MANUALLY & SEND G28 TO CALIBRATE" },
+        { 5, "HOMING COMPLETE" },
+        { 6, "GRIPPER ON" },
+        { 7, "GRIPPER OFF" },
+        { 8, "GRIPPER STOPPED" },
+        { 9, "QUICK STOP" },
+        { 10, "MOTORS ENABLED" },
+        { 11, "MOTORS DISABLED" },
+        { 12, "FAN ENABLED" },
+        { 13, "FAN DISABLED" },
+        { 14, "RELATIVE MODE" },
+        { 15, "ABSOLUTE MODE" },
+        { 16, "RELATIVE MODE ON" },
+        { 17, "ABSOLUTE MODE ON" },
+        { 20, "LINEAR MOVE: [X:% Y:% Z:% E:%]" },
+        { 21, "CW ARC MOVE: [X:% Y:% Z:% I:% J:%]" },
+        { 22, "CCW ARC MOVE: [X:% Y:% Z:% I:% J:%]" },
+        { 23, "CURRENT POSITION: [X:% Y:% Z:% E:%]" },
+        { 24, "POSITION OFFSET: [X:% Y:% Z:% E:%]" },
+        { 25, "ENDSTOP: [X:# Y:# Z:#]" },
+        // ERROR
+        { 50, "COMMAND NOT RECOGNIZED" },
+        { 51, "POINT IS OUTSIDE OF WORKSPACE" },
+        { 52, "ARC WITHOUT CENTER (I/J)" },
+        { 53, "ROBOT FAILURE" },
+        { 54, "SPEED DELAY NOT IMPLEMENTED" },
+        { 55, "PUMP ENABLED NOT IMPLEMENTED" },
+        { 56, "PUMP DISABLED NOT IMPLEMENTED" },
+        { 57, "LASER ENABLED NOT IMPLEMENTED" },
+        { 58, "LASER DISABLED NOT IMPLEMENTED" },
+        { 59, "COMMAND ABORTED BY QUICK STOP" },
+        { 60, "QUEUE FULL, COMMAND DROPPED" },
+    };
+
+    std::string_view recortar(std::string_view texto) {
+        const char* espacios = " \t\r\n";
+        size_t inicio = texto.find_first_not_of(espacios);
+        if (inicio == std::string_view::npos) return {};
+        size_t fin = texto.find_last_not_of(espacios);
+        return texto.substr(inicio, fin - inicio + 1);
+    }
+
+    bool empiezaCon(std::string_view texto, std::string_view prefijo) {
+        return texto.substr(0, prefijo.size()) == prefijo;
+    }
+
+    // "I20 1.50 -2.00 ..." / "E51" / "D3 ..."
+    bool esCompacta(std::string_view linea) {
+        return linea.size() >= 2
+            && (linea[0] == 'I' || linea[0] == 'E' || linea[0] == 'D')
+            && std::isdigit(static_cast<unsigned char>(linea[1]));
+    }
+
+    std::string decodificarCompacta(std::string_view linea) {
+        size_t pos = 1;
+        int codigo = 0;
+        while (pos < linea.size() && std::isdigit(static_cast<unsigned char>(linea[pos]))) {
+            codigo = codigo * 10 + (linea[pos] - '0');
+            ++pos;
+        }
+
+        std::vector<std::string_view> valores;
+        while (pos < linea.size()) {
+            size_t inicio = linea.find_first_not_of(' ', pos);
+            if (inicio == std::string_view::npos) break;
+            size_t fin = linea.find(' ', inicio);
+            if (fin == std::string_view::npos) fin = linea.size();
+            valores.push_back(linea.substr(inicio, fin - inicio));
+            pos = fin;
+        }
+        return FirmwareLog::decodificar(codigo, valores);
+    }
+
+}
+
+const char* FirmwareLog::plantilla(int codigo) {
+    for (const auto& entrada : TABLA_CODIGOS) {
+        if (entrada.codigo == codigo) return entrada.plantilla;
+    }
+    return nullptr;
+}
+
+std::string FirmwareLog::decodificar(int codigo, const std::vector<std::string_view>& valores) {
+    const char* texto = plantilla(codigo);
+    std::string resultado;
+
+    if (texto == nullptr) {
+        // Código desconocido (firmware más nuevo): no perder la información
+        resultado = "MSG " + std::to_string(codigo);
+        for (auto valor : valores) {
+            resultado += ' ';
+            resultado += valor;
+        }
+        return resultado;
+    }
+
+    size_t siguiente = 0;
+    for (const char* c = texto; *c != '\0'; ++c) {
+        if (*c != '%' && *c != '#') {
+            resultado += *c;
+            continue;
+        }
+        if (siguiente >= valores.size()) continue;
+
+        std::string_view valor = valores[siguiente++];
+        if (*c == '#') {
+            // Entero: el firmware compacto envía todos los valores con decimales
+            valor = valor.substr(0, valor.find('.'));
+        }
+        resultado += valor;
+    }
+    return resultado;
+}
+
+RespuestaFirmware FirmwareLog::parsear(std::string_view respuesta) {
+    RespuestaFirmware resultado;
+
+    size_t pos = 0;
+    while (pos < respuesta.size()) {
+        size_t fin = respuesta.find('\n', pos);
+        if (fin == std::string_view::npos) fin = respuesta.size();
+        std::string_view linea = recortar(respuesta.substr(pos, fin - pos));
+        pos = fin + 1;
+
+        if (linea.empty()) continue;
+
+        if (linea == SUFFIX_OK) {
+            resultado.ok = true;
+            continue;
+        }
+
+        // Formato compacto
+        if (esCompacta(linea)) {
+            std::string mensaje = decodificarCompacta(linea);
+            if (linea[0] == 'E') {
+                resultado.tieneError = true;
+                resultado.mensajeError = mensaje;
+                resultado.lineasLog.push_back(mensaje);
+            } else if (linea[0] == 'I') {
+                resultado.lineasLog.push_back(mensaje);
+                resultado.mensajes.push_back(std::move(mensaje));
+            } else {
+                resultado.mensajes.push_back("DEBUG: " + mensaje);
+            }
+            continue;
+        }
+
+        // Formato de texto
+        if (empiezaCon(linea, PREFIX_INFO)) {
+            std::string mensaje(recortar(linea.substr(PREFIX_INFO.size())));
+            resultado.lineasLog.push_back(mensaje);
+            if (!mensaje.empty()) {
+                resultado.mensajes.push_back(std::move(mensaje));
+            }
+            continue;
+        }
+
+        if (empiezaCon(linea, PREFIX_ERROR)) {
+            std::string mensaje(recortar(linea.substr(PREFIX_ERROR.size())));
+            resultado.lineasLog.push_back(mensaje);
+            if (!mensaje.empty()) {
+                resultado.tieneError = true;
+                resultado.mensajeError = std::move(mensaje);
+            }
+            continue;
+        }
+
+        // Si no tiene prefijo conocido, asumir que es mensaje informativo
+        resultado.mensajes.emplace_back(linea);
+    }
+
+    return resultado;
+}
+
+bool FirmwareLog::posicionActual(const RespuestaFirmware& respuesta, double& x, double& y, double& z) {
+    for (const auto& mensaje : respuesta.mensajes) {
+        if (std::sscanf(mensaje.c_str(), "CURRENT POSITION: [X:%lf Y:%lf Z:%lf", &x, &y, &z) == 3) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -1,5 +1,26 @@
 #include "hardware/SerialCom.h"
 
+#include <chrono>
+#include <sys/ioctl.h>
+
+#ifdef __linux__
+// <asm/termbits.h> choca con <termios.h>: se declara solo lo necesario.
+// TCGETS2/TCSETS2 ya vienen de <sys/ioctl.h> y usan esta estructura.
+struct termios2 {
+    tcflag_t c_iflag;
+    tcflag_t c_oflag;
+    tcflag_t c_cflag;
+    tcflag_t c_lflag;
+    cc_t c_line;
+    cc_t c_cc[19];
+    speed_t c_ispeed;
+    speed_t c_ospeed;
+};
+#ifndef BOTHER
+#define BOTHER 0010000
+#endif
+#endif
+
 //
 // ===== CONSTRUCTOR Y DESTRUCTOR =====
 //
@@ -165,6 +186,100 @@ std::string SerialCom::readResponse(int timeoutMs) {
     return response;
 }
 
+std::string SerialCom::readUntil(const std::vector<std::string>& endPrefixes, int timeoutMs) {
+    if (!is_connected) {
+        return "";
+    }
+
+    std::string response;
+    size_t lineStart = 0;
+    char buffer[256];
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+
+    while (true) {
+        auto remaining = std::chrono::duration_cast<std::chrono::microseconds>(
+            deadline - std::chrono::steady_clock::now()).count();
+        if (remaining <= 0) {
+            break;
+        }
+
+        fd_set set;
+        FD_ZERO(&set);
+        FD_SET(fileDescriptor, &set);
+        struct timeval timeout;
+        timeout.tv_sec = remaining / 1000000;
+        timeout.tv_usec = remaining % 1000000;
+
+        int rv = select(fileDescriptor + 1, &set, NULL, NULL, &timeout);
+        if (rv == -1) {
+            std::cerr << "Error en select(): " << strerror(errno) << std::endl;
+            break;
+        } else if (rv == 0) {
+            break;
+        }
+
+        ssize_t bytesRead = read(fileDescriptor, buffer, sizeof(buffer));
+        if (bytesRead < 0) {
+            std::cerr << "Error reading from serial port: " << strerror(errno) << std::endl;
+            break;
+        }
+        if (bytesRead == 0) {
+            continue;
+        }
+        response.append(buffer, bytesRead);
+
+        // Revisar solo las lineas completas nuevas
+        size_t lineEnd;
+        while ((lineEnd = response.find('\n', lineStart)) != std::string::npos) {
+            std::string line = response.substr(lineStart, lineEnd - lineStart);
+            lineStart = lineEnd + 1;
+            for (const auto& prefix : endPrefixes) {
+                if (line.compare(0, prefix.size(), prefix) == 0) {
+                    return response;
+                }
+            }
+        }
+    }
+
+    return response;
+}
+
+//
+// ===== PROTOCOLO CON NUMERO DE LINEA Y CHECKSUM =====
+//
+
+uint8_t SerialCom::checksum(const std::string& data) {
+    uint8_t sum = 0;
+    for (char c : data) {
+        sum ^= static_cast<uint8_t>(c);
+    }
+    return sum;
+}
+
+std::string SerialCom::frameLine(long lineNumber, const std::string& command) {
+    size_t end = command.find_last_not_of(" \t\r\n");
+    std::string line = "N" + std::to_string(lineNumber) + " "
+                     + (end == std::string::npos ? std::string() : command.substr(0, end + 1));
+    return line + "*" + std::to_string(checksum(line)) + "\r\n";
+}
+
+bool SerialCom::isSupportedBaudrate(int baudrate) {
+    switch (baudrate) {
+        case 9600:
+        case 19200:
+        case 38400:
+        case 57600:
+        case 115200:
+        case 230400:
+        case 250000:
+        case 500000:
+        case 1000000:
+            return true;
+        default:
+            return false;
+    }
+}
+
 //
 // ===== GETTERS Y SETTERS =====
 //
@@ -192,20 +307,12 @@ bool SerialCom::setBaudrate(int newBaudrate) {
         return false;
     }
     // Validacion
-    switch(newBaudrate) {
-        case 9600:
-        case 19200:
-        case 38400:
-        case 57600:
-        case 115200:
-            baudrate = newBaudrate;
-            return true;
-        default:
-            std::cerr << "Baudrate " << newBaudrate << "No soportado." << std::endl;
-            return false;
+    if (!isSupportedBaudrate(newBaudrate)) {
+        std::cerr << "Baudrate " << newBaudrate << " No soportado." << std::endl;
+        return false;
     }
-    
-    
+    baudrate = newBaudrate;
+    return true;
 }
 
 
@@ -224,7 +331,9 @@ bool SerialCom::configureSerialPort() {
     }
 
     // Configurar velocidad de baudios
+    // Las velocidades altas se fijan despues con termios2 (B38400 provisorio)
     speed_t speed;
+    bool customSpeed = false;
     switch (baudrate) {
         case 9600: speed = B9600; break;
         case 19200: speed = B19200; break;
@@ -232,7 +341,12 @@ bool SerialCom::configureSerialPort() {
         case 57600: speed = B57600; break;
         case 115200: speed = B115200; break;
         default:
-            return false;
+            if (!isSupportedBaudrate(baudrate)) {
+                return false;
+            }
+            speed = B38400;
+            customSpeed = true;
+            break;
     }
     
     cfsetospeed(&tty, speed);
@@ -259,7 +373,37 @@ bool SerialCom::configureSerialPort() {
         return false;
     }
 
+    if (customSpeed && !configureCustomBaudrate()) {
+        return false;
+    }
+
     // Limpiar el buffer del puerto
     tcflush(fileDescriptor, TCIOFLUSH);
     return true;
-}
\ No newline at end of file
+}
+
+// Velocidad arbitraria con termios2 / BOTHER (230400, 250000, 500000, 1000000)
+bool SerialCom::configureCustomBaudrate() {
+#ifdef __linux__
+    struct termios2 tty2;
+    if (ioctl(fileDescriptor, TCGETS2, &tty2) != 0) {
+        std::cerr << "Error leyendo termios2: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    tty2.c_cflag &= ~CBAUD;
+    tty2.c_cflag |= BOTHER;
+    tty2.c_ispeed = baudrate;
+    tty2.c_ospeed = baudrate;
+
+    if (ioctl(fileDescriptor, TCSETS2, &tty2) != 0) {
+        std::cerr << "Error configurando " << baudrate << " baudios: "
+                  << strerror(errno) << std::endl;
+        return false;
+    }
+    return true;
+#else
+    std::cerr << "Baudrate " << baudrate << " requiere termios2 (solo Linux)" << std::endl;
+    return false;
+#endif
+}
@@ -0,0 +1,214 @@
+#include "robot_model/GCodeAnalyzer.h"
+
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+
+GCodeAnalyzer::GCodeAnalyzer() : x(HOME_X), y(HOME_Y), z(HOME_Z) {}
+
+bool GCodeAnalyzer::parsearLinea(std::string_view linea, LineaGCode& out) {
+    out = LineaGCode{};
+
+    size_t i = 0;
+    const size_t n = linea.size();
+    while (i < n) {
+        char c = linea[i];
+        if (c == ';') break;                       // comentario hasta fin de línea
+        if (c == '(') {                            // comentario entre paréntesis
+            size_t cierre = linea.find(')', i);
+            if (cierre == std::string_view::npos) break;
+            i = cierre + 1;
+            continue;
+        }
+        if (!std::isalpha(static_cast<unsigned char>(c))) { ++i; continue; }
+
+        char letra = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+        ++i;
+
+        // Copiamos el número a un buffer local (string_view no termina en '\0')
+        char num[32];
+        size_t k = 0;
+        while (i < n && k < sizeof(num) - 1) {
+            char d = linea[i];
+            if (std::isdigit(static_cast<unsigned char>(d)) || d == '.' || d == '-' || d == '+') {
+                num[k++] = d;
+                ++i;
+            } else {
+                break;
+            }
+        }
+        num[k] = '\0';
+        double valor = std::strtod(num, nullptr);
+
+        switch (letra) {
+            case 'G':
+            case 'M':
+                if (out.letra == 0) {
+                    out.letra = letra;
+                    out.numero = static_cast<int>(valor);
+                }
+                break;
+            case 'X': out.tieneX = true; out.x = valor; break;
+            case 'Y': out.tieneY = true; out.y = valor; break;
+            case 'Z': out.tieneZ = true; out.z = valor; break;
+            case 'F': out.tieneF = true; out.f = valor; break;
+            case 'I': out.tieneI = true; out.i = valor; break;
+            case 'J': out.tieneJ = true; out.j = valor; break;
+            default: break;                        // N, E, P, etc. se ignoran
+        }
+    }
+    return out.letra != 0;
+}
+
+double GCodeAnalyzer::velocidadEfectiva(double distancia, double f) {
+    double v = f;
+    if (v < 5) v = std::sqrt(distancia) * 10;
+    if (v < 5) v = 5;
+    return v;
+}
+
+double GCodeAnalyzer::barridoArco(double x0, double y0, double x1, double y1,
+                                  double cx, double cy, bool horario) {
+    const double a0 = std::atan2(y0 - cy, x0 - cx);
+    const double a1 = std::atan2(y1 - cy, x1 - cx);
+    double barrido = a1 - a0;
+    if (horario) {
+        if (barrido >= 0) barrido -= 2 * M_PI;
+    } else {
+        if (barrido <= 0) barrido += 2 * M_PI;
+    }
+    return barrido;
+}
+
+double GCodeAnalyzer::longitudArco(double x0, double y0, double z0,
+                                   double x1, double y1, double z1, const LineaGCode& arco) {
+    // Mismo criterio que el firmware: sin centro o con radio nulo es una recta
+    const double cx = x0 + arco.i, cy = y0 + arco.j;
+    const double r0 = std::hypot(x0 - cx, y0 - cy);
+    if ((!arco.tieneI && !arco.tieneJ) || r0 < 0.01) {
+        return std::sqrt((x1 - x0) * (x1 - x0) + (y1 - y0) * (y1 - y0) + (z1 - z0) * (z1 - z0));
+    }
+    const double r1 = std::hypot(x1 - cx, y1 - cy);
+    const double barrido = barridoArco(x0, y0, x1, y1, cx, cy, arco.numero == 2);
+    return std::hypot(std::fabs(barrido) * (r0 + r1) * 0.5, z1 - z0);
+}
+
+void GCodeAnalyzer::extenderBBox(double px, double py, double pz) {
+    if (!meta.bboxValida) {
+        meta.minX = meta.maxX = px;
+        meta.minY = meta.maxY = py;
+        meta.minZ = meta.maxZ = pz;
+        meta.bboxValida = true;
+        return;
+    }
+    meta.minX = std::min(meta.minX, px); meta.maxX = std::max(meta.maxX, px);
+    meta.minY = std::min(meta.minY, py); meta.maxY = std::max(meta.maxY, py);
+    meta.minZ = std::min(meta.minZ, pz); meta.maxZ = std::max(meta.maxZ, pz);
+}
+
+void GCodeAnalyzer::procesarLinea(std::string_view linea) {
+    meta.bytes += linea.size();
+    if (linea.empty() || linea.back() != '\n') {
+        meta.bytes += 1;                           // se guarda con su '\n'
+    }
+
+    LineaGCode l;
+    if (!parsearLinea(linea, l)) return;
+    meta.lineas++;
+
+    if (l.letra == 'G') {
+        switch (l.numero) {
+            case 0:
+            case 1: {
+                double nx = x, ny = y, nz = z;
+                if (relativo) {
+                    if (l.tieneX) nx += l.x;
+                    if (l.tieneY) ny += l.y;
+                    if (l.tieneZ) nz += l.z;
+                } else {
+                    if (l.tieneX) nx = l.x;
+                    if (l.tieneY) ny = l.y;
+                    if (l.tieneZ) nz = l.z;
+                }
+                double dist = std::sqrt((nx - x) * (nx - x) + (ny - y) * (ny - y) + (nz - z) * (nz - z));
+                meta.movimientos++;
+                meta.distanciaMm += dist;
+                if (dist > 0) {
+                    meta.duracionEstimadaSeg += dist / velocidadEfectiva(dist, l.tieneF ? l.f : 0);
+                }
+                x = nx; y = ny; z = nz;
+                extenderBBox(x, y, z);
+                break;
+            }
+            case 2:
+            case 3:
+                procesarArco(l);
+                break;
+            case 28:
+                x = HOME_X; y = HOME_Y; z = HOME_Z;
+                meta.duracionEstimadaSeg += TIEMPO_HOMING_SEG;
+                break;
+            case 90: relativo = false; break;
+            case 91: relativo = true;  break;
+            default: break;
+        }
+    } else if (l.letra == 'M' && (l.numero == 3 || l.numero == 5)) {
+        meta.duracionEstimadaSeg += TIEMPO_EFECTOR_SEG;
+    }
+}
+
+void GCodeAnalyzer::procesarArco(const LineaGCode& l) {
+    double nx = x, ny = y, nz = z;
+    if (relativo) {
+        if (l.tieneX) nx += l.x;
+        if (l.tieneY) ny += l.y;
+        if (l.tieneZ) nz += l.z;
+    } else {
+        if (l.tieneX) nx = l.x;
+        if (l.tieneY) ny = l.y;
+        if (l.tieneZ) nz = l.z;
+    }
+    meta.movimientos++;
+
+    const double dist = longitudArco(x, y, z, nx, ny, nz, l);
+
+    // Los extremos cardinales que el arco cruza también cuentan en la bbox
+    const double cx = x + l.i, cy = y + l.j;
+    const double r0 = std::hypot(x - cx, y - cy);
+    if ((l.tieneI || l.tieneJ) && r0 >= 0.01) {
+        const double r1 = std::hypot(nx - cx, ny - cy);
+        const double barrido = barridoArco(x, y, nx, ny, cx, cy, l.numero == 2);
+        const double a0 = std::atan2(y - cy, x - cx);
+        for (int k = -6; k <= 6; ++k) {   // a0 + barrido cae en (-3π, 3π)
+            const double angulo = k * M_PI / 2;
+            const double t = (angulo - a0) / barrido;
+            if (t > 0 && t < 1) {
+                const double r = r0 + t * (r1 - r0);
+                extenderBBox(cx + r * std::cos(angulo), cy + r * std::sin(angulo), z + t * (nz - z));
+            }
+        }
+    }
+
+    meta.distanciaMm += dist;
+    if (dist > 0) {
+        meta.duracionEstimadaSeg += dist / velocidadEfectiva(dist, l.tieneF ? l.f : 0);
+    }
+    x = nx; y = ny; z = nz;
+    extenderBBox(x, y, z);
+}
+
+MetadatosGCode GCodeAnalyzer::analizar(const std::string& contenido) {
+    GCodeAnalyzer a;
+    size_t inicio = 0;
+    while (inicio < contenido.size()) {
+        size_t fin = contenido.find('\n', inicio);
+        if (fin == std::string::npos) fin = contenido.size();
+        else fin += 1;
+        a.procesarLinea(std::string_view(contenido).substr(inicio, fin - inicio));
+        inicio = fin;
+    }
+    MetadatosGCode m = a.resultado();
+    m.bytes = contenido.size();
+    return m;
+}
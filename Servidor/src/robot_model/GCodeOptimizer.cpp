@@ -0,0 +1,326 @@
+#include "robot_model/GCodeOptimizer.h"
+#include "robot_model/PickPlaceReorderer.h"
+
+#include <cmath>
+#include <cstdio>
+
+std::string ResultadoOptimizacion::contenido() const {
+    std::string out;
+    size_t total = 0;
+    for (const auto& l : lineas) total += l.size() + 1;
+    out.reserve(total);
+    for (const auto& l : lineas) {
+        out += l;
+        out += '\n';
+    }
+    return out;
+}
+
+double GCodeOptimizer::distancia(const Punto& a, const Punto& b) {
+    const double dx = b.x - a.x, dy = b.y - a.y, dz = b.z - a.z;
+    return std::sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+double GCodeOptimizer::distanciaASegmento(const Punto& p, const Punto& a, const Punto& b) {
+    const double abx = b.x - a.x, aby = b.y - a.y, abz = b.z - a.z;
+    const double largo2 = abx * abx + aby * aby + abz * abz;
+    if (largo2 == 0) return distancia(p, a);
+
+    // Distancia al segmento (no a la recta): un punto que se pasa del
+    // extremo no es colineal a efectos de la trayectoria.
+    double t = ((p.x - a.x) * abx + (p.y - a.y) * aby + (p.z - a.z) * abz) / largo2;
+    if (t < 0) t = 0;
+    if (t > 1) t = 1;
+    const Punto proy{a.x + t * abx, a.y + t * aby, a.z + t * abz};
+    return distancia(p, proy);
+}
+
+void GCodeOptimizer::rdp(const std::vector<Punto>& pts, size_t i, size_t j,
+                         double tolerancia, std::vector<bool>& conservar) {
+    // Iterativo con pila explícita: corridas largas no agotan el stack
+    std::vector<std::pair<size_t, size_t>> pendientes{{i, j}};
+    while (!pendientes.empty()) {
+        auto [a, b] = pendientes.back();
+        pendientes.pop_back();
+        if (b <= a + 1) continue;
+
+        double maxDist = -1;
+        size_t indice = a;
+        for (size_t k = a + 1; k < b; ++k) {
+            double d = distanciaASegmento(pts[k], pts[a], pts[b]);
+            if (d > maxDist) { maxDist = d; indice = k; }
+        }
+        if (maxDist > tolerancia) {
+            conservar[indice] = true;
+            pendientes.push_back({a, indice});
+            pendientes.push_back({indice, b});
+        }
+    }
+}
+
+size_t GCodeOptimizer::buscarArco(const std::vector<Punto>& pts, size_t s, double tolerancia, Arco& arco) {
+    size_t mejor = s;
+    for (size_t e = s + MIN_SEGMENTOS_ARCO; e < pts.size(); ++e) {
+        // Solo arcos planos: la hélice no se ajusta
+        if (std::fabs(pts[e].z - pts[s].z) > 1e-6) break;
+
+        // Círculo por el inicio, el punto medio y el final
+        const Punto& a = pts[s];
+        const Punto& b = pts[(s + e) / 2];
+        const Punto& c = pts[e];
+        const double d = 2 * (a.x * (b.y - c.y) + b.x * (c.y - a.y) + c.x * (a.y - b.y));
+        if (std::fabs(d) < 1e-9) break;   // colineales
+        const double a2 = a.x * a.x + a.y * a.y, b2 = b.x * b.x + b.y * b.y, c2 = c.x * c.x + c.y * c.y;
+        double cx = (a2 * (b.y - c.y) + b2 * (c.y - a.y) + c2 * (a.y - b.y)) / d;
+        double cy = (a2 * (c.x - b.x) + b2 * (a.x - c.x) + c2 * (b.x - a.x)) / d;
+
+        // Centro sobre la mediatriz de inicio y fin: mismo radio en ambos
+        // extremos, que es lo que el firmware espera de I/J
+        const double ux = -(c.y - a.y), uy = c.x - a.x;
+        const double u2 = ux * ux + uy * uy;
+        if (u2 > 1e-12) {
+            const double mx = (a.x + c.x) / 2, my = (a.y + c.y) / 2;
+            const double t = ((cx - mx) * ux + (cy - my) * uy) / u2;
+            cx = mx + t * ux;
+            cy = my + t * uy;
+        }
+        const double r = std::hypot(a.x - cx, a.y - cy);
+        if (r > RADIO_MAXIMO_ARCO_MM) break;
+
+        // Todos los puntos sobre el círculo, avanzando en un mismo sentido,
+        // y cada cuerda cerca del arco que reemplaza (flecha <= tolerancia)
+        bool valido = true;
+        double barrido = 0;
+        int sentido = 0;
+        for (size_t k = s + 1; k <= e && valido; ++k) {
+            const Punto& p = pts[k];
+            const Punto& q = pts[k - 1];
+            if (std::fabs(p.z - a.z) > 1e-6 || std::fabs(std::hypot(p.x - cx, p.y - cy) - r) > tolerancia) {
+                valido = false;
+                break;
+            }
+            const double paso = std::atan2((q.x - cx) * (p.y - cy) - (q.y - cy) * (p.x - cx),
+                                           (q.x - cx) * (p.x - cx) + (q.y - cy) * (p.y - cy));
+            const int s2 = paso > 0 ? 1 : (paso < 0 ? -1 : 0);
+            if (s2 == 0 || (sentido != 0 && s2 != sentido)) { valido = false; break; }
+            sentido = s2;
+            barrido += paso;
+            const double cuerda = std::hypot(p.x - q.x, p.y - q.y);
+            if (cuerda >= 2 * r || r - std::sqrt(r * r - cuerda * cuerda / 4) > tolerancia) valido = false;
+        }
+        // Nunca un círculo completo: el inicio y el fin serían ambiguos
+        if (!valido || std::fabs(barrido) >= 2 * M_PI - 1e-3) break;
+
+        mejor = e;
+        arco = Arco{cx, cy, barrido};
+    }
+    return mejor;
+}
+
+std::string GCodeOptimizer::formatearArco(const Punto& desde, const Punto& hasta, const Arco& arco, double f) {
+    char buf[160];
+    int n = std::snprintf(buf, sizeof(buf), "%s X%.2f Y%.2f Z%.2f I%.3f J%.3f",
+                          arco.barrido < 0 ? "G2" : "G3", hasta.x, hasta.y, hasta.z,
+                          arco.cx - desde.x, arco.cy - desde.y);
+    if (f >= 0 && n > 0 && static_cast<size_t>(n) < sizeof(buf)) {
+        std::snprintf(buf + n, sizeof(buf) - n, " F%g", f);
+    }
+    return buf;
+}
+
+ResultadoOptimizacion GCodeOptimizer::optimizar(const std::vector<std::string>& lineas,
+                                                const OpcionesOptimizacion& opciones) {
+    ResultadoOptimizacion res;
+
+    // El reordenamiento va primero: la simplificación posterior no cruza
+    // bloques (M3/M5 son barreras), así que no interfiere con él.
+    const std::vector<std::string>* fuente = &lineas;
+    ResultadoReorden reorden;
+    if (opciones.reordenarPickAndPlace) {
+        reorden = PickPlaceReorderer::reordenar(lineas);
+        res.reordenado = reorden.reordenado;
+        res.bloques = reorden.bloques;
+        res.viajeAntesSeg = reorden.viajeAntesSeg;
+        res.viajeDespuesSeg = reorden.reordenado ? reorden.viajeDespuesSeg : reorden.viajeAntesSeg;
+        res.motivoSinReorden = reorden.motivo;
+        fuente = &reorden.lineas;
+    }
+
+    Punto pos{GCodeAnalyzer::HOME_X, GCodeAnalyzer::HOME_Y, GCodeAnalyzer::HOME_Z};
+    bool posConocida = false;   // solo tras un G1 completo o un G28
+    bool relativo = false;
+    int  efector = -1;          // -1 desconocido, 0 abierto (M5), 1 cerrado (M3)
+
+    // Corrida de movimientos simplificables pendiente de emitir
+    std::vector<Punto> corrida;
+    std::vector<std::string> textosCorrida;
+    Punto ancla{};
+    bool anclaValida = false;
+    double fCorrida = -1;
+
+    // Racha de M3/M5 sin movimientos entre medio
+    std::string ultimoEfector;
+    size_t rachaEfector = 0;
+
+    auto emitirCorrida = [&]() {
+        if (corrida.empty()) return;
+        const bool transformar = opciones.simplificarColineales || opciones.ajustarArcos;
+        if (transformar && corrida.size() >= 2) {
+            std::vector<Punto> pts;
+            pts.reserve(corrida.size() + 1);
+            if (anclaValida) pts.push_back(ancla);
+            pts.insert(pts.end(), corrida.begin(), corrida.end());
+
+            std::vector<bool> conservar(pts.size(), false);
+            std::vector<std::string> arcoHasta(pts.size());   // G2/G3 que termina en ese punto
+
+            auto cerrarTramoRecto = [&](size_t a, size_t b) {
+                conservar[a] = conservar[b] = true;
+                if (opciones.simplificarColineales) {
+                    rdp(pts, a, b, opciones.toleranciaMm, conservar);
+                } else {
+                    for (size_t k = a; k <= b; ++k) conservar[k] = true;
+                }
+            };
+
+            // Los arcos se buscan primero; lo que queda entre ellos va por RDP
+            size_t inicioRecto = 0;
+            size_t s = 0;
+            while (s + 1 < pts.size()) {
+                Arco arco{};
+                const size_t e = opciones.ajustarArcos
+                    ? buscarArco(pts, s, opciones.toleranciaMm, arco) : s;
+                if (e > s) {
+                    cerrarTramoRecto(inicioRecto, s);
+                    arcoHasta[e] = formatearArco(pts[s], pts[e], arco, fCorrida);
+                    res.arcosAjustados++;
+                    s = inicioRecto = e;
+                } else {
+                    ++s;
+                }
+            }
+            cerrarTramoRecto(inicioRecto, pts.size() - 1);
+
+            const size_t offset = anclaValida ? 1 : 0;
+            for (size_t k = 0; k < corrida.size(); ++k) {
+                if (!arcoHasta[k + offset].empty()) res.lineas.push_back(std::move(arcoHasta[k + offset]));
+                else if (conservar[k + offset]) res.lineas.push_back(std::move(textosCorrida[k]));
+                else res.movimientosEliminados++;
+            }
+        } else {
+            for (auto& t : textosCorrida) res.lineas.push_back(std::move(t));
+        }
+        corrida.clear();
+        textosCorrida.clear();
+    };
+
+    auto emitirEfector = [&]() {
+        if (rachaEfector == 0) return;
+        const int estadoFinal = (ultimoEfector.rfind("M3", 0) == 0) ? 1 : 0;
+        size_t emitidas = 0;
+        if (estadoFinal != efector) {
+            res.lineas.push_back(ultimoEfector);
+            emitidas = 1;
+        }
+        res.efectorEliminados += rachaEfector - emitidas;
+        efector = estadoFinal;
+        rachaEfector = 0;
+    };
+
+    for (const std::string& original : *fuente) {
+        std::string linea = original;
+        while (!linea.empty() && (linea.back() == '\r' || linea.back() == ' ' || linea.back() == '\t')) {
+            linea.pop_back();
+        }
+        if (linea.find_first_not_of(" \t") == std::string::npos) continue;  // vacías
+
+        LineaGCode l;
+        const bool esComando = GCodeAnalyzer::parsearLinea(linea, l);
+        if (esComando) res.lineasAntes++;
+
+        const bool esMovimiento = esComando && l.letra == 'G' && (l.numero == 0 || l.numero == 1);
+        const bool completo = esMovimiento && !relativo && l.tieneX && l.tieneY && l.tieneZ;
+
+        if (completo) {
+            emitirEfector();
+            const Punto p{l.x, l.y, l.z};
+            if (posConocida && distancia(pos, p) < opciones.distanciaMinimaMm) {
+                res.movimientosEliminados++;   // nulo o repetido
+                continue;
+            }
+            const double f = l.tieneF ? l.f : -1;
+            if (!corrida.empty() && f != fCorrida) emitirCorrida();
+            if (corrida.empty()) {
+                ancla = pos;
+                anclaValida = posConocida;
+                fCorrida = f;
+            }
+            corrida.push_back(p);
+            textosCorrida.push_back(linea);
+            pos = p;
+            posConocida = true;
+            continue;
+        }
+
+        if (opciones.colapsarEfector && esComando && l.letra == 'M' && (l.numero == 3 || l.numero == 5)) {
+            emitirCorrida();
+            ultimoEfector = linea;
+            rachaEfector++;
+            continue;
+        }
+
+        // Barrera: se conserva tal cual
+        emitirCorrida();
+        emitirEfector();
+        res.lineas.push_back(linea);
+        if (!esComando) continue;
+
+        if (esMovimiento) {
+            posConocida = false;   // incompleto o relativo: no seguimos la pose
+        } else if (l.letra == 'G' && (l.numero == 2 || l.numero == 3)) {
+            // Arco ya existente: solo importa su punto final
+            if (relativo) {
+                posConocida = false;
+            } else {
+                if (l.tieneX) pos.x = l.x;
+                if (l.tieneY) pos.y = l.y;
+                if (l.tieneZ) pos.z = l.z;
+            }
+        } else if (l.letra == 'G' && l.numero == 28) {
+            pos = Punto{GCodeAnalyzer::HOME_X, GCodeAnalyzer::HOME_Y, GCodeAnalyzer::HOME_Z};
+            posConocida = true;
+        } else if (l.letra == 'G' && l.numero == 90) {
+            relativo = false;
+        } else if (l.letra == 'G' && l.numero == 91) {
+            relativo = true;
+            posConocida = false;
+        } else if (l.letra == 'M' && l.numero == 3) {
+            efector = 1;
+        } else if (l.letra == 'M' && l.numero == 5) {
+            efector = 0;
+        }
+    }
+    emitirCorrida();
+    emitirEfector();
+
+    GCodeAnalyzer antes, despues;
+    for (const auto& l : lineas) antes.procesarLinea(l);
+    for (const auto& l : res.lineas) despues.procesarLinea(l);
+    res.duracionAntesSeg = antes.resultado().duracionEstimadaSeg;
+    res.duracionDespuesSeg = despues.resultado().duracionEstimadaSeg;
+    res.lineasDespues = despues.resultado().lineas;
+    return res;
+}
+
+ResultadoOptimizacion GCodeOptimizer::optimizar(const std::string& contenido,
+                                                const OpcionesOptimizacion& opciones) {
+    std::vector<std::string> lineas;
+    size_t inicio = 0;
+    while (inicio < contenido.size()) {
+        size_t fin = contenido.find('\n', inicio);
+        if (fin == std::string::npos) fin = contenido.size();
+        lineas.emplace_back(contenido, inicio, fin - inicio);
+        inicio = fin + 1;
+    }
+    return optimizar(lineas, opciones);
+}
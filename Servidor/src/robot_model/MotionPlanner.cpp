@@ -0,0 +1,163 @@
+#include "robot_model/MotionPlanner.h"
+#include "robot_model/GCodeAnalyzer.h"
+
+#include <algorithm>
+#include <cmath>
+
+MotionPlanner::MotionPlanner(ParametrosPlanificador parametros)
+    : p_(parametros), x_(GCodeAnalyzer::HOME_X), y_(GCodeAnalyzer::HOME_Y), z_(GCodeAnalyzer::HOME_Z) {
+    if (!p_.anticipacion || p_.ventana == 0) p_.ventana = 1;
+}
+
+double MotionPlanner::tiempoTrapecio(double distancia, double v0, double vc, double v1, double a) {
+    if (distancia <= 0) return 0;
+    double da = (vc * vc - v0 * v0) / (2 * a);
+    double dd = (vc * vc - v1 * v1) / (2 * a);
+    if (da + dd > distancia) {
+        // Perfil triangular (mismo cálculo que Interpolation::setTrapezoid)
+        vc = std::sqrt((2 * a * distancia + v0 * v0 + v1 * v1) * 0.5);
+        vc = std::max({vc, v0, v1});
+        da = (vc * vc - v0 * v0) / (2 * a);
+        dd = std::min((vc * vc - v1 * v1) / (2 * a), distancia - da);
+    }
+    return (vc - v0) / a + (distancia - da - dd) / vc + (vc - v1) / a;
+}
+
+double MotionPlanner::velocidadUnion(const Bloque& previo, const Bloque& actual) const {
+    const double vmax = std::min(previo.vNominal, actual.vNominal);
+    const double cosTheta = -(previo.unidad[0] * actual.unidad[0] +
+                              previo.unidad[1] * actual.unidad[1] +
+                              previo.unidad[2] * actual.unidad[2]);
+    if (cosTheta > 0.999) return 0;        // vuelta atrás
+    if (cosTheta < -0.999) return vmax;    // en línea recta
+    const double sinMitad = std::sqrt(0.5 * (1.0 - cosTheta));
+    const double v = std::sqrt(p_.aceleracion * p_.desvioUnion * sinMitad / (1.0 - sinMitad));
+    return std::min(v, vmax);
+}
+
+void MotionPlanner::recalcular() {
+    double entradaSiguiente = 0;
+    for (auto it = ventana_.rbegin(); it != ventana_.rend(); ++it) {
+        if (!it->entradaFija) {
+            it->vEntrada = std::min(it->vEntradaMax,
+                                    std::sqrt(entradaSiguiente * entradaSiguiente + 2 * p_.aceleracion * it->largo));
+        }
+        entradaSiguiente = it->vEntrada;
+    }
+    for (size_t k = 0; k + 1 < ventana_.size(); ++k) {
+        Bloque& b = ventana_[k];
+        Bloque& n = ventana_[k + 1];
+        if (!n.entradaFija) {
+            n.vEntrada = std::min(n.vEntrada, std::sqrt(b.vEntrada * b.vEntrada + 2 * p_.aceleracion * b.largo));
+        }
+    }
+}
+
+void MotionPlanner::despacharPrimero() {
+    Bloque b = ventana_.front();
+    ventana_.pop_front();
+    double vSalida = 0;
+    if (!ventana_.empty()) {
+        ventana_.front().entradaFija = true;
+        vSalida = ventana_.front().vEntrada;
+    }
+    duracion_ += tiempoTrapecio(b.largo, b.vEntrada, b.vNominal, vSalida, p_.aceleracion);
+}
+
+void MotionPlanner::vaciar() {
+    while (!ventana_.empty()) despacharPrimero();
+}
+
+void MotionPlanner::agregarTramo(double x, double y, double z, double f) {
+    const double dx = x - x_, dy = y - y_, dz = z - z_;
+    const double largo = std::sqrt(dx * dx + dy * dy + dz * dz);
+    x_ = x; y_ = y; z_ = z;
+    if (largo < 0.001) return;
+
+    // Con la ventana llena, el firmware despacha el primero antes de aceptar otro
+    if (ventana_.size() >= p_.ventana) despacharPrimero();
+
+    Bloque b;
+    b.largo = largo;
+    b.unidad[0] = dx / largo;
+    b.unidad[1] = dy / largo;
+    b.unidad[2] = dz / largo;
+    b.vNominal = GCodeAnalyzer::velocidadEfectiva(largo, f);
+    if (ventana_.empty()) {
+        b.entradaFija = true;   // lo anterior ya terminó en reposo
+    } else {
+        b.vEntradaMax = velocidadUnion(ventana_.back(), b);
+        b.vEntrada = b.vEntradaMax;
+    }
+    ventana_.push_back(b);
+    segmentos_++;
+    recalcular();
+}
+
+void MotionPlanner::procesarLinea(std::string_view linea) {
+    LineaGCode l;
+    if (!GCodeAnalyzer::parsearLinea(linea, l)) return;
+
+    if (l.letra == 'G' && (l.numero == 0 || l.numero == 1)) {
+        double nx = x_, ny = y_, nz = z_;
+        if (relativo_) {
+            if (l.tieneX) nx += l.x;
+            if (l.tieneY) ny += l.y;
+            if (l.tieneZ) nz += l.z;
+        } else {
+            if (l.tieneX) nx = l.x;
+            if (l.tieneY) ny = l.y;
+            if (l.tieneZ) nz = l.z;
+        }
+        agregarTramo(nx, ny, nz, l.tieneF ? l.f : 0);
+        return;
+    }
+
+    // Cualquier otro comando espera a que el brazo se detenga
+    vaciar();
+    if (l.letra == 'G') {
+        switch (l.numero) {
+            case 2:
+            case 3: {
+                // Los arcos no pasan por el planificador: perfil de Interpolation
+                double nx = x_, ny = y_, nz = z_;
+                if (relativo_) {
+                    if (l.tieneX) nx += l.x;
+                    if (l.tieneY) ny += l.y;
+                    if (l.tieneZ) nz += l.z;
+                } else {
+                    if (l.tieneX) nx = l.x;
+                    if (l.tieneY) ny = l.y;
+                    if (l.tieneZ) nz = l.z;
+                }
+                const double largo = GCodeAnalyzer::longitudArco(x_, y_, z_, nx, ny, nz, l);
+                if (largo > 0) {
+                    duracion_ += largo / GCodeAnalyzer::velocidadEfectiva(largo, l.tieneF ? l.f : 0);
+                }
+                x_ = nx; y_ = ny; z_ = nz;
+                segmentos_++;
+                break;
+            }
+            case 28:
+                x_ = GCodeAnalyzer::HOME_X; y_ = GCodeAnalyzer::HOME_Y; z_ = GCodeAnalyzer::HOME_Z;
+                duracion_ += GCodeAnalyzer::TIEMPO_HOMING_SEG;
+                break;
+            case 90: relativo_ = false; break;
+            case 91: relativo_ = true;  break;
+            default: break;
+        }
+    } else if (l.letra == 'M' && (l.numero == 3 || l.numero == 5)) {
+        duracion_ += GCodeAnalyzer::TIEMPO_EFECTOR_SEG;
+    }
+}
+
+double MotionPlanner::finalizar() {
+    vaciar();
+    return duracion_;
+}
+
+double MotionPlanner::estimar(const std::vector<std::string>& lineas, ParametrosPlanificador parametros) {
+    MotionPlanner planner(parametros);
+    for (const auto& l : lineas) planner.procesarLinea(l);
+    return planner.finalizar();
+}
@@ -0,0 +1,61 @@
+#include "robot_model/MovimientosPendientes.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+    double distancia(double ax, double ay, double az, double bx, double by, double bz) {
+        return std::sqrt((ax - bx) * (ax - bx) + (ay - by) * (ay - by) + (az - bz) * (az - bz));
+    }
+
+    // Distancia del punto p al segmento a-b
+    double distanciaASegmento(double px, double py, double pz,
+                              double ax, double ay, double az,
+                              double bx, double by, double bz) {
+        const double dx = bx - ax, dy = by - ay, dz = bz - az;
+        const double largo2 = dx * dx + dy * dy + dz * dz;
+        double t = 0;
+        if (largo2 > 0) {
+            t = ((px - ax) * dx + (py - ay) * dy + (pz - az) * dz) / largo2;
+            t = std::clamp(t, 0.0, 1.0);
+        }
+        return distancia(px, py, pz, ax + t * dx, ay + t * dy, az + t * dz);
+    }
+
+}
+
+void MovimientosPendientes::agregar(const CheckpointTrayectoria& antes, double x, double y, double z, bool lineal) {
+    if (!lineal) {
+        pendientes.clear();
+    }
+    pendientes.push_back({antes, x, y, z, lineal});
+}
+
+size_t MovimientosPendientes::confirmarConPosicion(double x, double y, double z) {
+    size_t confirmados = 0;
+    for (size_t k = 0; k < pendientes.size(); ++k) {
+        const Movimiento& m = pendientes[k];
+        if (distancia(x, y, z, m.x, m.y, m.z) <= TOLERANCIA_MM) {
+            confirmados = k + 1;
+            break;
+        }
+        // Sin pose de partida (primer movimiento tras el homing) solo vale el destino
+        if (m.lineal && m.antes.poseValida
+            && distanciaASegmento(x, y, z, m.antes.x, m.antes.y, m.antes.z, m.x, m.y, m.z) <= TOLERANCIA_MM) {
+            confirmados = k;
+            break;
+        }
+    }
+    pendientes.erase(pendientes.begin(), pendientes.begin() + confirmados);
+    return confirmados;
+}
+
+CheckpointTrayectoria MovimientosPendientes::checkpointConfirmado(const CheckpointTrayectoria& actual) const {
+    if (pendientes.empty()) {
+        return actual;
+    }
+    CheckpointTrayectoria confirmado = pendientes.front().antes;
+    confirmado.motivo = actual.motivo;
+    return confirmado;
+}
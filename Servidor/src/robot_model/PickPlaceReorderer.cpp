@@ -0,0 +1,231 @@
+#include "robot_model/PickPlaceReorderer.h"
+#include "robot_model/GCodeAnalyzer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <thread>
+
+namespace {
+
+struct Punto { double x = 0, y = 0, z = 0; };
+
+struct Bloque {
+    size_t desde = 0, hasta = 0;   // rango [desde, hasta) de líneas
+    Punto  entrada, salida;
+    double fEntrada = 0;           // F del primer movimiento (0 = sin F)
+};
+
+// Nodo ficticio: inicio (solo salida) o epílogo (solo entrada, o libre)
+struct Extremos {
+    Punto inicio;
+    bool  hayEpilogo = false;
+    Punto entradaEpilogo;
+    double fEpilogo = 0;
+};
+
+double tiempoTraslado(const Punto& a, const Punto& b, double f) {
+    const double dx = b.x - a.x, dy = b.y - a.y, dz = b.z - a.z;
+    const double d = std::sqrt(dx * dx + dy * dy + dz * dz);
+    if (d <= 0) return 0;
+    return d / GCodeAnalyzer::velocidadEfectiva(d, f);
+}
+
+} // namespace
+
+ResultadoReorden PickPlaceReorderer::reordenar(const std::vector<std::string>& lineas,
+                                               unsigned hilos,
+                                               std::chrono::milliseconds presupuesto) {
+    ResultadoReorden res;
+    res.lineas = lineas;
+
+    // ---------- 1. Reconocer prólogo, bloques y epílogo ----------
+    size_t i = 0;
+    LineaGCode l;
+    Punto pos{GCodeAnalyzer::HOME_X, GCodeAnalyzer::HOME_Y, GCodeAnalyzer::HOME_Z};
+    for (; i < lineas.size(); ++i) {
+        if (!GCodeAnalyzer::parsearLinea(lineas[i], l)) continue;
+        if (l.letra == 'G' && l.numero >= 0 && l.numero <= 3) break;
+        if (l.letra == 'G' && (l.numero == 91 || l.numero == 92)) {
+            res.motivo = "el prólogo usa coordenadas relativas u offsets (G91/G92)";
+            return res;
+        }
+    }
+    const size_t finPrologo = i;
+    Extremos ext;
+    ext.inicio = pos;   // el ejecutor hace homing antes de correr la trayectoria
+
+    std::vector<Bloque> bloques;
+    Bloque actual;
+    actual.desde = finPrologo;
+    bool abierto = false;      // el bloque actual ya tiene su primer movimiento
+    bool soltado = false;      // ya pasó el M5 del bloque actual
+    Punto ultimo = pos;
+
+    for (; i < lineas.size(); ++i) {
+        if (!GCodeAnalyzer::parsearLinea(lineas[i], l)) continue;
+
+        if (l.letra == 'G' && (l.numero == 28 || l.numero == 91 || l.numero == 92)) {
+            res.motivo = "la trayectoria usa G28/G91/G92 entre operaciones";
+            return res;
+        }
+
+        if (l.letra == 'G' && l.numero >= 0 && l.numero <= 3) {
+            // Un arco solo puede ir dentro de un bloque: su trazado depende de dónde empieza
+            const bool completo = l.numero <= 1 && l.tieneX && l.tieneY && l.tieneZ;
+            const Punto p{l.tieneX ? l.x : ultimo.x, l.tieneY ? l.y : ultimo.y, l.tieneZ ? l.z : ultimo.z};
+
+            // Tras soltar, solo las subidas en vertical pertenecen al bloque
+            const bool retiro = soltado && std::fabs(p.x - ultimo.x) < 1e-6 && std::fabs(p.y - ultimo.y) < 1e-6;
+            if (soltado && !retiro) {
+                actual.hasta = i;
+                actual.salida = ultimo;
+                bloques.push_back(actual);
+                actual = Bloque{};
+                actual.desde = i;
+                abierto = false;
+                soltado = false;
+            }
+            if (!abierto) {
+                if (!completo) {
+                    res.motivo = "un bloque no empieza con un G0/G1 absoluto completo (X, Y y Z)";
+                    return res;
+                }
+                actual.entrada = p;
+                actual.fEntrada = l.tieneF ? l.f : 0;
+                abierto = true;
+            }
+            ultimo = p;
+        } else if (l.letra == 'M' && l.numero == 5 && abierto) {
+            soltado = true;
+        }
+    }
+
+    size_t inicioEpilogo = lineas.size();
+    if (soltado) {
+        actual.hasta = lineas.size();
+        actual.salida = ultimo;
+        bloques.push_back(actual);
+    } else if (abierto) {
+        // Movimientos finales sin M5 (p. ej. volver a reposo): quedan al final
+        inicioEpilogo = actual.desde;
+        ext.hayEpilogo = true;
+        ext.entradaEpilogo = actual.entrada;
+        ext.fEpilogo = actual.fEntrada;
+    }
+
+    res.bloques = bloques.size();
+    if (bloques.size() < 2) {
+        res.motivo = "hay menos de dos operaciones pick-and-place";
+        return res;
+    }
+
+    // ---------- 2. Costos ----------
+    // Nodos: 0 = inicio, 1..n = bloques, n+1 = epílogo
+    const size_t n = bloques.size();
+    auto costo = [&](size_t a, size_t b) -> double {
+        const Punto& desde = (a == 0) ? ext.inicio : bloques[a - 1].salida;
+        if (b == n + 1) {
+            return ext.hayEpilogo ? tiempoTraslado(desde, ext.entradaEpilogo, ext.fEpilogo) : 0.0;
+        }
+        return tiempoTraslado(desde, bloques[b - 1].entrada, bloques[b - 1].fEntrada);
+    };
+    auto costoRecorrido = [&](const std::vector<size_t>& seq) {
+        double total = 0;
+        for (size_t t = 0; t + 1 < seq.size(); ++t) total += costo(seq[t], seq[t + 1]);
+        return total;
+    };
+
+    std::vector<size_t> original(n + 2);
+    for (size_t t = 0; t < n + 2; ++t) original[t] = t;
+    res.viajeAntesSeg = costoRecorrido(original);
+
+    // ---------- 3. Vecino más cercano ----------
+    std::vector<size_t> seq;
+    seq.reserve(n + 2);
+    seq.push_back(0);
+    std::vector<bool> visitado(n + 1, false);
+    for (size_t paso = 0; paso < n; ++paso) {
+        size_t mejor = 0;
+        double mejorCosto = std::numeric_limits<double>::infinity();
+        for (size_t b = 1; b <= n; ++b) {
+            if (visitado[b]) continue;
+            double c = costo(seq.back(), b);
+            if (c < mejorCosto) { mejorCosto = c; mejor = b; }
+        }
+        visitado[mejor] = true;
+        seq.push_back(mejor);
+    }
+    seq.push_back(n + 1);
+
+    // ---------- 4. 2-opt (mejor mejora por pasada) ----------
+    // Como el costo no es simétrico, invertir seq[i..k] cambia también los
+    // tramos internos: se evalúan en O(1) con sumas prefijas de los tramos
+    // hacia adelante (P) y hacia atrás (Q) del recorrido actual.
+    if (hilos == 0) hilos = std::max(1u, std::thread::hardware_concurrency());
+    if (n < MIN_BLOQUES_PARALELO) hilos = 1;
+
+    const auto limite = std::chrono::steady_clock::now() + presupuesto;
+    std::vector<double> P(n + 2, 0), Q(n + 2, 0);
+
+    struct Movida { double delta = 0; size_t i = 0, k = 0; };
+
+    while (std::chrono::steady_clock::now() < limite) {
+        for (size_t t = 0; t + 1 < seq.size(); ++t) {
+            P[t + 1] = P[t] + costo(seq[t], seq[t + 1]);
+            Q[t + 1] = Q[t] + ((t >= 1 && t + 1 <= n) ? costo(seq[t + 1], seq[t]) : 0.0);
+        }
+
+        auto buscar = [&](size_t primero, size_t salto, Movida& mejor) {
+            for (size_t a = primero; a < n; a += salto) {
+                const double antesA = costo(seq[a - 1], seq[a]);
+                for (size_t b = a + 1; b <= n; ++b) {
+                    const double antes = antesA + (P[b] - P[a]) + costo(seq[b], seq[b + 1]);
+                    const double despues = costo(seq[a - 1], seq[b]) + (Q[b] - Q[a]) + costo(seq[a], seq[b + 1]);
+                    const double delta = despues - antes;
+                    if (delta < mejor.delta) mejor = Movida{delta, a, b};
+                }
+            }
+        };
+
+        std::vector<Movida> mejores(hilos);
+        if (hilos == 1) {
+            buscar(1, 1, mejores[0]);
+        } else {
+            // Reparto intercalado: las filas cortas y largas quedan balanceadas
+            std::vector<std::thread> trabajadores;
+            for (unsigned h = 0; h < hilos; ++h) {
+                trabajadores.emplace_back(buscar, 1 + h, hilos, std::ref(mejores[h]));
+            }
+            for (auto& t : trabajadores) t.join();
+        }
+
+        Movida mejor;
+        for (const auto& m : mejores) {
+            if (m.delta < mejor.delta) mejor = m;
+        }
+        if (mejor.delta > -1e-9) break;   // óptimo local
+        std::reverse(seq.begin() + mejor.i, seq.begin() + mejor.k + 1);
+    }
+
+    res.viajeDespuesSeg = costoRecorrido(seq);
+    if (res.viajeDespuesSeg >= res.viajeAntesSeg - 1e-9) {
+        res.motivo = "el orden original ya es el mejor encontrado";
+        return res;
+    }
+
+    // ---------- 5. Reconstruir ----------
+    std::vector<std::string> salida;
+    salida.reserve(lineas.size());
+    salida.insert(salida.end(), lineas.begin(), lineas.begin() + finPrologo);
+    for (size_t t = 1; t <= n; ++t) {
+        const Bloque& b = bloques[seq[t] - 1];
+        salida.insert(salida.end(), lineas.begin() + b.desde, lineas.begin() + b.hasta);
+    }
+    salida.insert(salida.end(), lineas.begin() + inicioEpilogo, lineas.end());
+
+    res.lineas = std::move(salida);
+    res.reordenado = true;
+    return res;
+}
@@ -2,17 +2,14 @@
 
 using namespace std::chrono_literals;
 
-const std::string RobotService::PREFIX_INFO = "INFO:";
-const std::string RobotService::PREFIX_ERROR = "ERROR:";
-const std::string RobotService::SUFFIX_OK = "OK";
-
 RobotService::RobotService(shared_ptr<ArduinoService> arduinoService,
                             PALogger& logger,
-                            const string& directorioTrayectorias)
+                            const string& directorioTrayectorias,
+                            SqliteDb* dbCatalogo)
     : arduinoService_(arduinoService)
     , logger_(logger)
     , directorioTrayectorias_(directorioTrayectorias)
-    , trajectoryManager_(std::make_unique<TrajectoryManager>(directorioTrayectorias_))
+    , trajectoryManager_(std::make_unique<TrajectoryManager>(directorioTrayectorias_, dbCatalogo))
     , modoOperacion_(ModoOperacion::MANUAL)
     , modoCoordenadas_(ModoCoordenadas::ABSOLUTO)
     , modoEjecucion_(ModoEjecucion::DETENIDO) {
@@ -76,8 +73,9 @@ std::string RobotService::homing(){
 
         std::string respuestaCompleta = arduinoService_->enviarComando("G28\r\n", getTimeoutParaComando("G28"));
         
-        logRespuestaCompleta(respuestaCompleta, "G28");
-        std::string respuestaCliente = procesarRespuesta(respuestaCompleta);
+        RespuestaFirmware respuesta = FirmwareLog::parsear(respuestaCompleta);
+        logRespuestaCompleta(respuesta, "G28");
+        std::string respuestaCliente = procesarRespuesta(respuesta);
 
         if (esTareaManual) {
             modoEjecucion_ = ModoEjecucion::DETENIDO;
@@ -86,7 +84,7 @@ std::string RobotService::homing(){
 
     } catch (const std::exception& e) {
         modoEjecucion_ = ModoEjecucion::DETENIDO;
-        logger_.error("Error en homing: " + std::string(e.what()));
+        logger_.error("Error en homing: {}", e.what());
         return "ERROR: " + std::string(e.what());
     }
 }
@@ -117,8 +115,9 @@ std::string RobotService::mover(double x, double y, double z, double velocidad)
         // Enviar comando a Firmware y recibir rta.
         std::string respuestaCompleta = arduinoService_->enviarComando(comando, getTimeoutParaComando(comando));
         
-        logRespuestaCompleta(respuestaCompleta, comando);
-        std::string respuestaCliente = procesarRespuesta(respuestaCompleta);
+        RespuestaFirmware respuesta = FirmwareLog::parsear(respuestaCompleta);
+        logRespuestaCompleta(respuesta, comando);
+        std::string respuestaCliente = procesarRespuesta(respuesta);
 
         if (esTareaManual) {
             modoEjecucion_ = ModoEjecucion::DETENIDO;
@@ -128,13 +127,54 @@ std::string RobotService::mover(double x, double y, double z, double velocidad)
 
     } catch (const std::exception& e) {
         modoEjecucion_ = ModoEjecucion::DETENIDO;
-        logger_.error("ERROR en mover :" + std::string(e.what()));
+        logger_.error("ERROR en mover :{}", e.what());
 
         // Retornar ERROR: 
         return "ERROR: " + std::string(e.what());
     }
 }
 
+// G2/G3 - ARCO
+std::string RobotService::moverArco(double x, double y, double z, double i, double j,
+                                    double velocidad, bool horario) {
+    if (!estaConectado()) {
+        return "ERROR: Robot no conectado";
+    }
+
+    if (!motoresActivados_) {
+        return "ERROR: Motores desactivados";
+    }
+
+    try {
+        std::string comando = formatearComandoArco(x, y, z, i, j, velocidad, horario);
+        std::string comandoLimpio = comando.substr(0, comando.find("\r\n"));
+        trajectoryManager_->guardarComando(comandoLimpio);
+
+        bool esTareaManual = (modoOperacion_ == ModoOperacion::MANUAL);
+
+        if (esTareaManual) {
+            modoEjecucion_ = ModoEjecucion::EJECUTANDO;
+        }
+
+        std::string respuestaCompleta = arduinoService_->enviarComando(comando, getTimeoutParaComando(comando));
+
+        RespuestaFirmware respuesta = FirmwareLog::parsear(respuestaCompleta);
+        logRespuestaCompleta(respuesta, comando);
+        std::string respuestaCliente = procesarRespuesta(respuesta);
+
+        if (esTareaManual) {
+            modoEjecucion_ = ModoEjecucion::DETENIDO;
+        }
+
+        return respuestaCliente;
+
+    } catch (const std::exception& e) {
+        modoEjecucion_ = ModoEjecucion::DETENIDO;
+        logger_.error("ERROR en moverArco :{}", e.what());
+        return "ERROR: " + std::string(e.what());
+    }
+}
+
 //std::string RobotService::mover(double x, double y, double z) {
 //    return mover(x, y, z, 50.0);
 //}
@@ -160,8 +200,9 @@ std::string RobotService::activarEfector() {
 
         std::string respuestaCompleta = arduinoService_->enviarComando("M3\r\n", getTimeoutParaComando("M3"));
 
-        logRespuestaCompleta(respuestaCompleta, "M3");
-        std::string respuestaCliente = procesarRespuesta(respuestaCompleta);
+        RespuestaFirmware respuesta = FirmwareLog::parsear(respuestaCompleta);
+        logRespuestaCompleta(respuesta, "M3");
+        std::string respuestaCliente = procesarRespuesta(respuesta);
 
         if (esTareaManual) {
             modoEjecucion_ = ModoEjecucion::DETENIDO;
@@ -170,7 +211,7 @@ std::string RobotService::activarEfector() {
         return respuestaCliente;
 
     } catch (const std::exception& e) {
-        logger_.error("Error activando efector: " + std::string(e.what()));
+        logger_.error("Error activando efector: {}", e.what());
         // Retornar ERROR: 
         return "ERROR: " + std::string(e.what());
     }
@@ -197,8 +238,9 @@ std::string RobotService::desactivarEfector() {
 
         std::string respuestaCompleta = arduinoService_->enviarComando("M5\r\n", getTimeoutParaComando("M5"));
 
-        logRespuestaCompleta(respuestaCompleta, "M5");
-        std::string respuestaCliente = procesarRespuesta(respuestaCompleta);
+        RespuestaFirmware respuesta = FirmwareLog::parsear(respuestaCompleta);
+        logRespuestaCompleta(respuesta, "M5");
+        std::string respuestaCliente = procesarRespuesta(respuesta);
 
         if (esTareaManual) {
             modoEjecucion_ = ModoEjecucion::DETENIDO;
@@ -207,7 +249,7 @@ std::string RobotService::desactivarEfector() {
         return respuestaCliente;
 
     } catch (const std::exception& e) {
-        logger_.error("Error desactivando efector: " + std::string(e.what()));
+        logger_.error("Error desactivando efector: {}", e.what());
         return "ERROR: " + std::string(e.what());
     }
 }
@@ -224,15 +266,16 @@ std::string RobotService::activarMotores() {
     try { 
         std::string respuestaCompleta = arduinoService_->enviarComando("M17\r\n", getTimeoutParaComando("M17"));
         
-        logRespuestaCompleta(respuestaCompleta, "M17");
-        std::string respuestaCliente = procesarRespuesta(respuestaCompleta);
+        RespuestaFirmware respuesta = FirmwareLog::parsear(respuestaCompleta);
+        logRespuestaCompleta(respuesta, "M17");
+        std::string respuestaCliente = procesarRespuesta(respuesta);
         
         motoresActivados_ = true;
 
         return respuestaCliente;
         
     } catch (const std::exception& e) {
-        logger_.error("Error activando motores: " + std::string(e.what()));
+        logger_.error("Error activando motores: {}", e.what());
         return "ERROR: " + std::string(e.what());
     }
 }
@@ -249,15 +292,16 @@ std::string RobotService::desactivarMotores() {
     try {   
         std::string respuestaCompleta = arduinoService_->enviarComando("M18\r\n", getTimeoutParaComando("M18"));
         
-        logRespuestaCompleta(respuestaCompleta, "M18");
-        std::string respuestaCliente = procesarRespuesta(respuestaCompleta);
+        RespuestaFirmware respuesta = FirmwareLog::parsear(respuestaCompleta);
+        logRespuestaCompleta(respuesta, "M18");
+        std::string respuestaCliente = procesarRespuesta(respuesta);
         
         motoresActivados_ = false;
 
         return respuestaCliente;
         
     } catch (const std::exception& e) {
-        logger_.error("Error desactivando motores: " + std::string(e.what()));
+        logger_.error("Error desactivando motores: {}", e.what());
         return "ERROR: " + std::string(e.what());
     }
 }
@@ -272,13 +316,14 @@ std::string RobotService::obtenerEstado() {
     try {
         std::string respuestaCompleta = arduinoService_->enviarComando("M114\r\n", getTimeoutParaComando("M114"));
         
-        logRespuestaCompleta(respuestaCompleta, "M114");
-        std::string respuestaCliente = procesarRespuesta(respuestaCompleta);
+        RespuestaFirmware respuesta = FirmwareLog::parsear(respuestaCompleta);
+        logRespuestaCompleta(respuesta, "M114");
+        std::string respuestaCliente = procesarRespuesta(respuesta);
     
         return respuestaCliente;
         
     } catch (const std::exception& e) {
-        logger_.error("Error obteniendo estado: " + std::string(e.what()));
+        logger_.error("Error obteniendo estado: {}", e.what());
         return "ERROR: " + std::string(e.what());
     }
 }
@@ -296,14 +341,15 @@ bool RobotService::setModoCoordenadas(ModoCoordenadas modo) {
         // Enviar comando
         std::string respuestaCompleta = arduinoService_->enviarComando(comando);
         
-        logRespuestaCompleta(respuestaCompleta, comando);
-        std::string respuestaCliente = procesarRespuesta(respuestaCompleta);
+        RespuestaFirmware respuesta = FirmwareLog::parsear(respuestaCompleta);
+        logRespuestaCompleta(respuesta, comando);
+        std::string respuestaCliente = procesarRespuesta(respuesta);
         
         modoCoordenadas_ = modo;
         return true;
         
     } catch (const std::exception& e) {
-        logger_.error("Error cambiando modo coordenadas: " + std::string(e.what()));
+        logger_.error("Error cambiando modo coordenadas: {}", e.what());
         return false;
     }
 }
@@ -312,7 +358,7 @@ bool RobotService::setModoCoordenadas(ModoCoordenadas modo) {
 bool RobotService::setModoOperacion(ModoOperacion modo) {
     modoOperacion_ = modo;
     std::string modoStr = (modo == ModoOperacion::MANUAL) ? "MANUAL" : "AUTOMATICO";
-    logger_.info("Modo operacion cambiado a: " + modoStr);
+    logger_.info("Modo operacion cambiado a: {}", modoStr);
     return true;
 }
 
@@ -347,139 +393,83 @@ std::string RobotService::formatearComandoG1(double x, double y, double z, doubl
     return comando.str();
 }
 
+std::string RobotService::formatearComandoArco(double x, double y, double z, double i, double j,
+                                               double velocidad, bool horario) {
+    std::ostringstream comando;
+    comando << (horario ? "G2" : "G3");
 
-// ==============================================================================
-
-std::string RobotService::procesarRespuesta(const std::string& respuestaCompleta) {
-    
-    // Inicializar variables
-    std::istringstream stream(respuestaCompleta);
-    std::string linea;
-    std::vector<std::string> mensajes;
-
-    bool comandoExitoso = false;
-
-    bool tieneError = false;
-    std::string mensajeError;
-
-    while (std::getline(stream, linea)) {
-        // Limpiar espacios y saltos de línea
-        linea.erase(0, linea.find_first_not_of(" \t\r\n"));
-        linea.erase(linea.find_last_not_of(" \t\r\n") + 1);
-
-        if (linea.empty()) {
-            continue;
-        }
-
-        // Verificar si es línea OK
-        if (linea == SUFFIX_OK) {
-            comandoExitoso = true;
-            continue;
-        }
+    comando << " X" << std::fixed << std::setprecision(2) << x;
+    comando << " Y" << std::fixed << std::setprecision(2) << y;
+    comando << " Z" << std::fixed << std::setprecision(2) << z;
+    comando << " I" << std::fixed << std::setprecision(3) << i;
+    comando << " J" << std::fixed << std::setprecision(3) << j;
 
-        // Procesar mensajes INFO
-        if (linea.find(PREFIX_INFO) == 0) {
-            std::string mensaje = linea.substr(PREFIX_INFO.length());
-            mensaje.erase(0, mensaje.find_first_not_of(" \t"));
-            if (!mensaje.empty()) {
-                mensajes.push_back(mensaje);
-            }
-            continue;
-        }
+    if (velocidad > 0) {
+        comando << " F" << std::fixed << std::setprecision(0) << velocidad;
+    }
 
-        // Procesar mensajes ERROR
-        if (linea.find(PREFIX_ERROR) == 0) {
-            std::string mensaje = linea.substr(PREFIX_ERROR.length());
-            mensaje.erase(0, mensaje.find_first_not_of(" \t"));
+    comando << "\r\n";
+    return comando.str();
+}
 
-            // Guardar mensaje de error
-            if (!mensaje.empty()) {
-                tieneError = true;
-                mensajeError = mensaje;
-            }
-            continue;
-        }
+// ==============================================================================
 
-        // Si no tiene prefijo conocido, asumir que es mensaje informativo
-        mensajes.push_back(linea);
-    }
+std::string RobotService::procesarRespuesta(const RespuestaFirmware& respuesta) {
 
     // Si hay error, lanzar excepción
-    if (tieneError) {
-        throw std::runtime_error(mensajeError);
+    if (respuesta.tieneError) {
+        throw std::runtime_error(respuesta.mensajeError);
     }
 
     // Si no se recibió OK, lanzar excepción
-    if (!comandoExitoso) {
+    if (!respuesta.ok) {
         throw std::runtime_error("No se recibió confirmación OK del Arduino");
     }
 
     // Combinar mensajes para el cliente
-    if (mensajes.empty()) {
+    if (respuesta.mensajes.empty()) {
         return "Movimiento completado";
     }
 
     std::string resultado;
-    for (size_t i = 0; i < mensajes.size(); ++i) {
+    for (size_t i = 0; i < respuesta.mensajes.size(); ++i) {
         if (i > 0) resultado += " | ";
-        resultado += mensajes[i];
+        resultado += respuesta.mensajes[i];
     }
 
     return resultado;
 }
 
 
-void RobotService::logRespuestaCompleta(const std::string& respuestaCompleta, const std::string& comando) {
-    std::istringstream stream(respuestaCompleta);
-    std::string linea;
-    bool tieneError = false;
-    std::vector<std::string> lineasImportantes;
-    
-    // Filtrar lineas importantes
-    while (std::getline(stream, linea)) {
-        linea.erase(0, linea.find_first_not_of(" \t\r\n"));
-        linea.erase(linea.find_last_not_of(" \t\r\n") + 1);
-        
-        if (linea.empty()) continue;
-        
-        if (linea.find(PREFIX_INFO) == 0) {
-            lineasImportantes.push_back(linea);
-
-        } else if (linea.find(PREFIX_ERROR) == 0) {
-            tieneError = true;
-            lineasImportantes.push_back(linea);
-        }
+void RobotService::logRespuestaCompleta(const RespuestaFirmware& respuesta, const std::string& comando) {
+    const LogLevel nivel = respuesta.tieneError ? LogLevel::ERROR : LogLevel::INFO;
+    if (!logger_.isEnabled(nivel)) {
+        return;
     }
 
     // Loggear de forma condensada
-    if (lineasImportantes.empty()) {
-        logger_.info("Comando '" + comando + "' - Sin respuesta específica");
+    if (respuesta.lineasLog.empty()) {
+        logger_.info("Comando '{}' - Sin respuesta específica", comando);
         return;
     }
 
-    std::string mensajeLog = "Respuesta '" + comando + "': ";
-    for (size_t i = 0; i < lineasImportantes.size(); ++i) {
-        if (i > 0) mensajeLog += " | ";
-        
-        std::string linea = lineasImportantes[i];
-        if (linea.find(PREFIX_INFO) == 0) {
-            mensajeLog += linea.substr(PREFIX_INFO.length());
-        } else if (linea.find(PREFIX_ERROR) == 0) {
-            mensajeLog += linea.substr(PREFIX_ERROR.length());
-        } else if (linea.find(SUFFIX_OK) == 0) {
-            mensajeLog += "OK";
-        } else {
-            mensajeLog += linea;
-        }
+    std::string lineas;
+    for (size_t i = 0; i < respuesta.lineasLog.size(); ++i) {
+        if (i > 0) lineas += " | ";
+        lineas += respuesta.lineasLog[i];
     }
 
-    if (tieneError) {
-        logger_.error(mensajeLog);
+    if (respuesta.tieneError) {
+        logger_.error("Respuesta '{}': {}", comando, lineas);
     } else {
-        logger_.info(mensajeLog);
+        logger_.info("Respuesta '{}': {}", comando, lineas);
     }
 }
 
+void RobotService::configurarGrabacion(size_t umbralBytes, std::chrono::milliseconds intervalo) {
+    trajectoryManager_->configurarGrabacion(umbralBytes, intervalo);
+}
+
 bool RobotService::iniciarGrabacionTrayectoria(const std::string& nombreLogico) {
     if (!estaConectado()) {
         logger_.warning("Intento de iniciar grabación sin robot conectado.");
@@ -487,7 +477,7 @@ bool RobotService::iniciarGrabacionTrayectoria(const std::string& nombreLogico)
     }
     // El nombre de archivo final se construirá dentro del manager
     // usando el nombreLogico y el UserID del contexto.
-    logger_.info("Iniciando grabación de trayectoria: " + nombreLogico);
+    logger_.info("Iniciando grabación de trayectoria: {}", nombreLogico);
     return trajectoryManager_->iniciarGrabacion(nombreLogico);
 }
 
@@ -514,6 +504,12 @@ std::chrono::milliseconds RobotService::getTimeoutParaComando(const std::string&
     if (lineaGCode.rfind("G1", 0) == 0) {
         return 20000ms; 
     }
+
+    // G2/G3 (Arco) - reemplaza a muchos G1 cortos, puede durar más que un tramo recto.
+    // Ojo: "G2" también es prefijo de "G28", por eso se exige el espacio.
+    if (lineaGCode.rfind("G2 ", 0) == 0 || lineaGCode.rfind("G3 ", 0) == 0) {
+        return 30000ms;
+    }
     
     // G28 (Homing) - También es un movimiento físico largo.
     if (lineaGCode.rfind("G28", 0) == 0) {
@@ -522,13 +518,13 @@ std::chrono::milliseconds RobotService::getTimeoutParaComando(const std::string&
 
     // Timeouts para comandos de actuadores
     
-    // M3 (Gripper On) - Suele ser lento.
+    // M3 (Gripper On) - ~1.2 s de pasos; el firmware ya no bloquea la serie mientras tanto.
     if (lineaGCode.rfind("M3", 0) == 0) {
-        return 8000ms;
+        return 4000ms;
     }
-    // M5 (Gripper Off) - Suele ser lento.
+    // M5 (Gripper Off) - Ídem M3.
     if (lineaGCode.rfind("M5", 0) == 0) {
-        return 8000ms;
+        return 4000ms;
     }
 
     // Timeouts para comandos de estado (suelen ser rápidos)
@@ -540,7 +536,7 @@ std::chrono::milliseconds RobotService::getTimeoutParaComando(const std::string&
         return 3000ms;
     }
     if (lineaGCode.rfind("M114", 0) == 0) { // Obtener estado
-        return 5000ms; // Un poco más por si la respuesta es larga
+        return 2000ms; // El firmware lo responde al llegar, sin pasar por la cola
     }
     
     // Default para cualquier otro comando (G90, G91, etc.)
@@ -548,10 +544,11 @@ std::chrono::milliseconds RobotService::getTimeoutParaComando(const std::string&
     return 3000ms;
 }
 
-// --- REEMPLAZAR LA FUNCIÓN COMPLETA ---
-
-string RobotService::ejecutarTrayectoria(const std::string& nombreArchivo) {
-    logger_.info("Solicitud para ejecutar trayectoria: " + nombreArchivo);
+string RobotService::ejecutarTrayectoria(const std::string& nombreArchivo, bool reordenar) {
+    if (reordenar) {
+        return ejecutarTrayectoriaReordenada(nombreArchivo);
+    }
+    logger_.info("Solicitud para ejecutar trayectoria: {}", nombreArchivo);
 
     // 1. Cambiar estado a automático (para la preparación)
     setModoOperacion(ModoOperacion::AUTOMATICO);
@@ -559,107 +556,389 @@ string RobotService::ejecutarTrayectoria(const std::string& nombreArchivo) {
 
     try {
         // 2. Cargar el archivo de trayectoria
-        logger_.info("Cargando archivo: " + nombreArchivo);
-        std::vector<std::string> lineas = trajectoryManager_->cargarTrayectoria(nombreArchivo);
+        logger_.info("Cargando archivo: {}", nombreArchivo);
+        std::unique_ptr<MappedFile> archivo = trajectoryManager_->abrirTrayectoria(nombreArchivo);
 
-        if (lineas.empty()) {
+        if (archivo->empty()) {
             throw std::runtime_error("El archivo no existe o está vacío.");
         }
 
+        // Una corrida completa descarta cualquier checkpoint anterior
+        trajectoryManager_->eliminarCheckpoint(nombreArchivo);
+
         // 3. Preparar el robot (Contexto de Ejecución)
-        // (Esta lógica sigue igual)
-        // -------------------------------------------------
-        logger_.info("Preparando robot para ejecución automática...");
-        
-        std::string respMotores = activarMotores();
-        if (respMotores.rfind("ERROR:", 0) == 0 && respMotores.find("ya activados") == std::string::npos) {
-            throw std::runtime_error("Fallo al activar motores: " + respMotores);
+        prepararEjecucion(true);
+
+        logger_.info("Robot preparado. Iniciando ejecución de {} ({} bytes).", nombreArchivo, archivo->size());
+
+        // 4. Ejecutar la Tarea (Línea por línea), guardando checkpoint
+        CheckpointTrayectoria checkpoint;
+        checkpoint.archivo = nombreArchivo;
+        ejecutarLineas(*archivo, 0, checkpoint);
+
+        // 5. Finalización
+        trajectoryManager_->eliminarCheckpoint(nombreArchivo);
+        logger_.info("Ejecución de trayectoria '{}' completada.", nombreArchivo);
+        setModoOperacion(ModoOperacion::MANUAL);
+        modoEjecucion_ = ModoEjecucion::DETENIDO;
+        return "Ejecución completada: " + nombreArchivo;
+
+    } catch (const std::exception& e) {
+        // Manejo de CUALQUER error
+        logger_.error("ERROR durante la ejecución de la trayectoria: {}", e.what());
+        setModoOperacion(ModoOperacion::MANUAL);
+        modoEjecucion_ = ModoEjecucion::DETENIDO;
+
+        std::string respuesta = "ERROR: " + std::string(e.what());
+        if (auto checkpoint = trajectoryManager_->cargarCheckpoint(nombreArchivo)) {
+            respuesta += " (checkpoint en la línea " + std::to_string(checkpoint->lineaReanudacion + 1) +
+                         ", use robot.resumeFile para continuar)";
         }
-        if (!setModoCoordenadas(ModoCoordenadas::ABSOLUTO)) {
-            throw std::runtime_error("Fallo al establecer modo absoluto (G90).");
+        return respuesta;
+    }
+}
+
+string RobotService::ejecutarTrayectoriaReordenada(const std::string& nombreArchivo) {
+    logger_.info("Solicitud para ejecutar trayectoria reordenada: {}", nombreArchivo);
+
+    std::vector<std::string> lineas = trajectoryManager_->cargarTrayectoria(nombreArchivo);
+    if (lineas.empty()) {
+        return "ERROR: El archivo no existe o está vacío.";
+    }
+
+    ResultadoReorden reorden = PickPlaceReorderer::reordenar(lineas);
+    if (!reorden.reordenado) {
+        logger_.info("No se reordena '{}': {}. Se ejecuta en el orden original.", nombreArchivo, reorden.motivo);
+        return ejecutarTrayectoria(nombreArchivo);
+    }
+
+    // Se ejecuta una copia para que el checkpoint (líneas) corresponda al archivo realmente ejecutado.
+    // Hay una sola copia por original: cada corrida la sobrescribe.
+    std::string contenido;
+    for (const auto& l : reorden.lineas) {
+        contenido += l;
+        contenido += '\n';
+    }
+    std::string copia = trajectoryManager_->guardarCopiaDerivada(nombreArchivo, SUFIJO_REORDENADA, contenido);
+    if (copia.empty()) {
+        return "ERROR: No se pudo guardar la copia reordenada de '" + nombreArchivo + "'.";
+    }
+
+    std::ostringstream ahorro;
+    ahorro << std::fixed << std::setprecision(1)
+           << reorden.bloques << " operaciones reordenadas, traslados "
+           << reorden.viajeAntesSeg << "s -> " << reorden.viajeDespuesSeg << "s estimados";
+    logger_.info("'{}' reordenado como '{}': {}", nombreArchivo, copia, ahorro.str());
+
+    // El checkpoint queda a nombre de la copia: se informa también si falla
+    std::string respuesta = ejecutarTrayectoria(copia);
+    if (respuesta.rfind("ERROR:", 0) == 0) {
+        return respuesta + " [copia reordenada ejecutada: " + copia + "]";
+    }
+    return respuesta + " (" + ahorro.str() + ")";
+}
+
+string RobotService::reanudarTrayectoria(const std::string& nombreArchivo) {
+    logger_.info("Solicitud para reanudar trayectoria: {}", nombreArchivo);
+
+    std::optional<CheckpointTrayectoria> checkpoint = trajectoryManager_->cargarCheckpoint(nombreArchivo);
+    if (!checkpoint) {
+        // Una corrida con reordenar=true deja el checkpoint en su copia
+        const std::string copia = trajectoryManager_->nombreCopiaDerivada(nombreArchivo, SUFIJO_REORDENADA);
+        if (trajectoryManager_->cargarCheckpoint(copia)) {
+            logger_.info("'{}' se interrumpió en su copia reordenada: se reanuda '{}'", nombreArchivo, copia);
+            return reanudarTrayectoria(copia);
         }
-        logger_.info("Ejecutando Homing (G28) antes de la trayectoria...");
-        std::string respHoming = homing();
-        if (respHoming.rfind("ERROR:", 0) == 0) {
-            throw std::runtime_error("Fallo durante el homing: " + respHoming);
+        return "ERROR: No hay checkpoint para reanudar '" + nombreArchivo + "'";
+    }
+
+    setModoOperacion(ModoOperacion::AUTOMATICO);
+    modoEjecucion_ = ModoEjecucion::EJECUTANDO;
+
+    try {
+        std::unique_ptr<MappedFile> archivo = trajectoryManager_->abrirTrayectoria(nombreArchivo);
+        if (archivo->empty()) {
+            throw std::runtime_error("El archivo no existe o está vacío.");
         }
-                
-        logger_.info("Robot preparado. Iniciando ejecución de " + std::to_string(lineas.size()) + " comandos.");
-        
-        // 4. Ejecutar la Tarea (Línea por línea) - MODO INTELIGENTE
-        // -------------------------------------------------
-        for (const std::string& linea : lineas) {
-            if (linea.empty()) continue; 
-
-            logger_.info("-> Procesando: " + linea);
-            std::string respuestaLinea;
-
-            // --- INICIO DE LA LÓGICA DE PARSEO ---
-
-            if (linea.rfind("G1", 0) == 0) {
-                // Es un comando G1. ¡Tenemos que parsearlo!
-                std::istringstream iss(linea);
-                std::string token;
-                double x = 0, y = 0, z = 0, f = 50; // Asumir valores por defecto
-
-                // Parseo simple de G-Code
-                while (iss >> token) {
-                    if (token.empty()) continue;
-                    char tipo = token[0];
-                    double valor = std::stod(token.substr(1));
-                    
-                    switch (tipo) {
-                        case 'X': x = valor; break;
-                        case 'Y': y = valor; break;
-                        case 'Z': z = valor; break;
-                        case 'F': f = valor; break;
-                        default: break;
-                    }
-                }
-                // Llamamos al método 'mover' que SABEMOS que funciona
-                respuestaLinea = mover(x, y, z, f);
-            
-            } else if (linea == "M3") {
-                // Llamamos al método 'activarEfector' que SABEMOS que funciona
-                respuestaLinea = activarEfector();
-
-            } else if (linea == "M5") {
-                // Llamamos al método 'desactivarEfector' que SABEMOS que funciona
-                respuestaLinea = desactivarEfector();
-            
-            } else {
-                logger_.warning("Comando desconocido en archivo: '" + linea + "'. Omitiendo.");
-                continue; // Saltar al siguiente comando
-            }
 
-            // --- FIN DE LA LÓGICA DE PARSEO ---
+        const size_t desde = checkpoint->lineaReanudacion;
+        if (checkpoint->motivo.empty()) {
+            logger_.info("Checkpoint encontrado: reanudando en la línea {}", desde + 1);
+        } else {
+            logger_.info("Checkpoint encontrado: reanudando en la línea {} (falló por: {})", desde + 1, checkpoint->motivo);
+        }
 
-            // Ahora chequeamos el resultado de la *llamada al método*
-            // (mover, activarEfector, etc.)
-            if (respuestaLinea.rfind("ERROR:", 0) == 0) {
-                // Si el método (ej. 'mover') falló, lanzamos una excepción
-                // para detener toda la trayectoria.
-                throw std::runtime_error("Error en la línea '" + linea + "': " + respuestaLinea);
-            }
-                        
+        // Sin pose confirmada no sabemos dónde quedó el brazo: se hace homing como en una corrida completa
+        prepararEjecucion(!checkpoint->poseValida);
+        if (checkpoint->poseValida) {
+            aproximarAPose(*checkpoint);
         }
+        // Tras un reset o reconexión el efector puede no estar como quedó
+        restaurarEfector(*checkpoint);
 
-        // 5. Finalización
-        // -------------------------------------------------
-        logger_.info("Ejecución de trayectoria '" + nombreArchivo + "' completada.");
+        ejecutarLineas(*archivo, desde, *checkpoint);
+
+        trajectoryManager_->eliminarCheckpoint(nombreArchivo);
+        logger_.info("Ejecución reanudada de '{}' completada.", nombreArchivo);
         setModoOperacion(ModoOperacion::MANUAL);
         modoEjecucion_ = ModoEjecucion::DETENIDO;
-        return "Ejecución completada: " + nombreArchivo;
+        return "Ejecución reanudada desde la línea " + std::to_string(desde + 1) + " y completada: " + nombreArchivo;
 
     } catch (const std::exception& e) {
-        // Manejo de CUALQUER error
-        logger_.error("ERROR durante la ejecución de la trayectoria: " + std::string(e.what()));
+        logger_.error("ERROR durante la reanudación de la trayectoria: {}", e.what());
         setModoOperacion(ModoOperacion::MANUAL);
         modoEjecucion_ = ModoEjecucion::DETENIDO;
         return "ERROR: " + std::string(e.what());
     }
 }
 
+void RobotService::prepararEjecucion(bool conHoming) {
+    logger_.info("Preparando robot para ejecución automática...");
+
+    std::string respMotores = activarMotores();
+    if (respMotores.rfind("ERROR:", 0) == 0 && respMotores.find("ya activados") == std::string::npos) {
+        throw std::runtime_error("Fallo al activar motores: " + respMotores);
+    }
+    if (!setModoCoordenadas(ModoCoordenadas::ABSOLUTO)) {
+        throw std::runtime_error("Fallo al establecer modo absoluto (G90).");
+    }
+    if (conHoming) {
+        logger_.info("Ejecutando Homing (G28) antes de la trayectoria...");
+        std::string respHoming = homing();
+        if (respHoming.rfind("ERROR:", 0) == 0) {
+            throw std::runtime_error("Fallo durante el homing: " + respHoming);
+        }
+    }
+}
+
+void RobotService::aproximarAPose(const CheckpointTrayectoria& checkpoint) {
+    // Primero por encima de la pose registrada y luego bajando en vertical,
+    // para no arrastrar la pieza ni chocar con lo que quedó en la zona de trabajo.
+    logger_.info("Aproximación segura a la pose del checkpoint...");
+    std::string resp = mover(checkpoint.x, checkpoint.y, checkpoint.z + DESPEJE_Z_REANUDACION, checkpoint.f);
+    if (resp.rfind("ERROR:", 0) == 0) {
+        logger_.warning("No se pudo aproximar con despeje ({}). Se intenta el movimiento directo.", resp);
+    }
+
+    resp = mover(checkpoint.x, checkpoint.y, checkpoint.z, checkpoint.f);
+    if (resp.rfind("ERROR:", 0) == 0) {
+        throw std::runtime_error("Fallo en la aproximación a la pose del checkpoint: " + resp);
+    }
+}
+
+void RobotService::restaurarEfector(const CheckpointTrayectoria& checkpoint) {
+    logger_.info("Restaurando el efector al estado del checkpoint: {}", checkpoint.efectorActivo ? "ACTIVO" : "INACTIVO");
+    std::string resp = checkpoint.efectorActivo ? activarEfector() : desactivarEfector();
+    if (resp.rfind("ERROR:", 0) == 0) {
+        throw std::runtime_error("Fallo al restaurar el efector del checkpoint: " + resp);
+    }
+}
+
+void RobotService::ejecutarLineas(MappedFile& archivo, size_t desde,
+                                  CheckpointTrayectoria& checkpoint) {
+    if (!archivo.saltarA(desde)) {
+        throw std::runtime_error("El archivo tiene menos de " + std::to_string(desde + 1) + " líneas.");
+    }
+
+    // 'checkpoint' sigue lo aceptado por el firmware y vive en memoria mientras
+    // se transmite. En disco se guarda solo lo que ya se ejecutó (ver
+    // MovimientosPendientes), y cada tanto: un M114 y una reescritura del
+    // checkpoint por línea duplicarían el tráfico serie y el planificador del
+    // firmware nunca llegaría a llenarse.
+    MovimientosPendientes pendientes;
+    size_t lineasSinGuardar = 0;
+    auto ultimoGuardado = std::chrono::steady_clock::now();
+    std::string_view vista;
+    while (archivo.siguienteLinea(vista)) {
+        const size_t i = archivo.lineaActual() - 1;
+        checkpoint.lineaReanudacion = i;
+        if (vista.empty()) continue;
+        const std::string linea(vista);  // líneas cortas: la copia es solo para el envío y el log
+
+        logger_.info("-> Procesando: {}", linea);
+
+        std::string respuestaLinea;
+        try {
+            respuestaLinea = ejecutarLineaGCode(linea, checkpoint, pendientes);
+        } catch (const std::exception& e) {
+            respuestaLinea = "ERROR: " + std::string(e.what());
+        }
+
+        if (respuestaLinea.rfind("ERROR:", 0) == 0) {
+            // Guardamos dónde quedó para poder reanudar sin repetir lo ya hecho,
+            // y lanzamos una excepción para detener toda la trayectoria.
+            checkpoint.motivo = respuestaLinea;
+            guardarCheckpointConfirmado(pendientes, checkpoint);
+            throw std::runtime_error("Error en la línea " + std::to_string(i + 1) + " '" + linea + "': " + respuestaLinea);
+        }
+
+        // Línea aceptada por el firmware (un movimiento puede seguir en el planificador)
+        checkpoint.lineaReanudacion = i + 1;
+        checkpoint.motivo.clear();
+
+        const auto ahora = std::chrono::steady_clock::now();
+        if (++lineasSinGuardar >= LINEAS_ENTRE_CHECKPOINTS || ahora - ultimoGuardado >= INTERVALO_CHECKPOINT) {
+            guardarCheckpointConfirmado(pendientes, checkpoint);
+            lineasSinGuardar = 0;
+            ultimoGuardado = ahora;
+        }
+    }
+
+    esperarMovimientos(pendientes, checkpoint);
+}
+
+bool RobotService::leerPosicion(double& x, double& y, double& z) {
+    try {
+        std::string respuestaCompleta = arduinoService_->enviarComando("M114\r\n", getTimeoutParaComando("M114"));
+        return FirmwareLog::posicionActual(FirmwareLog::parsear(respuestaCompleta), x, y, z);
+    } catch (const std::exception& e) {
+        logger_.warning("No se pudo leer la posición (M114): {}", e.what());
+        return false;
+    }
+}
+
+void RobotService::confirmarMovimientos(MovimientosPendientes& pendientes) {
+    double x, y, z;
+    if (!pendientes.vacio() && leerPosicion(x, y, z)) {
+        pendientes.confirmarConPosicion(x, y, z);
+    }
+}
+
+void RobotService::guardarCheckpointConfirmado(MovimientosPendientes& pendientes,
+                                               const CheckpointTrayectoria& checkpoint) {
+    confirmarMovimientos(pendientes);
+    trajectoryManager_->guardarCheckpoint(pendientes.checkpointConfirmado(checkpoint));
+}
+
+void RobotService::esperarMovimientos(MovimientosPendientes& pendientes, const CheckpointTrayectoria& checkpoint) {
+    if (!pendientes.vacio()) {
+        logger_.info("Esperando {} movimiento(s) aceptados por el firmware...", pendientes.cantidad());
+    }
+
+    auto ultimoAvance = std::chrono::steady_clock::now();
+    auto ultimoGuardado = ultimoAvance;
+    bool hayPosicion = false;
+    double xPrevia = 0, yPrevia = 0, zPrevia = 0;
+    while (!pendientes.vacio()) {
+        // El último movimiento recién entró al planificador: consultar sin pausa
+        // solo ocuparía la línea serie que el firmware usa para responder
+        std::this_thread::sleep_for(INTERVALO_CONSULTA_POSICION);
+
+        double x, y, z;
+        bool avanzo = false;
+        if (leerPosicion(x, y, z)) {
+            avanzo = pendientes.confirmarConPosicion(x, y, z) > 0
+                     || (hayPosicion && (x != xPrevia || y != yPrevia || z != zPrevia));
+            hayPosicion = true;
+            xPrevia = x;
+            yPrevia = y;
+            zPrevia = z;
+        }
+
+        const auto ahora = std::chrono::steady_clock::now();
+        if (avanzo) {
+            ultimoAvance = ahora;
+            if (ahora - ultimoGuardado >= INTERVALO_CHECKPOINT) {
+                trajectoryManager_->guardarCheckpoint(pendientes.checkpointConfirmado(checkpoint));
+                ultimoGuardado = ahora;
+            }
+        } else if (ahora - ultimoAvance > ESPERA_SIN_AVANCE) {
+            // El brazo se detuvo antes de llegar (M410, reset): esos movimientos no se hicieron
+            const std::string error = "El firmware no completó " + std::to_string(pendientes.cantidad()) +
+                                      " movimiento(s) aceptados";
+            CheckpointTrayectoria confirmado = pendientes.checkpointConfirmado(checkpoint);
+            confirmado.motivo = "ERROR: " + error;
+            trajectoryManager_->guardarCheckpoint(confirmado);
+            throw std::runtime_error(error + " (desde la línea " + std::to_string(confirmado.lineaReanudacion + 1) + ")");
+        }
+    }
+}
+
+string RobotService::ejecutarLineaGCode(const std::string& linea, CheckpointTrayectoria& checkpoint,
+                                        MovimientosPendientes& pendientes) {
+    std::string respuestaLinea;
+    const CheckpointTrayectoria antes = checkpoint;
+
+    // G2/G3 se detectan con el parser común ("G2" también es prefijo de "G28")
+    LineaGCode arco;
+    const bool esArco = GCodeAnalyzer::parsearLinea(linea, arco) && arco.letra == 'G'
+                        && (arco.numero == 2 || arco.numero == 3);
+
+    if (linea.rfind("G1", 0) == 0) {
+        // Es un comando G1. ¡Tenemos que parsearlo!
+        std::istringstream iss(linea);
+        std::string token;
+        double x = 0, y = 0, z = 0, f = 50; // Asumir valores por defecto
+
+        // Parseo simple de G-Code
+        while (iss >> token) {
+            if (token.empty()) continue;
+            char tipo = token[0];
+            double valor = std::stod(token.substr(1));
+
+            switch (tipo) {
+                case 'X': x = valor; break;
+                case 'Y': y = valor; break;
+                case 'Z': z = valor; break;
+                case 'F': f = valor; break;
+                default: break;
+            }
+        }
+        respuestaLinea = mover(x, y, z, f);
+        if (respuestaLinea.rfind("ERROR:", 0) != 0) {
+            checkpoint.x = x;
+            checkpoint.y = y;
+            checkpoint.z = z;
+            checkpoint.f = f;
+            checkpoint.poseValida = true;
+            pendientes.agregar(antes, x, y, z, true);
+        }
+
+    } else if (esArco) {
+        if (!arco.tieneI && !arco.tieneJ) {
+            return "ERROR: Arco sin centro (I/J)";
+        }
+        // Los ejes omitidos conservan la pose actual (la última confirmada)
+        double x0 = checkpoint.poseValida ? checkpoint.x : GCodeAnalyzer::HOME_X;
+        double y0 = checkpoint.poseValida ? checkpoint.y : GCodeAnalyzer::HOME_Y;
+        double z0 = checkpoint.poseValida ? checkpoint.z : GCodeAnalyzer::HOME_Z;
+        double x = arco.tieneX ? arco.x : x0;
+        double y = arco.tieneY ? arco.y : y0;
+        double z = arco.tieneZ ? arco.z : z0;
+        double f = arco.tieneF ? arco.f : 50;
+
+        respuestaLinea = moverArco(x, y, z, arco.i, arco.j, f, arco.numero == 2);
+        if (respuestaLinea.rfind("ERROR:", 0) != 0) {
+            checkpoint.x = x;
+            checkpoint.y = y;
+            checkpoint.z = z;
+            checkpoint.f = f;
+            checkpoint.poseValida = true;
+            pendientes.agregar(antes, x, y, z, false);
+        }
+
+    } else if (linea == "M3") {
+        // El firmware responde M3/M5 con el planificador vacío y el efector ya movido
+        respuestaLinea = activarEfector();
+        if (respuestaLinea.rfind("ERROR:", 0) != 0) {
+            checkpoint.efectorActivo = true;
+            pendientes.confirmarTodos();
+        }
+
+    } else if (linea == "M5") {
+        respuestaLinea = desactivarEfector();
+        if (respuestaLinea.rfind("ERROR:", 0) != 0) {
+            checkpoint.efectorActivo = false;
+            pendientes.confirmarTodos();
+        }
+
+    } else {
+        logger_.warning("Comando desconocido en archivo: '{}'. Omitiendo.", linea);
+    }
+
+    return respuestaLinea;
+}
+
 std::string RobotService::guardarTrayectoriaSubida(const std::string& nombreArchivo, const std::string& contenido) {
     if (!trajectoryManager_) {
         logger_.error("TrajectoryManager no está inicializado. No se puede guardar el archivo.");
@@ -667,16 +946,61 @@ std::string RobotService::guardarTrayectoriaSubida(const std::string& nombreArch
     }
 
     if (contenido.empty()) {
-        logger_.warning("Intento de guardar trayectoria vacía: " + nombreArchivo);
+        logger_.warning("Intento de guardar trayectoria vacía: {}", nombreArchivo);
         return ""; // Devolver string vacío en caso de error
     }
     
-    logger_.info("Guardando archivo de trayectoria subido: " + nombreArchivo);
+    logger_.info("Guardando archivo de trayectoria subido: {}", nombreArchivo);
     
     // Delegamos la lógica al manager y devolvemos su respuesta (el nombre final o "")
     return trajectoryManager_->guardarTrayectoriaCompleta(nombreArchivo, contenido);
 }
 
+void RobotService::logResultadoOptimizacion(const std::string& nombreArchivo,
+                                            const ResultadoOptimizacion& resultado) {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(1)
+        << "Optimización de '" << nombreArchivo << "': "
+        << resultado.lineasAntes << " -> " << resultado.lineasDespues << " líneas ("
+        << resultado.movimientosEliminados << " movimientos y "
+        << resultado.efectorEliminados << " comandos de efector eliminados), "
+        << resultado.duracionAntesSeg << "s -> " << resultado.duracionDespuesSeg << "s estimados.";
+    logger_.info(oss.str());
+}
+
+std::string RobotService::guardarTrayectoriaSubida(const std::string& nombreArchivo, const std::string& contenido,
+                                                   const OpcionesOptimizacion& opciones,
+                                                   ResultadoOptimizacion& resultado) {
+    if (contenido.empty()) {
+        logger_.warning("Intento de guardar trayectoria vacía: {}", nombreArchivo);
+        return "";
+    }
+
+    resultado = GCodeOptimizer::optimizar(contenido, opciones);
+    logResultadoOptimizacion(nombreArchivo, resultado);
+    return guardarTrayectoriaSubida(nombreArchivo, resultado.contenido());
+}
+
+std::string RobotService::optimizarTrayectoria(const std::string& nombreArchivo,
+                                               const OpcionesOptimizacion& opciones,
+                                               ResultadoOptimizacion& resultado) {
+    if (!trajectoryManager_) {
+        logger_.error("TrajectoryManager no está inicializado. No se puede optimizar el archivo.");
+        return "";
+    }
+
+    std::vector<std::string> lineas = trajectoryManager_->cargarTrayectoria(nombreArchivo);
+    if (lineas.empty()) {
+        logger_.warning("No se puede optimizar '{}': no existe o está vacío.", nombreArchivo);
+        return "";
+    }
+
+    resultado = GCodeOptimizer::optimizar(lineas, opciones);
+    logResultadoOptimizacion(nombreArchivo, resultado);
+    // Como la copia reordenada: conserva el dueño del original aunque la pida un admin
+    return trajectoryManager_->guardarCopiaDerivada(nombreArchivo, SUFIJO_OPTIMIZADA, resultado.contenido());
+}
+
 std::vector<std::string> RobotService::listarTrayectorias(int userId, const std::string& userRole) {
     if (!trajectoryManager_) {
         logger_.error("TrajectoryManager no está inicializado. No se pueden listar archivos.");
@@ -684,8 +1008,17 @@ std::vector<std::string> RobotService::listarTrayectorias(int userId, const std:
         return {};
     }
 
-    logger_.info("Solicitud para listar trayectorias por usuario ID: " + std::to_string(userId) + " (Rol: " + userRole + ")");
+    logger_.info("Solicitud para listar trayectorias por usuario ID: {} (Rol: {})", userId, userRole);
     
     // Delegamos toda la lógica de filtrado al manager
     return trajectoryManager_->listarTrayectorias(userId, userRole);
+}
+
+PaginaCatalogo RobotService::listarTrayectoriasPaginado(int userId, const std::string& userRole,
+                                                        const FiltroCatalogo& filtro) {
+    if (!trajectoryManager_) {
+        logger_.error("TrajectoryManager no está inicializado. No se pueden listar archivos.");
+        return {};
+    }
+    return trajectoryManager_->listarTrayectoriasPaginado(userId, userRole, filtro);
 }
\ No newline at end of file
@@ -8,12 +8,13 @@
 #include <iomanip>
 #include <sstream>
 #include <ctime>
+#include <unordered_map>
 
 namespace fs = std::filesystem;
 
 // ===================== Constructor =====================
 
-TrajectoryManager::TrajectoryManager(const std::string& directorioBase)
+TrajectoryManager::TrajectoryManager(const std::string& directorioBase, SqliteDb* dbCatalogo)
     : directorioBase(directorioBase), grabando(false), archivoActual(nullptr) {
     try {
         crearDirectorioSiNoExiste();
@@ -22,6 +23,16 @@ TrajectoryManager::TrajectoryManager(const std::string& directorioBase)
                   << directorioBase << " - " << e.what() << std::endl;
         throw;
     }
+
+    if (!dbCatalogo) {
+        dbCatalogoPropio = std::make_unique<SqliteDb>(":memory:");
+        dbCatalogo = dbCatalogoPropio.get();
+    }
+    catalogo = std::make_unique<TrajectoryCatalogSqlite>(*dbCatalogo);
+    size_t analizados = sincronizarCatalogo();
+    if (analizados > 0) {
+        std::cout << "Catálogo de trayectorias: " << analizados << " archivo(s) indexado(s)." << std::endl;
+    }
 }
 
 // ===================== Helpers de convención =====================
@@ -67,42 +78,53 @@ bool TrajectoryManager::existeTrayectoria(const std::string& nombreTrayectoria)
 }
 
 std::vector<std::string> TrajectoryManager::listarTrayectorias(int userId, const std::string& userRole) const {
+    FiltroCatalogo filtro;
+    filtro.ordenarPor = "nombre";
+    filtro.descendente = false;
+    filtro.conTotal = false;
+
     std::vector<std::string> lista;
-    
-    // Preparamos el prefijo del operador (ej. "2__")
-    std::string prefijoOperador;
-    if (userId >= 0) {
-        prefijoOperador = std::to_string(userId) + "__";
+    for (auto& entrada : listarTrayectoriasPaginado(userId, userRole, filtro).items) {
+        lista.push_back(std::move(entrada.archivo));
     }
+    return lista;
+}
 
+PaginaCatalogo TrajectoryManager::listarTrayectoriasPaginado(int userId, const std::string& userRole,
+                                                             FiltroCatalogo filtro) const {
+    if (userRole == "admin") {
+        // El Admin ve todo (o el owner que pida en el filtro)
+    } else if (userRole == "op" && userId >= 0) {
+        // El Operador solo ve sus archivos
+        filtro.ownerId = userId;
+    } else {
+        // Los "viewers" o roles desconocidos no ven nada
+        return {};
+    }
+
+    sincronizarSiCambioDirectorio();
     try {
-        for (const auto& entry : fs::directory_iterator(directorioBase)) {
-            if (!entry.is_regular_file()) continue;
-            
-            const std::string fname = entry.path().filename().string();
-            if (fname.rfind(".gcode", 0) != 0 && fname.rfind(".gcode") != (fname.size() - 6)) {
-                 continue; // Ignorar si no termina en .gcode
-            }
+        return catalogo->listar(filtro);
+    } catch (const std::exception& e) {
+        std::cerr << "Error al listar trayectorias del catálogo: " << e.what() << std::endl;
+        return {};
+    }
+}
 
-            // --- INICIO DE LA NUEVA LÓGICA DE FILTRADO ---
-            
-            if (userRole == "admin") {
-                // El Admin ve todo.
-                lista.push_back(fname);
-            
-            } else if (userRole == "op" && !prefijoOperador.empty()) {
-                // El Operador solo ve sus archivos.
-                if (fname.rfind(prefijoOperador, 0) == 0) {
-                    lista.push_back(fname);
-                }
-            }
-            // (Los "viewers" o roles desconocidos no ven nada)
-            // --- FIN DE LA NUEVA LÓGICA ---
+std::optional<EntradaCatalogo> TrajectoryManager::obtenerMetadatos(const std::string& nombreTrayectoria) const {
+    try {
+        const std::string nombreNorm = normalizarNombreArchivo(nombreTrayectoria);
+        auto entrada = catalogo->obtener(nombreNorm);
+        if (!entrada && existeTrayectoria(nombreNorm)) {
+            // Agregado por fuera con el servidor en marcha
+            sincronizarCatalogo();
+            entrada = catalogo->obtener(nombreNorm);
         }
+        return entrada;
     } catch (const std::exception& e) {
-        std::cerr << "Error al listar trayectorias en " << directorioBase << ": " << e.what() << std::endl;
+        std::cerr << "Error al leer metadatos de " << nombreTrayectoria << ": " << e.what() << std::endl;
+        return std::nullopt;
     }
-    return lista;
 }
 
 bool TrajectoryManager::eliminarTrayectoria(const std::string& nombreTrayectoria) {
@@ -125,6 +147,12 @@ bool TrajectoryManager::eliminarTrayectoria(const std::string& nombreTrayectoria
         std::cerr << "No se pudo eliminar '" << nombreNorm << "' (¿no existía?)." << std::endl;
         return false;
     }
+    eliminarCheckpoint(nombreNorm);
+    try {
+        catalogo->eliminar(nombreNorm);
+    } catch (const std::exception& e) {
+        std::cerr << "Error al quitar '" << nombreNorm << "' del catálogo: " << e.what() << std::endl;
+    }
     std::cout << "Trayectoria eliminada: " << nombreNorm << std::endl;
     return true;
 }
@@ -147,8 +175,12 @@ bool TrajectoryManager::iniciarGrabacion(const std::string& nombreTrayectoria) {
     trayectoriaActual = buildNombreConvencion(uid, nombreTrayectoria); 
 
     try {
-        archivoActual = std::make_unique<File>(trayectoriaActual, directorioBase);
-        archivoActual->open(FileMode::WRITE);  // trunca si existe
+        // Los comandos se acumulan en memoria y un hilo los vuelca al disco
+        archivoActual = std::make_unique<BufferedFileWriter>(
+            (fs::path(directorioBase) / trayectoriaActual).string(),
+            true,  // trunca si existe
+            umbralVolcado, intervaloVolcado);
+        analizadorGrabacion = GCodeAnalyzer();
         grabando = true;
         std::cout << "Iniciando grabación en: " << archivoActual->getFilePath() << std::endl;
         return true;
@@ -169,7 +201,8 @@ bool TrajectoryManager::guardarComando(const std::string& comandoGCode) {
     }
 
     try {
-        archivoActual->append(comandoGCode + "\n");
+        archivoActual->appendLine(comandoGCode);
+        analizadorGrabacion.procesarLinea(comandoGCode);
         return true;
     } catch (const std::exception& e) {
         std::cerr << "Error al guardar comando en " << trayectoriaActual << ": " << e.what() << std::endl;
@@ -186,35 +219,146 @@ bool TrajectoryManager::finalizarGrabacion() {
     bool ok = true;
     try {
         if (archivoActual && archivoActual->isOpen()) {
-            archivoActual->close();
+            archivoActual->close();  // vuelca y sincroniza (fdatasync) todo lo grabado
         }
     } catch (const std::exception& e) {
         std::cerr << "Error al cerrar archivo " << trayectoriaActual << ": " << e.what() << std::endl;
         ok = false;
     }
 
+    if (ok) {
+        registrarEnCatalogo(trayectoriaActual, analizadorGrabacion.resultado());
+    }
+
     grabando = false;
     trayectoriaActual.clear();
     archivoActual = nullptr;
     return ok;
 }
 
+void TrajectoryManager::configurarGrabacion(size_t umbralBytes, std::chrono::milliseconds intervalo) {
+    umbralVolcado = umbralBytes > 0 ? umbralBytes : 1;
+    intervaloVolcado = intervalo.count() > 0 ? intervalo : std::chrono::milliseconds(1);
+}
+
 // ===================== Carga =====================
 
 std::vector<std::string> TrajectoryManager::cargarTrayectoria(const std::string& nombreTrayectoria) const {
-    std::string nombreNorm = normalizarNombreArchivo(nombreTrayectoria);
     try {
-        File archivo(nombreNorm, directorioBase);
-        if (!archivo.exists()) {
-            throw std::runtime_error("El archivo de trayectoria no existe: " + nombreNorm);
+        std::unique_ptr<MappedFile> archivo = abrirTrayectoria(nombreTrayectoria);
+        std::vector<std::string> lineas;
+        std::string_view linea;
+        while (archivo->siguienteLinea(linea)) {
+            lineas.emplace_back(linea);
         }
-        return archivo.readLines();
+        return lineas;
     } catch (const std::exception& e) {
-        std::cerr << "Error al cargar trayectoria '" << nombreNorm << "': " << e.what() << std::endl;
+        std::cerr << "Error al cargar trayectoria '" << normalizarNombreArchivo(nombreTrayectoria)
+                  << "': " << e.what() << std::endl;
         return {};
     }
 }
 
+std::unique_ptr<MappedFile> TrajectoryManager::abrirTrayectoria(const std::string& nombreTrayectoria) const {
+    std::string nombreNorm = normalizarNombreArchivo(nombreTrayectoria);
+    std::string rutaCompleta = directorioBase + "/" + nombreNorm;
+    std::error_code ec;
+    if (!fs::exists(rutaCompleta, ec)) {
+        throw std::runtime_error("El archivo de trayectoria no existe: " + nombreNorm);
+    }
+    return std::make_unique<MappedFile>(rutaCompleta);
+}
+
+// ===================== Checkpoints =====================
+
+bool TrajectoryManager::guardarCheckpoint(const CheckpointTrayectoria& checkpoint) const {
+    const std::string ruta = rutaCheckpoint(checkpoint.archivo);
+    const std::string rutaTmp = ruta + ".tmp";
+
+    // El formato es clave=valor por línea: el motivo no puede contener saltos
+    std::string motivo = checkpoint.motivo;
+    for (char& c : motivo) {
+        if (c == '\n' || c == '\r') c = ' ';
+    }
+
+    std::ostringstream oss;
+    oss << std::setprecision(10);
+    oss << "archivo=" << checkpoint.archivo << "\n"
+        << "linea=" << checkpoint.lineaReanudacion << "\n"
+        << "x=" << checkpoint.x << "\n"
+        << "y=" << checkpoint.y << "\n"
+        << "z=" << checkpoint.z << "\n"
+        << "f=" << checkpoint.f << "\n"
+        << "pose_valida=" << (checkpoint.poseValida ? 1 : 0) << "\n"
+        << "efector=" << (checkpoint.efectorActivo ? 1 : 0) << "\n"
+        << "motivo=" << motivo << "\n";
+
+    // Escribimos a un temporal y renombramos: un corte a mitad de escritura
+    // nunca deja un checkpoint truncado.
+    {
+        std::ofstream out(rutaTmp, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            std::cerr << "Error: no se pudo escribir el checkpoint " << rutaTmp << std::endl;
+            return false;
+        }
+        out << oss.str();
+        if (!out.good()) {
+            std::cerr << "Error al escribir el checkpoint " << rutaTmp << std::endl;
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    fs::rename(rutaTmp, ruta, ec);
+    if (ec) {
+        std::cerr << "Error al publicar el checkpoint " << ruta << ": " << ec.message() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+std::optional<CheckpointTrayectoria> TrajectoryManager::cargarCheckpoint(const std::string& nombreTrayectoria) const {
+    std::ifstream in(rutaCheckpoint(normalizarNombreArchivo(nombreTrayectoria)));
+    if (!in.is_open()) {
+        return std::nullopt;
+    }
+
+    CheckpointTrayectoria checkpoint;
+    std::string linea;
+    try {
+        while (std::getline(in, linea)) {
+            size_t sep = linea.find('=');
+            if (sep == std::string::npos) continue;
+            std::string clave = linea.substr(0, sep);
+            std::string valor = linea.substr(sep + 1);
+
+            if (clave == "archivo")          checkpoint.archivo = valor;
+            else if (clave == "linea")       checkpoint.lineaReanudacion = std::stoul(valor);
+            else if (clave == "x")           checkpoint.x = std::stod(valor);
+            else if (clave == "y")           checkpoint.y = std::stod(valor);
+            else if (clave == "z")           checkpoint.z = std::stod(valor);
+            else if (clave == "f")           checkpoint.f = std::stod(valor);
+            else if (clave == "pose_valida") checkpoint.poseValida = (valor == "1");
+            else if (clave == "efector")     checkpoint.efectorActivo = (valor == "1");
+            else if (clave == "motivo")      checkpoint.motivo = valor;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Checkpoint corrupto para '" << nombreTrayectoria << "': " << e.what() << std::endl;
+        return std::nullopt;
+    }
+
+    if (checkpoint.archivo.empty()) {
+        return std::nullopt;
+    }
+    return checkpoint;
+}
+
+bool TrajectoryManager::eliminarCheckpoint(const std::string& nombreTrayectoria) const {
+    std::error_code ec;
+    fs::remove(rutaCheckpoint(normalizarNombreArchivo(nombreTrayectoria)), ec);
+    return !ec;
+}
+
 // ===================== Privados =====================
 
 void TrajectoryManager::crearDirectorioSiNoExiste() const {
@@ -245,6 +389,138 @@ std::string TrajectoryManager::normalizarNombreArchivo(const std::string& nombre
     return nombreTrayectoria + ".gcode";
 }
 
+std::string TrajectoryManager::rutaCheckpoint(const std::string& nombreTrayectoria) const {
+    return directorioBase + "/" + nombreTrayectoria + ".ckpt";
+}
+
+// ===================== Catálogo =====================
+
+bool TrajectoryManager::parsearNombreConvencion(const std::string& archivo, int& ownerId,
+                                                std::string& nombreLogico, int64_t& creadoEn) {
+    // <userId>__<slug>__YYYYMMDD_HHMMSS.gcode
+    const std::string ext = ".gcode";
+    const size_t largoTs = 15;  // YYYYMMDD_HHMMSS
+    size_t sep = archivo.find("__");
+    if (sep == std::string::npos || sep == 0) return false;
+    if (archivo.size() < sep + 2 + 2 + largoTs + ext.size()) return false;
+
+    const std::string uid = archivo.substr(0, sep);
+    for (char c : uid) {
+        if (!std::isdigit(static_cast<unsigned char>(c))) return false;
+    }
+
+    const size_t inicioTs = archivo.size() - ext.size() - largoTs;
+    if (archivo.compare(inicioTs - 2, 2, "__") != 0) return false;
+
+    std::tm tm{};
+    std::istringstream iss(archivo.substr(inicioTs, largoTs));
+    iss >> std::get_time(&tm, "%Y%m%d_%H%M%S");
+    if (iss.fail()) return false;
+    tm.tm_isdst = -1;
+
+    ownerId = std::stoi(uid);
+    nombreLogico = archivo.substr(sep + 2, inicioTs - 2 - (sep + 2));
+    creadoEn = static_cast<int64_t>(std::mktime(&tm));
+    return true;
+}
+
+bool TrajectoryManager::registrarEnCatalogo(const std::string& archivo, const MetadatosGCode& meta) const {
+    EntradaCatalogo entrada;
+    entrada.archivo = archivo;
+    entrada.meta = meta;
+
+    std::error_code ec;
+    const fs::path ruta = fs::path(directorioBase) / archivo;
+    auto mtime = fs::last_write_time(ruta, ec);
+    if (!ec) {
+        entrada.mtime = std::chrono::duration_cast<std::chrono::seconds>(mtime.time_since_epoch()).count();
+    }
+    auto bytes = fs::file_size(ruta, ec);
+    if (!ec) {
+        entrada.meta.bytes = static_cast<size_t>(bytes);
+    }
+
+    if (!parsearNombreConvencion(archivo, entrada.ownerId, entrada.nombreLogico, entrada.creadoEn)) {
+        // Archivo legacy: sin dueño (solo lo ve el admin)
+        entrada.ownerId = -1;
+        entrada.nombreLogico = fs::path(archivo).stem().string();
+        entrada.creadoEn = static_cast<int64_t>(std::time(nullptr));
+    }
+
+    try {
+        catalogo->upsert(entrada);
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "Error al registrar '" << archivo << "' en el catálogo: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+void TrajectoryManager::sincronizarSiCambioDirectorio() const {
+    std::error_code ec;
+    auto mtime = fs::last_write_time(directorioBase, ec);
+    if (!ec && mtime != mtimeDirectorioSincronizado) {
+        sincronizarCatalogo();
+    }
+}
+
+size_t TrajectoryManager::sincronizarCatalogo() const {
+    size_t analizados = 0;
+    try {
+        // Se toma antes de recorrer: lo que cambie durante el recorrido se ve la próxima vez
+        std::error_code ecDirectorio;
+        auto mtimeDirectorio = fs::last_write_time(directorioBase, ecDirectorio);
+
+        std::unordered_map<std::string, int64_t> enCatalogo;
+        for (auto& [archivo, mtime] : catalogo->listarArchivos()) {
+            enCatalogo.emplace(std::move(archivo), mtime);
+        }
+
+        catalogo->begin();
+        try {
+            for (const auto& entry : fs::directory_iterator(directorioBase)) {
+                if (!entry.is_regular_file() || entry.path().extension() != ".gcode") continue;
+
+                const std::string fname = entry.path().filename().string();
+                std::error_code ec;
+                auto mtime = std::chrono::duration_cast<std::chrono::seconds>(
+                    fs::last_write_time(entry.path(), ec).time_since_epoch()).count();
+
+                auto it = enCatalogo.find(fname);
+                if (it != enCatalogo.end()) {
+                    bool sinCambios = !ec && it->second == mtime;
+                    enCatalogo.erase(it);
+                    if (sinCambios) continue;
+                }
+                if (grabando && fname == trayectoriaActual) continue;
+
+                MappedFile archivo(entry.path().string());
+                GCodeAnalyzer analizador;
+                std::string_view linea;
+                while (archivo.siguienteLinea(linea)) {
+                    analizador.procesarLinea(linea);
+                }
+                if (registrarEnCatalogo(fname, analizador.resultado())) {
+                    ++analizados;
+                }
+            }
+
+            // Lo que quedó no existe más en disco
+            for (const auto& [archivo, mtime] : enCatalogo) {
+                catalogo->eliminar(archivo);
+            }
+            catalogo->commit();
+            if (!ecDirectorio) mtimeDirectorioSincronizado = mtimeDirectorio;
+        } catch (...) {
+            catalogo->rollback();
+            throw;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error al sincronizar el catálogo con " << directorioBase << ": " << e.what() << std::endl;
+    }
+    return analizados;
+}
+
 std::string TrajectoryManager::guardarTrayectoriaCompleta(const std::string& nombreArchivo, const std::string& contenido) {
     
     // 1. Validar el nombre de archivo (seguridad básica)
@@ -280,6 +556,7 @@ std::string TrajectoryManager::guardarTrayectoriaCompleta(const std::string& nom
         archivo.close();
         
         std::cout << "Archivo subido guardado en: " << archivo.getFilePath() << std::endl;
+        registrarEnCatalogo(nombreNorm, GCodeAnalyzer::analizar(contenido));
         
         // ¡ÉXITO! Devolver el nombre de archivo final
         return nombreNorm; 
@@ -288,4 +565,38 @@ std::string TrajectoryManager::guardarTrayectoriaCompleta(const std::string& nom
         std::cerr << "Error al guardar archivo subido '" << nombreNorm << "': " << e.what() << std::endl;
         return ""; // Devolver string vacío en caso de error
     }
+}
+
+std::string TrajectoryManager::nombreCopiaDerivada(const std::string& archivoOrigen, const std::string& sufijo) const {
+    const std::string origen = normalizarNombreArchivo(archivoOrigen);
+    int ownerId = -1;
+    std::string nombreLogico;
+    int64_t creadoEn = 0;
+    if (parsearNombreConvencion(origen, ownerId, nombreLogico, creadoEn)) {
+        // <userId>__<slug>_<sufijo>__<timestamp del original>.gcode
+        const size_t largoTs = 15;
+        const std::string ts = origen.substr(origen.size() - 6 - largoTs, largoTs);
+        return std::to_string(ownerId) + "__" + nombreLogico + "_" + slugify(sufijo) + "__" + ts + ".gcode";
+    }
+    // Legacy: <nombre>_<sufijo>.gcode
+    return fs::path(origen).stem().string() + "_" + slugify(sufijo) + ".gcode";
+}
+
+std::string TrajectoryManager::guardarCopiaDerivada(const std::string& archivoOrigen, const std::string& sufijo,
+                                                     const std::string& contenido) {
+    const std::string nombre = nombreCopiaDerivada(archivoOrigen, sufijo);
+    try {
+        File archivo(nombre, directorioBase);
+        archivo.open(FileMode::WRITE);  // trunca la copia de una corrida anterior
+        archivo.append(contenido);
+        archivo.close();
+
+        // El dueño sale del nombre: el del original, no el de quien la ejecuta
+        registrarEnCatalogo(nombre, GCodeAnalyzer::analizar(contenido));
+        return nombre;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Error al guardar la copia '" << nombre << "': " << e.what() << std::endl;
+        return "";
+    }
 }
\ No newline at end of file
@@ -0,0 +1,240 @@
+#include "storage/CommandHistorySqlite.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+
+static const char* COLUMNAS = "id,ts,username,service,details,was_error";
+
+CommandHistorySqlite::CommandHistorySqlite(const std::string& rutaDb, size_t tamLote,
+                                           std::chrono::milliseconds intervalo)
+    : escritura_(rutaDb), lectura_(rutaDb),
+      tamLote_(tamLote > 0 ? tamLote : 1), intervalo_(intervalo) {
+  // La base la comparte la capa de autenticación: esperar su lock en vez de fallar
+  escritura_.exec("PRAGMA busy_timeout=5000;");
+  lectura_.exec("PRAGMA busy_timeout=5000;");
+  // Con WAL, NORMAL solo arriesga el último lote ante un corte de energía
+  escritura_.exec("PRAGMA synchronous=NORMAL;");
+
+  escritura_.exec(
+    "CREATE TABLE IF NOT EXISTS command_history ("
+    "  id        INTEGER PRIMARY KEY,"
+    "  ts        INTEGER NOT NULL,"
+    "  username  TEXT NOT NULL,"
+    "  service   TEXT NOT NULL,"
+    "  details   TEXT NOT NULL,"
+    "  was_error INTEGER NOT NULL"
+    ");"
+    // Índices de una columna: llevan el rowid, así que sirven para paginar por id
+    "DROP INDEX IF EXISTS idx_hist_user_ts;"
+    "DROP INDEX IF EXISTS idx_hist_error_ts;"
+    "CREATE INDEX IF NOT EXISTS idx_hist_user ON command_history(username);"
+    "CREATE INDEX IF NOT EXISTS idx_hist_service ON command_history(service);"
+    "CREATE INDEX IF NOT EXISTS idx_hist_error ON command_history(was_error);"
+    "CREATE INDEX IF NOT EXISTS idx_hist_ts ON command_history(ts);");
+
+  escritura_.withPrepared("SELECT COALESCE(MAX(id),0) FROM command_history", nullptr,
+    [&](sqlite3_stmt* st){ ultimoConfirmado_ = (uint64_t)sqlite3_column_int64(st,0); });
+
+  if (sqlite3_prepare_v2(escritura_.handle(),
+        "INSERT OR REPLACE INTO command_history(id,ts,username,service,details,was_error) "
+        "VALUES(?1,?2,?3,?4,?5,?6)", -1, &insert_, nullptr) != SQLITE_OK) {
+    throw std::runtime_error(std::string("Prepare: ") + sqlite3_errmsg(escritura_.handle()));
+  }
+
+  hilo_ = std::thread(&CommandHistorySqlite::bucleEscritor, this);
+}
+
+CommandHistorySqlite::~CommandHistorySqlite() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    detener_ = true;
+  }
+  cv_.notify_one();
+  if (hilo_.joinable()) hilo_.join();
+  sqlite3_finalize(insert_);
+}
+
+void CommandHistorySqlite::encolar(CommandEntry entrada) {
+  bool lleno;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pendientes_.push_back(std::move(entrada));
+    ++encolados_;
+    lleno = pendientes_.size() >= tamLote_;
+  }
+  if (lleno) cv_.notify_one();
+}
+
+void CommandHistorySqlite::vaciar() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  const uint64_t objetivo = encolados_;
+  objetivoVaciado_ = std::max(objetivoVaciado_, objetivo);
+  cv_.notify_one();
+  cvConfirmado_.wait(lock, [&]{ return procesados_ >= objetivo; });
+}
+
+void CommandHistorySqlite::bucleEscritor() {
+  std::vector<CommandEntry> lote;
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    // Esperar un lote completo, el intervalo, un vaciar() o el cierre
+    cv_.wait_for(lock, intervalo_, [&]{
+      return detener_ || pendientes_.size() >= tamLote_ || procesados_ < objetivoVaciado_;
+    });
+    if (pendientes_.empty()) {
+      if (detener_) break;
+      continue;
+    }
+
+    // A lo sumo tamLote_ filas por transacción: no retener el lock de escritura
+    // de la base (compartida con la autenticación) mientras se acumula atraso
+    const size_t n = std::min(pendientes_.size(), tamLote_);
+    lote.assign(std::make_move_iterator(pendientes_.begin()),
+                std::make_move_iterator(pendientes_.begin() + n));
+    pendientes_.erase(pendientes_.begin(), pendientes_.begin() + n);
+    lock.unlock();
+    escribirLote(lote);
+    lock.lock();
+
+    procesados_ += lote.size();
+    lote.clear();
+    cvConfirmado_.notify_all();
+  }
+}
+
+void CommandHistorySqlite::escribirLote(std::vector<CommandEntry>& lote) {
+  sqlite3* db = escritura_.handle();
+  try {
+    escritura_.exec("BEGIN IMMEDIATE;");
+    for (const auto& e : lote) {
+      sqlite3_reset(insert_);
+      sqlite3_bind_int64(insert_, 1, (sqlite3_int64)e.id);
+      sqlite3_bind_int64(insert_, 2, e.epoch);
+      sqlite3_bind_text(insert_, 3, e.username.c_str(), (int)e.username.size(), SQLITE_STATIC);
+      sqlite3_bind_text(insert_, 4, e.service_name.c_str(), (int)e.service_name.size(), SQLITE_STATIC);
+      sqlite3_bind_text(insert_, 5, e.details.c_str(), (int)e.details.size(), SQLITE_STATIC);
+      sqlite3_bind_int(insert_, 6, e.was_error ? 1 : 0);
+      if (sqlite3_step(insert_) != SQLITE_DONE) {
+        throw std::runtime_error(std::string("Insert: ") + sqlite3_errmsg(db));
+      }
+    }
+    sqlite3_reset(insert_);
+    escritura_.exec("COMMIT;");
+    ++lotes_;
+  } catch (const std::exception& ex) {
+    sqlite3_reset(insert_);
+    sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+    std::cerr << "CommandHistorySqlite: se descartan " << lote.size()
+              << " entradas: " << ex.what() << std::endl;
+  }
+  // Aunque se descarten, las consultas ya no deben esperarlas de la base
+  if (!lote.empty() && lote.back().id > ultimoConfirmado_.load()) {
+    ultimoConfirmado_ = lote.back().id;
+  }
+}
+
+// Parámetros: ?1 desde, ?2 hasta, ?3 límite; el filtro usa ?4..?8
+std::string CommandHistorySqlite::armarWhere(const HistoryFilter& f) {
+  // WHERE armado según el filtro para que el planner elija el índice
+  std::string where = " WHERE id>?1 AND id<=?2";
+  if (!f.username.empty()) where += " AND username=?4";
+  if (!f.service_name.empty()) where += " AND service=?5";
+  if (f.was_error.has_value()) where += " AND was_error=?6";
+  if (f.from_epoch.has_value()) where += " AND ts>=?7";
+  if (f.to_epoch.has_value()) where += " AND ts<=?8";
+  return where;
+}
+
+void CommandHistorySqlite::enlazarFiltro(sqlite3_stmt* st, const HistoryFilter& f) {
+  if (!f.username.empty()) sqlite3_bind_text(st, 4, f.username.c_str(), -1, SQLITE_TRANSIENT);
+  if (!f.service_name.empty()) sqlite3_bind_text(st, 5, f.service_name.c_str(), -1, SQLITE_TRANSIENT);
+  if (f.was_error.has_value()) sqlite3_bind_int(st, 6, *f.was_error ? 1 : 0);
+  if (f.from_epoch.has_value()) sqlite3_bind_int64(st, 7, *f.from_epoch);
+  if (f.to_epoch.has_value()) sqlite3_bind_int64(st, 8, *f.to_epoch);
+}
+
+std::vector<CommandEntry> CommandHistorySqlite::consultar(const HistoryFilter& f, uint64_t desdeId,
+                                                          uint64_t hastaId, size_t limite, bool descendente) {
+  // Los ids son enteros de SQLite (con signo)
+  const sqlite3_int64 hasta = (sqlite3_int64)std::min<uint64_t>(hastaId, INT64_MAX);
+  const sqlite3_int64 lim = limite >= (size_t)INT64_MAX ? -1 : (sqlite3_int64)limite;
+  const std::string sql = std::string("SELECT ") + COLUMNAS + " FROM command_history" + armarWhere(f) +
+                          (descendente ? " ORDER BY id DESC" : " ORDER BY id") + " LIMIT ?3";
+
+  std::vector<CommandEntry> out;
+  std::lock_guard<std::mutex> lock(mutexLectura_);
+  lectura_.withPrepared(sql,
+    [&](sqlite3_stmt* st){
+      sqlite3_bind_int64(st, 1, (sqlite3_int64)desdeId);
+      sqlite3_bind_int64(st, 2, hasta);
+      sqlite3_bind_int64(st, 3, lim);
+      enlazarFiltro(st, f);
+    },
+    [&](sqlite3_stmt* st){
+      CommandEntry e;
+      e.id = (uint64_t)sqlite3_column_int64(st, 0);
+      e.epoch = sqlite3_column_int64(st, 1);
+      e.timestamp = CommandHistory::format_timestamp(e.epoch);
+      e.username = (const char*)sqlite3_column_text(st, 2);
+      e.service_name = (const char*)sqlite3_column_text(st, 3);
+      e.details = (const char*)sqlite3_column_text(st, 4);
+      e.was_error = sqlite3_column_int(st, 5) != 0;
+      out.push_back(std::move(e));
+    });
+  return out;
+}
+
+HistoryTotals CommandHistorySqlite::contar(const HistoryFilter& f, uint64_t hastaId) {
+  HistoryTotals totales;
+  std::lock_guard<std::mutex> lock(mutexLectura_);
+  lectura_.withPrepared(
+    "SELECT COUNT(*), COALESCE(SUM(was_error),0) FROM command_history" + armarWhere(f),
+    [&](sqlite3_stmt* st){
+      sqlite3_bind_int64(st, 1, 0);
+      sqlite3_bind_int64(st, 2, (sqlite3_int64)std::min<uint64_t>(hastaId, INT64_MAX));
+      enlazarFiltro(st, f);
+    },
+    [&](sqlite3_stmt* st){
+      totales.commands = (uint64_t)sqlite3_column_int64(st, 0);
+      totales.errors = (uint64_t)sqlite3_column_int64(st, 1);
+    });
+  return totales;
+}
+
+void CommandHistorySqlite::borrarUsuario(const std::string& usuario) {
+  std::lock_guard<std::mutex> lock(mutexLectura_);
+  lectura_.withPrepared("DELETE FROM command_history WHERE username=?1",
+    [&](sqlite3_stmt* st){ sqlite3_bind_text(st, 1, usuario.c_str(), -1, SQLITE_TRANSIENT); }, nullptr);
+}
+
+AgregadosHistorial CommandHistorySqlite::agregados(int64_t desdeMinuto, int64_t desdeHora) {
+  AgregadosHistorial out;
+  // desde == nullptr: agrupado por nombre, sin parámetros
+  auto agrupar = [&](const char* sql, const int64_t* desde, std::vector<AgregadosHistorial::Fila>& filas) {
+    const bool porNombre = (desde == nullptr);
+    lectura_.withPrepared(sql,
+      [&](sqlite3_stmt* st){ if (desde) sqlite3_bind_int64(st, 1, *desde); },
+      [&](sqlite3_stmt* st){
+        AgregadosHistorial::Fila f;
+        if (porNombre) f.nombre = (const char*)sqlite3_column_text(st, 0);
+        else f.inicio = sqlite3_column_int64(st, 0);
+        f.comandos = (uint64_t)sqlite3_column_int64(st, 1);
+        f.errores = (uint64_t)sqlite3_column_int64(st, 2);
+        filas.push_back(std::move(f));
+      });
+  };
+
+  std::lock_guard<std::mutex> lock(mutexLectura_);
+  agrupar("SELECT username, COUNT(*), SUM(was_error) FROM command_history GROUP BY username",
+          nullptr, out.porUsuario);
+  agrupar("SELECT service, COUNT(*), SUM(was_error) FROM command_history GROUP BY service",
+          nullptr, out.porServicio);
+  agrupar("SELECT ts/60*60, COUNT(*), SUM(was_error) FROM command_history WHERE ts>=?1 GROUP BY 1",
+          &desdeMinuto, out.porMinuto);
+  agrupar("SELECT ts/3600*3600, COUNT(*), SUM(was_error) FROM command_history WHERE ts>=?1 GROUP BY 1",
+          &desdeHora, out.porHora);
+  return out;
+}
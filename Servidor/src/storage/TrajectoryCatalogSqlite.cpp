@@ -0,0 +1,164 @@
+#include "storage/TrajectoryCatalogSqlite.h"
+
+static const char* COLUMNAS =
+  "archivo,owner_id,nombre_logico,creado_en,mtime,bytes,lineas,movimientos,"
+  "min_x,min_y,min_z,max_x,max_y,max_z,distancia_mm,duracion_seg";
+
+TrajectoryCatalogSqlite::TrajectoryCatalogSqlite(SqliteDb& db):db_(db){
+  db_.exec(
+    "CREATE TABLE IF NOT EXISTS trajectories ("
+    "  archivo       TEXT PRIMARY KEY,"
+    "  owner_id      INTEGER NOT NULL,"
+    "  nombre_logico TEXT NOT NULL,"
+    "  creado_en     INTEGER NOT NULL,"
+    "  mtime         INTEGER NOT NULL,"
+    "  bytes         INTEGER NOT NULL,"
+    "  lineas        INTEGER NOT NULL,"
+    "  movimientos   INTEGER NOT NULL,"
+    "  min_x REAL, min_y REAL, min_z REAL,"
+    "  max_x REAL, max_y REAL, max_z REAL,"
+    "  distancia_mm  REAL NOT NULL,"
+    "  duracion_seg  REAL NOT NULL"
+    ");"
+    // Índices con el desempate (archivo) al final: las páginas salen en
+    // orden del índice, sin ordenar aparte. El orden por nombre de un owner
+    // (el de robot.listMyFiles) usa idx_traj_owner_archivo; sin owner, la PK.
+    "DROP INDEX IF EXISTS idx_traj_owner_creado;"
+    "DROP INDEX IF EXISTS idx_traj_creado;"
+    "CREATE INDEX IF NOT EXISTS idx_traj_owner_creado_archivo ON trajectories(owner_id, creado_en, archivo);"
+    "CREATE INDEX IF NOT EXISTS idx_traj_creado_archivo ON trajectories(creado_en, archivo);"
+    "CREATE INDEX IF NOT EXISTS idx_traj_owner_archivo ON trajectories(owner_id, archivo);");
+}
+
+EntradaCatalogo TrajectoryCatalogSqlite::row(sqlite3_stmt* s){
+  EntradaCatalogo e;
+  e.archivo=(const char*)sqlite3_column_text(s,0);
+  e.ownerId=sqlite3_column_int(s,1);
+  e.nombreLogico=(const char*)sqlite3_column_text(s,2);
+  e.creadoEn=sqlite3_column_int64(s,3);
+  e.mtime=sqlite3_column_int64(s,4);
+  e.meta.bytes=(size_t)sqlite3_column_int64(s,5);
+  e.meta.lineas=(size_t)sqlite3_column_int64(s,6);
+  e.meta.movimientos=(size_t)sqlite3_column_int64(s,7);
+  e.meta.bboxValida=sqlite3_column_type(s,8)!=SQLITE_NULL;
+  if(e.meta.bboxValida){
+    e.meta.minX=sqlite3_column_double(s,8);
+    e.meta.minY=sqlite3_column_double(s,9);
+    e.meta.minZ=sqlite3_column_double(s,10);
+    e.meta.maxX=sqlite3_column_double(s,11);
+    e.meta.maxY=sqlite3_column_double(s,12);
+    e.meta.maxZ=sqlite3_column_double(s,13);
+  }
+  e.meta.distanciaMm=sqlite3_column_double(s,14);
+  e.meta.duracionEstimadaSeg=sqlite3_column_double(s,15);
+  return e;
+}
+
+void TrajectoryCatalogSqlite::upsert(const EntradaCatalogo& e){
+  db_.withPrepared(
+    std::string("INSERT OR REPLACE INTO trajectories(")+COLUMNAS+") "
+    "VALUES(?1,?2,?3,?4,?5,?6,?7,?8,?9,?10,?11,?12,?13,?14,?15,?16)",
+    [&](sqlite3_stmt* st){
+      sqlite3_bind_text(st,1,e.archivo.c_str(),-1,SQLITE_TRANSIENT);
+      sqlite3_bind_int(st,2,e.ownerId);
+      sqlite3_bind_text(st,3,e.nombreLogico.c_str(),-1,SQLITE_TRANSIENT);
+      sqlite3_bind_int64(st,4,e.creadoEn);
+      sqlite3_bind_int64(st,5,e.mtime);
+      sqlite3_bind_int64(st,6,(sqlite3_int64)e.meta.bytes);
+      sqlite3_bind_int64(st,7,(sqlite3_int64)e.meta.lineas);
+      sqlite3_bind_int64(st,8,(sqlite3_int64)e.meta.movimientos);
+      if(e.meta.bboxValida){
+        sqlite3_bind_double(st,9,e.meta.minX);
+        sqlite3_bind_double(st,10,e.meta.minY);
+        sqlite3_bind_double(st,11,e.meta.minZ);
+        sqlite3_bind_double(st,12,e.meta.maxX);
+        sqlite3_bind_double(st,13,e.meta.maxY);
+        sqlite3_bind_double(st,14,e.meta.maxZ);
+      }
+      // sin bbox: los parámetros quedan en NULL
+      sqlite3_bind_double(st,15,e.meta.distanciaMm);
+      sqlite3_bind_double(st,16,e.meta.duracionEstimadaSeg);
+    }, nullptr);
+}
+
+void TrajectoryCatalogSqlite::eliminar(const std::string& archivo){
+  db_.withPrepared("DELETE FROM trajectories WHERE archivo=?1",
+    [&](sqlite3_stmt* st){ sqlite3_bind_text(st,1,archivo.c_str(),-1,SQLITE_TRANSIENT); }, nullptr);
+}
+
+std::optional<EntradaCatalogo> TrajectoryCatalogSqlite::obtener(const std::string& archivo){
+  std::optional<EntradaCatalogo> out;
+  db_.withPrepared(
+    std::string("SELECT ")+COLUMNAS+" FROM trajectories WHERE archivo=?1",
+    [&](sqlite3_stmt* st){ sqlite3_bind_text(st,1,archivo.c_str(),-1,SQLITE_TRANSIENT); },
+    [&](sqlite3_stmt* st){ out=row(st); });
+  return out;
+}
+
+const char* TrajectoryCatalogSqlite::columnaOrden(const std::string& o){
+  if(o=="nombre")   return "archivo";
+  if(o=="tamano")   return "bytes";
+  if(o=="lineas")   return "lineas";
+  if(o=="duracion") return "duracion_seg";
+  return "creado_en";   // "creado" y cualquier valor desconocido
+}
+
+PaginaCatalogo TrajectoryCatalogSqlite::listar(const FiltroCatalogo& f){
+  // WHERE armado según el filtro para que el planner use los índices por owner
+  // (un "?1<0 OR owner_id=?1" impediría usar el índice)
+  std::string where;
+  if(f.ownerId>=0) where+=" WHERE owner_id=?1";
+  std::string patron;
+  if(!f.texto.empty()){
+    // Escapamos los comodines de LIKE en el texto del usuario
+    for(char c: f.texto){
+      if(c=='%'||c=='_'||c=='\\') patron.push_back('\\');
+      patron.push_back(c);
+    }
+    patron="%"+patron+"%";
+    where+=where.empty()?" WHERE ":" AND ";
+    where+="archivo LIKE ?2 ESCAPE '\\'";
+  }
+  auto bindFiltro=[&](sqlite3_stmt* st){
+    if(f.ownerId>=0) sqlite3_bind_int(st,1,f.ownerId);
+    if(!patron.empty()) sqlite3_bind_text(st,2,patron.c_str(),-1,SQLITE_TRANSIENT);
+  };
+
+  // El ORDER BY solo admite columnas de la lista blanca de columnaOrden()
+  const char* dir = f.descendente ? " DESC" : " ASC";
+  const std::string columna = columnaOrden(f.ordenarPor);
+  std::string orden = " ORDER BY "+columna+dir;
+  if(columna!="archivo") orden += std::string(", archivo")+dir;   // desempate estable
+  std::string sql = std::string("SELECT ")+COLUMNAS+" FROM trajectories"+where+orden+
+    " LIMIT ?3 OFFSET ?4";
+
+  PaginaCatalogo p;
+  db_.withPrepared(sql,
+    [&](sqlite3_stmt* st){
+      bindFiltro(st);
+      sqlite3_bind_int64(st,3,f.limite>0?(sqlite3_int64)f.limite:-1);
+      sqlite3_bind_int64(st,4,(sqlite3_int64)f.offset);
+    },
+    [&](sqlite3_stmt* st){ p.items.push_back(row(st)); });
+
+  // Conteo aparte y solo si se pide: un COUNT(*) OVER() recorrería todo el
+  // filtro en cada página aunque el LIMIT corte antes
+  if(f.conTotal){
+    db_.withPrepared("SELECT COUNT(*) FROM trajectories"+where, bindFiltro,
+      [&](sqlite3_stmt* st){ p.total=(size_t)sqlite3_column_int64(st,0); });
+  }
+  return p;
+}
+
+std::vector<std::pair<std::string,int64_t>> TrajectoryCatalogSqlite::listarArchivos(){
+  std::vector<std::pair<std::string,int64_t>> v;
+  db_.withPrepared("SELECT archivo,mtime FROM trajectories", nullptr,
+    [&](sqlite3_stmt* st){
+      v.emplace_back((const char*)sqlite3_column_text(st,0), sqlite3_column_int64(st,1));
+    });
+  return v;
+}
+
+void TrajectoryCatalogSqlite::begin(){ db_.exec("BEGIN"); }
+void TrajectoryCatalogSqlite::commit(){ db_.exec("COMMIT"); }
+void TrajectoryCatalogSqlite::rollback(){ db_.exec("ROLLBACK"); }
@@ -0,0 +1,426 @@
+#include "utils/AsyncLogWriter.h"
+
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <iostream>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    // Registros que el escritor toma por vuelta (y iovecs por writev)
+    constexpr size_t MAX_BATCH = 256;
+    constexpr size_t MAX_IOV = IOV_MAX < 1024 ? IOV_MAX : 1024;
+    // Espera máxima del escritor dormido (red de seguridad ante un aviso perdido)
+    constexpr std::chrono::milliseconds MAX_IDLE(100);
+
+    size_t roundUpPow2(size_t n) {
+        size_t p = 2;
+        while (p < n) p <<= 1;
+        return p;
+    }
+
+    int targetIndex(uint8_t target) {
+        switch (target) {
+            case AsyncLogWriter::CONSOLE: return 0;
+            case AsyncLogWriter::DEBUG_FILE: return 1;
+            case AsyncLogWriter::AUDIT_FILE: return 2;
+            default: return -1;
+        }
+    }
+
+    // Primera medianoche (hora local) posterior a when
+    std::time_t nextMidnight(std::time_t when) {
+        std::tm timeinfo;
+        localtime_r(&when, &timeinfo);
+        timeinfo.tm_hour = 0;
+        timeinfo.tm_min = 0;
+        timeinfo.tm_sec = 0;
+        timeinfo.tm_mday += 1;
+        timeinfo.tm_isdst = -1;
+        return std::mktime(&timeinfo);
+    }
+}
+
+AsyncLogWriter::AsyncLogWriter(size_t capacity,
+                               FsyncPolicy fsyncPolicy,
+                               std::chrono::milliseconds fsyncInterval,
+                               OverflowPolicy overflowPolicy)
+    : fsyncPolicy_(fsyncPolicy),
+      fsyncIntervalMs_(fsyncInterval.count()),
+      overflowPolicy_(overflowPolicy) {
+    const size_t size = roundUpPow2(capacity);
+    cells_ = std::make_unique<Cell[]>(size);
+    mask_ = size - 1;
+    for (size_t i = 0; i < size; ++i) {
+        cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    writer_ = std::thread(&AsyncLogWriter::writerLoop, this);
+}
+
+AsyncLogWriter::~AsyncLogWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    writerCv_.notify_one();
+    if (writer_.joinable()) {
+        writer_.join();
+    }
+    compressor_.reset();
+    for (int i = 1; i < 3; ++i) {
+        if (fds_[i] >= 0) ::close(fds_[i]);
+    }
+}
+
+void AsyncLogWriter::setTarget(Target target, int fd) {
+    int index = targetIndex(target);
+    if (index < 0) return;
+    flush();
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (index > 0 && fds_[index] >= 0 && fds_[index] != fd) {
+        ::close(fds_[index]);
+    }
+    fds_[index] = fd;
+}
+
+void AsyncLogWriter::setRotation(Target target, const std::string& path,
+                                 const RotationPolicy& policy, const std::string& header) {
+    int index = targetIndex(target);
+    if (index <= 0) return;
+    flush();
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Rotation& rotation = rotation_[index];
+    rotation.enabled = policy.enabled() && fds_[index] >= 0;
+    rotation.path = path;
+    rotation.header = header;
+    rotation.policy = policy;
+    if (!rotation.enabled) return;
+
+    // Tamaño y fecha del archivo existente: si es de otro día, se rota al escribir
+    struct stat st;
+    std::time_t since = std::time(nullptr);
+    rotation.bytes = 0;
+    if (::fstat(fds_[index], &st) == 0) {
+        rotation.bytes = static_cast<uint64_t>(st.st_size);
+        if (st.st_size > static_cast<off_t>(header.size())) since = st.st_mtime;
+    }
+    rotation.nextDaily = nextMidnight(since);
+
+    if (!compressor_) {
+        compressor_ = std::make_unique<LogCompressor>();
+    }
+    compressor_->recover(path, policy);
+}
+
+void AsyncLogWriter::waitForCompression() {
+    flush();
+    if (compressor_) {
+        compressor_->waitIdle();
+    }
+}
+
+//
+// ===== COLA MPSC =====
+//
+
+bool AsyncLogWriter::tryPush(LogRecord& record) {
+    size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+    while (true) {
+        Cell& cell = cells_[pos & mask_];
+        size_t seq = cell.sequence.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+        if (diff == 0) {
+            if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                cell.record = std::move(record);
+                cell.sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (diff < 0) {
+            return false;   // Llena
+        } else {
+            pos = enqueuePos_.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+bool AsyncLogWriter::tryPop(LogRecord& record) {
+    Cell& cell = cells_[dequeuePos_ & mask_];
+    size_t seq = cell.sequence.load(std::memory_order_acquire);
+    if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(dequeuePos_ + 1) < 0) {
+        return false;   // Vacía (o el productor todavía no terminó de copiar)
+    }
+    record = std::move(cell.record);
+    cell.record.text.clear();
+    cell.sequence.store(dequeuePos_ + mask_ + 1, std::memory_order_release);
+    ++dequeuePos_;
+    return true;
+}
+
+bool AsyncLogWriter::hasPending() const {
+    const Cell& cell = cells_[dequeuePos_ & mask_];
+    return cell.sequence.load(std::memory_order_acquire) == dequeuePos_ + 1;
+}
+
+void AsyncLogWriter::wakeWriter() {
+    // Emparejado con el fence del escritor antes de dormir: o él ve el
+    // registro nuevo, o nosotros lo vemos dormido y lo despertamos.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (writerSleeping_.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        writerCv_.notify_one();
+    }
+}
+
+bool AsyncLogWriter::push(LogRecord&& record) {
+    if (tryPush(record)) {
+        wakeWriter();
+        return true;
+    }
+
+    if (!record.critical && overflowPolicy_.load() == OverflowPolicy::DROP) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // BLOCK (o registro crítico): esperar a que el escritor libere lugar
+    waitingProducers_.fetch_add(1);
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!tryPush(record)) {
+            writerCv_.notify_one();
+            spaceCv_.wait_for(lock, std::chrono::milliseconds(1));
+        }
+    }
+    waitingProducers_.fetch_sub(1);
+    wakeWriter();
+    return true;
+}
+
+void AsyncLogWriter::flush() {
+    const uint64_t target = enqueuePos_.load();
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (written_.load() < target) {
+        writerCv_.notify_one();
+        spaceCv_.wait_for(lock, std::chrono::milliseconds(10));
+    }
+}
+
+void AsyncLogWriter::setFsyncPolicy(FsyncPolicy policy, std::chrono::milliseconds interval) {
+    fsyncPolicy_.store(policy);
+    fsyncIntervalMs_.store(interval.count());
+}
+
+void AsyncLogWriter::setOverflowPolicy(OverflowPolicy policy) {
+    overflowPolicy_.store(policy);
+}
+
+uint64_t AsyncLogWriter::droppedCount() const {
+    return dropped_.load(std::memory_order_relaxed);
+}
+
+//
+// ===== HILO ESCRITOR =====
+//
+
+void AsyncLogWriter::writerLoop() {
+    std::vector<LogRecord> batch;
+    batch.reserve(MAX_BATCH);
+    auto lastSync = std::chrono::steady_clock::now();
+    bool dirty = false;
+
+    auto syncFiles = [&]() {
+        for (int i = 1; i < 3; ++i) {
+            if (fds_[i] >= 0) ::fdatasync(fds_[i]);
+        }
+        lastSync = std::chrono::steady_clock::now();
+        dirty = false;
+    };
+
+    while (true) {
+        LogRecord record;
+        while (batch.size() < MAX_BATCH && tryPop(record)) {
+            batch.push_back(std::move(record));
+        }
+
+        if (!batch.empty()) {
+            writeBatch(batch);
+            written_.fetch_add(batch.size());
+            batch.clear();
+            dirty = true;
+            if (fsyncPolicy_.load() == FsyncPolicy::PER_BATCH) {
+                syncFiles();
+            }
+            if (waitingProducers_.load() > 0) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                spaceCv_.notify_all();
+            }
+            continue;
+        }
+
+        // Sin registros: avisar a flush(), sincronizar si toca y dormir
+        const auto interval = std::chrono::milliseconds(fsyncIntervalMs_.load());
+        if (dirty && fsyncPolicy_.load() == FsyncPolicy::INTERVAL &&
+            std::chrono::steady_clock::now() - lastSync >= interval) {
+            syncFiles();
+        }
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        spaceCv_.notify_all();
+        if (stop_ && !hasPending()) {
+            break;
+        }
+        writerSleeping_.store(true);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!hasPending() && !stop_) {
+            auto wait = MAX_IDLE;
+            if (dirty && fsyncPolicy_.load() == FsyncPolicy::INTERVAL && interval < wait) {
+                wait = interval;
+            }
+            writerCv_.wait_for(lock, wait);
+        }
+        writerSleeping_.store(false);
+    }
+
+    if (dirty && fsyncPolicy_.load() != FsyncPolicy::NEVER) {
+        syncFiles();
+    }
+}
+
+const std::string& AsyncLogWriter::timestamp(std::time_t when) {
+    if (when != cachedWhen_) {
+        std::tm timeinfo;
+        localtime_r(&when, &timeinfo);
+        char buffer[32];
+        size_t n = std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &timeinfo);
+        cachedTimestamp_.assign(buffer, n);
+        cachedWhen_ = when;
+    }
+    return cachedTimestamp_;
+}
+
+void AsyncLogWriter::writeBatch(std::vector<LogRecord>& batch) {
+    static const char NEWLINE = '\n';
+
+    // Prefijo de cada registro ("[fecha hora] [INFO] " o "fecha hora,")
+    std::vector<std::string> prefixes;
+    prefixes.reserve(batch.size());
+    for (const auto& record : batch) {
+        const std::string& ts = timestamp(record.when);
+        if (record.format == LogRecord::Format::CSV) {
+            prefixes.push_back(ts + ",");
+        } else {
+            prefixes.push_back("[" + ts + "] " + record.tag);
+        }
+    }
+
+    std::vector<struct iovec> iov;
+    iov.reserve(batch.size() * 3);
+    for (int index = 0; index < 3; ++index) {
+        if (fds_[index] < 0) continue;
+
+        iov.clear();
+        Rotation& rotation = rotation_[index];
+        for (size_t i = 0; i < batch.size(); ++i) {
+            if (!(batch[i].targets & (1 << index))) continue;
+            if (rotation.enabled) {
+                const size_t bytes = prefixes[i].size() + batch[i].text.size() + 1;
+                if (needsRotation(rotation, bytes, batch[i].when)) {
+                    // Lo anterior va al segmento que se cierra
+                    if (!iov.empty()) {
+                        writeAll(fds_[index], iov);
+                        iov.clear();
+                    }
+                    rotate(index, batch[i].when);
+                }
+                rotation.bytes += bytes;
+            }
+            iov.push_back({const_cast<char*>(prefixes[i].data()), prefixes[i].size()});
+            iov.push_back({const_cast<char*>(batch[i].text.data()), batch[i].text.size()});
+            iov.push_back({const_cast<char*>(&NEWLINE), 1});
+        }
+        if (!iov.empty()) {
+            writeAll(fds_[index], iov);
+        }
+    }
+}
+
+void AsyncLogWriter::writeAll(int fd, std::vector<struct iovec>& iov) {
+    size_t first = 0;
+    while (first < iov.size()) {
+        const int count = static_cast<int>(std::min(MAX_IOV, iov.size() - first));
+        ssize_t n = ::writev(fd, &iov[first], count);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "AsyncLogWriter: error escribiendo log: " << strerror(errno) << std::endl;
+            return;
+        }
+        // Escritura parcial: avanzar sobre los iovec ya escritos
+        size_t left = static_cast<size_t>(n);
+        while (first < iov.size() && left >= iov[first].iov_len) {
+            left -= iov[first].iov_len;
+            ++first;
+        }
+        if (left > 0) {
+            iov[first].iov_base = static_cast<char*>(iov[first].iov_base) + left;
+            iov[first].iov_len -= left;
+        }
+    }
+}
+
+//
+// ===== ROTACIÓN =====
+//
+
+bool AsyncLogWriter::needsRotation(Rotation& rotation, size_t bytes, std::time_t when) {
+    // Un archivo que solo tiene la cabecera no se rota (evita segmentos vacíos);
+    // su día pasa a ser el del primer registro
+    if (rotation.bytes <= rotation.header.size()) {
+        if (rotation.policy.daily && when >= rotation.nextDaily) rotation.nextDaily = nextMidnight(when);
+        return false;
+    }
+    if (rotation.policy.maxBytes > 0 && rotation.bytes + bytes > rotation.policy.maxBytes) return true;
+    return rotation.policy.daily && when >= rotation.nextDaily;
+}
+
+void AsyncLogWriter::rotate(int index, std::time_t when) {
+    Rotation& rotation = rotation_[index];
+    const std::string segment = LogSegments::nextName(rotation.path, when);
+
+    // rename() es atómico: un lector ve el archivo viejo completo o el nuevo
+    if (std::rename(rotation.path.c_str(), segment.c_str()) != 0) {
+        std::cerr << "AsyncLogWriter: no se pudo rotar " << rotation.path << ": " << strerror(errno) << std::endl;
+        rotation.nextDaily = nextMidnight(when);
+        rotation.bytes = rotation.header.size();    // Reintentar recién al volver a llenarse
+        return;
+    }
+    int fd = ::open(rotation.path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        // Seguir en el archivo de siempre antes que perder registros
+        std::cerr << "AsyncLogWriter: no se pudo reabrir " << rotation.path << ": " << strerror(errno) << std::endl;
+        std::rename(segment.c_str(), rotation.path.c_str());
+        rotation.nextDaily = nextMidnight(when);
+        rotation.bytes = rotation.header.size();
+        return;
+    }
+    if (!rotation.header.empty() && ::write(fd, rotation.header.data(), rotation.header.size()) < 0) {
+        std::cerr << "AsyncLogWriter: error escribiendo la cabecera de " << rotation.path << std::endl;
+    }
+
+    const int old = fds_[index];
+    if (fsyncPolicy_.load() != FsyncPolicy::NEVER) {
+        ::fdatasync(old);
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        fds_[index] = fd;
+    }
+    ::close(old);
+
+    rotation.bytes = rotation.header.size();
+    rotation.nextDaily = nextMidnight(when);
+    compressor_->enqueue(rotation.path, segment);
+}
@@ -1,53 +1,284 @@
 #include "utils/AuditLogReader.h"
-#include <iostream> // Para std::cerr
+#include "utils/LogRotation.h"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <set>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+
+namespace {
+    constexpr size_t READ_CHUNK = 64 * 1024;
+
+    /**
+     * @brief Separa una línea CSV (comas, comillas y "" como escape).
+     * Copia de a tramos entre caracteres especiales, no de a un byte.
+     * @return Cantidad de campos de la línea; guarda los primeros @p maxFields.
+     */
+    size_t splitCsv(std::string_view line, std::string* fields, size_t maxFields) {
+        size_t count = 0;
+        std::string* current = maxFields > 0 ? &fields[0] : nullptr;
+        if (current) current->clear();
+        bool inQuotes = false;
+
+        size_t i = 0;
+        while (i < line.size()) {
+            size_t j = i;
+            while (j < line.size() && line[j] != '"' && (inQuotes || line[j] != ',')) ++j;
+            if (current) current->append(line.data() + i, j - i);
+            if (j == line.size()) break;
+
+            if (line[j] == '"') {
+                if (j + 1 < line.size() && line[j + 1] == '"') {
+                    // Es un escape de comillas ("")
+                    if (current) current->push_back('"');
+                    i = j + 2;
+                } else {
+                    // Es el inicio o fin de un campo entrecomillado
+                    inQuotes = !inQuotes;
+                    i = j + 1;
+                }
+            } else {
+                // Fin de un campo
+                ++count;
+                current = count < maxFields ? &fields[count] : nullptr;
+                if (current) current->clear();
+                i = j + 1;
+            }
+        }
+        return count + 1;
+    }
+
+    // Nombre del segmento sin ".gz": no cambia al comprimirse
+    std::string segmentName(const std::string& segment) {
+        return LogSegments::isCompressed(segment) ? segment.substr(0, segment.size() - 3) : segment;
+    }
+
+    bool sameFile(const struct stat& st, dev_t dev, ino_t ino) {
+        return st.st_dev == dev && st.st_ino == ino;
+    }
+}
+
+/**
+ * @brief Lectura por posición de un archivo plano (pread) o de un .gz
+ * (gzseek, que hacia adelante descomprime sin parsear).
+ */
+class AuditLogReader::ByteSource {
+public:
+    ~ByteSource() {
+        if (fd_ >= 0) ::close(fd_);
+        if (gz_ != nullptr) gzclose(gz_);
+    }
+
+    // Plano o .gz según el nombre; nullptr si no se pudo abrir
+    static std::unique_ptr<ByteSource> open(const std::string& path) {
+        std::unique_ptr<ByteSource> source(new ByteSource());
+        if (LogSegments::isCompressed(path)) {
+            source->gz_ = gzopen(path.c_str(), "rb");
+            if (source->gz_ == nullptr) return nullptr;
+            gzbuffer(source->gz_, READ_CHUNK);
+        } else {
+            source->fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (source->fd_ < 0) return nullptr;
+        }
+        return source;
+    }
+
+    // Si se comprimió desde que se listó, queda el .gz
+    static std::unique_ptr<ByteSource> openSegment(const std::string& segment) {
+        std::unique_ptr<ByteSource> source = open(segment);
+        if (!source && !LogSegments::isCompressed(segment)) {
+            source = open(segment + ".gz");
+        }
+        return source;
+    }
+
+    int fd() const { return fd_; }
+
+    size_t readAt(uint64_t offset, char* buffer, size_t n) {
+        size_t total = 0;
+        if (gz_ == nullptr) {
+            while (total < n) {
+                ssize_t r = ::pread(fd_, buffer + total, n - total, static_cast<off_t>(offset + total));
+                if (r < 0 && errno == EINTR) continue;
+                if (r <= 0) break;
+                total += static_cast<size_t>(r);
+            }
+            return total;
+        }
+
+        if (gztell(gz_) != static_cast<z_off_t>(offset) &&
+            gzseek(gz_, static_cast<z_off_t>(offset), SEEK_SET) < 0) {
+            return 0;
+        }
+        while (total < n) {
+            int r = gzread(gz_, buffer + total, static_cast<unsigned>(std::min<size_t>(n - total, INT_MAX)));
+            if (r <= 0) break;
+            total += static_cast<size_t>(r);
+        }
+        return total;
+    }
+
+private:
+    ByteSource() = default;
+
+    int fd_ = -1;
+    gzFile gz_ = nullptr;
+};
 
 /**
  * @brief Helper interno para parsear una sola línea de CSV.
  * Esta es una función de parseo simple que maneja comillas.
  */
-AuditEntry AuditLogReader::parseCsvLine(const std::string& line) const {
+AuditEntry AuditLogReader::parseCsvLine(std::string_view line) const {
     AuditEntry entry;
-    std::stringstream ss(line);
-    std::string field;
-    char c;
-
-    std::vector<std::string> fields;
-    bool in_quotes = false;
-    std::string current_field;
-
-    for (size_t i = 0; i < line.length(); ++i) {
-        c = line[i];
-
-        if (c == '"') {
-            if (i + 1 < line.length() && line[i + 1] == '"') {
-                // Es un escape de comillas ("")
-                current_field += '"';
-                i++; // Saltar la siguiente comilla
-            } else {
-                // Es el inicio o fin de un campo entrecomillado
-                in_quotes = !in_quotes;
+    std::string fields[5];
+
+    // Asignar los campos a la estructura
+    if (splitCsv(line, fields, 5) >= 5) {
+        entry.timestamp = std::move(fields[0]);
+        entry.peticion = std::move(fields[1]);
+        entry.usuario = std::move(fields[2]);
+        entry.nodo = std::move(fields[3]);
+        entry.respuesta = std::move(fields[4]);
+    }
+
+    return entry;
+}
+
+/**
+ * @brief "YYYY-MM-DD HH:MM:SS" (hora local, como la escribe el logger) a
+ * epoch. mktime() solo se llama al cambiar la hora: las líneas vienen en
+ * orden y casi todas reutilizan la conversión anterior.
+ */
+int64_t AuditLogReader::parseTimestamp(std::string_view ts) {
+    if (ts.size() != 19 || ts[4] != '-' || ts[7] != '-' || ts[10] != ' ' || ts[13] != ':' || ts[16] != ':') {
+        return -1;
+    }
+    auto number = [&](size_t pos, size_t len) {
+        int value = 0;
+        for (size_t i = pos; i < pos + len; ++i) {
+            if (ts[i] < '0' || ts[i] > '9') return -1;
+            value = value * 10 + (ts[i] - '0');
+        }
+        return value;
+    };
+
+    const int minutes = number(14, 2);
+    const int seconds = number(17, 2);
+    if (minutes < 0 || seconds < 0) return -1;
+
+    if (ts.substr(0, 13) != cachedHour_) {
+        std::tm tm{};
+        tm.tm_year = number(0, 4) - 1900;
+        tm.tm_mon = number(5, 2) - 1;
+        tm.tm_mday = number(8, 2);
+        tm.tm_hour = number(11, 2);
+        tm.tm_isdst = -1;
+        if (tm.tm_year < 0 || tm.tm_mon < 0 || tm.tm_mday < 0 || tm.tm_hour < 0) return -1;
+        const std::time_t hour = std::mktime(&tm);
+        if (hour == static_cast<std::time_t>(-1)) return -1;
+        cachedHour_.assign(ts.data(), 13);
+        cachedHourEpoch_ = static_cast<int64_t>(hour);
+    }
+    return cachedHourEpoch_ + minutes * 60 + seconds;
+}
+
+void AuditLogReader::addRow(FileIndex& index, uint64_t offset, std::string_view line) {
+    if (!index.headerSeen) {
+        index.headerSeen = true;    // La primera línea de cada archivo es la cabecera
+        return;
+    }
+    if (line.empty()) return;
+
+    // Solo fecha y usuario; el resto se parsea si la fila entra en un reporte
+    std::string fields[3];
+    const bool complete = splitCsv(line, fields, 3) >= 5;
+    if (!complete) fields[2].clear();
+
+    auto inserted = userIds_.emplace(fields[2], static_cast<uint32_t>(userIds_.size()));
+    const uint32_t userId = inserted.first->second;
+    const uint32_t rowId = static_cast<uint32_t>(index.rows.size());
+
+    index.rows.push_back(Row{offset, static_cast<uint32_t>(line.size()), userId,
+                             complete ? parseTimestamp(fields[0]) : -1});
+    index.byUser[userId].push_back(rowId);
+    index.lastLine.assign(line.data(), line.size());
+}
+
+void AuditLogReader::indexFrom(ByteSource& source, FileIndex& index, bool complete) {
+    std::vector<char> buffer(READ_CHUNK);
+    std::string partial;            // Línea cortada entre dos lecturas
+    uint64_t readPos = index.indexedBytes;
+
+    size_t n;
+    while ((n = source.readAt(readPos, buffer.data(), buffer.size())) > 0) {
+        const char* chunk = buffer.data();
+        size_t start = 0;
+        while (start < n) {
+            const void* newline = std::memchr(chunk + start, '\n', n - start);
+            if (newline == nullptr) {
+                partial.append(chunk + start, n - start);
+                break;
             }
-        } else if (c == ',' && !in_quotes) {
-            // Fin de un campo
-            fields.push_back(current_field);
-            current_field = "";
-        } else {
-            current_field += c;
+            const size_t end = static_cast<size_t>(static_cast<const char*>(newline) - chunk);
+            std::string_view line(chunk + start, end - start);
+            if (!partial.empty()) {
+                partial.append(line.data(), line.size());
+                line = partial;
+            }
+            addRow(index, index.indexedBytes, line);
+            index.indexedBytes += line.size() + 1;
+            partial.clear();
+            start = end + 1;
         }
+        readPos += n;
     }
-    // Añadir el último campo
-    fields.push_back(current_field);
 
-    // Asignar los campos a la estructura
-    if (fields.size() >= 5) {
-        entry.timestamp = fields[0];
-        entry.peticion = fields[1];
-        entry.usuario = fields[2];
-        entry.nodo = fields[3];
-        entry.respuesta = fields[4];
+    // En el activo, una línea sin '\n' puede estar a medio escribir: se retoma después
+    if (complete && !partial.empty()) {
+        addRow(index, index.indexedBytes, partial);
+        index.indexedBytes += partial.size();
     }
+}
 
-    return entry;
+void AuditLogReader::adoptRotated(const std::vector<std::string>& segments) {
+    FileIndex rotated = std::move(active_);
+    active_ = FileIndex{};
+    hasActiveIndex_ = false;
+    if (rotated.rows.empty()) return;
+
+    // Los segmentos nacen de a uno y en orden al rotar el activo: el activo
+    // indexado es el más viejo de los que todavía no tienen índice
+    for (const std::string& segment : segments) {
+        const std::string name = segmentName(segment);
+        if (segments_.count(name) > 0) continue;
+
+        struct stat st;
+        if (!LogSegments::isCompressed(segment) && ::stat(segment.c_str(), &st) == 0 &&
+            !sameFile(st, rotated.dev, rotated.ino)) {
+            return;
+        }
+        std::unique_ptr<ByteSource> source = ByteSource::openSegment(segment);
+        if (!source) return;
+
+        // Comprimido ya no tiene el mismo inodo: confirmar con la última línea indexada
+        const Row& last = rotated.rows.back();
+        std::string check(last.length + 1, '\0');
+        if (source->readAt(last.offset, &check[0], check.size()) != check.size() ||
+            check.compare(0, last.length, rotated.lastLine) != 0 || check.back() != '\n') {
+            return;
+        }
+
+        indexFrom(*source, rotated, true);
+        segments_.emplace(name, std::move(rotated));
+        return;
+    }
 }
 
 /**
@@ -55,50 +286,149 @@ AuditEntry AuditLogReader::parseCsvLine(const std::string& line) const {
  */
 std::vector<AuditEntry> AuditLogReader::getEntries(
     const std::string& filter_user,
-    const std::string& filter_response_contains) const {
+    const std::string& filter_response_contains,
+    std::optional<int64_t> from_epoch,
+    std::optional<int64_t> to_epoch) {
     
     std::vector<AuditEntry> results;
-    std::ifstream file(auditFilePath_);
+    // El log se escribe en segundo plano: incluir lo registrado hasta ahora
+    logger_.flush();
+    std::lock_guard<std::mutex> lock(mtx_);
 
-    if (!file.is_open()) {
-        logger_.error("AuditLogReader: No se pudo abrir el archivo de log: " + auditFilePath_);
-        return results; // Devolver vector vacío
-    }
+    // 1. Abrir primero el activo: si rota mientras leemos, este descriptor
+    //    sigue siendo el mismo archivo (ahora segmento) y no se lee dos veces
+    std::unique_ptr<ByteSource> active = ByteSource::open(auditFilePath_);
+    struct stat activeStat{};
+    const bool hasActive = active && ::fstat(active->fd(), &activeStat) == 0;
 
-    std::string line;
-    // 1. Leer y descartar la línea de cabecera
-    if (!std::getline(file, line)) {
-        logger_.warning("AuditLogReader: El archivo de log CSV está vacío: " + auditFilePath_);
-        return results; // Archivo vacío
+    const std::vector<std::string> segments = LogSegments::list(auditFilePath_);
+    if (hasActiveIndex_ && !(hasActive && sameFile(activeStat, active_.dev, active_.ino))) {
+        adoptRotated(segments);
     }
 
-    // 2. Leer el resto del archivo línea por línea
-    while (std::getline(file, line)) {
-        if (line.empty()) continue;
+    // Filas de un archivo que pasan los filtros de usuario y fecha (sin leerlo)
+    std::vector<uint32_t> matching;
+    auto select = [&](const FileIndex& index) {
+        matching.clear();
+        auto keep = [&](uint32_t r) {
+            const int64_t epoch = index.rows[r].epoch;
+            if ((from_epoch || to_epoch) && epoch < 0) return;
+            if (from_epoch && epoch < *from_epoch) return;
+            if (to_epoch && epoch > *to_epoch) return;
+            matching.push_back(r);
+        };
+        if (!filter_user.empty()) {
+            // Se busca en cada archivo: indexar puede agregar usuarios
+            auto user = userIds_.find(filter_user);
+            if (user == userIds_.end()) return;
+            auto rows = index.byUser.find(user->second);
+            if (rows == index.byUser.end()) return;
+            for (uint32_t r : rows->second) keep(r);
+        } else {
+            for (uint32_t r = 0; r < index.rows.size(); ++r) keep(r);
+        }
+    };
+
+    // Lee por posición las filas seleccionadas y aplica el filtro de respuesta
+    const bool rawSearch = !filter_response_contains.empty() &&
+                           filter_response_contains.find('"') == std::string::npos;
+    std::vector<char> window;
+    auto collect = [&](const FileIndex& index, ByteSource& source) {
+        uint64_t windowStart = 0;
+        size_t windowSize = 0;
+        for (uint32_t r : matching) {
+            const Row& row = index.rows[r];
+            if (row.offset < windowStart || row.offset + row.length > windowStart + windowSize) {
+                window.resize(std::max<size_t>(READ_CHUNK, row.length));
+                windowStart = row.offset;
+                windowSize = source.readAt(row.offset, window.data(), window.size());
+                if (windowSize < row.length) return false;
+            }
+            std::string_view line(window.data() + (row.offset - windowStart), row.length);
+            // Sin comillas en el filtro, si la línea cruda no lo contiene la respuesta tampoco
+            if (rawSearch && line.find(filter_response_contains) == std::string_view::npos) continue;
 
-        AuditEntry entry = parseCsvLine(line);
+            AuditEntry entry = parseCsvLine(line);
 
-        // 3. Aplicar filtros
-        bool pass_user_filter = true;
-        bool pass_response_filter = true;
+            // Criterio 2: Filtrar por contenido de respuesta (si se proveyó)
+            if (!filter_response_contains.empty() &&
+                entry.respuesta.find(filter_response_contains) == std::string::npos) {
+                continue;
+            }
+            results.push_back(std::move(entry));
+        }
+        return true;
+    };
 
-        // Criterio 1: Filtrar por usuario (si se proveyó)
-        if (!filter_user.empty()) {
-            pass_user_filter = (entry.usuario == filter_user);
+    // 2. Segmentos rotados, del más viejo al más nuevo (indexados una sola vez)
+    std::set<std::string> listed;
+    for (const std::string& segment : segments) {
+        struct stat st;
+        if (hasActive && !LogSegments::isCompressed(segment) && ::stat(segment.c_str(), &st) == 0 &&
+            sameFile(st, activeStat.st_dev, activeStat.st_ino)) {
+            continue;
         }
+        const std::string name = segmentName(segment);
+        listed.insert(name);
 
-        // Criterio 2: Filtrar por contenido de respuesta (si se proveyó)
-        if (!filter_response_contains.empty()) {
-            // Búsqueda "contiene" (case-insensitive sería mejor, pero esto funciona)
-            pass_response_filter = (entry.respuesta.find(filter_response_contains) != std::string::npos);
+        std::unique_ptr<ByteSource> source;
+        auto indexed = segments_.find(name);
+        if (indexed == segments_.end()) {
+            source = ByteSource::openSegment(segment);
+            if (!source) {
+                logger_.warning("AuditLogReader: No se pudo leer el segmento: {}", segment);
+                continue;
+            }
+            FileIndex index;
+            indexFrom(*source, index, true);
+            indexed = segments_.emplace(name, std::move(index)).first;
         }
 
-        // 4. Añadir a resultados si pasa ambos filtros
-        if (pass_user_filter && pass_response_filter) {
-            results.push_back(entry);
+        select(indexed->second);
+        if (matching.empty()) continue;
+        if (!source) source = ByteSource::openSegment(segment);
+        if (!source || !collect(indexed->second, *source)) {
+            logger_.warning("AuditLogReader: No se pudo leer el segmento: {}", segment);
         }
     }
+    // Los que borró la retención
+    for (auto it = segments_.begin(); it != segments_.end();) {
+        it = listed.count(it->first) > 0 ? std::next(it) : segments_.erase(it);
+    }
 
-    file.close();
+    // 3. Archivo activo: solo lo agregado desde el último reporte
+    if (!hasActive) {
+        logger_.error("AuditLogReader: No se pudo abrir el archivo de log: " + auditFilePath_);
+        return results;
+    }
+    bool reindex = !hasActiveIndex_ || static_cast<uint64_t>(activeStat.st_size) < active_.indexedBytes;
+    if (!reindex && active_.indexedBytes > 0) {
+        char last = '\0';
+        reindex = active->readAt(active_.indexedBytes - 1, &last, 1) != 1 || last != '\n';
+    }
+    if (reindex) {
+        if (hasActiveIndex_) {
+            logger_.warning("AuditLogReader: {} se truncó; se vuelve a indexar", auditFilePath_);
+        }
+        active_ = FileIndex{};
+        active_.dev = activeStat.st_dev;
+        active_.ino = activeStat.st_ino;
+        hasActiveIndex_ = true;
+    }
+    indexFrom(*active, active_, false);
+
+    select(active_);
+    if (!collect(active_, *active)) {
+        logger_.warning("AuditLogReader: {} cambió durante la lectura", auditFilePath_);
+    }
     return results;
-}
\ No newline at end of file
+}
+
+size_t AuditLogReader::indexedRows() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    size_t rows = active_.rows.size();
+    for (const auto& segment : segments_) {
+        rows += segment.second.rows.size();
+    }
+    return rows;
+}
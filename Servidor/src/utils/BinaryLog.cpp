@@ -0,0 +1,442 @@
+#include "utils/BinaryLog.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+    constexpr char MAGIC[8] = {'P', 'A', 'B', 'L', 'O', 'G', '1', '\0'};
+    constexpr uint32_t VERSION = 1;
+    constexpr size_t FIELD_HEADER = 5;          // tipo (u8) + largo (u32)
+    constexpr size_t MIN_SEGMENT_BYTES = 64 * 1024;
+
+    std::atomic<uint64_t> nextSerial{1};
+
+    // Ids de formato ya vistos por este hilo (evita el mutex en cada llamada)
+    struct FormatCache {
+        uint64_t owner = 0;
+        std::unordered_map<const char*, uint32_t> ids;
+    };
+    thread_local FormatCache formatCache;
+
+    uint64_t nowNs(clockid_t clock) {
+        timespec ts;
+        clock_gettime(clock, &ts);
+        return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+    }
+
+    uint32_t currentThreadId() {
+        thread_local const uint32_t tid = static_cast<uint32_t>(::syscall(SYS_gettid));
+        return tid;
+    }
+
+    size_t align8(size_t n) {
+        return (n + 7) & ~static_cast<size_t>(7);
+    }
+
+    size_t payloadSize(const BinaryLogField& field) {
+        switch (field.type) {
+            case BinaryLogField::STR: return field.length;
+            case BinaryLogField::BOOL: return 1;
+            default: return 8;
+        }
+    }
+
+    std::string segmentName(const std::string& basePath, uint64_t sequence) {
+        char suffix[24];
+        std::snprintf(suffix, sizeof(suffix), ".%06llu", static_cast<unsigned long long>(sequence));
+        return basePath + suffix;
+    }
+
+    uint64_t segmentSequence(const std::string& basePath, const std::string& path) {
+        return std::strtoull(path.c_str() + basePath.size() + 1, nullptr, 10);
+    }
+}
+
+//
+// ===== ESCRITURA =====
+//
+
+BinaryLogSink::BinaryLogSink(const std::string& basePath, size_t segmentBytes)
+    : basePath_(basePath),
+      segmentBytes_(align8(std::max(segmentBytes, MIN_SEGMENT_BYTES))),
+      serial_(nextSerial.fetch_add(1)) {
+    auto existing = segments(basePath_);
+    uint64_t sequence = existing.empty() ? 1 : segmentSequence(basePath_, existing.back()) + 1;
+
+    Segment* segment = openSegment(sequence);
+    if (segment == nullptr) {
+        throw std::runtime_error("No se pudo crear el log binario: " + segmentName(basePath_, sequence) +
+                                 " (" + std::strerror(errno) + ")");
+    }
+    current_.store(segment);
+}
+
+BinaryLogSink::~BinaryLogSink() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Segment* segment = current_.load();
+    while (segment->writers.load() != 0) {
+        std::this_thread::yield();
+    }
+    closeSegment(segment);
+}
+
+void BinaryLogSink::setText(BinaryLogField& field, std::string_view text) {
+    field.type = BinaryLogField::STR;
+    field.data = text.data();
+    field.length = static_cast<uint32_t>(std::min<size_t>(text.size(), UINT32_MAX));
+}
+
+void BinaryLogSink::writeText(uint8_t level, std::string_view message) {
+    BinaryLogField field;
+    setText(field, message);
+    append(EVENT, level, TEXT_EVENT, &field, 1);
+}
+
+uint32_t BinaryLogSink::eventId(const char* fmt) {
+    if (formatCache.owner != serial_) {
+        formatCache.owner = serial_;
+        formatCache.ids.clear();
+    }
+    auto it = formatCache.ids.find(fmt);
+    if (it != formatCache.ids.end()) {
+        return it->second;
+    }
+    uint32_t id = registerFormat(fmt);
+    formatCache.ids.emplace(fmt, id);
+    return id;
+}
+
+uint32_t BinaryLogSink::registerFormat(const char* fmt) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = formatIds_.find(fmt);
+    if (it != formatIds_.end()) {
+        return it->second;
+    }
+    formats_.emplace_back(fmt);
+    const uint32_t id = static_cast<uint32_t>(formats_.size());
+    formatIds_.emplace(fmt, id);
+
+    BinaryLogField field;
+    setText(field, formats_.back());
+    append(FORMAT, 0, id, &field, 1, true);
+    return id;
+}
+
+size_t BinaryLogSink::recordSize(const BinaryLogField* fields, size_t count) {
+    size_t size = sizeof(BinaryLogRecordHeader);
+    for (size_t i = 0; i < count; ++i) {
+        size += FIELD_HEADER + payloadSize(fields[i]);
+    }
+    return align8(size);
+}
+
+void BinaryLogSink::encode(char* out, size_t size, uint8_t kind, uint8_t level, uint32_t eventId,
+                           const BinaryLogField* fields, size_t count) {
+    BinaryLogRecordHeader header;
+    header.size = 0;
+    header.kind = kind;
+    header.level = level;
+    header.fieldCount = static_cast<uint16_t>(count);
+    header.eventId = eventId;
+    header.threadId = currentThreadId();
+    header.monotonicNs = nowNs(CLOCK_MONOTONIC);
+    std::memcpy(out, &header, sizeof(header));
+
+    char* p = out + sizeof(header);
+    for (size_t i = 0; i < count; ++i) {
+        const BinaryLogField& field = fields[i];
+        const uint32_t length = static_cast<uint32_t>(payloadSize(field));
+        *p++ = static_cast<char>(field.type);
+        std::memcpy(p, &length, sizeof(length));
+        p += sizeof(length);
+        if (field.type == BinaryLogField::STR) {
+            std::memcpy(p, field.data, length);
+        } else if (field.type == BinaryLogField::BOOL) {
+            *p = field.value.u ? 1 : 0;
+        } else {
+            std::memcpy(p, &field.value, 8);
+        }
+        p += length;
+    }
+
+    // Publicar: el lector no pasa de un registro con size == 0
+    __atomic_store_n(reinterpret_cast<uint32_t*>(out), static_cast<uint32_t>(size), __ATOMIC_RELEASE);
+}
+
+BinaryLogSink::Segment* BinaryLogSink::acquire() {
+    while (true) {
+        Segment* segment = current_.load();
+        segment->writers.fetch_add(1);
+        // Si rotó entre la lectura y el alta, el segmento puede estar cerrándose
+        if (current_.load() == segment) {
+            return segment;
+        }
+        segment->writers.fetch_sub(1);
+    }
+}
+
+void BinaryLogSink::release(Segment* segment) {
+    segment->writers.fetch_sub(1);
+}
+
+bool BinaryLogSink::tryAppend(Segment* segment, size_t size, uint8_t kind, uint8_t level,
+                              uint32_t eventId, const BinaryLogField* fields, size_t count) {
+    const size_t start = segment->offset.fetch_add(size, std::memory_order_relaxed);
+    if (start + size > segment->capacity) {
+        return false;
+    }
+    encode(segment->base + start, size, kind, level, eventId, fields, count);
+    return true;
+}
+
+void BinaryLogSink::append(uint8_t kind, uint8_t level, uint32_t eventId,
+                           const BinaryLogField* fields, size_t count, bool locked) {
+    const size_t size = recordSize(fields, count);
+    if (size > segmentBytes_ - sizeof(BinaryLogFileHeader)) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    while (true) {
+        Segment* segment = acquire();
+        const bool ok = tryAppend(segment, size, kind, level, eventId, fields, count);
+        release(segment);
+        if (ok) {
+            return;
+        }
+
+        // Segmento lleno: uno solo rota, el resto reintenta en el nuevo
+        std::unique_lock<std::mutex> lock(mutex_, std::defer_lock);
+        if (!locked) lock.lock();
+        if (current_.load() == segment) {
+            roll(segment);
+            if (current_.load() == segment) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+        }
+    }
+}
+
+void BinaryLogSink::roll(Segment* full) {
+    Segment* next = openSegment(full->sequence + 1);
+    if (next == nullptr) {
+        std::cerr << "BinaryLogSink: no se pudo crear el segmento " << full->sequence + 1
+                  << ": " << strerror(errno) << std::endl;
+        return;
+    }
+
+    // Los formatos conocidos encabezan el segmento nuevo (todavía no es visible)
+    for (size_t i = 0; i < formats_.size(); ++i) {
+        BinaryLogField field;
+        setText(field, formats_[i]);
+        tryAppend(next, recordSize(&field, 1), FORMAT, 0, static_cast<uint32_t>(i + 1), &field, 1);
+    }
+
+    current_.store(next);
+    while (full->writers.load() != 0) {
+        std::this_thread::yield();
+    }
+    closeSegment(full);
+}
+
+BinaryLogSink::Segment* BinaryLogSink::openSegment(uint64_t sequence) {
+    const std::string path = segmentName(basePath_, sequence);
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return nullptr;
+    }
+    // Preasignar: escribir en el mapeo nunca extiende el archivo
+    if (::posix_fallocate(fd, 0, static_cast<off_t>(segmentBytes_)) != 0 &&
+        ::ftruncate(fd, static_cast<off_t>(segmentBytes_)) != 0) {
+        ::close(fd);
+        ::unlink(path.c_str());
+        return nullptr;
+    }
+    void* base = ::mmap(nullptr, segmentBytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        ::close(fd);
+        ::unlink(path.c_str());
+        return nullptr;
+    }
+
+    BinaryLogFileHeader header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.headerSize = sizeof(BinaryLogFileHeader);
+    header.capacity = segmentBytes_;
+    header.realtimeOffsetNs = static_cast<int64_t>(nowNs(CLOCK_REALTIME) - nowNs(CLOCK_MONOTONIC));
+    header.sequence = sequence;
+    std::memcpy(base, &header, sizeof(header));
+
+    auto segment = std::make_unique<Segment>();
+    segment->fd = fd;
+    segment->base = static_cast<char*>(base);
+    segment->capacity = segmentBytes_;
+    segment->sequence = sequence;
+    segment->offset.store(sizeof(BinaryLogFileHeader));
+    segments_.push_back(std::move(segment));
+    return segments_.back().get();
+}
+
+void BinaryLogSink::closeSegment(Segment* segment) {
+    if (segment->base == nullptr) return;
+    const size_t used = std::min(segment->offset.load(), segment->capacity);
+    ::munmap(segment->base, segment->capacity);
+    segment->base = nullptr;
+    // Lo no usado no se guarda (el lector igual se detiene en size == 0)
+    if (::ftruncate(segment->fd, static_cast<off_t>(used)) != 0) {
+        std::cerr << "BinaryLogSink: no se pudo recortar el segmento " << segment->sequence << std::endl;
+    }
+    ::close(segment->fd);
+    segment->fd = -1;
+}
+
+void BinaryLogSink::sync() {
+    Segment* segment = acquire();
+    ::msync(segment->base, std::min(segment->offset.load(), segment->capacity), MS_SYNC);
+    release(segment);
+}
+
+std::vector<std::string> BinaryLogSink::segments(const std::string& basePath) {
+    std::vector<std::string> paths;
+    const fs::path base(basePath);
+    const fs::path dir = base.has_parent_path() ? base.parent_path() : fs::path(".");
+    const std::string prefix = base.filename().string() + ".";
+
+    std::error_code ec;
+    for (fs::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec)) {
+        const std::string name = it->path().filename().string();
+        if (name.size() <= prefix.size() || name.compare(0, prefix.size(), prefix) != 0) continue;
+        const std::string digits = name.substr(prefix.size());
+        if (!std::all_of(digits.begin(), digits.end(), [](char c) { return c >= '0' && c <= '9'; })) continue;
+        paths.push_back(basePath + "." + digits);
+    }
+    std::sort(paths.begin(), paths.end(), [&](const std::string& a, const std::string& b) {
+        return segmentSequence(basePath, a) < segmentSequence(basePath, b);
+    });
+    return paths;
+}
+
+//
+// ===== LECTURA =====
+//
+
+const char* BinaryLogReader::levelName(uint8_t level) {
+    switch (level) {
+        case 0: return "DEBUG";
+        case 1: return "INFO";
+        case 2: return "WARNING";
+        case 3: return "ERROR";
+        default: return "?";
+    }
+}
+
+bool BinaryLogReader::read(const std::string& path, const std::function<void(const BinaryLogEntry&)>& callback) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) return false;
+    std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    BinaryLogFileHeader fileHeader;
+    if (data.size() < sizeof(fileHeader)) return false;
+    std::memcpy(&fileHeader, data.data(), sizeof(fileHeader));
+    if (std::memcmp(fileHeader.magic, MAGIC, sizeof(MAGIC)) != 0 || fileHeader.version != VERSION) {
+        return false;
+    }
+
+    struct Value {
+        uint8_t type;
+        std::string text;
+    };
+    std::vector<Value> values;
+
+    size_t offset = fileHeader.headerSize;
+    while (offset + sizeof(BinaryLogRecordHeader) <= data.size()) {
+        BinaryLogRecordHeader header;
+        std::memcpy(&header, data.data() + offset, sizeof(header));
+        // size == 0: fin (o registro a medio escribir si el proceso murió)
+        if (header.size < sizeof(header) || offset + header.size > data.size()) break;
+
+        values.clear();
+        size_t p = offset + sizeof(header);
+        const size_t end = offset + header.size;
+        bool valid = true;
+        for (uint16_t i = 0; i < header.fieldCount; ++i) {
+            if (p + FIELD_HEADER > end) { valid = false; break; }
+            const uint8_t type = static_cast<uint8_t>(data[p]);
+            uint32_t length;
+            std::memcpy(&length, data.data() + p + 1, sizeof(length));
+            p += FIELD_HEADER;
+            if (p + length > end) { valid = false; break; }
+
+            Value value{type, {}};
+            if (type == BinaryLogField::STR) {
+                value.text.assign(data.data() + p, length);
+            } else if (type == BinaryLogField::BOOL && length == 1) {
+                value.text = data[p] ? "true" : "false";
+            } else if (length == 8) {
+                int64_t i64;
+                uint64_t u64;
+                double f64;
+                std::memcpy(&i64, data.data() + p, 8);
+                std::memcpy(&u64, data.data() + p, 8);
+                std::memcpy(&f64, data.data() + p, 8);
+                if (type == BinaryLogField::I64) value.text = std::to_string(i64);
+                else if (type == BinaryLogField::U64) value.text = std::to_string(u64);
+                else value.text = std::to_string(f64);
+            }
+            values.push_back(std::move(value));
+            p += length;
+        }
+        if (!valid) break;
+
+        if (header.kind == BinaryLogSink::FORMAT) {
+            if (!values.empty()) formats_[header.eventId] = values[0].text;
+        } else if (header.kind == BinaryLogSink::EVENT) {
+            BinaryLogEntry entry;
+            entry.monotonicNs = header.monotonicNs;
+            entry.wallNs = static_cast<int64_t>(header.monotonicNs) + fileHeader.realtimeOffsetNs;
+            entry.level = header.level;
+            entry.eventId = header.eventId;
+            entry.threadId = header.threadId;
+
+            auto fmt = formats_.find(header.eventId);
+            if (header.eventId == BinaryLogSink::TEXT_EVENT && !values.empty()) {
+                entry.message = values[0].text;
+            } else if (fmt != formats_.end()) {
+                // Mismas reglas que palogger_detail::format
+                const std::string& f = fmt->second;
+                size_t pos = 0;
+                size_t next = 0;
+                while (next < values.size()) {
+                    size_t mark = f.find("{}", pos);
+                    if (mark == std::string::npos) break;
+                    entry.message.append(f, pos, mark - pos);
+                    entry.message += values[next++].text;
+                    pos = mark + 2;
+                }
+                entry.message.append(f, pos, std::string::npos);
+            } else {
+                entry.message = "<evento " + std::to_string(header.eventId) + ">";
+                for (const auto& value : values) entry.message += " " + value.text;
+            }
+            callback(entry);
+        }
+        offset += header.size;
+    }
+    return true;
+}
@@ -0,0 +1,181 @@
+#include "utils/BufferedFileWriter.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+BufferedFileWriter::BufferedFileWriter(const std::string& filePath,
+                                       bool truncate,
+                                       size_t flushThreshold,
+                                       std::chrono::milliseconds flushInterval)
+    : filePath_(filePath),
+      fd_(-1),
+      flushThreshold_(flushThreshold),
+      flushInterval_(flushInterval) {
+
+    int flags = O_WRONLY | O_CREAT | O_CLOEXEC | (truncate ? O_TRUNC : O_APPEND);
+    fd_ = ::open(filePath_.c_str(), flags, 0644);
+    if (fd_ < 0) {
+        throw std::runtime_error("No se pudo abrir el archivo: " + filePath_ + " (" + std::strerror(errno) + ")");
+    }
+
+    pending_.reserve(flushThreshold_);
+    writer_ = std::thread(&BufferedFileWriter::writerLoop, this);
+}
+
+BufferedFileWriter::~BufferedFileWriter() {
+    try {
+        close();
+    } catch (...) {
+        // El destructor no puede propagar; el error ya se reportó en sync()
+    }
+}
+
+void BufferedFileWriter::append(const std::string& data) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (fd_ < 0 || stopping_) {
+        throw std::runtime_error("Archivo cerrado: " + filePath_);
+    }
+    if (failed_) {
+        throw std::runtime_error("Error al añadir al archivo: " + filePath_);
+    }
+
+    pending_ += data;
+    bytesAccepted_ += data.size();
+    if (pending_.size() >= flushThreshold_) {
+        cvWriter_.notify_one();
+    }
+}
+
+void BufferedFileWriter::appendLine(const std::string& line) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (fd_ < 0 || stopping_) {
+        throw std::runtime_error("Archivo cerrado: " + filePath_);
+    }
+    if (failed_) {
+        throw std::runtime_error("Error al añadir al archivo: " + filePath_);
+    }
+
+    pending_ += line;
+    pending_ += '\n';
+    bytesAccepted_ += line.size() + 1;
+    if (pending_.size() >= flushThreshold_) {
+        cvWriter_.notify_one();
+    }
+}
+
+void BufferedFileWriter::sync() {
+    std::unique_lock<std::mutex> lock(mtx_);
+    if (fd_ < 0) {
+        return;
+    }
+
+    const uint64_t target = bytesAccepted_;
+    flushRequested_ = true;
+    cvWriter_.notify_one();
+    cvFlushed_.wait(lock, [&] { return bytesWritten_ >= target || failed_; });
+
+    const bool failed = failed_;
+    lock.unlock();
+
+    if (failed) {
+        throw std::runtime_error("Error al escribir en el archivo: " + filePath_);
+    }
+    if (::fdatasync(fd_) != 0) {
+        throw std::runtime_error("Error al sincronizar el archivo: " + filePath_ + " (" + std::strerror(errno) + ")");
+    }
+}
+
+void BufferedFileWriter::close() {
+    if (!isOpen()) {
+        return;
+    }
+
+    // Primero volcamos todo; si falla, igual detenemos el hilo y cerramos
+    std::exception_ptr syncError;
+    try {
+        sync();
+    } catch (...) {
+        syncError = std::current_exception();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        stopping_ = true;
+    }
+    cvWriter_.notify_one();
+    if (writer_.joinable()) {
+        writer_.join();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        ::close(fd_);
+        fd_ = -1;
+    }
+
+    if (syncError) {
+        std::rethrow_exception(syncError);
+    }
+}
+
+bool BufferedFileWriter::isOpen() const {
+    std::lock_guard<std::mutex> lock(mtx_);
+    return fd_ >= 0 && !stopping_;
+}
+
+std::string BufferedFileWriter::getFilePath() const {
+    return filePath_;
+}
+
+// Hilo escritor: intercambia el buffer pendiente bajo el mutex y escribe
+// fuera de él, para que append() nunca espere por el disco.
+void BufferedFileWriter::writerLoop() {
+    std::string batch;
+    batch.reserve(flushThreshold_);
+
+    std::unique_lock<std::mutex> lock(mtx_);
+    while (true) {
+        cvWriter_.wait_for(lock, flushInterval_, [&] {
+            return stopping_ || flushRequested_ || pending_.size() >= flushThreshold_;
+        });
+        flushRequested_ = false;
+
+        if (pending_.empty()) {
+            cvFlushed_.notify_all();
+            if (stopping_) break;
+            continue;
+        }
+
+        batch.swap(pending_);
+        const uint64_t written = bytesWritten_ + batch.size();
+        lock.unlock();
+
+        const bool ok = writeAll(batch);
+        batch.clear();
+
+        lock.lock();
+        if (!ok) {
+            failed_ = true;
+        }
+        bytesWritten_ = written;
+        cvFlushed_.notify_all();
+    }
+}
+
+bool BufferedFileWriter::writeAll(const std::string& data) {
+    const char* ptr = data.data();
+    size_t remaining = data.size();
+    while (remaining > 0) {
+        ssize_t n = ::write(fd_, ptr, remaining);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        ptr += n;
+        remaining -= static_cast<size_t>(n);
+    }
+    return true;
+}
@@ -121,23 +121,25 @@ std::string File::readAll() {
 }
 
 std::vector<std::string> File::readLines() {
+    // readAll() ya consumió el stream: se corta el contenido en su lugar,
+    // sin pasar por un stringstream intermedio
     string content = readAll();
     vector<string> lines;
-    stringstream ss(content);
-    string line;
-    
-    while (getline(fileStream, line)) {
-        lines.push_back(line);
-    }
-    
-    while (getline(ss, line)) {
+
+    size_t start = 0;
+    while (start < content.size()) {
+        size_t end = content.find('\n', start);
+        size_t next = (end == string::npos) ? content.size() : end + 1;
+        if (end == string::npos) end = content.size();
+
         // Remove trailing \r if present (for Windows line endings)
-        if (!line.empty() && line.back() == '\r') {
-            line.pop_back();
+        if (end > start && content[end - 1] == '\r') {
+            --end;
         }
-        lines.push_back(line);
+        lines.emplace_back(content, start, end - start);
+        start = next;
     }
-    
+
     return lines;
 }
 
@@ -0,0 +1,262 @@
+#include "utils/LogRotation.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <zlib.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+    const std::string GZ_EXT = ".gz";
+    const std::string TMP_EXT = ".gz.tmp";
+
+    bool endsWith(const std::string& s, const std::string& suffix) {
+        return s.size() >= suffix.size() &&
+               s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+
+    // "YYYYMMDD-HHMMSS" con un sufijo opcional "-N"
+    bool isSegmentStamp(const std::string& stamp) {
+        if (stamp.size() < 15 || stamp[8] != '-') return false;
+        for (size_t i = 0; i < 15; ++i) {
+            if (i != 8 && !std::isdigit(static_cast<unsigned char>(stamp[i]))) return false;
+        }
+        if (stamp.size() == 15) return true;
+        if (stamp[15] != '-' || stamp.size() == 16) return false;
+        return std::all_of(stamp.begin() + 16, stamp.end(),
+                           [](char c) { return std::isdigit(static_cast<unsigned char>(c)); });
+    }
+
+    // Clave de orden: el sufijo "-N" se compara como número
+    std::pair<std::string, long> sortKey(const std::string& stamp) {
+        long seq = stamp.size() > 16 ? std::strtol(stamp.c_str() + 16, nullptr, 10) : 0;
+        return {stamp.substr(0, 15), seq};
+    }
+
+    struct Segment {
+        std::string stamp;
+        bool plain = false;
+        bool gz = false;
+    };
+
+    // Segmentos de activePath indexados por su marca de tiempo
+    std::map<std::string, Segment> scan(const std::string& activePath, bool removeTmp) {
+        std::map<std::string, Segment> segments;
+        const fs::path active(activePath);
+        const fs::path dir = active.has_parent_path() ? active.parent_path() : fs::path(".");
+        const std::string prefix = active.filename().string() + ".";
+
+        std::error_code ec;
+        for (fs::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec)) {
+            std::string name = it->path().filename().string();
+            if (name.compare(0, prefix.size(), prefix) != 0) continue;
+            std::string rest = name.substr(prefix.size());
+
+            if (endsWith(rest, TMP_EXT)) {
+                if (removeTmp) fs::remove(it->path(), ec);
+                continue;
+            }
+            bool gz = endsWith(rest, GZ_EXT);
+            if (gz) rest.resize(rest.size() - GZ_EXT.size());
+            if (!isSegmentStamp(rest)) continue;
+
+            Segment& s = segments[rest];
+            s.stamp = rest;
+            (gz ? s.gz : s.plain) = true;
+        }
+        return segments;
+    }
+
+    std::vector<Segment> sorted(const std::map<std::string, Segment>& segments) {
+        std::vector<Segment> out;
+        for (const auto& [stamp, s] : segments) out.push_back(s);
+        std::sort(out.begin(), out.end(), [](const Segment& a, const Segment& b) {
+            return sortKey(a.stamp) < sortKey(b.stamp);
+        });
+        return out;
+    }
+}
+
+//
+// ===== NOMBRES =====
+//
+
+std::string LogSegments::nextName(const std::string& activePath, std::time_t when) {
+    std::tm timeinfo;
+    localtime_r(&when, &timeinfo);
+    char buffer[32];
+    std::strftime(buffer, sizeof(buffer), "%Y%m%d-%H%M%S", &timeinfo);
+
+    const std::string base = activePath + "." + buffer;
+    std::string name = base;
+    std::error_code ec;
+    for (int n = 1; fs::exists(name, ec) || fs::exists(name + GZ_EXT, ec); ++n) {
+        name = base + "-" + std::to_string(n);
+    }
+    return name;
+}
+
+std::vector<std::string> LogSegments::list(const std::string& activePath) {
+    std::vector<std::string> paths;
+    for (const Segment& s : sorted(scan(activePath, false))) {
+        paths.push_back(activePath + "." + s.stamp + (s.gz ? GZ_EXT : ""));
+    }
+    return paths;
+}
+
+bool LogSegments::isCompressed(const std::string& segment) {
+    return endsWith(segment, GZ_EXT);
+}
+
+//
+// ===== COMPRESOR =====
+//
+
+LogCompressor::LogCompressor() {
+    worker_ = std::thread(&LogCompressor::workerLoop, this);
+}
+
+LogCompressor::~LogCompressor() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_one();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+void LogCompressor::recover(const std::string& activePath, const RotationPolicy& policy) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    policies_[activePath] = policy;
+
+    for (const Segment& s : sorted(scan(activePath, true))) {
+        if (s.plain) {
+            jobs_.push_back({activePath, activePath + "." + s.stamp});
+        }
+    }
+    jobs_.push_back({activePath, ""});
+    cv_.notify_one();
+}
+
+void LogCompressor::enqueue(const std::string& activePath, const std::string& segment) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        jobs_.push_back({activePath, segment});
+    }
+    cv_.notify_one();
+}
+
+void LogCompressor::waitIdle() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idleCv_.wait(lock, [this]() { return jobs_.empty() && !busy_; });
+}
+
+void LogCompressor::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        cv_.wait(lock, [this]() { return stop_ || !jobs_.empty(); });
+        // Al cerrar no se espera a la cola: recover() la retoma al arrancar
+        if (stop_) break;
+
+        Job job = std::move(jobs_.front());
+        jobs_.pop_front();
+        RotationPolicy policy = policies_[job.activePath];
+        busy_ = true;
+
+        lock.unlock();
+        process(job, policy);
+        lock.lock();
+
+        busy_ = false;
+        if (jobs_.empty()) idleCv_.notify_all();
+    }
+    busy_ = false;
+    jobs_.clear();
+    idleCv_.notify_all();
+}
+
+void LogCompressor::process(const Job& job, const RotationPolicy& policy) {
+    if (!job.segment.empty() && policy.compress) {
+        std::error_code ec;
+        if (fs::exists(job.segment + GZ_EXT, ec)) {
+            // Ya se había comprimido; queda el original por borrar
+            fs::remove(job.segment, ec);
+        } else if (fs::exists(job.segment, ec) && compressFile(job.segment)) {
+            fs::remove(job.segment, ec);
+        }
+    }
+    applyRetention(job.activePath, policy);
+}
+
+void LogCompressor::applyRetention(const std::string& activePath, const RotationPolicy& policy) {
+    if (policy.maxSegments == 0 && policy.maxTotalBytes == 0) return;
+
+    std::vector<Segment> segments = sorted(scan(activePath, false));
+    std::vector<uint64_t> sizes;
+    uint64_t total = 0;
+    auto sizeOf = [](const std::string& path) -> uint64_t {
+        std::error_code ec;
+        uint64_t size = fs::file_size(path, ec);
+        return ec ? 0 : size;
+    };
+    for (const Segment& s : segments) {
+        const std::string base = activePath + "." + s.stamp;
+        sizes.push_back((s.gz ? sizeOf(base + GZ_EXT) : 0) + (s.plain ? sizeOf(base) : 0));
+        total += sizes.back();
+    }
+
+    // Borrar desde el más viejo hasta cumplir ambos límites
+    size_t count = segments.size();
+    for (size_t i = 0; i < segments.size(); ++i) {
+        bool overCount = policy.maxSegments > 0 && count > policy.maxSegments;
+        bool overSize = policy.maxTotalBytes > 0 && total > policy.maxTotalBytes;
+        if (!overCount && !overSize) break;
+
+        std::error_code ec;
+        fs::remove(activePath + "." + segments[i].stamp + GZ_EXT, ec);
+        fs::remove(activePath + "." + segments[i].stamp, ec);
+        --count;
+        total -= sizes[i];
+    }
+}
+
+bool LogCompressor::compressFile(const std::string& segment) {
+    const std::string tmp = segment + TMP_EXT;
+
+    int in = ::open(segment.c_str(), O_RDONLY | O_CLOEXEC);
+    if (in < 0) return false;
+    gzFile out = gzopen(tmp.c_str(), "wb6");
+    if (out == nullptr) {
+        ::close(in);
+        std::cerr << "LogCompressor: no se pudo crear " << tmp << std::endl;
+        return false;
+    }
+
+    bool ok = true;
+    char buffer[64 * 1024];
+    while (true) {
+        ssize_t n = ::read(in, buffer, sizeof(buffer));
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) { ok = false; break; }
+        if (n == 0) break;
+        if (gzwrite(out, buffer, static_cast<unsigned>(n)) != n) { ok = false; break; }
+    }
+    ::close(in);
+    if (gzclose(out) != Z_OK) ok = false;
+
+    if (!ok || std::rename(tmp.c_str(), (segment + GZ_EXT).c_str()) != 0) {
+        std::cerr << "LogCompressor: error comprimiendo " << segment << ": " << strerror(errno) << std::endl;
+        std::error_code ec;
+        fs::remove(tmp, ec);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,111 @@
+#include "utils/MappedFile.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+MappedFile::MappedFile(const std::string& filePath, size_t ventanaBytes)
+    : filePath_(filePath),
+      fd_(-1),
+      data_(nullptr),
+      size_(0),
+      ventana_(ventanaBytes),
+      pageSize_(static_cast<size_t>(::sysconf(_SC_PAGESIZE))) {
+
+    fd_ = ::open(filePath_.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd_ < 0) {
+        throw std::runtime_error("No se pudo abrir el archivo: " + filePath_ + " (" + std::strerror(errno) + ")");
+    }
+
+    struct stat st{};
+    if (::fstat(fd_, &st) != 0) {
+        int err = errno;
+        ::close(fd_);
+        throw std::runtime_error("No se pudo leer el tamaño de: " + filePath_ + " (" + std::strerror(err) + ")");
+    }
+    size_ = static_cast<size_t>(st.st_size);
+
+    // mmap no admite longitud 0: un archivo vacío simplemente no tiene líneas
+    if (size_ > 0) {
+        void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+        if (p == MAP_FAILED) {
+            int err = errno;
+            ::close(fd_);
+            throw std::runtime_error("No se pudo mapear el archivo: " + filePath_ + " (" + std::strerror(err) + ")");
+        }
+        data_ = static_cast<const char*>(p);
+        ::madvise(p, size_, MADV_SEQUENTIAL);
+    }
+
+    if (ventana_ < pageSize_) {
+        ventana_ = pageSize_;
+    }
+}
+
+MappedFile::~MappedFile() {
+    if (data_) {
+        ::munmap(const_cast<char*>(data_), size_);
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+}
+
+bool MappedFile::siguienteLinea(std::string_view& linea) {
+    if (offset_ >= size_) {
+        return false;
+    }
+
+    const char* inicio = data_ + offset_;
+    const size_t restante = size_ - offset_;
+    const char* nl = static_cast<const char*>(std::memchr(inicio, '\n', restante));
+
+    size_t largo = nl ? static_cast<size_t>(nl - inicio) : restante;
+    offset_ += nl ? largo + 1 : largo;
+
+    // Finales CRLF (archivos subidos desde Windows)
+    if (largo > 0 && inicio[largo - 1] == '\r') {
+        --largo;
+    }
+    linea = std::string_view(inicio, largo);
+    ++lineaActual_;
+
+    if (offset_ - liberadoHasta_ >= 2 * ventana_) {
+        liberarLeido();
+    }
+    return true;
+}
+
+void MappedFile::liberarLeido() {
+    // Se conserva una ventana detrás del cursor para no liberar páginas que
+    // el llamador probablemente siga usando (la línea recién devuelta).
+    size_t hasta = offset_ - ventana_;
+    hasta -= hasta % pageSize_;
+    if (hasta > liberadoHasta_) {
+        ::madvise(const_cast<char*>(data_) + liberadoHasta_, hasta - liberadoHasta_, MADV_DONTNEED);
+        liberadoHasta_ = hasta;
+    }
+}
+
+bool MappedFile::saltarA(size_t indiceLinea) {
+    if (indiceLinea < lineaActual_) {
+        reiniciar();
+    }
+    std::string_view descartada;
+    while (lineaActual_ < indiceLinea) {
+        if (!siguienteLinea(descartada)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void MappedFile::reiniciar() {
+    offset_ = 0;
+    lineaActual_ = 0;
+    liberadoHasta_ = 0;  // las páginas liberadas se vuelven a leer del archivo
+}
@@ -1,18 +1,29 @@
 #include "utils/PALogger.h"
 
+#include <fcntl.h>
+#include <unistd.h>
+
 using namespace std;
+
+namespace {
+    const std::string AUDIT_HEADER = "timestamp,peticion,usuario,nodo,respuesta\n";
+}
 	
 // --- Constructor Actualizado ---
 PALogger::PALogger(const LogLevel &level, bool logToFile, const std::string& debugFilename, const std::string& auditFilename) 
-	: level_(level), logToFile_(logToFile) {
+	: level_(level), logToFile_(logToFile), debugFilename_(debugFilename), auditFilename_(auditFilename) {
+
+	writer_.setTarget(AsyncLogWriter::CONSOLE, STDOUT_FILENO);
 			
 	if (logToFile_) {
         // 1. Abrir el log de depuración (servidor.log)
-		logFile_.open(debugFilename, std::ios::app); 
-		if (!logFile_.is_open()) {
+		int debugFd = ::open(debugFilename.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+		if (debugFd < 0) {
 			std::cerr << "Error al abrir el archivo de log (debug): " << debugFilename << std::endl;
 			std::cerr << "Se continua sin registro permanente. " << std::endl;
 			logToFile_ = false; 
+		} else {
+			writer_.setTarget(AsyncLogWriter::DEBUG_FILE, debugFd);
 		}
 
         // 2. Abrir el log de auditoría (audit.csv)
@@ -23,70 +34,51 @@ PALogger::PALogger(const LogLevel &level, bool logToFile, const std::string& deb
         }
         testFile.close();
 
-        auditFile_.open(auditFilename, std::ios::app);
-        if (!auditFile_.is_open()) {
+        int auditFd = ::open(auditFilename.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (auditFd < 0) {
 			std::cerr << "Error al abrir el archivo de log (audit): " << auditFilename << std::endl;
-		} else if (isNewAuditFile) {
-            // Si es nuevo, escribimos la cabecera CSV
-            auditFile_ << "timestamp,peticion,usuario,nodo,respuesta" << std::endl;
-            auditFile_.flush();
+		} else {
+            if (isNewAuditFile) {
+                // Si es nuevo, escribimos la cabecera CSV (antes de cualquier registro)
+                if (::write(auditFd, AUDIT_HEADER.data(), AUDIT_HEADER.size()) < 0) {
+                    std::cerr << "Error escribiendo la cabecera de " << auditFilename << std::endl;
+                }
+            }
+            writer_.setTarget(AsyncLogWriter::AUDIT_FILE, auditFd);
+            auditOpen_ = true;
         }
 	}
 }
 		
 // --- Destructor Actualizado ---
+// El escritor asincrónico escribe lo pendiente y cierra los archivos
 PALogger::~PALogger() {
-	if (logToFile_ && logFile_.is_open()) {
-		logFile_.close();
-	}
-    if (auditFile_.is_open()) {
-        auditFile_.close();
-    }
 }
 		
-// --- (Funciones de log de depuración: sin cambios) ---
-void PALogger::debug(const std::string& message) { log(LogLevel::DEBUG, message); }
-void PALogger::info(const std::string& message) { log(LogLevel::INFO, message); }
-void PALogger::warning(const std::string& message) { log(LogLevel::WARNING, message); }
-void PALogger::error(const std::string& message) { log(LogLevel::ERROR, message); }
+// --- Funciones de log de depuración: nivel verificado antes de copiar ---
+void PALogger::debug(const std::string& message) { if (isEnabled(LogLevel::DEBUG)) log(LogLevel::DEBUG, message); }
+void PALogger::info(const std::string& message) { if (isEnabled(LogLevel::INFO)) log(LogLevel::INFO, message); }
+void PALogger::warning(const std::string& message) { if (isEnabled(LogLevel::WARNING)) log(LogLevel::WARNING, message); }
+void PALogger::error(const std::string& message) { if (isEnabled(LogLevel::ERROR)) log(LogLevel::ERROR, message); }
 			
-void PALogger::log(LogLevel level, const std::string& message) {
-	std::time_t now = std::time(0);
-	std::tm timeinfo;
-	localtime_r(&now, &timeinfo); 	
-	std::stringstream messageNew;
-	messageNew << "[" << std::put_time(&timeinfo, "%Y-%m-%d %H:%M:%S") << "] ";
-	
+// Solo encola: la fecha y el prefijo los arma el hilo escritor
+void PALogger::log(LogLevel level, std::string message) {
+	if (binary_) {
+		binary_->writeText(static_cast<uint8_t>(level), message);
+		return;
+	}
+	LogRecord record;
 	switch (level) {
-		case LogLevel::DEBUG:   messageNew << "[DEBUG] ";   break;
-		case LogLevel::INFO:    messageNew << "[INFO] ";    break;
-		case LogLevel::WARNING: messageNew << "[WARNING] "; break;
-		case LogLevel::ERROR:   messageNew << "[ERROR] ";   break;
+		case LogLevel::DEBUG:   record.tag = "[DEBUG] ";   break;
+		case LogLevel::INFO:    record.tag = "[INFO] ";    break;
+		case LogLevel::WARNING: record.tag = "[WARNING] "; break;
+		case LogLevel::ERROR:   record.tag = "[ERROR] ";   break;
 	}
-	messageNew << message;
-	std::string finalMessage = messageNew.str();
-
-    if (static_cast<int>(level) < static_cast<int>(level_)) { return; }
-    std::cout << finalMessage << std::endl;
-	
-	if (logToFile_) {
-		if (!logFile_.is_open()) {
-			std::cerr << "El archivo de log (debug) no esta abierto." << std::endl;
-			return;
-		}
-		logFile_ << finalMessage << std::endl;
-        logFile_.flush(); 
-	}			
-}
-
-// --- NUEVO: Helper de Timestamp para CSV ---
-std::string PALogger::getTimestampCsv() const {
-    std::time_t now = std::time(0);
-	std::tm timeinfo;
-	localtime_r(&now, &timeinfo);
-    std::stringstream ss;
-    ss << std::put_time(&timeinfo, "%Y-%m-%d %H:%M:%S");
-    return ss.str();
+	record.targets = AsyncLogWriter::CONSOLE | (logToFile_ ? AsyncLogWriter::DEBUG_FILE : 0);
+	record.format = LogRecord::Format::LINE;
+	record.when = std::time(nullptr);
+	record.text = std::move(message);
+	writer_.push(std::move(record));
 }
 
 // --- NUEVO: Implementación de logRequest (CSV) ---
@@ -95,7 +87,7 @@ void PALogger::logRequest(const std::string& usuario,
                         const std::string& respuesta,
                         const std::string& nodo) {
     
-    if (!auditFile_.is_open()) {
+    if (!auditOpen_) {
         std::cerr << "El archivo de log (audit) no esta abierto. No se pudo registrar la petición." << std::endl;
         return;
     }
@@ -112,13 +104,51 @@ void PALogger::logRequest(const std::string& usuario,
         return s;
     };
 
-    std::stringstream ss;
-    ss << getTimestampCsv() << ","
-       << escapeCsv(peticion) << ","
-       << escapeCsv(usuario) << ","
-       << escapeCsv(nodo) << ","
-       << escapeCsv(respuesta) << std::endl;
+    // El timestamp lo antepone el escritor ("fecha,peticion,usuario,nodo,respuesta")
+    LogRecord record;
+    record.targets = AsyncLogWriter::AUDIT_FILE;
+    record.format = LogRecord::Format::CSV;
+    record.critical = true;
+    record.when = std::time(nullptr);
+    record.text = escapeCsv(peticion) + "," + escapeCsv(usuario) + "," +
+                  escapeCsv(nodo) + "," + escapeCsv(respuesta);
+    writer_.push(std::move(record));
+}
 
-    auditFile_ << ss.str();
-    auditFile_.flush();
-}
\ No newline at end of file
+void PALogger::flush() {
+    writer_.flush();
+}
+
+void PALogger::setFsyncPolicy(AsyncLogWriter::FsyncPolicy policy, std::chrono::milliseconds interval) {
+    writer_.setFsyncPolicy(policy, interval);
+}
+
+void PALogger::setOverflowPolicy(AsyncLogWriter::OverflowPolicy policy) {
+    writer_.setOverflowPolicy(policy);
+}
+
+void PALogger::setRotation(const RotationPolicy& policy) {
+    if (!logToFile_) return;
+    writer_.setRotation(AsyncLogWriter::DEBUG_FILE, debugFilename_, policy);
+    if (auditOpen_) {
+        writer_.setRotation(AsyncLogWriter::AUDIT_FILE, auditFilename_, policy, AUDIT_HEADER);
+    }
+}
+
+void PALogger::waitForCompression() {
+    writer_.waitForCompression();
+}
+
+bool PALogger::enableBinaryLog(const std::string& basePath, size_t segmentBytes) {
+    try {
+        binary_ = std::make_unique<BinaryLogSink>(basePath, segmentBytes);
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return false;
+    }
+}
+
+uint64_t PALogger::getDroppedCount() const {
+    return writer_.droppedCount() + (binary_ ? binary_->droppedCount() : 0);
+}
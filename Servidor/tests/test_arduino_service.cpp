@@ -4,6 +4,13 @@
 #include <iostream>
 #include <thread>
 #include <chrono>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <cstdlib>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
 
 using namespace std::chrono_literals;
 
@@ -209,3 +216,159 @@ struct TestGlobalTeardown {
 
 // Instancia global que se destruirá al final del programa
 static TestGlobalTeardown globalTeardown;
+
+// Firmware simulado sobre un pseudo-terminal: reproduce el protocolo de
+// Command::unframe (RS con la primera línea que falta, OK sin re-ejecutar
+// a los duplicados, M110 fija el número de línea) y permite perder tramas.
+class FirmwareSimulado {
+public:
+    long perderConOK = -1;      // Responde "OK" a esta línea sin recibirla (una vez)
+    long ignorar = -1;          // No responde a esta línea (una vez)
+    long nuncaResponder = -1;   // No responde nunca a esta línea
+
+    FirmwareSimulado() {
+        maestro = posix_openpt(O_RDWR | O_NOCTTY);
+        if (maestro >= 0 && grantpt(maestro) == 0 && unlockpt(maestro) == 0) {
+            esclavo = ptsname(maestro);
+        }
+        hilo = std::thread([this] { atender(); });
+    }
+
+    ~FirmwareSimulado() {
+        activo = false;
+        hilo.join();
+        if (maestro >= 0) close(maestro);
+    }
+
+    const std::string& puerto() const { return esclavo; }
+
+    std::vector<std::string> ejecutados() {
+        std::lock_guard<std::mutex> lock(mtx);
+        return comandos;
+    }
+
+private:
+    int maestro = -1;
+    std::string esclavo;
+    std::thread hilo;
+    std::atomic<bool> activo{true};
+    std::mutex mtx;
+    std::vector<std::string> comandos;
+    long ultimaLinea = 0;
+
+    void atender() {
+        std::string pendiente;
+        char buffer[256];
+        while (activo) {
+            struct pollfd pfd = {maestro, POLLIN, 0};
+            if (poll(&pfd, 1, 20) <= 0 || !(pfd.revents & POLLIN)) continue;
+            ssize_t n = read(maestro, buffer, sizeof(buffer));
+            if (n <= 0) continue;
+            pendiente.append(buffer, n);
+            size_t fin;
+            while ((fin = pendiente.find('\n')) != std::string::npos) {
+                std::string linea = pendiente.substr(0, fin);
+                pendiente.erase(0, fin + 1);
+                if (!linea.empty() && linea.back() == '\r') linea.pop_back();
+                if (!linea.empty()) procesar(linea);
+            }
+        }
+    }
+
+    void responder(const std::string& texto) {
+        std::string salida = texto + "\r\n";
+        (void)!write(maestro, salida.data(), salida.size());
+    }
+
+    void procesar(const std::string& linea) {
+        size_t asterisco = linea.rfind('*');
+        size_t espacio = linea.find(' ');
+        if (linea[0] != 'N' || asterisco == std::string::npos || espacio == std::string::npos ||
+            SerialCom::checksum(linea.substr(0, asterisco)) != std::atoi(linea.c_str() + asterisco + 1)) {
+            responder("RS " + std::to_string(ultimaLinea + 1));
+            return;
+        }
+        long numero = std::atol(linea.c_str() + 1);
+        std::string comando = linea.substr(espacio + 1, asterisco - espacio - 1);
+
+        if (comando.rfind("M110", 0) == 0) {
+            ultimaLinea = numero;
+            responder("OK");
+            return;
+        }
+        if (numero == nuncaResponder) return;
+        if (numero == ignorar) { ignorar = -1; return; }
+        if (numero == perderConOK) { perderConOK = -1; responder("OK"); return; }
+        if (numero == ultimaLinea) { responder("OK"); return; }   // Duplicada
+        if (numero != ultimaLinea + 1) {
+            responder("RS " + std::to_string(ultimaLinea + 1));
+            return;
+        }
+        ultimaLinea = numero;
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            comandos.push_back(comando);
+        }
+        responder("OK");
+    }
+};
+
+TEST_SUITE("ArduinoService Reenvio (firmware simulado)") {
+
+    static std::unique_ptr<ArduinoService> conectarSimulado(FirmwareSimulado& firmware) {
+        auto servicio = std::make_unique<ArduinoService>(firmware.puerto(), 115200);
+        servicio->setTimeoutEstabilizacion(0ms);
+        servicio->setTimeoutRespuesta(200ms);
+        servicio->setProtocoloConChecksum(true);
+        return servicio;
+    }
+
+    TEST_CASE("Linea anterior perdida: se reenvia desde la pedida") {
+        FirmwareSimulado firmware;
+        REQUIRE_FALSE(firmware.puerto().empty());
+        auto servicio = conectarSimulado(firmware);
+        REQUIRE(servicio->conectar(1));     // N1 = M114
+
+        // El "OK" de la línea 3 llega pero la línea no: el firmware pide la 3
+        // cuando le llega la 4, y el host debe reenviar la 3 antes de la 4
+        firmware.perderConOK = 3;
+        for (int i = 2; i <= 5; ++i) {
+            CHECK(servicio->enviarComando("G1 X" + std::to_string(i) + "\r\n")
+                      .find("OK") != std::string::npos);
+        }
+
+        std::vector<std::string> esperados = {"M114", "G1 X2", "G1 X3", "G1 X4", "G1 X5"};
+        CHECK(firmware.ejecutados() == esperados);
+        CHECK(servicio->getReenvios() == 1);
+        servicio->desconectar();
+    }
+
+    TEST_CASE("Timeout: se reenvia la misma trama") {
+        FirmwareSimulado firmware;
+        REQUIRE_FALSE(firmware.puerto().empty());
+        auto servicio = conectarSimulado(firmware);
+        REQUIRE(servicio->conectar(1));
+
+        firmware.ignorar = 2;
+        CHECK(servicio->enviarComando("G1 X2\r\n").find("OK") != std::string::npos);
+        CHECK(servicio->enviarComando("G1 X3\r\n").find("OK") != std::string::npos);
+
+        std::vector<std::string> esperados = {"M114", "G1 X2", "G1 X3"};
+        CHECK(firmware.ejecutados() == esperados);
+        CHECK(servicio->getReenvios() == 1);
+        servicio->desconectar();
+    }
+
+    TEST_CASE("Sin respuesta tras los reenvios: excepcion") {
+        FirmwareSimulado firmware;
+        REQUIRE_FALSE(firmware.puerto().empty());
+        auto servicio = conectarSimulado(firmware);
+        REQUIRE(servicio->conectar(1));
+
+        servicio->setMaxReenvios(2);
+        firmware.nuncaResponder = 2;
+        CHECK_THROWS_AS(servicio->enviarComando("G1 X2\r\n", 100ms), std::runtime_error);
+        CHECK(servicio->getReenvios() == 2);
+        servicio->desconectar();
+    }
+}
@@ -1,8 +1,28 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest.h"
 #include "utils/File.h"
+#include "utils/BufferedFileWriter.h"
+#include "utils/MappedFile.h"
+#include "utils/AsyncLogWriter.h"
+#include "utils/PALogger.h"
+#include "utils/AuditLogReader.h"
+#include "utils/LogRotation.h"
+#include "utils/BinaryLog.h"
+#include <ctime>
 #include <filesystem>
 #include <fstream>
+#include <fcntl.h>
+#include <thread>
+
+namespace {
+    // Cuenta cuántas veces se formatea (para verificar el formato diferido)
+    int formateosCostosos = 0;
+    struct Costoso {};
+    std::ostream& operator<<(std::ostream& os, const Costoso&) {
+        ++formateosCostosos;
+        return os << "costoso";
+    }
+}
 
 TEST_SUITE("File Class - Essential Operations") {
     
@@ -208,4 +228,476 @@ TEST_SUITE("File Class - Edge Cases") {
             CHECK_NOTHROW(file.write("more data"));
         }
     }
-}
\ No newline at end of file
+
+    TEST_CASE_FIXTURE(TestSetup, "BufferedFileWriter") {
+        const std::string ruta = "test_data/buffered.gcode";
+
+        SUBCASE("sync vuelca todo lo pendiente") {
+            // Umbral e intervalo grandes: nada se escribe hasta sync()
+            BufferedFileWriter writer(ruta, true, 1 << 20, std::chrono::milliseconds(60000));
+            writer.appendLine("G28");
+            writer.appendLine("G1 X10 Y20 Z30 F50");
+            writer.append("M3\n");
+            writer.sync();
+
+            File file("buffered.gcode", "test_data");
+            CHECK(file.readAll() == "G28\nG1 X10 Y20 Z30 F50\nM3\n");
+            writer.close();
+        }
+
+        SUBCASE("El umbral de tamaño dispara el volcado") {
+            BufferedFileWriter writer(ruta, true, 8, std::chrono::milliseconds(60000));
+            writer.appendLine("G1 X100 Y100");
+
+            bool volcado = false;
+            for (int i = 0; i < 200 && !volcado; ++i) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                volcado = std::filesystem::file_size(ruta) > 0;
+            }
+            CHECK(volcado);
+        }
+
+        SUBCASE("close preserva el orden y modo append") {
+            {
+                BufferedFileWriter writer(ruta, true, 4, std::chrono::milliseconds(1));
+                for (int i = 0; i < 100; ++i) writer.appendLine("L" + std::to_string(i));
+            }
+            BufferedFileWriter writer(ruta, false);
+            writer.appendLine("FIN");
+            writer.close();
+            CHECK_FALSE(writer.isOpen());
+            CHECK_THROWS_AS(writer.append("x"), std::runtime_error);
+
+            std::ifstream in(ruta);
+            std::string linea;
+            int n = 0;
+            while (std::getline(in, linea) && n < 100) {
+                CHECK(linea == "L" + std::to_string(n));
+                ++n;
+            }
+            CHECK(n == 100);
+            CHECK(linea == "FIN");
+        }
+    }
+
+    TEST_CASE_FIXTURE(TestSetup, "AsyncLogWriter") {
+        const std::string ruta = "test_data/async.log";
+        auto contarLineas = [&]() {
+            std::ifstream in(ruta);
+            std::string linea;
+            size_t n = 0;
+            while (std::getline(in, linea)) ++n;
+            return n;
+        };
+
+        SUBCASE("Varios productores: nada se pierde y cada uno conserva su orden") {
+            {
+                AsyncLogWriter writer(64);
+                writer.setTarget(AsyncLogWriter::DEBUG_FILE, ::open(ruta.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644));
+
+                std::vector<std::thread> hilos;
+                for (int h = 0; h < 4; ++h) {
+                    hilos.emplace_back([&writer, h]() {
+                        for (int i = 0; i < 500; ++i) {
+                            LogRecord r;
+                            r.targets = AsyncLogWriter::DEBUG_FILE;
+                            r.tag = "[INFO] ";
+                            r.text = std::to_string(h) + " " + std::to_string(i);
+                            writer.push(std::move(r));
+                        }
+                    });
+                }
+                for (auto& t : hilos) t.join();
+                writer.flush();
+                CHECK(contarLineas() == 2000);
+            }
+
+            std::ifstream in(ruta);
+            std::string linea;
+            int siguiente[4] = {0, 0, 0, 0};
+            bool ordenado = true;
+            while (std::getline(in, linea)) {
+                size_t pos = linea.find("] [INFO] ");
+                REQUIRE(pos != std::string::npos);
+                int h = 0, i = 0;
+                std::sscanf(linea.c_str() + pos + 9, "%d %d", &h, &i);
+                ordenado = ordenado && i == siguiente[h];
+                siguiente[h] = i + 1;
+            }
+            CHECK(ordenado);
+        }
+
+        SUBCASE("DROP descarta y cuenta; los registros críticos siempre entran") {
+            AsyncLogWriter writer(2, AsyncLogWriter::FsyncPolicy::NEVER, std::chrono::milliseconds(0),
+                                  AsyncLogWriter::OverflowPolicy::DROP);
+            writer.setTarget(AsyncLogWriter::DEBUG_FILE, ::open(ruta.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644));
+
+            size_t aceptados = 0;
+            for (int i = 0; i < 5000; ++i) {
+                LogRecord r;
+                r.targets = AsyncLogWriter::DEBUG_FILE;
+                r.critical = (i % 100 == 0);
+                r.text = "linea " + std::to_string(i);
+                if (writer.push(std::move(r))) ++aceptados;
+            }
+            writer.flush();
+            CHECK(contarLineas() == aceptados);
+            CHECK(aceptados + writer.droppedCount() == 5000);
+            CHECK(aceptados >= 50);
+        }
+
+        SUBCASE("PALogger: audit.csv con cabecera y registros tras flush") {
+            const std::string audit = "test_data/audit.csv";
+            PALogger logger(LogLevel::ERROR, true, "test_data/servidor.log", audit);
+            logger.logRequest("admin", "robot.move", "OK, listo");
+            logger.info("no pasa el nivel");
+            logger.flush();
+
+            std::ifstream in(audit);
+            std::string cabecera, registro;
+            std::getline(in, cabecera);
+            std::getline(in, registro);
+            CHECK(cabecera == "timestamp,peticion,usuario,nodo,respuesta");
+            CHECK(registro.find(",robot.move,admin,N/A,\"OK, listo\"") != std::string::npos);
+            CHECK(std::filesystem::file_size("test_data/servidor.log") == 0);
+        }
+    }
+
+    TEST_CASE_FIXTURE(TestSetup, "PALogger con formato diferido") {
+        SUBCASE("Reemplazo de {} por los argumentos") {
+            std::string out;
+            palogger_detail::format(out, "Respuesta '{}': {} ({} ms, ok={})", "G28", std::string("OK"), 42, true);
+            CHECK(out == "Respuesta 'G28': OK (42 ms, ok=true)");
+
+            out.clear();
+            palogger_detail::format(out, "sin marcas", 1, 2);
+            CHECK(out == "sin marcas");
+
+            out.clear();
+            palogger_detail::format(out, "{} y {}", 'a');
+            CHECK(out == "a y {}");
+        }
+
+        SUBCASE("Un nivel deshabilitado no formatea") {
+            PALogger logger(LogLevel::WARNING, true, "test_data/servidor.log", "test_data/audit.csv");
+            CHECK_FALSE(logger.isEnabled(LogLevel::INFO));
+            CHECK(logger.isEnabled(LogLevel::ERROR));
+
+            logger.info("no se escribe {}", Costoso{});
+            CHECK(formateosCostosos == 0);
+            logger.warning("aviso {} de {}", 1, Costoso{});
+            CHECK(formateosCostosos == 1);
+            logger.flush();
+
+            std::ifstream in("test_data/servidor.log");
+            std::string linea, ultima;
+            int n = 0;
+            while (std::getline(in, linea)) { ultima = linea; ++n; }
+            CHECK(n == 1);
+            CHECK(ultima.find("[WARNING] aviso 1 de costoso") != std::string::npos);
+        }
+    }
+
+    TEST_CASE_FIXTURE(TestSetup, "Rotación de logs") {
+        const std::string audit = "test_data/audit.csv";
+        auto registrar = [](PALogger& logger, int desde, int hasta) {
+            for (int i = desde; i < hasta; ++i) {
+                logger.logRequest("operador", "robot.move", "respuesta " + std::to_string(i));
+            }
+        };
+
+        SUBCASE("Rota por tamaño y el lector recorre segmentos comprimidos y activo") {
+            PALogger logger(LogLevel::ERROR, true, "test_data/servidor.log", audit);
+            RotationPolicy politica;
+            politica.maxBytes = 2000;
+            logger.setRotation(politica);
+
+            registrar(logger, 0, 100);
+            AuditLogReader lector(audit, logger);
+            // Sin esperar la compresión: segmentos planos, .gz o mezclados
+            CHECK(lector.getEntries("", "").size() == 100);
+
+            registrar(logger, 100, 200);
+            logger.waitForCompression();
+
+            auto segmentos = LogSegments::list(audit);
+            REQUIRE(segmentos.size() >= 5);
+            for (const auto& segmento : segmentos) {
+                CHECK(LogSegments::isCompressed(segmento));
+            }
+            CHECK(std::filesystem::file_size(audit) <= 2000);
+
+            auto entradas = lector.getEntries("operador", "");
+            REQUIRE(entradas.size() == 200);
+            bool ordenadas = true;
+            for (size_t i = 0; i < entradas.size(); ++i) {
+                ordenadas = ordenadas && entradas[i].respuesta == "respuesta " + std::to_string(i);
+            }
+            CHECK(ordenadas);
+
+            std::ifstream activo(audit);
+            std::string cabecera;
+            std::getline(activo, cabecera);
+            CHECK(cabecera == "timestamp,peticion,usuario,nodo,respuesta");
+        }
+
+        SUBCASE("La retención conserva solo los segmentos más nuevos") {
+            {
+                PALogger logger(LogLevel::ERROR, true, "test_data/servidor.log", audit);
+                RotationPolicy politica;
+                politica.maxBytes = 1000;
+                politica.maxSegments = 2;
+                logger.setRotation(politica);
+                registrar(logger, 0, 200);
+                logger.waitForCompression();
+                CHECK(LogSegments::list(audit).size() == 2);
+
+                auto entradas = AuditLogReader(audit, logger).getEntries("", "");
+                REQUIRE_FALSE(entradas.empty());
+                CHECK(entradas.back().respuesta == "respuesta 199");
+            }
+
+            // Un segmento sin comprimir de una ejecución anterior se retoma al arrancar
+            std::filesystem::copy_file(audit, audit + ".20000101-000000");
+            PALogger logger(LogLevel::ERROR, true, "test_data/servidor.log", audit);
+            RotationPolicy politica;
+            politica.maxBytes = 1000;
+            logger.setRotation(politica);
+            logger.waitForCompression();
+            CHECK(std::filesystem::exists(audit + ".20000101-000000.gz"));
+            CHECK_FALSE(std::filesystem::exists(audit + ".20000101-000000"));
+        }
+    }
+
+    TEST_CASE_FIXTURE(TestSetup, "Índice incremental del log de auditoría") {
+        const std::string audit = "test_data/audit.csv";
+        auto registrar = [](PALogger& logger, int desde, int hasta) {
+            for (int i = desde; i < hasta; ++i) {
+                logger.logRequest(i % 2 == 0 ? "ana" : "beto", "robot.move",
+                                  (i % 10 == 0 ? "ERROR, \"" : "OK, \"") + std::to_string(i) + "\"");
+            }
+        };
+
+        SUBCASE("Solo indexa lo agregado desde el reporte anterior") {
+            PALogger logger(LogLevel::ERROR, true, "test_data/servidor.log", audit);
+            AuditLogReader lector(audit, logger);
+            registrar(logger, 0, 50);
+            CHECK(lector.getEntries("", "").size() == 50);
+            CHECK(lector.indexedRows() == 50);
+
+            registrar(logger, 50, 80);
+            auto ana = lector.getEntries("ana", "");
+            REQUIRE(ana.size() == 40);
+            CHECK(ana.front().respuesta == "ERROR, \"0\"");
+            CHECK(ana.back().respuesta == "OK, \"78\"");
+            CHECK(ana.back().peticion == "robot.move");
+            CHECK(lector.indexedRows() == 80);
+
+            CHECK(lector.getEntries("beto", "ERROR").empty());
+            CHECK(lector.getEntries("ana", "ERROR").size() == 8);
+            CHECK(lector.getEntries("", "\"7").size() == 11);
+            CHECK(lector.getEntries("nadie", "").empty());
+
+            const int64_t ahora = std::time(nullptr);
+            CHECK(lector.getEntries("", "", ahora - 60, ahora + 60).size() == 80);
+            CHECK(lector.getEntries("", "", std::nullopt, ahora - 3600).empty());
+            CHECK(lector.indexedRows() == 80);
+        }
+
+        SUBCASE("Un archivo truncado se vuelve a indexar") {
+            PALogger logger(LogLevel::ERROR, true, "test_data/servidor.log", audit);
+            AuditLogReader lector(audit, logger);
+            registrar(logger, 0, 20);
+            REQUIRE(lector.getEntries("", "").size() == 20);
+
+            std::ofstream(audit, std::ios::trunc)
+                << "timestamp,peticion,usuario,nodo,respuesta\n"
+                << "2026-01-01 10:00:00,robot.home,carla,-,\"a, b\"\n";
+            auto entradas = lector.getEntries("", "");
+            REQUIRE(entradas.size() == 1);
+            CHECK(entradas[0].usuario == "carla");
+            CHECK(entradas[0].respuesta == "a, b");
+            CHECK(lector.indexedRows() == 1);
+            CHECK(lector.getEntries("ana", "").empty());
+        }
+
+        SUBCASE("Sigue al activo a través de las rotaciones") {
+            PALogger logger(LogLevel::ERROR, true, "test_data/servidor.log", audit);
+            RotationPolicy politica;
+            politica.maxBytes = 1000;
+            logger.setRotation(politica);
+            AuditLogReader lector(audit, logger);
+
+            registrar(logger, 0, 10);
+            REQUIRE(lector.getEntries("", "").size() == 10);
+
+            registrar(logger, 10, 120);
+            logger.waitForCompression();
+            REQUIRE(LogSegments::list(audit).size() >= 5);
+
+            for (int vuelta = 0; vuelta < 2; ++vuelta) {
+                auto entradas = lector.getEntries("", "");
+                REQUIRE(entradas.size() == 120);
+                bool ordenadas = true;
+                for (size_t i = 0; i < entradas.size(); ++i) {
+                    ordenadas = ordenadas && entradas[i].respuesta.find("\"" + std::to_string(i) + "\"") != std::string::npos;
+                }
+                CHECK(ordenadas);
+                CHECK(lector.indexedRows() == 120);
+            }
+            CHECK(lector.getEntries("beto", "").size() == 60);
+        }
+    }
+
+    TEST_CASE_FIXTURE(TestSetup, "Log binario") {
+        const std::string base = "test_data/servidor.plog";
+        auto leerTodo = [&]() {
+            std::vector<BinaryLogEntry> entradas;
+            BinaryLogReader lector;
+            for (const auto& segmento : BinaryLogSink::segments(base)) {
+                REQUIRE(lector.read(segmento, [&](const BinaryLogEntry& e) { entradas.push_back(e); }));
+            }
+            return entradas;
+        };
+
+        SUBCASE("Campos tipados y formato armado al decodificar") {
+            {
+                BinaryLogSink sink(base);
+                sink.write(1, "Respuesta '{}': {} ({} ms, ok={}, x={})", "G28", std::string("OK"), 42, true, 1.5);
+                sink.write(3, "sin argumentos");
+                sink.writeText(2, "mensaje ya armado");
+            }
+            auto entradas = leerTodo();
+            REQUIRE(entradas.size() == 3);
+            CHECK(entradas[0].message == "Respuesta 'G28': OK (42 ms, ok=true, x=1.500000)");
+            CHECK(entradas[0].level == 1);
+            CHECK(entradas[1].message == "sin argumentos");
+            CHECK(entradas[2].message == "mensaje ya armado");
+            CHECK(entradas[2].eventId == BinaryLogSink::TEXT_EVENT);
+            CHECK(entradas[0].threadId == entradas[2].threadId);
+            CHECK(entradas[0].monotonicNs <= entradas[2].monotonicNs);
+            CHECK(std::llabs(entradas[0].wallNs / 1000000000 - std::time(nullptr)) < 5);
+        }
+
+        SUBCASE("Varios hilos y segmentos: cada segmento se decodifica solo") {
+            {
+                BinaryLogSink sink(base, 64 * 1024);
+                std::vector<std::thread> hilos;
+                for (int h = 0; h < 4; ++h) {
+                    hilos.emplace_back([&sink, h]() {
+                        for (int i = 0; i < 3000; ++i) {
+                            sink.write(1, "hilo {} mensaje {}", h, i);
+                        }
+                    });
+                }
+                for (auto& t : hilos) t.join();
+                CHECK(sink.droppedCount() == 0);
+            }
+
+            auto segmentos = BinaryLogSink::segments(base);
+            REQUIRE(segmentos.size() > 2);
+
+            // Un segmento intermedio, leído sin los anteriores, trae sus formatos
+            BinaryLogReader solo;
+            size_t enSegmento = 0;
+            bool conTexto = true;
+            solo.read(segmentos[1], [&](const BinaryLogEntry& e) {
+                ++enSegmento;
+                conTexto = conTexto && e.message.compare(0, 5, "hilo ") == 0;
+            });
+            CHECK(enSegmento > 0);
+            CHECK(conTexto);
+
+            auto entradas = leerTodo();
+            REQUIRE(entradas.size() == 12000);
+            int siguiente[4] = {0, 0, 0, 0};
+            bool ordenado = true;
+            for (const auto& e : entradas) {
+                int h = -1, i = -1;
+                std::sscanf(e.message.c_str(), "hilo %d mensaje %d", &h, &i);
+                ordenado = ordenado && h >= 0 && h < 4 && i == siguiente[h];
+                if (h >= 0 && h < 4) siguiente[h] = i + 1;
+            }
+            CHECK(ordenado);
+        }
+
+        SUBCASE("PALogger con log binario: sin texto en servidor.log") {
+            {
+                PALogger logger(LogLevel::INFO, true, "test_data/servidor.log", "test_data/audit.csv");
+                REQUIRE(logger.enableBinaryLog(base));
+                logger.info("[{}] movimiento de {}", "robot.move", "admin");
+                logger.debug("filtrado {}", 1);
+                logger.error(std::string("error armado"));
+                logger.logRequest("admin", "robot.move", "OK");
+                logger.flush();
+                CHECK(std::filesystem::file_size("test_data/servidor.log") == 0);
+            }
+            auto entradas = leerTodo();
+            REQUIRE(entradas.size() == 2);
+            CHECK(entradas[0].message == "[robot.move] movimiento de admin");
+            CHECK(entradas[1].message == "error armado");
+            CHECK(entradas[1].level == static_cast<uint8_t>(LogLevel::ERROR));
+        }
+    }
+
+    TEST_CASE_FIXTURE(TestSetup, "MappedFile") {
+        SUBCASE("Líneas CRLF y última línea sin salto") {
+            {
+                std::ofstream out("test_data/mapped.gcode", std::ios::binary);
+                out << "G28\r\n\r\nG1 X10 Y20\nM3";
+            }
+            MappedFile archivo("test_data/mapped.gcode");
+            std::string_view linea;
+            REQUIRE(archivo.siguienteLinea(linea));
+            CHECK(linea == "G28");
+            REQUIRE(archivo.siguienteLinea(linea));
+            CHECK(linea.empty());
+            REQUIRE(archivo.siguienteLinea(linea));
+            CHECK(linea == "G1 X10 Y20");
+            REQUIRE(archivo.siguienteLinea(linea));
+            CHECK(linea == "M3");
+            CHECK(archivo.lineaActual() == 4);
+            CHECK_FALSE(archivo.siguienteLinea(linea));
+
+            // readLines da el mismo resultado
+            File file("mapped.gcode", "test_data");
+            auto lines = file.readLines();
+            REQUIRE(lines.size() == 4);
+            CHECK(lines[0] == "G28");
+            CHECK(lines[3] == "M3");
+        }
+
+        SUBCASE("Archivo vacío e inexistente") {
+            { std::ofstream out("test_data/vacio.gcode"); }
+            MappedFile vacio("test_data/vacio.gcode");
+            std::string_view linea;
+            CHECK(vacio.empty());
+            CHECK_FALSE(vacio.siguienteLinea(linea));
+            CHECK_THROWS_AS(MappedFile("test_data/no_existe.gcode"), std::runtime_error);
+        }
+
+        SUBCASE("Recorrido largo con ventana mínima y saltarA") {
+            const int N = 20000;
+            {
+                std::ofstream out("test_data/largo.gcode");
+                for (int i = 0; i < N; ++i) out << "G1 X" << i << " Y0 Z0\n";
+            }
+            // Ventana de una página: se liberan páginas continuamente
+            MappedFile archivo("test_data/largo.gcode", 1);
+            std::string_view linea;
+            int n = 0;
+            bool ok = true;
+            while (archivo.siguienteLinea(linea)) {
+                ok = ok && (linea == "G1 X" + std::to_string(n) + " Y0 Z0");
+                ++n;
+            }
+            CHECK(ok);
+            CHECK(n == N);
+
+            REQUIRE(archivo.saltarA(12345));
+            REQUIRE(archivo.siguienteLinea(linea));
+            CHECK(linea == "G1 X12345 Y0 Z0");
+            CHECK_FALSE(archivo.saltarA(N + 1));
+        }
+    }
+}
@@ -4,6 +4,11 @@
 #include "robot_model/RobotService.h"
 #include "utils/PALogger.h"
 #include "hardware/ArduinoService.h"
+#include "core/CommandHistory.h"
+#include "storage/CommandHistorySqlite.h"
+#include <atomic>
+#include <filesystem>
+#include <thread>
 #include <memory>
 #include <chrono>
 #include <iomanip>
@@ -320,4 +325,300 @@ TEST_SUITE("RobotService Integration Tests") {
         
         logger->info("🎉 SECUENCIA COMPLETA FINALIZADA EXITOSAMENTE");
     }
-}
\ No newline at end of file
+}
+
+TEST_SUITE("CommandHistory") {
+
+    struct HistorialSetup {
+        std::unique_ptr<PALogger> logger;
+        HistorialSetup() {
+            std::filesystem::create_directories("test_data_historial");
+            logger = std::make_unique<PALogger>(LogLevel::ERROR, true, "test_data_historial/servidor.log",
+                                                "test_data_historial/audit.csv");
+        }
+        ~HistorialSetup() {
+            logger.reset();
+            std::filesystem::remove_all("test_data_historial");
+        }
+    };
+
+    TEST_CASE_FIXTURE(HistorialSetup, "Índice por usuario y borrado") {
+        CommandHistory historial(*logger, 1000);
+        for (int i = 0; i < 30; ++i) {
+            historial.addEntry(i % 3 == 0 ? "ana" : "beto", "robot.move", "G1 X" + std::to_string(i), i % 5 == 0);
+        }
+
+        auto ana = historial.getEntriesForUser("ana");
+        REQUIRE(ana.size() == 10);
+        CHECK(ana[0].details == "G1 X0");
+        CHECK(ana[9].details == "G1 X27");
+        CHECK(ana[0].was_error);
+        CHECK(ana[0].service_name == "robot.move");
+        CHECK(ana[0].id < ana[1].id);
+        CHECK(ana[0].timestamp.size() == 19);
+        CHECK(historial.getEntriesForUser("nadie").empty());
+
+        historial.clearUserHistory("ana");
+        CHECK(historial.getEntriesForUser("ana").empty());
+        CHECK(historial.size() == 20);
+        auto todas = historial.getAllEntries();
+        REQUIRE(todas.size() == 20);
+        for (const auto& e : todas) CHECK(e.username == "beto");
+
+        historial.addEntry("ana", "robot.homing", "G28", false);
+        REQUIRE(historial.getEntriesForUser("ana").size() == 1);
+        CHECK(historial.getAllEntries().back().username == "ana");
+    }
+
+    TEST_CASE_FIXTURE(HistorialSetup, "Capacidad acotada: se descartan las más viejas") {
+        CommandHistory historial(*logger, 64);
+        for (int i = 0; i < 1000; ++i) {
+            historial.addEntry(i % 2 ? "ana" : "beto", "robot.move", std::to_string(i), false);
+        }
+        CHECK(historial.size() <= 64);
+        CHECK(historial.size() >= 60);
+
+        auto todas = historial.getAllEntries();
+        REQUIRE(todas.size() == historial.size());
+        CHECK(todas.back().details == "999");
+        for (size_t i = 1; i < todas.size(); ++i) CHECK(todas[i].id == todas[i - 1].id + 1);
+
+        // El índice por usuario acompaña al descarte
+        auto ana = historial.getEntriesForUser("ana");
+        auto beto = historial.getEntriesForUser("beto");
+        CHECK(ana.size() + beto.size() == todas.size());
+        CHECK(ana.front().id >= todas.front().id);
+        CHECK(ana.back().details == "999");
+    }
+
+    TEST_CASE_FIXTURE(HistorialSetup, "Persistencia en SQLite") {
+        const std::string rutaDb = "test_data_historial/historial.db";
+
+        {
+            CommandHistory historial(*logger, 16);
+            historial.attachStore(std::make_unique<CommandHistorySqlite>(rutaDb, 8, std::chrono::milliseconds(20)));
+            for (int i = 0; i < 100; ++i) {
+                historial.addEntry(i % 4 == 0 ? "ana" : "beto", "robot.move", std::to_string(i), i % 10 == 0);
+            }
+            historial.flush();
+
+            // La base conserva todo aunque la memoria solo guarde 16
+            CHECK(historial.size() <= 16);
+            CHECK(historial.getAllEntries().size() == 100);
+
+            HistoryFilter errores;
+            errores.was_error = true;
+            auto e = historial.getEntries(errores);
+            REQUIRE(e.size() == 10);
+            for (const auto& x : e) CHECK(x.was_error);
+
+            HistoryFilter exitosAna;
+            exitosAna.username = "ana";
+            exitosAna.was_error = false;
+            auto ea = historial.getEntries(exitosAna);
+            CHECK(ea.size() == 20);
+            for (const auto& x : ea) CHECK((x.username == "ana" && !x.was_error));
+        }
+
+        // Otra instancia: lo guardado sigue y los ids continúan
+        CommandHistory historial(*logger, 16);
+        historial.attachStore(std::make_unique<CommandHistorySqlite>(rutaDb, 1000, std::chrono::hours(1)));
+        historial.addEntry("ana", "robot.homing", "G28", false);
+
+        // Sin vaciar: la última entrada sale de memoria, el resto de la base
+        auto ana = historial.getEntriesForUser("ana");
+        REQUIRE(ana.size() == 26);
+        CHECK(ana.front().details == "0");
+        CHECK(ana.back().details == "G28");
+        CHECK(ana.back().id == 101);
+        CHECK(ana.front().timestamp.size() == 19);
+        auto todas = historial.getAllEntries();
+        REQUIRE(todas.size() == 101);
+        for (size_t i = 1; i < todas.size(); ++i) CHECK(todas[i].id == todas[i - 1].id + 1);
+
+        historial.clearUserHistory("ana");
+        CHECK(historial.getEntriesForUser("ana").empty());
+        CHECK(historial.getAllEntries().size() == 75);
+    }
+
+    // Recorre todas las páginas y verifica que no se repitan ni falten entradas
+    static std::vector<CommandEntry> recorrerPaginas(const CommandHistory& h, const HistoryFilter& f,
+                                                     size_t limite, bool desc, size_t& paginas) {
+        std::vector<CommandEntry> todas;
+        uint64_t cursor = 0;
+        paginas = 0;
+        do {
+            HistoryPage p = h.getPage(f, cursor, limite, desc);
+            CHECK(p.entries.size() <= limite);
+            todas.insert(todas.end(), p.entries.begin(), p.entries.end());
+            cursor = p.next_cursor;
+            ++paginas;
+        } while (cursor != 0 && paginas < 1000);
+        return todas;
+    }
+
+    static void paginadoCompleto(CommandHistory& historial) {
+        for (int i = 0; i < 100; ++i) {
+            historial.addEntry(i % 4 == 0 ? "ana" : "beto", i % 2 ? "robot.move" : "robot.homing",
+                               std::to_string(i), i % 10 == 0);
+        }
+
+        size_t paginas = 0;
+        auto asc = recorrerPaginas(historial, HistoryFilter{}, 7, false, paginas);
+        REQUIRE(asc.size() == 100);
+        CHECK(paginas == 15);
+        for (size_t i = 0; i < asc.size(); ++i) CHECK(asc[i].details == std::to_string(i));
+
+        auto desc = recorrerPaginas(historial, HistoryFilter{}, 10, true, paginas);
+        REQUIRE(desc.size() == 100);
+        CHECK(desc.front().details == "99");
+        CHECK(desc.back().details == "0");
+
+        // Filtros combinados: ana + robot.homing = i % 4 == 0 (i par)
+        HistoryFilter f;
+        f.username = "ana";
+        f.service_name = "robot.homing";
+        auto ana = recorrerPaginas(historial, f, 4, true, paginas);
+        REQUIRE(ana.size() == 25);
+        CHECK(ana.front().details == "96");
+        for (size_t i = 1; i < ana.size(); ++i) CHECK(ana[i].id < ana[i - 1].id);
+
+        HistoryTotals t = historial.countEntries(f);
+        CHECK(t.commands == 25);
+        CHECK(t.errors == 5);
+        HistoryTotals todos = historial.countEntries(HistoryFilter{});
+        CHECK(todos.commands == 100);
+        CHECK(todos.errors == 10);
+
+        // Rango de fechas: todas son de ahora
+        const int64_t ahora = std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        HistoryFilter futuro;
+        futuro.from_epoch = ahora + 3600;
+        CHECK(historial.getPage(futuro, 0, 10).entries.empty());
+        HistoryFilter reciente;
+        reciente.from_epoch = ahora - 3600;
+        reciente.to_epoch = ahora + 3600;
+        CHECK(historial.countEntries(reciente).commands == 100);
+    }
+
+    TEST_CASE_FIXTURE(HistorialSetup, "Paginado por cursor en memoria") {
+        CommandHistory historial(*logger, 1000);
+        paginadoCompleto(historial);
+    }
+
+    TEST_CASE_FIXTURE(HistorialSetup, "Paginado por cursor con SQLite y entradas pendientes") {
+        CommandHistory historial(*logger, 1000);
+        // Lotes de 16 sin espera por tiempo: al terminar quedan entradas solo en memoria
+        historial.attachStore(std::make_unique<CommandHistorySqlite>(
+            "test_data_historial/paginado.db", 16, std::chrono::hours(1)));
+        paginadoCompleto(historial);
+    }
+
+    static StatsCounter contadorDe(const std::vector<std::pair<std::string, StatsCounter>>& v, const std::string& nombre) {
+        for (const auto& [n, c] : v) if (n == nombre) return c;
+        return StatsCounter{};
+    }
+
+    TEST_CASE_FIXTURE(HistorialSetup, "Estadísticas incrementales") {
+        const std::string rutaDb = "test_data_historial/stats.db";
+        {
+            CommandHistory historial(*logger, 64);
+            historial.attachStore(std::make_unique<CommandHistorySqlite>(rutaDb));
+
+            // Un lector consulta sin parar mientras se registra
+            std::atomic<bool> fin{false};
+            std::atomic<bool> monotono{true};
+            std::thread lector([&] {
+                uint64_t anterior = 0;
+                while (!fin.load()) {
+                    HistoryStatsSnapshot s = historial.getStats();
+                    if (s.total.commands < anterior || s.total.errors > s.total.commands) monotono = false;
+                    anterior = s.total.commands;
+                }
+            });
+            for (int i = 0; i < 5000; ++i) {
+                historial.addEntry("user" + std::to_string(i % 5), i % 2 ? "robot.move" : "robot.homing",
+                                   "x", i % 10 == 0);
+            }
+            fin = true;
+            lector.join();
+            CHECK(monotono.load());
+
+            HistoryStatsSnapshot s = historial.getStats();
+            CHECK(s.total.commands == 5000);
+            CHECK(s.total.errors == 500);
+            REQUIRE(s.byUser.size() == 5);
+            CHECK(contadorDe(s.byUser, "user0").commands == 1000);
+            CHECK(contadorDe(s.byUser, "user0").errors == 500);
+            CHECK(contadorDe(s.byService, "robot.move").commands == 2500);
+            CHECK(contadorDe(s.byService, "robot.homing").errors == 500);
+
+            // Todo cae en uno o dos minutos (y una o dos horas)
+            uint64_t porMinuto = 0, porHora = 0;
+            for (const auto& b : s.byMinute) porMinuto += b.commands;
+            for (const auto& b : s.byHour) porHora += b.commands;
+            CHECK(porMinuto == 5000);
+            CHECK(porHora == 5000);
+            CHECK(s.byMinute.size() <= 2);
+
+            // Borrar historial no descuenta lo registrado
+            historial.clearUserHistory("user1");
+            CHECK(historial.getStats().total.commands == 5000);
+        }
+
+        // Al reabrir, los contadores parten de lo guardado
+        CommandHistory historial(*logger, 64);
+        historial.attachStore(std::make_unique<CommandHistorySqlite>(rutaDb));
+        historial.addEntry("user0", "robot.move", "x", true);
+        HistoryStatsSnapshot s = historial.getStats();
+        CHECK(s.total.commands == 4001);
+        CHECK(contadorDe(s.byUser, "user0").commands == 1001);
+        CHECK(contadorDe(s.byUser, "user0").errors == 501);
+        CHECK(contadorDe(s.byUser, "user1").commands == 0);
+        uint64_t porMinuto = 0;
+        for (const auto& b : s.byMinute) porMinuto += b.commands;
+        CHECK(porMinuto == 4001);
+    }
+
+    TEST_CASE_FIXTURE(HistorialSetup, "Lecturas concurrentes con descarte y borrado") {
+        CommandHistory historial(*logger, 256);
+        std::atomic<bool> fin{false};
+        std::atomic<int> inconsistencias{0};
+        std::atomic<uint64_t> lecturas{0};
+
+        std::vector<std::thread> lectores;
+        for (int r = 0; r < 3; ++r) {
+            lectores.emplace_back([&, r] {
+                while (!fin.load()) {
+                    auto todas = r == 0 ? historial.getAllEntries() : historial.getEntriesForUser("ana");
+                    for (size_t i = 0; i < todas.size(); ++i) {
+                        const auto& e = todas[i];
+                        if (i > 0 && e.id <= todas[i - 1].id) ++inconsistencias;
+                        if (e.username != "ana" && e.username != "beto") ++inconsistencias;
+                        if (r != 0 && e.username != "ana") ++inconsistencias;
+                        if (e.details != std::to_string(e.id)) ++inconsistencias;
+                    }
+                    ++lecturas;
+                }
+            });
+        }
+
+        std::thread escritor([&] {
+            for (int i = 1; i <= 20000; ++i) {
+                historial.addEntry(i % 3 ? "beto" : "ana", "robot.move", std::to_string(i), false);
+                if (i % 5000 == 0) historial.clearUserHistory("ana");
+            }
+        });
+        escritor.join();
+        fin = true;
+        for (auto& l : lectores) l.join();
+
+        CHECK(inconsistencias.load() == 0);
+        CHECK(lecturas.load() > 0);
+        // Tras el último borrado (i = 20000) no quedan entradas de ana
+        CHECK(historial.getEntriesForUser("ana").empty());
+        CHECK(historial.size() == historial.getAllEntries().size());
+        CHECK(historial.size() <= 256);
+    }
+}
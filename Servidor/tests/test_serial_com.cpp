@@ -1,6 +1,7 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest.h"
 #include "hardware/SerialCom.h"
+#include "hardware/FirmwareLog.h"
 #include <iostream>
 
 TEST_SUITE("SerialCom Unit Tests") {
@@ -61,6 +62,28 @@ TEST_SUITE("SerialCom Unit Tests") {
         }
     }
 
+    TEST_CASE("Baudrates altos") {
+        SerialCom serial;
+
+        CHECK(serial.setBaudrate(250000));
+        CHECK(serial.getBaudrate() == 250000);
+        CHECK(serial.setBaudrate(1000000));
+        CHECK_FALSE(serial.setBaudrate(12345));
+        CHECK(serial.getBaudrate() == 1000000);
+    }
+
+    TEST_CASE("Checksum y numero de linea") {
+        // Mismo calculo que el firmware (y Marlin): XOR de los bytes antes del '*'
+        CHECK(SerialCom::checksum("N0 M110") == 35);
+        CHECK(SerialCom::checksum("") == 0);
+
+        CHECK(SerialCom::frameLine(1, "G1 X5\r\n") == "N1 G1 X5*100\r\n");
+        CHECK(SerialCom::frameLine(0, "M110") == "N0 M110*35\r\n");
+
+        // Un byte alterado cambia el checksum
+        CHECK(SerialCom::checksum("N1 G1 X5") != SerialCom::checksum("N1 G1 X6"));
+    }
+
     TEST_CASE("Copy Operations Deleted") {
         // These should cause compilation errors if uncommented
         // SerialCom serial1;
@@ -70,4 +93,58 @@ TEST_SUITE("SerialCom Unit Tests") {
         
         CHECK(true); // Just to have at least one assertion
     }
-}
\ No newline at end of file
+}
+TEST_SUITE("FirmwareLog Unit Tests") {
+
+    TEST_CASE("Decodificar mensajes compactos") {
+        RespuestaFirmware r = FirmwareLog::parsear("I20 1.50 -2.00 120.00 0.00\r\nI25 1.00 0.00 1.00\r\nOK\r\n");
+
+        CHECK(r.ok);
+        CHECK_FALSE(r.tieneError);
+        REQUIRE(r.mensajes.size() == 2);
+        CHECK(r.mensajes[0] == "LINEAR MOVE: [X:1.50 Y:-2.00 Z:120.00 E:0.00]");
+        CHECK(r.mensajes[1] == "ENDSTOP: [X:1 Y:0 Z:1]");
+        CHECK(r.lineasLog.size() == 2);
+    }
+
+    TEST_CASE("Errores compactos y codigos desconocidos") {
+        RespuestaFirmware r = FirmwareLog::parsear("E51\r\nOK\r\n");
+        CHECK(r.tieneError);
+        CHECK(r.mensajeError == "POINT IS OUTSIDE OF WORKSPACE");
+
+        // M410 durante G28/M3/M5: el comando cortado se cierra con error
+        RespuestaFirmware cortado = FirmwareLog::parsear("I9\r\nE59\r\nOK\r\n");
+        CHECK(cortado.tieneError);
+        CHECK(cortado.mensajeError == "COMMAND ABORTED BY QUICK STOP");
+
+        // Comando recibido con la cola llena y otro ya retenido
+        RespuestaFirmware descartado = FirmwareLog::parsear("E60\r\nOK\r\n");
+        CHECK(descartado.tieneError);
+        CHECK(descartado.mensajeError == "QUEUE FULL, COMMAND DROPPED");
+
+        CHECK(FirmwareLog::decodificar(99, {"1.00"}) == "MSG 99 1.00");
+    }
+
+    TEST_CASE("Posicion actual de M114") {
+        double x = 0, y = 0, z = 0;
+        RespuestaFirmware r = FirmwareLog::parsear("I15\r\nI23 12.50 -3.25 80.00 0.00\r\nI10\r\nI13\r\nOK\r\n");
+        REQUIRE(FirmwareLog::posicionActual(r, x, y, z));
+        CHECK(x == doctest::Approx(12.5));
+        CHECK(y == doctest::Approx(-3.25));
+        CHECK(z == doctest::Approx(80));
+
+        CHECK_FALSE(FirmwareLog::posicionActual(FirmwareLog::parsear("E51\r\nOK\r\n"), x, y, z));
+    }
+
+    TEST_CASE("Formato de texto antiguo") {
+        RespuestaFirmware r = FirmwareLog::parsear("INFO: GRIPPER ON\nERROR: ROBOT FAILURE\nsin prefijo\nOK");
+
+        CHECK(r.ok);
+        CHECK(r.tieneError);
+        CHECK(r.mensajeError == "ROBOT FAILURE");
+        REQUIRE(r.mensajes.size() == 2);
+        CHECK(r.mensajes[0] == "GRIPPER ON");
+        CHECK(r.mensajes[1] == "sin prefijo");
+        CHECK(r.lineasLog.size() == 2);
+    }
+}
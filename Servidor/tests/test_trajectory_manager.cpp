@@ -3,9 +3,17 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest.h"
 #include "robot_model/TrajectoryManager.h"
+#include "robot_model/GCodeOptimizer.h"
+#include "robot_model/PickPlaceReorderer.h"
+#include "robot_model/MotionPlanner.h"
+#include "robot_model/MovimientosPendientes.h"
 #include "utils/File.h"  // Necesario para leer/verificar
 #include "../include/session/CurrentUser.h"
 #include <filesystem>
+#include <fstream>
+#include <cstdio>
+#include <cmath>
+#include <algorithm>
 #include <vector>
 #include <string>
 
@@ -102,4 +110,526 @@ TEST_CASE("TrajectoryManager: Casos Borde") {
     CHECK(manager.getTrayectoriaActual().rfind("prueba_doble") != std::string::npos);
 
     manager.finalizarGrabacion();
-}
\ No newline at end of file
+}
+
+TEST_CASE("TrajectoryManager: Checkpoints de ejecución") {
+    CurrentUser::set(1);
+    limpiarDirectorioTest();
+    TrajectoryManager manager(DIRECTORIO_PRUEBAS);
+
+    const std::string archivo = "1__pieza__20250101_120000.gcode";
+
+    // Sin checkpoint previo
+    CHECK_FALSE(manager.cargarCheckpoint(archivo).has_value());
+
+    CheckpointTrayectoria checkpoint;
+    checkpoint.archivo = archivo;
+    checkpoint.lineaReanudacion = 8999;
+    checkpoint.x = 10.5;
+    checkpoint.y = 150.25;
+    checkpoint.z = -20;
+    checkpoint.f = 80;
+    checkpoint.poseValida = true;
+    checkpoint.efectorActivo = true;
+    checkpoint.motivo = "ERROR: No se recibió confirmación OK\ndel Arduino";
+    REQUIRE(manager.guardarCheckpoint(checkpoint));
+
+    auto leido = manager.cargarCheckpoint(archivo);
+    REQUIRE(leido.has_value());
+    CHECK(leido->archivo == archivo);
+    CHECK(leido->lineaReanudacion == 8999);
+    CHECK(leido->x == doctest::Approx(10.5));
+    CHECK(leido->y == doctest::Approx(150.25));
+    CHECK(leido->z == doctest::Approx(-20));
+    CHECK(leido->f == doctest::Approx(80));
+    CHECK(leido->poseValida);
+    CHECK(leido->efectorActivo);
+    CHECK(leido->motivo == "ERROR: No se recibió confirmación OK del Arduino");
+
+    // Sobrescribir avanza el punto de reanudación
+    checkpoint.lineaReanudacion = 9000;
+    REQUIRE(manager.guardarCheckpoint(checkpoint));
+    CHECK(manager.cargarCheckpoint(archivo)->lineaReanudacion == 9000);
+
+    // El checkpoint no aparece como trayectoria
+    CHECK(manager.listarTrayectorias(1, "admin").empty());
+
+    CHECK(manager.eliminarCheckpoint(archivo));
+    CHECK_FALSE(manager.cargarCheckpoint(archivo).has_value());
+}
+
+TEST_CASE("MovimientosPendientes: El checkpoint no pasa a la pose ejecutada") {
+    // Estado antes de cada línea, como lo arma RobotService::ejecutarLineas
+    auto antesDe = [](size_t linea, double x, double y, double z) {
+        CheckpointTrayectoria c;
+        c.archivo = "1__pieza__20250101_120000.gcode";
+        c.lineaReanudacion = linea;
+        c.x = x; c.y = y; c.z = z;
+        c.poseValida = true;
+        return c;
+    };
+
+    MovimientosPendientes pendientes;
+    CheckpointTrayectoria actual = antesDe(3, 0, 100, 50);
+    CHECK(pendientes.checkpointConfirmado(actual).lineaReanudacion == 3);
+
+    // Tres G1 aceptados (OK al entrar al planificador): 10 -> 11 -> 12
+    pendientes.agregar(antesDe(10, 0, 100, 50), 40, 100, 50, true);
+    pendientes.agregar(antesDe(11, 40, 100, 50), 40, 140, 50, true);
+    pendientes.agregar(antesDe(12, 40, 140, 50), 0, 140, 50, true);
+    actual = antesDe(13, 0, 140, 50);
+    actual.motivo = "ERROR: E51";
+
+    // El brazo todavía no salió: se reanuda en la línea 10 desde su pose previa
+    CHECK(pendientes.confirmarConPosicion(0, 100, 50) == 0);
+    CheckpointTrayectoria guardado = pendientes.checkpointConfirmado(actual);
+    CHECK(guardado.lineaReanudacion == 10);
+    CHECK(guardado.x == doctest::Approx(0));
+    CHECK(guardado.y == doctest::Approx(100));
+    CHECK(guardado.motivo == "ERROR: E51");
+
+    // A mitad del segundo tramo: solo el primero está hecho
+    CHECK(pendientes.confirmarConPosicion(40.2, 120, 50) == 1);
+    CHECK(pendientes.cantidad() == 2);
+    CHECK(pendientes.checkpointConfirmado(actual).lineaReanudacion == 11);
+
+    // Fuera de la trayectoria (p. ej. tras un reset): no se confirma nada
+    CHECK(pendientes.confirmarConPosicion(-30, 0, 10) == 0);
+
+    // En el destino del último: todo confirmado
+    CHECK(pendientes.confirmarConPosicion(0, 140, 50) == 2);
+    CHECK(pendientes.vacio());
+    CHECK(pendientes.checkpointConfirmado(actual).lineaReanudacion == 13);
+
+    // Un arco empieza con el planificador vacío y solo se confirma en su destino
+    pendientes.agregar(antesDe(20, 0, 140, 50), 20, 140, 50, true);
+    pendientes.agregar(antesDe(21, 20, 140, 50), 40, 160, 50, false);
+    CHECK(pendientes.cantidad() == 1);
+    CHECK(pendientes.confirmarConPosicion(34, 146, 50) == 0);
+    CHECK(pendientes.checkpointConfirmado(actual).lineaReanudacion == 21);
+    CHECK(pendientes.confirmarConPosicion(40, 160, 50) == 1);
+
+    // Primer movimiento sin pose de partida: solo cuenta el destino
+    CheckpointTrayectoria inicial;
+    inicial.lineaReanudacion = 0;
+    pendientes.agregar(inicial, 10, 10, 10, true);
+    CHECK(pendientes.confirmarConPosicion(5, 5, 5) == 0);
+    pendientes.confirmarTodos();
+    CHECK(pendientes.vacio());
+}
+
+TEST_CASE("GCodeAnalyzer: Metadatos y duración estimada") {
+    // Desde home (0,170,120): tramo de 100 mm a F20 y otro de 50 mm sin F
+    const std::string contenido =
+        "G28\n"
+        "; comentario\n"
+        "G1 X0 Y70 Z120 F20\n"
+        "M3\n"
+        "G1 X0 Y70 Z70 (bajar)\n"
+        "M5\n";
+
+    MetadatosGCode meta = GCodeAnalyzer::analizar(contenido);
+    CHECK(meta.bytes == contenido.size());
+    CHECK(meta.lineas == 5);
+    CHECK(meta.movimientos == 2);
+    CHECK(meta.distanciaMm == doctest::Approx(150));
+    REQUIRE(meta.bboxValida);
+    CHECK(meta.minY == doctest::Approx(70));
+    CHECK(meta.maxY == doctest::Approx(70));
+    CHECK(meta.minZ == doctest::Approx(70));
+    CHECK(meta.maxZ == doctest::Approx(120));
+
+    // homing + 100/20 + 50/(sqrt(50)*10) + 2 efector
+    double esperado = GCodeAnalyzer::TIEMPO_HOMING_SEG + 5.0 + 50.0 / (std::sqrt(50.0) * 10)
+                    + 2 * GCodeAnalyzer::TIEMPO_EFECTOR_SEG;
+    CHECK(meta.duracionEstimadaSeg == doctest::Approx(esperado));
+
+    // Modo relativo
+    MetadatosGCode rel = GCodeAnalyzer::analizar("G91\nG1 X10\nG1 X10\nG90\nG1 X0\n");
+    CHECK(rel.distanciaMm == doctest::Approx(40));
+    CHECK(rel.maxX == doctest::Approx(20));
+}
+
+TEST_CASE("TrajectoryManager: Catálogo paginado") {
+    limpiarDirectorioTest();
+
+    // Un archivo "legacy" preexistente se indexa al construir el manager
+    {
+        std::ofstream legacy(DIRECTORIO_PRUEBAS + "vieja.gcode");
+        legacy << "G1 X10 Y150 Z100\n";
+    }
+
+    SqliteDb db(":memory:");
+    TrajectoryManager manager(DIRECTORIO_PRUEBAS, &db);
+
+    CurrentUser::set(1);
+    std::string a = manager.guardarTrayectoriaCompleta("pieza_a", "G1 X0 Y150 Z100\nG1 X0 Y150 Z50\n");
+    std::string b = manager.guardarTrayectoriaCompleta("pieza_b.gcode", "M3\n");
+    CHECK(manager.iniciarGrabacion("grabada"));
+    manager.guardarComando("G1 X10 Y160 Z100 F40");
+    manager.guardarComando("M3");
+    std::string c = manager.getTrayectoriaActual();
+    CHECK(manager.finalizarGrabacion());
+
+    CurrentUser::set(2);
+    std::string d = manager.guardarTrayectoriaCompleta("ajena", "G28\n");
+    REQUIRE_FALSE(a.empty());
+    REQUIRE_FALSE(d.empty());
+
+    // Metadatos calculados al subir y al grabar
+    auto metaA = manager.obtenerMetadatos(a);
+    REQUIRE(metaA.has_value());
+    CHECK(metaA->ownerId == 1);
+    CHECK(metaA->nombreLogico == "pieza_a");
+    CHECK(metaA->meta.lineas == 2);
+    CHECK(metaA->meta.distanciaMm == doctest::Approx(std::sqrt(800.0) + 50.0));  // desde home (0,170,120)
+
+    auto metaC = manager.obtenerMetadatos(c);
+    REQUIRE(metaC.has_value());
+    CHECK(metaC->meta.lineas == 2);
+    CHECK(metaC->meta.bytes == std::string("G1 X10 Y160 Z100 F40\nM3\n").size());
+
+    // Operador: solo lo propio, aunque pida otro owner
+    FiltroCatalogo filtro;
+    filtro.ownerId = 2;
+    filtro.ordenarPor = "nombre";
+    filtro.descendente = false;
+    PaginaCatalogo propias = manager.listarTrayectoriasPaginado(1, "op", filtro);
+    CHECK(propias.total == 3);
+    REQUIRE(propias.items.size() == 3);
+    CHECK(propias.items[0].archivo == c);  // "1__grabada" < "1__pieza_a" < "1__pieza_b"
+
+    // Admin: todo (incluye el legacy), paginado
+    FiltroCatalogo todo;
+    todo.ordenarPor = "nombre";
+    todo.descendente = false;
+    todo.limite = 2;
+    todo.offset = 2;
+    PaginaCatalogo pagina = manager.listarTrayectoriasPaginado(99, "admin", todo);
+    CHECK(pagina.total == 5);
+    REQUIRE(pagina.items.size() == 2);
+    CHECK(pagina.items[0].archivo == b);
+    CHECK(pagina.items[1].archivo == d);
+
+    todo.offset = 10;
+    pagina = manager.listarTrayectoriasPaginado(99, "admin", todo);
+    CHECK(pagina.items.empty());
+    CHECK(pagina.total == 5);
+
+    // Filtro por texto (los comodines de LIKE se escapan) y orden por líneas
+    FiltroCatalogo texto;
+    texto.texto = "pieza_";
+    texto.ordenarPor = "lineas";
+    pagina = manager.listarTrayectoriasPaginado(99, "admin", texto);
+    REQUIRE(pagina.items.size() == 2);
+    CHECK(pagina.items[0].archivo == a);
+    texto.texto = "%";
+    CHECK(manager.listarTrayectoriasPaginado(99, "admin", texto).total == 0);
+
+    // Sin conteo: misma página, total en 0
+    todo.offset = 2;
+    todo.conTotal = false;
+    pagina = manager.listarTrayectoriasPaginado(99, "admin", todo);
+    REQUIRE(pagina.items.size() == 2);
+    CHECK(pagina.items[0].archivo == b);
+    CHECK(pagina.total == 0);
+
+    // Los órdenes por defecto salen del índice, sin ordenar aparte
+    auto plan = [&](const std::string& consulta) {
+        std::string texto;
+        db.withPrepared("EXPLAIN QUERY PLAN " + consulta, nullptr, [&](sqlite3_stmt* st) {
+            texto += reinterpret_cast<const char*>(sqlite3_column_text(st, 3));
+            texto += "\n";
+        });
+        return texto;
+    };
+    std::string porNombre = plan("SELECT * FROM trajectories WHERE owner_id=1 ORDER BY archivo ASC LIMIT 20");
+    CHECK(porNombre.find("idx_traj_owner_archivo") != std::string::npos);
+    CHECK(porNombre.find("TEMP B-TREE") == std::string::npos);
+    std::string porFecha = plan("SELECT * FROM trajectories WHERE owner_id=1 ORDER BY creado_en DESC, archivo DESC LIMIT 20");
+    CHECK(porFecha.find("idx_traj_owner_creado_archivo") != std::string::npos);
+    CHECK(porFecha.find("TEMP B-TREE") == std::string::npos);
+
+    // Roles sin permiso no ven nada
+    CHECK(manager.listarTrayectoriasPaginado(1, "viewer", FiltroCatalogo{}).items.empty());
+
+    // Bajas: por el manager y por fuera (se detectan al sincronizar)
+    CHECK(manager.eliminarTrayectoria(a));
+    std::filesystem::remove(DIRECTORIO_PRUEBAS + "vieja.gcode");
+    manager.sincronizarCatalogo();
+    CHECK(manager.listarTrayectorias(99, "admin").size() == 3);
+
+    // Un segundo manager sobre la misma base no reanaliza nada
+    TrajectoryManager otro(DIRECTORIO_PRUEBAS, &db);
+    CHECK(otro.sincronizarCatalogo() == 0);
+    CHECK(otro.listarTrayectorias(2, "op") == std::vector<std::string>{d});
+
+    // Altas por fuera con el manager en marcha: el listado ve el cambio del
+    // directorio y obtenerMetadatos sincroniza ante un archivo desconocido
+    {
+        std::ofstream externo(DIRECTORIO_PRUEBAS + "2__externa__20240101_000000.gcode");
+        externo << "G1 X0 Y150 Z100\n";
+    }
+    CHECK(otro.listarTrayectorias(2, "op").size() == 2);
+    {
+        std::ofstream externo(DIRECTORIO_PRUEBAS + "2__otra__20240101_000000.gcode");
+        externo << "M3\nM5\n";
+    }
+    auto metaOtra = otro.obtenerMetadatos("2__otra__20240101_000000.gcode");
+    REQUIRE(metaOtra.has_value());
+    CHECK(metaOtra->ownerId == 2);
+    CHECK(metaOtra->meta.lineas == 2);
+}
+
+TEST_CASE("TrajectoryManager: Copia derivada única por original") {
+    limpiarDirectorioTest();
+    TrajectoryManager manager(DIRECTORIO_PRUEBAS);
+
+    CurrentUser::set(3);
+    std::string original = manager.guardarTrayectoriaCompleta("pieza", "M3\nG1 X0 Y150 Z50\nM5\n");
+    REQUIRE_FALSE(original.empty());
+
+    // Nombre fijo: dueño y timestamp del original
+    std::string copia = manager.nombreCopiaDerivada(original, "reord");
+    CHECK(copia == "3__pieza_reord__" + original.substr(original.size() - 21));
+
+    // La ejecuta otro usuario (admin): la copia sigue siendo del dueño del original
+    CurrentUser::set(7);
+    CHECK(manager.guardarCopiaDerivada(original, "reord", "M5\n") == copia);
+    CHECK(manager.guardarCopiaDerivada(original, "reord", "M3\nM5\n") == copia);
+    auto meta = manager.obtenerMetadatos(copia);
+    REQUIRE(meta.has_value());
+    CHECK(meta->ownerId == 3);
+    CHECK(meta->meta.lineas == 2);
+    CHECK(manager.cargarTrayectoria(copia) == std::vector<std::string>{"M3", "M5"});
+    CHECK(manager.listarTrayectorias(99, "admin").size() == 2);
+
+    // Legacy: sin convención de nombres
+    CHECK(manager.nombreCopiaDerivada("vieja.gcode", "reord") == "vieja_reord.gcode");
+    CurrentUser::clear();
+}
+
+TEST_CASE("GCodeOptimizer: Duplicados, colineales y efector") {
+    const std::vector<std::string> grabada = {
+        "G28",
+        "G1 X0.00 Y150.00 Z100.00 F50",
+        "G1 X0.00 Y150.00 Z100.00 F50",   // repetido
+        "G1 X10.00 Y150.00 Z100.00 F50",  // colineal
+        "G1 X20.00 Y150.05 Z100.00 F50",  // colineal dentro de la tolerancia
+        "G1 X30.00 Y150.00 Z100.00 F50",
+        "G1 X30.00 Y160.00 Z100.00 F50",  // esquina: se conserva
+        "M3",
+        "M5",
+        "M3",                             // racha: solo queda el último M3
+        "",
+        "G1 X30.00 Y170.00 Z100.00 F80",  // cambia F: no se fusiona
+        "M3",                             // ya cerrado: redundante
+        "G1 X30.00 Y170.00 Z50.00",
+        "G91",
+        "G1 X5",                          // relativo: barrera, se conserva
+        "G1 X5",
+    };
+
+    OpcionesOptimizacion opciones;
+    opciones.toleranciaMm = 0.1;
+    ResultadoOptimizacion r = GCodeOptimizer::optimizar(grabada, opciones);
+
+    const std::vector<std::string> esperado = {
+        "G28",
+        "G1 X0.00 Y150.00 Z100.00 F50",
+        "G1 X30.00 Y150.00 Z100.00 F50",
+        "G1 X30.00 Y160.00 Z100.00 F50",
+        "M3",
+        "G1 X30.00 Y170.00 Z100.00 F80",
+        "G1 X30.00 Y170.00 Z50.00",
+        "G91",
+        "G1 X5",
+        "G1 X5",
+    };
+    CHECK(r.lineas == esperado);
+    CHECK(r.lineasAntes == 16);
+    CHECK(r.lineasDespues == esperado.size());
+    CHECK(r.movimientosEliminados == 3);
+    CHECK(r.efectorEliminados == 3);
+    CHECK(r.duracionDespuesSeg < r.duracionAntesSeg);
+
+    // Con tolerancia 0 el punto desviado 0.05 mm se conserva
+    opciones.toleranciaMm = 0;
+    ResultadoOptimizacion estricto = GCodeOptimizer::optimizar(grabada, opciones);
+    CHECK(std::find(estricto.lineas.begin(), estricto.lineas.end(), "G1 X20.00 Y150.05 Z100.00 F50")
+          != estricto.lineas.end());
+
+    // Un ida y vuelta sobre la misma recta no se fusiona
+    ResultadoOptimizacion vuelta = GCodeOptimizer::optimizar(
+        std::string("G1 X0 Y150 Z100\nG1 X50 Y150 Z100\nG1 X0 Y150 Z100\n"), OpcionesOptimizacion{});
+    CHECK(vuelta.lineas.size() == 3);
+    CHECK(vuelta.contenido() == "G1 X0 Y150 Z100\nG1 X50 Y150 Z100\nG1 X0 Y150 Z100\n");
+}
+
+TEST_CASE("PickPlaceReorderer: Reordenar operaciones") {
+    // Tres operaciones cruzadas: ir a 200, volver a 0, ir a 100 (recorrido zigzag)
+    auto operacion = [](int x) {
+        const std::string sx = std::to_string(x);
+        return std::vector<std::string>{
+            "G1 X" + sx + " Y150 Z50 F50",
+            "G1 X" + sx + " Y150 Z10 F20",
+            "M3",
+            "G1 X" + sx + " Y200 Z10 F20",
+            "M5",
+            "G1 X" + sx + " Y200 Z50 F20",
+        };
+    };
+    std::vector<std::string> lineas = {"G28", "G90"};
+    for (int x : {200, 0, 100}) {
+        auto op = operacion(x);
+        lineas.insert(lineas.end(), op.begin(), op.end());
+    }
+    lineas.push_back("G1 X0 Y170 Z120 F50");   // epílogo: volver a reposo
+
+    ResultadoReorden r = PickPlaceReorderer::reordenar(lineas, 1);
+    REQUIRE(r.reordenado);
+    CHECK(r.bloques == 3);
+    CHECK(r.viajeDespuesSeg < r.viajeAntesSeg);
+    REQUIRE(r.lineas.size() == lineas.size());
+
+    // Prólogo y epílogo fijos; cada bloque se conserva íntegro
+    CHECK(r.lineas[0] == "G28");
+    CHECK(r.lineas[1] == "G90");
+    CHECK(r.lineas.back() == "G1 X0 Y170 Z120 F50");
+    std::vector<std::string> ordenEntradas;
+    for (size_t b = 0; b < 3; ++b) {
+        const size_t base = 2 + b * 6;
+        const std::string x = r.lineas[base].substr(4, r.lineas[base].find(' ', 4) - 4);
+        CHECK(std::vector<std::string>(r.lineas.begin() + base, r.lineas.begin() + base + 6)
+              == operacion(std::stoi(x)));
+        ordenEntradas.push_back(x);
+    }
+    CHECK(ordenEntradas == std::vector<std::string>{"0", "100", "200"});
+
+    // A través del optimizador: solo reordenar
+    OpcionesOptimizacion opciones;
+    opciones.reordenarPickAndPlace = true;
+    opciones.simplificarColineales = false;
+    opciones.colapsarEfector = false;
+    opciones.distanciaMinimaMm = 0;
+    ResultadoOptimizacion opt = GCodeOptimizer::optimizar(lineas, opciones);
+    CHECK(opt.reordenado);
+    CHECK(opt.lineas == r.lineas);
+    CHECK(opt.duracionDespuesSeg < opt.duracionAntesSeg);
+
+    // Coordenadas relativas: no se reordena
+    std::vector<std::string> relativas = lineas;
+    relativas.insert(relativas.begin() + 8, "G91");
+    ResultadoReorden rel = PickPlaceReorderer::reordenar(relativas, 1);
+    CHECK_FALSE(rel.reordenado);
+    CHECK_FALSE(rel.motivo.empty());
+    CHECK(rel.lineas == relativas);
+
+    // Muchos bloques con búsqueda en paralelo: resultado es una permutación válida
+    std::vector<std::string> grande = {"G28"};
+    for (int k = 0; k < 150; ++k) {
+        auto op = operacion((k * 37) % 151);
+        grande.insert(grande.end(), op.begin(), op.end());
+    }
+    ResultadoReorden par = PickPlaceReorderer::reordenar(grande, 4);
+    REQUIRE(par.reordenado);
+    CHECK(par.bloques == 150);
+    CHECK(par.viajeDespuesSeg < par.viajeAntesSeg);
+    std::vector<std::string> a = grande, b = par.lineas;
+    std::sort(a.begin(), a.end());
+    std::sort(b.begin(), b.end());
+    CHECK(a == b);
+}
+
+TEST_CASE("GCodeOptimizer: Ajuste de arcos G2/G3") {
+    // Cuarto de círculo antihorario de radio 50 alrededor de (0, 150), en 30 tramos.
+    // Sin F el firmware elige la velocidad según el largo: los tramos cortos son lentos.
+    std::vector<std::string> lineas = {"G28", "G1 X50.00 Y150.00 Z100.00"};
+    for (int k = 1; k <= 30; ++k) {
+        const double a = (M_PI / 2) * k / 30;
+        char buf[96];
+        std::snprintf(buf, sizeof(buf), "G1 X%.2f Y%.2f Z100.00", 50 * std::cos(a), 150 + 50 * std::sin(a));
+        lineas.push_back(buf);
+    }
+    lineas.push_back("G1 X-30.00 Y200.00 Z100.00");   // sigue en recta
+
+    OpcionesOptimizacion opciones;
+    opciones.ajustarArcos = true;
+    opciones.toleranciaMm = 0.05;
+    ResultadoOptimizacion r = GCodeOptimizer::optimizar(lineas, opciones);
+
+    REQUIRE(r.lineas.size() == 4);
+    CHECK(r.lineas[1] == "G1 X50.00 Y150.00 Z100.00");
+    CHECK(r.lineas[3] == "G1 X-30.00 Y200.00 Z100.00");
+    LineaGCode arco;
+    REQUIRE(GCodeAnalyzer::parsearLinea(r.lineas[2], arco));
+    CHECK(arco.numero == 3);
+    CHECK(arco.x == doctest::Approx(0));
+    CHECK(arco.y == doctest::Approx(200));
+    // La entrada está redondeada a 0.01 mm: el centro se recupera con ese margen
+    CHECK(std::fabs(arco.i + 50) < 0.05);
+    CHECK(std::fabs(arco.j) < 0.05);
+    CHECK(r.arcosAjustados == 1);
+    CHECK(r.movimientosEliminados == 29);
+    CHECK(r.duracionDespuesSeg < r.duracionAntesSeg);
+
+    // Sin la opción, el arco denso queda como polilínea (solo RDP)
+    opciones.ajustarArcos = false;
+    ResultadoOptimizacion sinArcos = GCodeOptimizer::optimizar(lineas, opciones);
+    CHECK(sinArcos.arcosAjustados == 0);
+    CHECK(sinArcos.lineas.size() > r.lineas.size());
+
+    // Un zigzag no es un arco
+    opciones.ajustarArcos = true;
+    ResultadoOptimizacion zigzag = GCodeOptimizer::optimizar(std::string(
+        "G28\nG1 X0 Y150 Z100\nG1 X10 Y160 Z100\nG1 X20 Y150 Z100\nG1 X30 Y160 Z100\n"
+        "G1 X40 Y150 Z100\nG1 X50 Y160 Z100\n"), opciones);
+    CHECK(zigzag.arcosAjustados == 0);
+
+    // El analizador mide el arco por su longitud y extiende la bbox
+    MetadatosGCode m = GCodeAnalyzer::analizar(
+        "G28\nG1 X50 Y150 Z100 F40\nG2 X50 Y150 Z100 I-50 J0 F40\n");
+    CHECK(m.movimientos == 2);
+    CHECK(m.distanciaMm == doctest::Approx(std::sqrt(50.0 * 50 + 20 * 20 + 20 * 20) + 2 * M_PI * 50));
+    CHECK(m.minX == doctest::Approx(-50));
+    CHECK(m.minY == doctest::Approx(100));
+    CHECK(m.maxY == doctest::Approx(200));
+
+    // G3 de un cuarto de vuelta: misma longitud que el firmware (r * barrido)
+    CHECK(GCodeAnalyzer::barridoArco(50, 150, 0, 200, 0, 150, false) == doctest::Approx(M_PI / 2));
+    CHECK(GCodeAnalyzer::barridoArco(50, 150, 0, 200, 0, 150, true) == doctest::Approx(-3 * M_PI / 2));
+}
+
+TEST_CASE("MotionPlanner: Velocidades de unión y perfiles trapezoidales") {
+    const double a = ParametrosPlanificador{}.aceleracion;
+
+    // Un tramo aislado: trapecio completo desde y hasta el reposo
+    CHECK(MotionPlanner::tiempoTrapecio(100, 0, 50, 0, a) == doctest::Approx(50.0 / a + 100.0 / 50));
+    // Tramo corto: no llega a crucero (triangular)
+    CHECK(MotionPlanner::tiempoTrapecio(2, 0, 50, 0, a) == doctest::Approx(2 * std::sqrt(2.0 / a)));
+
+    // Una recta partida en 10 tramos colineales cuesta lo mismo que la recta entera
+    std::vector<std::string> partida = {"G28", "G1 X0 Y150 Z100 F50"};
+    for (int k = 1; k <= 10; ++k) partida.push_back("G1 X" + std::to_string(10 * k) + " Y150 Z100 F50");
+    const double entera = MotionPlanner::estimar({"G28", "G1 X0 Y150 Z100 F50", "G1 X100 Y150 Z100 F50"});
+    CHECK(MotionPlanner::estimar(partida) == doctest::Approx(entera));
+
+    // Sin anticipación se frena en cada vértice
+    ParametrosPlanificador sinAnticipacion;
+    sinAnticipacion.anticipacion = false;
+    CHECK(MotionPlanner::estimar(partida, sinAnticipacion) > entera + 0.3);
+
+    // En una esquina de 90° se frena parcialmente; en una vuelta atrás, por completo
+    const double esquina = MotionPlanner::estimar({"G1 X0 Y150 Z100 F50", "G1 X50 Y150 Z100 F50", "G1 X50 Y200 Z100 F50"});
+    const double esquinaSinAnt = MotionPlanner::estimar({"G1 X0 Y150 Z100 F50", "G1 X50 Y150 Z100 F50", "G1 X50 Y200 Z100 F50"},
+                                                        sinAnticipacion);
+    // (desde home: bajar en Z y volver a subir)
+    const double vuelta = MotionPlanner::estimar({"G1 X0 Y170 Z60 F50", "G1 X0 Y170 Z120 F50"});
+    const double vueltaSinAnt = MotionPlanner::estimar({"G1 X0 Y170 Z60 F50", "G1 X0 Y170 Z120 F50"}, sinAnticipacion);
+    CHECK(esquina < esquinaSinAnt);
+    CHECK(vuelta == doctest::Approx(vueltaSinAnt));
+
+    // M3/M5 vacían la ventana y suman su tiempo fijo
+    const double conPinza = MotionPlanner::estimar({"G1 X0 Y150 Z100 F50", "M3", "G1 X50 Y150 Z100 F50"});
+    CHECK(conPinza > GCodeAnalyzer::TIEMPO_EFECTOR_SEG);
+}
@@ -0,0 +1,79 @@
+// Benchmark del lector del log de auditoría (admin.getLogReport).
+//
+// Uso:
+//   make bench-auditoria
+//   ./bin/bench_auditoria [filas] [usuarios]   (por defecto, 500000 y 50)
+//
+// Escribe un audit.csv con las filas en un directorio temporal y mide,
+// para un filtro por usuario y otro por respuesta: el primer reporte (arma
+// el índice, equivale a releer todo el archivo como antes), el mismo
+// reporte repetido y el reporte después de agregar 1000 filas al activo.
+
+#include "utils/AuditLogReader.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+using Reloj = std::chrono::steady_clock;
+
+static double msDesde(Reloj::time_point t0) {
+    return std::chrono::duration<double, std::milli>(Reloj::now() - t0).count();
+}
+
+static void escribir(const std::string& ruta, size_t desde, size_t hasta, size_t usuarios) {
+    std::ofstream out(ruta, std::ios::app);
+    for (size_t i = desde; i < hasta; ++i) {
+        out << "2026-10-19 1" << (i / 3600) % 10 << ":" << (i / 600) % 6 << (i / 60) % 10 << ":"
+            << (i / 10) % 6 << i % 10 << ",robot.move,user" << i % usuarios << ",-,"
+            << (i % 97 == 0 ? "\"ERROR, fuera de rango\"" : "\"OK, G1 X10 Y20 F1000\"") << "\n";
+    }
+}
+
+int main(int argc, char** argv) {
+    const size_t filas = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 500000;
+    const size_t usuarios = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 50;
+
+    const auto dir = std::filesystem::temp_directory_path() / "bench_auditoria";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    const std::string audit = (dir / "audit.csv").string();
+    std::ofstream(audit) << "timestamp,peticion,usuario,nodo,respuesta\n";
+    escribir(audit, 0, filas, usuarios);
+    std::printf("audit.csv: %zu filas, %.1f MiB\n", filas,
+                std::filesystem::file_size(audit) / (1024.0 * 1024.0));
+
+    {
+        PALogger logger(LogLevel::ERROR, true, (dir / "servidor.log").string(), audit);
+        size_t total = filas;
+
+        auto medir = [&](const char* nombre, const std::string& usuario, const std::string& respuesta) {
+            AuditLogReader lector(audit, logger);
+            auto t0 = Reloj::now();
+            const size_t n = lector.getEntries(usuario, respuesta).size();
+            const double msPrimero = msDesde(t0);
+
+            auto t1 = Reloj::now();
+            lector.getEntries(usuario, respuesta);
+            const double msRepetido = msDesde(t1);
+
+            escribir(audit, total, total + 1000, usuarios);
+            total += 1000;
+            auto t2 = Reloj::now();
+            lector.getEntries(usuario, respuesta);
+            const double msCreciente = msDesde(t2);
+
+            std::printf("%-18s %7zu filas  primero %8.1f ms  repetido %7.1f ms  +1000 filas %7.1f ms\n",
+                        nombre, n, msPrimero, msRepetido, msCreciente);
+        };
+
+        medir("filter_user", "user7", "");
+        medir("filter_response", "", "ERROR");
+        medir("sin filtros", "", "");
+    }
+    std::filesystem::remove_all(dir);
+    return 0;
+}
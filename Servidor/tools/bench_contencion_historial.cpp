@@ -0,0 +1,124 @@
+// Benchmark de contención del historial de comandos en memoria.
+//
+// Uso:
+//   make bench-contencion
+//   ./bin/bench_contencion_historial [ms por escenario] [capacidad]   (por defecto, 2000 y 100000)
+//
+// Llena el historial hasta la capacidad y, para cada escenario, corre
+// escritores que llaman a addEntry() (como los robot.*) junto a lectores
+// que piden reportes: getAllEntries() (reporte de admin completo),
+// getEntriesForUser() o una página de 200 (robot.getReport). Para los
+// escritores muestra altas/s y la latencia de addEntry (p50, p99, máx.);
+// para los lectores, reportes/s. La auditoría CSV va a un directorio
+// temporal y forma parte del costo de addEntry, igual que en el servidor.
+
+#include "core/CommandHistory.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Reloj = std::chrono::steady_clock;
+
+enum class Reporte { Completo, PorUsuario, Pagina };
+
+static const char* nombreReporte(Reporte r) {
+    switch (r) {
+        case Reporte::Completo: return "getAllEntries";
+        case Reporte::PorUsuario: return "getEntriesForUser";
+        case Reporte::Pagina: return "página de 200";
+    }
+    return "";
+}
+
+struct Escenario {
+    int escritores;
+    int lectores;
+    Reporte reporte;
+};
+
+static void correr(CommandHistory& historial, const Escenario& e, int ms) {
+    std::atomic<bool> fin{false};
+    std::vector<std::vector<double>> latencias(e.escritores);
+    std::vector<uint64_t> reportes(e.lectores, 0);
+    std::vector<std::thread> hilos;
+
+    for (int w = 0; w < e.escritores; ++w) {
+        hilos.emplace_back([&, w] {
+            const std::string usuario = "operador" + std::to_string(w);
+            auto& lat = latencias[w];
+            lat.reserve(1 << 20);
+            for (uint64_t i = 0; !fin.load(std::memory_order_relaxed); ++i) {
+                auto t0 = Reloj::now();
+                historial.addEntry(usuario, "robot.move", "G1 X" + std::to_string(i % 200) + " Y10", i % 50 == 0);
+                lat.push_back(std::chrono::duration<double, std::micro>(Reloj::now() - t0).count());
+            }
+        });
+    }
+    for (int r = 0; r < e.lectores; ++r) {
+        hilos.emplace_back([&, r] {
+            HistoryFilter ultimos;
+            while (!fin.load(std::memory_order_relaxed)) {
+                size_t n = 0;
+                switch (e.reporte) {
+                    case Reporte::Completo: n = historial.getAllEntries().size(); break;
+                    case Reporte::PorUsuario: n = historial.getEntriesForUser("operador0").size(); break;
+                    case Reporte::Pagina: n = historial.getPage(ultimos, 0, 200, true).entries.size(); break;
+                }
+                if (n > 0) ++reportes[r];
+            }
+        });
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+    fin = true;
+    for (auto& h : hilos) h.join();
+
+    std::vector<double> todas;
+    for (auto& lat : latencias) todas.insert(todas.end(), lat.begin(), lat.end());
+    std::sort(todas.begin(), todas.end());
+    auto pct = [&](double p) {
+        return todas.empty() ? 0.0 : todas[std::min(todas.size() - 1, static_cast<size_t>(p * todas.size()))];
+    };
+    uint64_t totalReportes = 0;
+    for (uint64_t n : reportes) totalReportes += n;
+
+    std::printf("%d escritores + %d lectores (%-17s)  %8.0f altas/s  p50 %6.1f us  p99 %8.1f us  máx %9.1f us",
+                e.escritores, e.lectores, e.lectores ? nombreReporte(e.reporte) : "-",
+                todas.size() / (ms / 1000.0), pct(0.50), pct(0.99), todas.empty() ? 0.0 : todas.back());
+    if (e.lectores) std::printf("  %8.1f reportes/s", totalReportes / (ms / 1000.0));
+    std::printf("\n");
+}
+
+int main(int argc, char** argv) {
+    const int ms = argc > 1 ? std::atoi(argv[1]) : 2000;
+    const size_t capacidad = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : CommandHistory::DEFAULT_CAPACITY;
+
+    const auto dir = std::filesystem::temp_directory_path() / "bench_contencion_historial";
+    std::filesystem::create_directories(dir);
+    {
+        PALogger logger(LogLevel::ERROR, true, (dir / "servidor.log").string(), (dir / "audit.csv").string());
+        CommandHistory historial(logger, capacidad);
+        for (size_t i = 0; i < capacidad; ++i) {
+            historial.addEntry("operador" + std::to_string(i % 8), "robot.move", "G1 X" + std::to_string(i % 200), false);
+        }
+        std::printf("Historial lleno: %zu entradas (capacidad %zu)\n", historial.size(), capacidad);
+
+        const Escenario escenarios[] = {
+            {4, 0, Reporte::Completo},
+            {4, 1, Reporte::Completo},
+            {4, 4, Reporte::Completo},
+            {4, 4, Reporte::PorUsuario},
+            {4, 4, Reporte::Pagina},
+        };
+        for (const auto& e : escenarios) correr(historial, e, ms);
+    }
+    std::filesystem::remove_all(dir);
+    return 0;
+}
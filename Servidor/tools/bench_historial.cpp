@@ -0,0 +1,114 @@
+// Benchmark del historial de comandos persistente (tabla command_history).
+//
+// Uso:
+//   make bench-historial
+//   ./bin/bench_historial [filas] [usuarios]   (por defecto, 2000000 y 50)
+//
+// Inserta las filas con CommandHistorySqlite (lotes de 512 en una base
+// temporal) y mide filas/s. Después compara, para un filtro por usuario y
+// otro por error, la consulta completa en SQL con el camino anterior de
+// robot.getReport (copiar todo el historial y filtrar en C++), y mide una
+// página de 200 por cursor y el conteo de totales.
+
+#include "storage/CommandHistorySqlite.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+using Reloj = std::chrono::steady_clock;
+
+static double msDesde(Reloj::time_point t0) {
+    return std::chrono::duration<double, std::milli>(Reloj::now() - t0).count();
+}
+
+int main(int argc, char** argv) {
+    const size_t filas = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000000;
+    const size_t usuarios = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 50;
+    const std::string ruta = (std::filesystem::temp_directory_path() / "bench_historial.db").string();
+    for (const char* sufijo : {"", "-wal", "-shm"}) std::filesystem::remove(ruta + sufijo);
+
+    std::vector<CommandEntry> todas;
+    todas.reserve(filas);
+    {
+        CommandHistorySqlite store(ruta);
+        const int64_t base = 1700000000;
+        auto t0 = Reloj::now();
+        for (size_t i = 0; i < filas; ++i) {
+            CommandEntry e;
+            e.id = i + 1;
+            e.epoch = base + static_cast<int64_t>(i / 10);
+            e.username = "user" + std::to_string(i % usuarios);
+            e.service_name = (i % 3 == 0) ? "robot.move" : "robot.getStatus";
+            e.details = "G1 X" + std::to_string(i % 200) + " Y10 F1000";
+            e.was_error = (i % 97 == 0);
+            todas.push_back(e);
+            store.encolar(std::move(e));
+        }
+        store.vaciar();
+        const double ms = msDesde(t0);
+        std::printf("Inserción: %zu filas en %.0f ms (%.0f filas/s, %llu lotes)\n",
+                    filas, ms, filas / (ms / 1000.0),
+                    static_cast<unsigned long long>(store.getLotesConfirmados()));
+
+        auto medir = [&](const char* nombre, const HistoryFilter& f) {
+            auto t1 = Reloj::now();
+            auto enSql = store.consultar(f, 0, store.ultimoConfirmado(), SIZE_MAX, false);
+            const double msSql = msDesde(t1);
+
+            // Camino anterior: copia completa y filtro en C++
+            auto t2 = Reloj::now();
+            std::vector<CommandEntry> copia = todas;
+            std::vector<CommandEntry> filtradas;
+            for (const auto& e : copia) {
+                if (!f.username.empty() && e.username != f.username) continue;
+                if (f.was_error.has_value() && e.was_error != *f.was_error) continue;
+                filtradas.push_back(e);
+            }
+            const double msMem = msDesde(t2);
+
+            // Una página de 200 (robot.getReport): al principio, a la mitad y la última
+            const uint64_t tope = store.ultimoConfirmado();
+            auto t3 = Reloj::now();
+            store.consultar(f, 0, tope, 201, false);
+            const double msPrimera = msDesde(t3);
+            auto t4 = Reloj::now();
+            store.consultar(f, tope / 2, tope, 201, false);
+            const double msMitad = msDesde(t4);
+            auto t5 = Reloj::now();
+            store.consultar(f, 0, tope, 201, true);
+            const double msUltima = msDesde(t5);
+            auto t6 = Reloj::now();
+            store.contar(f, tope);
+            const double msContar = msDesde(t6);
+
+            std::printf("%-22s %7zu filas  SQL %8.1f ms  copia+filtro %8.1f ms%s\n",
+                        nombre, enSql.size(), msSql, msMem,
+                        enSql.size() == filtradas.size() ? "" : "  (¡distinto!)");
+            std::printf("%-22s página de 200: primera %.2f ms, mitad %.2f ms, última (desc) %.2f ms;"
+                        " totales %.1f ms\n", "", msPrimera, msMitad, msUltima, msContar);
+        };
+
+        HistoryFilter porUsuario;
+        porUsuario.username = "user7";
+        medir("filter_user", porUsuario);
+
+        HistoryFilter soloErrores;
+        soloErrores.was_error = true;
+        medir("filter_error=true", soloErrores);
+
+        HistoryFilter errorDeUsuario;
+        errorDeUsuario.username = "user7";
+        errorDeUsuario.was_error = true;
+        medir("usuario + error", errorDeUsuario);
+    }
+
+    std::error_code ec;
+    std::printf("Tamaño de la base: %.1f MiB\n",
+                std::filesystem::file_size(ruta, ec) / (1024.0 * 1024.0));
+    for (const char* sufijo : {"", "-wal", "-shm"}) std::filesystem::remove(ruta + sufijo);
+    return 0;
+}
@@ -0,0 +1,123 @@
+// Benchmark de tiempo total de trayectoria: perfil actual vs planificador look-ahead.
+//
+// Uso:
+//   make bench
+//   ./bin/bench_planificador [archivo.gcode ...]   (por defecto, data/trayectorias/*.gcode)
+//
+// Para cada trayectoria muestra la duración estimada:
+//   - sin_lookahead: perfil de Interpolation (cada tramo parte y termina en reposo)
+//   - trapecio:      perfiles trapezoidales sin anticipación (ventana de 1)
+//   - lookahead:     planificador con la ventana del firmware (PLANNER_WINDOW)
+// El ahorro se calcula contra 'trapecio' (misma aceleración máxima); el perfil
+// coseno de 'sin_lookahead' no limita la aceleración y se muestra como referencia.
+
+#include "robot_model/GCodeAnalyzer.h"
+#include "robot_model/MotionPlanner.h"
+#include "utils/MappedFile.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+struct Medicion {
+    size_t lineas = 0;
+    size_t movimientos = 0;
+    double sinLookahead = 0;
+    double trapecio = 0;
+    double lookahead = 0;
+    double microsPlanificar = 0;
+};
+
+static Medicion medir(const std::vector<std::string>& lineas) {
+    Medicion m;
+    GCodeAnalyzer analizador;
+    for (const auto& l : lineas) analizador.procesarLinea(l);
+    m.lineas = analizador.resultado().lineas;
+    m.movimientos = analizador.resultado().movimientos;
+    m.sinLookahead = analizador.resultado().duracionEstimadaSeg;
+
+    ParametrosPlanificador sinAnticipacion;
+    sinAnticipacion.anticipacion = false;
+    m.trapecio = MotionPlanner::estimar(lineas, sinAnticipacion);
+
+    const auto t0 = std::chrono::steady_clock::now();
+    m.lookahead = MotionPlanner::estimar(lineas);
+    m.microsPlanificar = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+    return m;
+}
+
+static void imprimir(const std::string& nombre, const Medicion& m) {
+    const double ahorro = m.trapecio > 0 ? 100.0 * (1.0 - m.lookahead / m.trapecio) : 0;
+    std::printf("%-48s %7zu %7zu %12.2f %10.2f %10.2f %7.1f%% %10.0f\n",
+                nombre.c_str(), m.lineas, m.movimientos, m.sinLookahead, m.trapecio, m.lookahead,
+                ahorro, m.microsPlanificar);
+}
+
+// Trayectorias sintéticas para cuando no hay grabaciones a mano
+static std::vector<std::pair<std::string, std::vector<std::string>>> sinteticas() {
+    std::vector<std::pair<std::string, std::vector<std::string>>> out;
+    char buf[96];
+
+    std::vector<std::string> circulo = {"G28"};
+    for (int k = 0; k <= 360; k += 3) {
+        const double a = k * M_PI / 180;
+        std::snprintf(buf, sizeof(buf), "G1 X%.2f Y%.2f Z80.00 F60", 40 * std::cos(a), 160 + 40 * std::sin(a));
+        circulo.push_back(buf);
+    }
+    out.emplace_back("(sintética) círculo r=40 en 120 tramos", circulo);
+
+    std::vector<std::string> zigzag = {"G28"};
+    for (int k = 0; k < 60; ++k) {
+        std::snprintf(buf, sizeof(buf), "G1 X%.2f Y%.2f Z80.00 F60", -60.0 + 2 * k, (k % 2) ? 150.0 : 160.0);
+        zigzag.push_back(buf);
+    }
+    out.emplace_back("(sintética) zigzag 60 tramos", zigzag);
+
+    std::vector<std::string> pickPlace = {"G28"};
+    for (int k = 0; k < 20; ++k) {
+        const double x = -50.0 + 5 * k;
+        for (const char* f : {"G1 X%.2f Y150.00 Z60.00", "G1 X%.2f Y150.00 Z20.00", "M3",
+                              "G1 X%.2f Y150.00 Z60.00", "G1 X%.2f Y190.00 Z60.00", "G1 X%.2f Y190.00 Z20.00", "M5",
+                              "G1 X%.2f Y190.00 Z60.00"}) {
+            std::snprintf(buf, sizeof(buf), f, x);
+            pickPlace.push_back(buf);
+        }
+    }
+    out.emplace_back("(sintética) pick-and-place x20", pickPlace);
+    return out;
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string> archivos;
+    for (int i = 1; i < argc; ++i) archivos.push_back(argv[i]);
+    if (archivos.empty()) {
+        std::error_code ec;
+        for (const auto& e : fs::directory_iterator("data/trayectorias/", ec)) {
+            if (e.path().extension() == ".gcode") archivos.push_back(e.path().string());
+        }
+    }
+
+    std::printf("%-48s %7s %7s %12s %10s %10s %8s %10s\n",
+                "trayectoria", "lineas", "movs", "sin_look(s)", "trap(s)", "look(s)", "ahorro", "plan(us)");
+
+    for (const auto& ruta : archivos) {
+        try {
+            MappedFile archivo(ruta);
+            std::vector<std::string> lineas;
+            std::string_view l;
+            while (archivo.siguienteLinea(l)) lineas.emplace_back(l);
+            imprimir(fs::path(ruta).filename().string(), medir(lineas));
+        } catch (const std::exception& e) {
+            std::fprintf(stderr, "No se pudo leer %s: %s\n", ruta.c_str(), e.what());
+        }
+    }
+    for (const auto& [nombre, lineas] : sinteticas()) {
+        imprimir(nombre, medir(lineas));
+    }
+    return 0;
+}
@@ -0,0 +1,220 @@
+// Benchmark del protocolo serie con número de línea y checksum sobre un pty.
+//
+// Uso:
+//   make bench-serial
+//   ./bin/bench_protocolo_serial [comandos]   (por defecto, 2000)
+//
+// Un hilo hace de firmware del lado maestro del pty: arma líneas hasta '\r',
+// valida "N<linea> ...*<checksum>" como Command::unframe() y responde "OK" o
+// "RS <linea>". El pty no tiene velocidad real, así que el tiempo de cable se
+// simula (10 bits por byte a la velocidad indicada). Con probabilidad p se
+// invierte un bit de un byte de la línea recibida (corrupción inyectada).
+//
+// Para cada velocidad y tasa de error muestra comandos/s, bytes útiles/s,
+// reenvíos y comandos ejecutados distintos de los enviados. El modo sin
+// protocolo se mide con pocos comandos: usa la espera fija de ArduinoService.
+
+#include "hardware/ArduinoService.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+struct FirmwareSimulado {
+    int fd = -1;
+    int baudrate = 115200;
+    double probError = 0;
+    std::atomic<bool> activo{true};
+    std::mutex mutex;
+    std::vector<std::string> ejecutados;
+    std::mt19937 rng{1234};
+
+    void esperarCable(size_t bytes) const {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(
+            static_cast<long long>(bytes * 10 * 1e9 / baudrate)));
+    }
+
+    void responder(const std::string& texto) {
+        esperarCable(texto.size());
+        if (write(fd, texto.data(), texto.size()) < 0) activo = false;
+    }
+
+    void corromper(std::string& linea) {
+        if (linea.empty() || std::uniform_real_distribution<double>(0, 1)(rng) >= probError) return;
+        size_t pos = std::uniform_int_distribution<size_t>(0, linea.size() - 1)(rng);
+        linea[pos] ^= static_cast<char>(1 << std::uniform_int_distribution<int>(0, 6)(rng));
+    }
+
+    // Mismas reglas que Command::unframe() en el firmware
+    void procesar(std::string linea, long& ultimaLinea, bool& numerado) {
+        esperarCable(linea.size() + 2);
+        corromper(linea);
+
+        std::string comando = linea;
+        if (numerado && linea[0] != 'N') {
+            responder("RS " + std::to_string(ultimaLinea + 1) + "\r\n");
+            return;
+        }
+        if (linea[0] == 'N') {
+            size_t asterisco = linea.find('*');
+            char* fin = nullptr;
+            long recibido = asterisco == std::string::npos ? -1 : std::strtol(linea.c_str() + asterisco + 1, &fin, 10);
+            if (asterisco == std::string::npos || fin == linea.c_str() + asterisco + 1 || *fin != '\0' ||
+                recibido != SerialCom::checksum(linea.substr(0, asterisco))) {
+                responder("RS " + std::to_string(ultimaLinea + 1) + "\r\n");
+                return;
+            }
+            char* p = nullptr;
+            long numero = std::strtol(linea.c_str() + 1, &p, 10);
+            while (*p == ' ') ++p;
+            const size_t inicio = p - linea.c_str();
+            comando = linea.substr(inicio, asterisco - inicio);
+            if (comando.compare(0, 4, "M110") == 0) {
+                ultimaLinea = numero;
+                numerado = true;
+                responder("OK\r\n");
+                return;
+            }
+            if (numero == ultimaLinea) {
+                responder("OK\r\n");
+                return;
+            }
+            if (numero != ultimaLinea + 1) {
+                responder("RS " + std::to_string(ultimaLinea + 1) + "\r\n");
+                return;
+            }
+            ultimaLinea = numero;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ejecutados.push_back(comando);
+        }
+        responder("OK\r\n");
+    }
+
+    void ejecutar() {
+        std::string linea;
+        long ultimaLinea = 0;
+        bool numerado = false;
+        char buffer[256];
+        while (activo) {
+            ssize_t n = read(fd, buffer, sizeof(buffer));
+            if (n <= 0) {
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+                continue;
+            }
+            for (ssize_t i = 0; i < n; ++i) {
+                // La disciplina de línea del pty puede traducir '\r' a '\n'
+                if (buffer[i] == '\r' || buffer[i] == '\n') {
+                    if (!linea.empty()) procesar(linea, ultimaLinea, numerado);
+                    linea.clear();
+                } else {
+                    linea += buffer[i];
+                }
+            }
+        }
+    }
+};
+
+struct Resultado {
+    double segundos = 0;
+    size_t comandos = 0;
+    size_t bytesUtiles = 0;
+    size_t reenvios = 0;
+    size_t corruptos = 0;
+    size_t fallidos = 0;
+};
+
+static Resultado medir(int baudrate, double probError, bool conProtocolo, size_t cantidad) {
+    Resultado r;
+
+    int maestro = posix_openpt(O_RDWR | O_NOCTTY);
+    if (maestro < 0 || grantpt(maestro) != 0 || unlockpt(maestro) != 0) {
+        std::fprintf(stderr, "No se pudo crear el pty\n");
+        return r;
+    }
+    fcntl(maestro, F_SETFL, O_NONBLOCK);
+
+    FirmwareSimulado firmware;
+    firmware.fd = maestro;
+    firmware.baudrate = baudrate;
+    std::thread hilo(&FirmwareSimulado::ejecutar, &firmware);
+
+    ArduinoService arduino(ptsname(maestro), baudrate);
+    arduino.setTimeoutEstabilizacion(std::chrono::milliseconds(0));
+    arduino.setProtocoloConChecksum(conProtocolo);
+
+    if (arduino.conectar(1)) {
+        {
+            std::lock_guard<std::mutex> lock(firmware.mutex);
+            firmware.ejecutados.clear();  // M114 de verificación
+        }
+        firmware.probError = probError;
+
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<double> coord(-100, 100);
+        std::vector<std::string> enviados;
+        char buf[96];
+
+        const auto t0 = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < cantidad; ++i) {
+            std::snprintf(buf, sizeof(buf), "G1 X%.2f Y%.2f Z%.2f F60", coord(rng), coord(rng) + 150, coord(rng) / 2 + 80);
+            enviados.push_back(buf);
+            try {
+                arduino.enviarComando(enviados.back() + "\r\n");
+            } catch (const std::exception&) {
+                ++r.fallidos;
+            }
+            r.bytesUtiles += enviados.back().size();
+        }
+        r.segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        r.comandos = cantidad;
+        r.reenvios = arduino.getReenvios();
+
+        std::lock_guard<std::mutex> lock(firmware.mutex);
+        for (size_t i = 0; i < enviados.size(); ++i) {
+            if (i >= firmware.ejecutados.size() || firmware.ejecutados[i] != enviados[i]) ++r.corruptos;
+        }
+        arduino.desconectar();
+    } else {
+        std::fprintf(stderr, "No se pudo conectar al pty a %d baudios\n", baudrate);
+    }
+
+    firmware.activo = false;
+    hilo.join();
+    close(maestro);
+    return r;
+}
+
+static void imprimir(const char* modo, int baudrate, double probError, const Resultado& r) {
+    const double cmdSeg = r.segundos > 0 ? r.comandos / r.segundos : 0;
+    const double bytesSeg = r.segundos > 0 ? r.bytesUtiles / r.segundos : 0;
+    std::printf("%-14s %8d %6.1f%% %8zu %10.0f %12.0f %9zu %10zu %9zu\n",
+                modo, baudrate, probError * 100, r.comandos, cmdSeg, bytesSeg, r.reenvios, r.corruptos, r.fallidos);
+}
+
+int main(int argc, char** argv) {
+    const size_t cantidad = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000;
+
+    std::printf("%-14s %8s %7s %8s %10s %12s %9s %10s %9s\n",
+                "modo", "baudios", "error", "cmds", "cmds/s", "bytes_ut/s", "reenvios", "corruptos", "fallidos");
+
+    for (int baudrate : {115200, 250000, 500000, 1000000}) {
+        for (double probError : {0.0, 0.01, 0.05}) {
+            imprimir("N+checksum", baudrate, probError, medir(baudrate, probError, true, cantidad));
+        }
+    }
+
+    // Sin protocolo: ~300 ms por comando (espera fija), pocos comandos alcanzan
+    imprimir("sin protocolo", 115200, 0.05, medir(115200, 0.05, false, 40));
+    return 0;
+}
@@ -0,0 +1,83 @@
+// Decodificador del log binario de PALogger (ver include/utils/BinaryLog.h).
+//
+// Uso:
+//   ./bin/decodificar_log [--csv] <base|segmento>...
+//
+// Con una ruta base (ej. servidor.plog) recorre todos sus segmentos en
+// orden; con un segmento (servidor.plog.000003) solo ese. La salida de
+// texto imita servidor.log; con --csv: timestamp,nivel,hilo,evento,mensaje.
+
+#include "utils/BinaryLog.h"
+
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
+
+static std::string formatearHora(int64_t wallNs) {
+    std::time_t segundos = static_cast<std::time_t>(wallNs / 1000000000);
+    std::tm timeinfo;
+    localtime_r(&segundos, &timeinfo);
+    char buffer[48];
+    size_t n = std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &timeinfo);
+    std::snprintf(buffer + n, sizeof(buffer) - n, ".%06lld",
+                  static_cast<long long>((wallNs % 1000000000) / 1000));
+    return buffer;
+}
+
+static std::string escaparCsv(const std::string& s) {
+    if (s.find_first_of(",\"\n") == std::string::npos) return s;
+    std::string out = "\"";
+    for (char c : s) {
+        if (c == '"') out += '"';
+        out += c;
+    }
+    return out + "\"";
+}
+
+int main(int argc, char** argv) {
+    bool csv = false;
+    std::vector<std::string> rutas;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--csv") == 0) csv = true;
+        else rutas.push_back(argv[i]);
+    }
+    if (rutas.empty()) {
+        std::fprintf(stderr, "Uso: %s [--csv] <base|segmento>...\n", argv[0]);
+        return 2;
+    }
+
+    // Expandir rutas base a sus segmentos
+    std::vector<std::string> segmentos;
+    for (const auto& ruta : rutas) {
+        auto deBase = BinaryLogSink::segments(ruta);
+        if (!deBase.empty()) {
+            segmentos.insert(segmentos.end(), deBase.begin(), deBase.end());
+        } else {
+            segmentos.push_back(ruta);
+        }
+    }
+
+    if (csv) std::printf("timestamp,nivel,hilo,evento,mensaje\n");
+
+    BinaryLogReader lector;
+    int errores = 0;
+    for (const auto& segmento : segmentos) {
+        bool ok = lector.read(segmento, [&](const BinaryLogEntry& e) {
+            if (csv) {
+                std::printf("%s,%s,%u,%u,%s\n", formatearHora(e.wallNs).c_str(),
+                            BinaryLogReader::levelName(e.level), e.threadId, e.eventId,
+                            escaparCsv(e.message).c_str());
+            } else {
+                std::printf("[%s] [%s] [%u] %s\n", formatearHora(e.wallNs).c_str(),
+                            BinaryLogReader::levelName(e.level), e.threadId, e.message.c_str());
+            }
+        });
+        if (!ok) {
+            std::fprintf(stderr, "No es un segmento de log binario: %s\n", segmento.c_str());
+            ++errores;
+        }
+    }
+    return errores == 0 ? 0 : 1;
+}
@@ -99,6 +99,20 @@ void RampsStepper::update() {
   }
 }
 
+void RampsStepper::stepOnce(bool forward) {
+#ifndef SIMULATION
+  digitalWrite(dirPin, forward ? inverse : !inverse);
+  digitalWrite(stepPin, HIGH);
+  digitalWrite(stepPin, LOW);
+#endif
+  stepperStepPosition += forward ? 1 : -1;
+  stepperStepTargetPosition = stepperStepPosition;
+}
+
+long RampsStepper::radToSteps(float rad) const {
+  return rad * radToStepFactor;
+}
+
 void RampsStepper::setReductionRatio(float gearRatio, int stepsPerRev) {
   radToStepFactor = gearRatio * stepsPerRev / 2 / PI;
 }
@@ -24,6 +24,9 @@ public:
   void stepRelativeRad(float rad);
 
   void update();
+  // Un único paso (generador DDA); mueve también el objetivo
+  void stepOnce(bool forward);
+  long radToSteps(float rad) const;
   void setReductionRatio(float gearRatio, int stepsPerRev);
   bool getState() const;
 private:
@@ -9,6 +9,8 @@ BYJ_Gripper::BYJ_Gripper(int pin0, int pin1, int pin2, int pin3, int steps){
   byj_pin_2 = pin2;
   byj_pin_3 = pin3;
   step_cycle = 0;
+  steps_left = 0;
+  last_step = 0;
 #ifndef SIMULATION
   pinMode(byj_pin_0, OUTPUT);
   pinMode(byj_pin_1, OUTPUT);
@@ -19,24 +21,42 @@ BYJ_Gripper::BYJ_Gripper(int pin0, int pin1, int pin2, int pin3, int steps){
 
 void BYJ_Gripper::cmdOn() {
   direction = true;
-  for (int i = 1; i <= grip_steps; i++) {
-    moveSteps();
-    delay(1);
-    //unsigned long ini = millis();
-    //while (millis() - ini < 1);
-  }
-    Logger::logINFO("GRIPPER ON");
+  steps_left = grip_steps;
+  last_step = millis();
 }
 
 void BYJ_Gripper::cmdOff() {
   direction = false;
-  for (int i = 1; i <= grip_steps; i++) {
-    moveSteps();
-    delay(1);
-    //unsigned long ini = millis();
-    //while (millis() - ini < 1);
+  steps_left = grip_steps;
+  last_step = millis();
+}
+
+// Un paso por milisegundo, como el delay(1) de la versión bloqueante
+void BYJ_Gripper::update() {
+  if (steps_left <= 0 || millis() - last_step < 1) {
+    return;
   }
-    Logger::logINFO("GRIPPER OFF");
+  last_step = millis();
+  moveSteps();
+  steps_left--;
+  if (steps_left == 0) {
+    if (direction) {
+      LOG_INFO_MSG(MSG_GRIPPER_ON, "GRIPPER ON");
+    } else {
+      LOG_INFO_MSG(MSG_GRIPPER_OFF, "GRIPPER OFF");
+    }
+  }
+}
+
+void BYJ_Gripper::stop() {
+  if (steps_left > 0) {
+    steps_left = 0;
+    LOG_INFO_MSG(MSG_GRIPPER_STOPPED, "GRIPPER STOPPED");
+  }
+}
+
+bool BYJ_Gripper::isBusy() const {
+  return steps_left > 0;
 }
 
 void BYJ_Gripper::setDirection(){
@@ -4,10 +4,16 @@
 class BYJ_Gripper {
 public:
   BYJ_Gripper(int pin0, int pin1, int pin2, int pin3, int steps);
+  // cmdOn/cmdOff solo inician el movimiento; update() lo avanza desde loop()
   void cmdOn();
   void cmdOff();
+  void update();
+  void stop();
+  bool isBusy() const;
 private:
   bool direction;
+  int steps_left;
+  unsigned long last_step;
   void moveSteps();
   void setDirection();
   int byj_pin_0;
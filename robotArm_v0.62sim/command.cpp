@@ -11,34 +11,179 @@ Command::Command() {
   new_command.valueF = 0;
   new_command.valueE = NAN;
   new_command.valueS = 0;
-  message = "";
+  new_command.valueI = NAN;
+  new_command.valueJ = NAN;
+  messageLength = 0;
+  messageOverflow = false;
   isRelativeCoord = false;
+#if LINE_CHECKSUM
+  lastLineNumber = 0;
+  lineNumbering = false;
+#endif
 }
 
+// Una línea descartada también lleva su "OK": cada línea recibida tiene
+// exactamente una respuesta (OK o RS) y el host puede esperarla sin timeout.
+static void replyRejected() {
+  if (PRINT_REPLY) {
+    Serial.println(PRINT_REPLY_MSG);
+  }
+}
+
+#if LINE_CHECKSUM
+// Checksum del protocolo: XOR de todos los bytes anteriores al '*'
+static byte lineChecksum(const char* begin, const char* end) {
+  byte sum = 0;
+  for (const char* c = begin; c < end; c++) {
+    sum ^= *c;
+  }
+  return sum;
+}
+
+// Pide al host que reenvíe desde la línea que se esperaba
+void Command::requestResend() {
+  Serial.print(F("RS "));
+  Serial.println(lastLineNumber + 1);
+}
+
+// Protocolo con número de línea y checksum: "N<línea> <comando>*<checksum>".
+// Devuelve el comando sin el marco, o NULL si la línea ya fue respondida
+// (RS si llegó dañada o fuera de orden, OK si era M110 o un duplicado).
+// Las líneas sin 'N' se aceptan tal cual hasta el primer M110; después una
+// 'N' dañada no debe pasar por línea sin marco, así que se pide reenvío.
+char* Command::unframe(char* msg) {
+  if (msg[0] != 'N') {
+    if (lineNumbering) {
+      requestResend();
+      return NULL;
+    }
+    return msg;
+  }
+  char* star = strchr(msg, '*');
+  if (star == NULL) {
+    requestResend();
+    return NULL;
+  }
+  char* end;
+  long received = strtol(star + 1, &end, 10);
+  if (end == star + 1 || *end != '\0' || received != lineChecksum(msg, star)) {
+    requestResend();
+    return NULL;
+  }
+  *star = '\0';
+
+  char* p = msg + 1;
+  long line = strtol(p, &p, 10);
+  while (*p == ' ') {
+    p++;
+  }
+  // M110: fija el número de línea actual (sincronización al conectar)
+  if (strncmp(p, "M110", 4) == 0 && !isDigit(p[4])) {
+    lastLineNumber = line;
+    lineNumbering = true;
+    replyRejected();
+    return NULL;
+  }
+  if (line == lastLineNumber) {
+    // El host no recibió el OK y reenvió: ya se ejecutó, solo confirmar
+    replyRejected();
+    return NULL;
+  }
+  if (line != lastLineNumber + 1) {
+    requestResend();
+    return NULL;
+  }
+  lastLineNumber = line;
+  return p;
+}
+#endif
+
 // Devuelve True si se procesa un mensaje GCode, False si no.
-// Ejecuta processMessage() antes
+// Consume todos los bytes disponibles hasta completar una línea ('\r') y
+// ejecuta processMessage() sobre el buffer fijo. Lo que llegue después de
+// la línea queda en el buffer de recepción de Serial para la próxima vuelta.
 bool Command::handleGcode() {
-  if (Serial.available()) {
+  while (Serial.available()) {
     char c = Serial.read();
     if (c == '\n') {
-       return false; 
+      continue;
     }
     if (c == '\r') {
       // Si encuentra caracter de fin de mensaje, lo procesa
-       bool b = processMessage(message);
-       // Limpiar mensaje para esperar el siguiente
-       message = "";
-       return b;
+      message[messageLength] = '\0';
+      bool overflow = messageOverflow;
+      // Limpiar mensaje para esperar el siguiente
+      messageLength = 0;
+      messageOverflow = false;
+      if (overflow) {
+        printErr();
+        replyRejected();
+        return false;
+      }
+#if LINE_CHECKSUM
+      char* line = unframe(message);
+      if (line == NULL) {
+        return false;
+      }
+#else
+      char* line = message;
+#endif
+      if (!processMessage(line)) {
+        replyRejected();
+        return false;
+      }
+      return true;
+    }
+    if (messageLength < MAX_LINE_LENGTH) {
+      message[messageLength++] = c;
     } else {
-       message += c; 
+      // Línea demasiado larga: se descarta hasta el próximo fin de línea
+      messageOverflow = true;
     }
   }
   return false;
 }
 
+// Número decimal con signo ("-12.5", ".5", "7"), sin exponente: en G-code
+// la E que sigue a un número es el eje E, no notación científica.
+static float parseNumber(char* &p) {
+  while (*p == ' ') {
+    p++;
+  }
+  bool negative = false;
+  if (*p == '-' || *p == '+') {
+    negative = *p == '-';
+    p++;
+  }
+  long mantissa = 0;
+  float scale = 1;
+  byte digits = 0;
+  bool decimals = false;
+  for (;; p++) {
+    if (*p == '.' && !decimals) {
+      decimals = true;
+    } else if (*p >= '0' && *p <= '9') {
+      // Más de 9 cifras no entran en long; las siguientes se ignoran
+      if (digits < 9) {
+        mantissa = mantissa * 10 + (*p - '0');
+        digits++;
+        if (decimals) {
+          scale *= 10;
+        }
+      } else if (!decimals) {
+        scale /= 10;
+      }
+    } else if (*p != ' ') {
+      break;
+    }
+  }
+  float value = mantissa / scale;
+  return negative ? -value : value;
+}
+
 // Retornar verdadero si el mensaje se proceso correctamente
-// Ejecutando value_segment()
-bool Command::processMessage(String msg){
+// Recorre el mensaje en el lugar, ejecutando value_segment() por campo
+bool Command::processMessage(char* msg){
 
   // Resetear estructura de comandos
   new_command.valueX = NAN; 
@@ -47,14 +192,19 @@ bool Command::processMessage(String msg){
   new_command.valueE = NAN;
   new_command.valueF = 0;
   new_command.valueS = 0;
+  new_command.valueI = NAN;
+  new_command.valueJ = NAN;
   
   // Normalizar el mensaje
-  msg.toUpperCase();
-  msg.replace(" ", "");
+  for (char* c = msg; *c != '\0'; c++) {
+    *c = toupper(*c);
+  }
 
-  // Inicializa indice para recorrer el mensaje
-  int active_index = 0;
-  new_command.id = msg[active_index];
+  char* p = msg;
+  while (*p == ' ') {
+    p++;
+  }
+  new_command.id = *p;
 
   // Valida si es un comando valido ej. (G1)
   if((new_command.id != 'G') && (new_command.id != 'M')){
@@ -62,46 +212,33 @@ bool Command::processMessage(String msg){
     return false;
   }
   
-  // Aumenta el indice y crea indice temporal
-  active_index++;
-  int temp_index = active_index;
-
-  // Aumentar indice temporal (recorriendo el codigo numerico), hasta siguiente caracter no numerico
-  while (temp_index<msg.length() && !isAlpha(msg[temp_index])){
-    temp_index++;
-  }
-
   // guarda el comando 
-  new_command.num = msg.substring(active_index, temp_index).toInt();
-
-  // Seguir recorriendo
-  active_index = temp_index;
-  temp_index++;
-  while (temp_index<msg.length()){
-    // Se extraen segmentos y procesan con value_segment
-    while (!isAlpha(msg[temp_index]) || msg[temp_index]=='.'){
-      temp_index++;
-      if (temp_index == msg.length()){
-        break;
-      }
+  p++;
+  new_command.num = (int)parseNumber(p);
+
+  // Seguir recorriendo: cada letra inicia un campo con su valor
+  while (*p != '\0') {
+    if (isAlpha(*p)) {
+      char letter = *p++;
+      value_segment(letter, parseNumber(p));
+    } else {
+      p++;
     }
-    value_segment(msg.substring(active_index, temp_index));
-    active_index = temp_index;
-    temp_index++;
   }
   return true;
 }
 
 // Va tomando los segmento G1 X20 Y30 ... y actualizando parametros internos
-void Command::value_segment(String msg_segment){
-  float msg_value = msg_segment.substring(1).toFloat();
-  switch (msg_segment[0]){
-    case 'X': new_command.valueX = msg_value; break;
-    case 'Y': new_command.valueY = msg_value; break;
-    case 'Z': new_command.valueZ = msg_value; break;
-    case 'E': new_command.valueE = msg_value; break;
-    case 'F': new_command.valueF = msg_value; break;
-    case 'S': new_command.valueS = msg_value; break;
+void Command::value_segment(char letter, float value){
+  switch (letter){
+    case 'X': new_command.valueX = value; break;
+    case 'Y': new_command.valueY = value; break;
+    case 'Z': new_command.valueZ = value; break;
+    case 'E': new_command.valueE = value; break;
+    case 'F': new_command.valueF = value; break;
+    case 'S': new_command.valueS = value; break;
+    case 'I': new_command.valueI = value; break;
+    case 'J': new_command.valueJ = value; break;
   }
 }
 
@@ -112,34 +249,34 @@ Cmd Command::getCmd() const {
 
 void Command::cmdGetPosition(Point pos, Point pos_offset, float highRad, float lowRad, float rotRad, bool onFan, bool onMotors){
   if(isRelativeCoord) {
-    Logger::logINFO("RELATIVE MODE");
+    LOG_INFO_MSG(MSG_RELATIVE_MODE, "RELATIVE MODE");
   } else {
-    Logger::logINFO("ABSOLUTE MODE");
+    LOG_INFO_MSG(MSG_ABSOLUTE_MODE, "ABSOLUTE MODE");
   }
-  Logger::logINFO("CURRENT POSITION: [X:"+String(pos.xmm - pos_offset.xmm)+" Y:"+String(pos.ymm - pos_offset.ymm)+" Z:"+String(pos.zmm - pos_offset.zmm)+" E:"+String(pos.emm - pos_offset.emm)+"]");
+  LOG_INFO_VALUES(MSG_CURRENT_POSITION, "CURRENT POSITION: [X:% Y:% Z:% E:%]", pos.xmm - pos_offset.xmm, pos.ymm - pos_offset.ymm, pos.zmm - pos_offset.zmm, pos.emm - pos_offset.emm);
   //Logger::logINFO("RADIANS: [HIGH:"+String(highRad)+" LOW:"+String(lowRad)+" ROT:"+String(rotRad));
   
   if(onMotors) {
-    Logger::logINFO("MOTORS ENABLED");  
+    LOG_INFO_MSG(MSG_MOTORS_ENABLED, "MOTORS ENABLED");  
   } else {
-    Logger::logINFO("MOTORS DISABLED");  
+    LOG_INFO_MSG(MSG_MOTORS_DISABLED, "MOTORS DISABLED");  
   }
   if(onFan) {
-    Logger::logINFO("FAN ENABLED");  
+    LOG_INFO_MSG(MSG_FAN_ENABLED, "FAN ENABLED");  
   } else {
-    Logger::logINFO("FAN DISABLED");  
+    LOG_INFO_MSG(MSG_FAN_DISABLED, "FAN DISABLED");  
   }
   
 }
 
 void Command::cmdToRelative(){
   isRelativeCoord = true;
-  Logger::logINFO("RELATIVE MODE ON");
+  LOG_INFO_MSG(MSG_RELATIVE_MODE_ON, "RELATIVE MODE ON");
 }
 
 void Command::cmdToAbsolute(){
   isRelativeCoord = false;
-  Logger::logINFO("ABSOLUTE MODE ON");
+  LOG_INFO_MSG(MSG_ABSOLUTE_MODE_ON, "ABSOLUTE MODE ON");
 }
 
 void cmdMove(Cmd(&cmd), Point pos, Point pos_offset, bool isRelativeCoord){
@@ -157,6 +294,18 @@ void cmdMove(Cmd(&cmd), Point pos, Point pos_offset, bool isRelativeCoord){
   }
 }
 
+// G2/G3: resuelve el destino igual que cmdMove. I/J son siempre relativos al
+// punto de partida; sin ninguno de los dos no hay centro y el arco se rechaza.
+bool cmdArc(Cmd(&cmd), Point pos, Point pos_offset, bool isRelativeCoord){
+  if (isnan(cmd.valueI) && isnan(cmd.valueJ)) {
+    return false;
+  }
+  cmd.valueI = isnan(cmd.valueI) ? 0 : cmd.valueI;
+  cmd.valueJ = isnan(cmd.valueJ) ? 0 : cmd.valueJ;
+  cmdMove(cmd, pos, pos_offset, isRelativeCoord);
+  return true;
+}
+
 void cmdDwell(Cmd(&cmd)){
   delay(int(cmd.valueS * 1000));
 //    unsigned long ini = millis();
@@ -164,5 +313,5 @@ void cmdDwell(Cmd(&cmd)){
 }
 
 void printErr() {
-  Logger::logERROR("COMMAND NOT RECOGNIZED");
+  LOG_ERROR_MSG(MSG_COMMAND_NOT_RECOGNIZED, "COMMAND NOT RECOGNIZED");
 }
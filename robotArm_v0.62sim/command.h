@@ -3,6 +3,7 @@
 
 #include <Arduino.h>
 #include "interpolation.h"
+#include "config.h"
 
 struct Cmd {
   char id;
@@ -13,14 +14,16 @@ struct Cmd {
   float valueF;
   float valueE;
   float valueS; 
+  float valueI; // G2/G3: centro del arco relativo al punto de partida
+  float valueJ;
 };
 
 class Command {
   public:
     Command();
     bool handleGcode();
-    bool processMessage(String msg);
-    void value_segment(String msg_segment);
+    bool processMessage(char* msg);
+    void value_segment(char letter, float value);
     Cmd getCmd() const;
     void cmdGetPosition(Point pos, Point pos_offset, float highRad, float lowRad, float rotRad, bool onFan, bool onMotors);
     void cmdToRelative();
@@ -29,10 +32,21 @@ class Command {
     Cmd new_command;
 
   private: 
-    String message;
+    // Línea en construcción: buffer fijo, sin String ni memoria dinámica
+    char message[MAX_LINE_LENGTH + 1];
+    byte messageLength;
+    bool messageOverflow;
+#if LINE_CHECKSUM
+    // Último número de línea aceptado ("N<línea> ...*<checksum>")
+    long lastLineNumber;
+    bool lineNumbering; // true tras M110: solo se aceptan líneas con marco
+    char* unframe(char* msg);
+    void requestResend();
+#endif
 };
 
 void cmdMove(Cmd(&cmd), Point pos, Point pos_offset, bool isRelativeCoord);
+bool cmdArc(Cmd(&cmd), Point pos, Point pos_offset, bool isRelativeCoord);
 void cmdDwell(Cmd(&cmd));
 void printErr();
 
@@ -0,0 +1,109 @@
+#include "commandQueue.h"
+
+CommandQueue::CommandQueue(int size) : bytes(size) {
+  count = 0;
+}
+
+static long toPacked(float value, float scale) {
+  return (long)(value * scale + (value >= 0 ? 0.5 : -0.5));
+}
+
+void CommandQueue::writeLong(long value) {
+  for (byte i = 0; i < 4; i++) {
+    bytes.push((byte)(value >> (8 * i)));
+  }
+}
+
+long CommandQueue::readLong(int &offset) const {
+  uint32_t value = 0;
+  for (byte i = 0; i < 4; i++) {
+    value |= (uint32_t)bytes.peek(offset++) << (8 * i);
+  }
+  return (int32_t)value;
+}
+
+bool CommandQueue::push(const Cmd &cmd) {
+  if (isFull()) {
+    return false;
+  }
+  const float values[7] = {cmd.valueX, cmd.valueY, cmd.valueZ, cmd.valueE, cmd.valueI, cmd.valueJ, cmd.valueS};
+  byte mask = 0;
+  for (byte i = 0; i < 7; i++) {
+    // S vale 0 cuando no viene; el resto de los ejes, NAN
+    if (i == 6 ? values[i] != 0 : !isnan(values[i])) {
+      mask |= 1 << i;
+    }
+  }
+  if (cmd.valueF > 0) {
+    mask |= CMD_FIELD_F;
+  }
+
+  bytes.push(cmd.id);
+  // Números fuera de rango se guardan como 255, que ningún comando usa
+  bytes.push(cmd.num >= 0 && cmd.num < 255 ? cmd.num : 255);
+  bytes.push(mask);
+  for (byte i = 0; i < 7; i++) {
+    if (mask & (1 << i)) {
+      writeLong(toPacked(values[i], PACKED_CMD_SCALE));
+    }
+  }
+  if (mask & CMD_FIELD_F) {
+    long f = toPacked(cmd.valueF, PACKED_F_SCALE);
+    unsigned int packedF = f > 65535 ? 65535 : f;
+    bytes.push(packedF & 0xFF);
+    bytes.push(packedF >> 8);
+  }
+  count++;
+  return true;
+}
+
+Cmd CommandQueue::decode(int &offset) const {
+  Cmd cmd;
+  cmd.id = bytes.peek(offset++);
+  cmd.num = bytes.peek(offset++);
+  byte mask = bytes.peek(offset++);
+  float *values[7] = {&cmd.valueX, &cmd.valueY, &cmd.valueZ, &cmd.valueE, &cmd.valueI, &cmd.valueJ, &cmd.valueS};
+  for (byte i = 0; i < 7; i++) {
+    if (mask & (1 << i)) {
+      *values[i] = readLong(offset) / PACKED_CMD_SCALE;
+    } else {
+      *values[i] = i == 6 ? 0 : NAN;
+    }
+  }
+  cmd.valueF = 0;
+  if (mask & CMD_FIELD_F) {
+    unsigned int packedF = bytes.peek(offset) | ((unsigned int)bytes.peek(offset + 1) << 8);
+    offset += 2;
+    cmd.valueF = packedF / PACKED_F_SCALE;
+  }
+  return cmd;
+}
+
+Cmd CommandQueue::pop() {
+  int offset = 0;
+  Cmd cmd = decode(offset);
+  if (count > 0) {
+    for (int i = 0; i < offset; i++) {
+      bytes.pop();
+    }
+    count--;
+  }
+  return cmd;
+}
+
+Cmd CommandQueue::peek() const {
+  int offset = 0;
+  return decode(offset);
+}
+
+bool CommandQueue::isFull() const {
+  return bytes.getFreeSpace() < PACKED_CMD_MAX_BYTES;
+}
+
+bool CommandQueue::isEmpty() const {
+  return count == 0;
+}
+
+int CommandQueue::getUsedSpace() const {
+  return count;
+}
@@ -0,0 +1,44 @@
+#ifndef COMMANDQUEUE_H_
+#define COMMANDQUEUE_H_
+
+#include <Arduino.h>
+#include "command.h"
+#include "queue.h"
+
+// Campos presentes en un comando empaquetado
+#define CMD_FIELD_X 0x01
+#define CMD_FIELD_Y 0x02
+#define CMD_FIELD_Z 0x04
+#define CMD_FIELD_E 0x08
+#define CMD_FIELD_I 0x10
+#define CMD_FIELD_J 0x20
+#define CMD_FIELD_S 0x40
+#define CMD_FIELD_F 0x80
+
+#define PACKED_CMD_SCALE 1000.0 // X, Y, Z, E, I, J, S EN MILESIMAS (INT32)
+#define PACKED_F_SCALE 10.0     // F EN DECIMAS DE MM/S (UINT16)
+#define PACKED_CMD_MAX_BYTES 33 // ID + NUM + MASCARA + 7 * INT32 + UINT16
+
+// Cola de comandos empaquetados sobre un anillo de bytes. Cada comando ocupa
+// una cabecera (id, num, máscara) y solo los campos presentes en punto fijo:
+// un G1 X Y Z F ocupa 17 bytes en lugar de los 35 de un Cmd de floats.
+class CommandQueue {
+public:
+  CommandQueue(int size);      // tamaño del anillo en bytes
+  bool push(const Cmd &cmd);   // false si no hay lugar
+  Cmd pop();
+  Cmd peek() const;
+  bool isFull() const;         // no entra un comando del tamaño máximo
+  bool isEmpty() const;
+  int getUsedSpace() const;    // comandos en cola
+
+private:
+  Cmd decode(int &offset) const;
+  long readLong(int &offset) const;
+  void writeLong(long value);
+
+  Queue<byte> bytes;
+  int count;
+};
+
+#endif
@@ -2,7 +2,8 @@
 #define CONFIG_H_
 
 //SERIAL SETTINGS
-#define BAUD 115200
+#define BAUD 115200 // 250000, 500000 AND 1000000 ARE EXACT ON 16MHz AVR (115200 IS 2% OFF); USE LINE_CHECKSUM ABOVE 115200
+#define LINE_CHECKSUM true // "true" TO ACCEPT "N<LINE> <CMD>*<CHECKSUM>" LINES, ANSWERING "RS <LINE>" TO ASK FOR A RESEND ON ERRORS
 
 //MEGA2560 BY DEFAULT, SET TO true IF UNO & CNC SHILED USED TO DRIVE ROBOT
 #define USE_UNO true
@@ -80,7 +81,8 @@
 #define SERVO_UNGRIP_DEGREE 0.0
 
 //COMMAND QUEUE SETTINGS
-#define QUEUE_SIZE 15
+#define QUEUE_BYTES 525 // RAM FOR QUEUED COMMANDS, PACKED (ABOUT 30 G1 X Y Z F; WAS 15 UNPACKED COMMANDS)
+#define MAX_LINE_LENGTH 95 // LONGEST ACCEPTED COMMAND LINE (FIXED RX BUFFER, LONGER LINES ARE REJECTED)
 
 //PRINT REPLY SETTING
 #define PRINT_REPLY true // "true" TO PRINT MSG AFTER ONE COMMAND IS PROCESSED
@@ -92,12 +94,28 @@
 //1: ARCTAN APPROX (SLIGHT BELL CURVE ACCELERATION & DECELERATION)
 //2: COSIN APPROX (TOTAL BELL CURVE ACCEL FROM 0 & DECEL FROM 0, SUITABLE FOR PRESET COMMAND MOVEMENTS)
 
+//LOOK-AHEAD PLANNER SETTINGS
+#define LOOKAHEAD true // "true" TO BLEND CONSECUTIVE G0/G1 THROUGH CORNERS (TRAPEZOIDAL PROFILES, IGNORES SPEED_PROFILE FOR G0/G1)
+#define PLANNER_WINDOW 8 // QUEUED LINEAR SEGMENTS CONSIDERED BY THE PLANNER
+#define MAX_ACCEL 1000.0 // MM/S^2 (THE COSINE PROFILE ALREADY PEAKS ABOVE THIS ON SHORT MOVES)
+#define JUNCTION_DEVIATION 0.05 // MM, HIGHER = FASTER CORNERS
+
+//STEP GENERATOR SETTINGS
+#define STEP_GENERATOR true // "true" TO SOLVE IK ONLY AT SUBSEGMENT BOUNDARIES AND EMIT STEPS WITH AN INTEGER DDA
+#define STEP_SEGMENT_US 5000 // SUBSEGMENT LENGTH IN MICROSECONDS (IK RATE = 1e6 / STEP_SEGMENT_US)
+
+//INVERSE KINEMATICS SETTINGS
+#ifndef FIXED_POINT_IK // THE HOST TESTS BUILD BOTH VARIANTS
+#define FIXED_POINT_IK false // "true" FOR INTEGER IK WITH ASIN/ACOS TABLES IN FLASH (NO FLOAT TRIG; MEASURE ON THE AVR BEFORE ENABLING)
+#endif
+
 
 //LOG SETTINGS
-#define LOG_LEVEL 2
+#define LOG_LEVEL 2 // MESSAGES ABOVE THIS LEVEL ARE REMOVED AT COMPILE TIME
 //0: ERROR
 //1: INFO
 //2: DEBUG
+#define LOG_COMPACT true // "true" TO SEND NUMERIC CODES ("I20 10.00 ...") INSTEAD OF TEXT; THE SERVER MAPS THEM BACK
 
 //MOVE LIMIT PARAMETERS
 #define Z_MIN -115 // -140.0 //MINIMUM Z HEIGHT OF TOOLHEAD TOUCHING GROUND
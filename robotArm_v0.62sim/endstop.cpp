@@ -11,6 +11,8 @@ Endstop::Endstop(int a_min_pin, int a_dir_pin, int a_step_pin, int a_en_pin, int
   step_offset = a_step_offset;
   check_delay = a_check_delay;
   bCheckDelay = false;
+  operation = ENDSTOP_IDLE;
+  steps_left = 0;
   pinMode(min_pin, INPUT_PULLUP);
 }
 
@@ -107,6 +109,73 @@ void Endstop::oneStepToEndstop(bool dir){
 #endif
 }
 
+void Endstop::startSeek(bool dir){
+#ifndef SIMULATION
+  digitalWrite(en_pin, LOW);
+  digitalWrite(dir_pin, dir == 1 ? HIGH : LOW);
+#endif
+  bCheckDelay = false;
+  operation = ENDSTOP_SEEK;
+  seek_start = millis();
+  last_step = micros();
+}
+
+void Endstop::startOffset(bool dir){
+#ifndef SIMULATION
+  digitalWrite(dir_pin, dir == 1 ? LOW : HIGH);
+#endif
+  operation = ENDSTOP_OFFSET;
+  steps_left = step_offset;
+  last_step = micros();
+}
+
+bool Endstop::update(){
+  if (operation == ENDSTOP_IDLE) {
+    return false;
+  }
+  if (micros() - last_step < (unsigned long)home_dwell) {
+    return true;
+  }
+  last_step = micros();
+
+  if (operation == ENDSTOP_SEEK) {
+#ifndef SIMULATION
+    if (state()) {
+      operation = ENDSTOP_IDLE;
+      return false;
+    }
+    digitalWrite(step_pin, HIGH);
+    digitalWrite(step_pin, LOW);
+    // si en un tiempo dado el endstop no cambia de estado: fallo electromecanico
+    if (millis() - seek_start > (unsigned long)check_delay * 1000) {
+      bCheckDelay = true;
+      operation = ENDSTOP_IDLE;
+      return false;
+    }
+    return true;
+#else
+    operation = ENDSTOP_IDLE;
+    return false;
+#endif
+  }
+
+  if (steps_left <= 0) {
+    operation = ENDSTOP_IDLE;
+    return false;
+  }
+#ifndef SIMULATION
+  digitalWrite(step_pin, HIGH);
+  digitalWrite(step_pin, LOW);
+#endif
+  steps_left--;
+  return true;
+}
+
+void Endstop::abort(){
+  operation = ENDSTOP_IDLE;
+  steps_left = 0;
+}
+
 bool Endstop::state(){
 #ifndef SIMULATION
   bState = !(digitalRead(min_pin) ^ switch_input);
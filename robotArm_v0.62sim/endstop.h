@@ -1,6 +1,12 @@
 #ifndef ENDSTOP_H_
 #define ENDSTOP_H_
 
+#include <Arduino.h>
+
+#define ENDSTOP_IDLE 0
+#define ENDSTOP_SEEK 1
+#define ENDSTOP_OFFSET 2
+
 class Endstop {
   public:
     Endstop(int a_min_pin, int a_dir_pin, int a_step_pin, int a_en_pin, int a_switch_input, int a_step_offset, int a_home_dwell, int a_check_delay);
@@ -10,6 +16,13 @@ class Endstop {
     bool state();
     bool checkDelay();
 
+    // Versiones no bloqueantes: se inician y avanzan con update() desde loop(),
+    // un paso cada home_dwell us. update() devuelve true mientras sigan.
+    void startSeek(bool dir);
+    void startOffset(bool dir);
+    bool update();
+    void abort();
+
   private:
     int min_pin;
     int dir_pin;
@@ -21,6 +34,10 @@ class Endstop {
     bool bState;
     int check_delay; // seconds
     bool bCheckDelay;
+    byte operation;            // ENDSTOP_IDLE, ENDSTOP_SEEK u ENDSTOP_OFFSET
+    int steps_left;
+    unsigned long last_step;   // us
+    unsigned long seek_start;  // ms
 };
 
 #endif
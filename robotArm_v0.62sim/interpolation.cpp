@@ -8,6 +8,9 @@ Interpolation::Interpolation(){
   pos_offset.ymm = 0.0;
   pos_offset.zmm = 0.0;
   pos_offset.emm = 0.0;
+  arcSweep = 0;
+  trapezoid = false;
+  limitHit = false;
 }
 
 //G92 POSITION OFFSET FUNCTIONS
@@ -16,8 +19,8 @@ void Interpolation::setPosOffset(float new_x, float new_y, float new_z, float ne
   pos_offset.ymm = yPosmm - new_y;
   pos_offset.zmm = zPosmm - new_z;
   pos_offset.emm = ePosmm - new_e;
-  Logger::logINFO("POSITION OFFSET: [X" + String(pos_offset.xmm) + " Y:" + String(pos_offset.ymm) + " Z:" + String(pos_offset.zmm) + " E:" + String(pos_offset.emm) + "]");
-  Logger::logINFO("CURRENT POSITION: [X:" + String(new_x) + " Y:" + String(new_y) + " Z:" + String(new_z) + " E:" + String(new_e) + "]");
+  LOG_INFO_VALUES(MSG_POSITION_OFFSET, "POSITION OFFSET: [X:% Y:% Z:% E:%]", pos_offset.xmm, pos_offset.ymm, pos_offset.zmm, pos_offset.emm);
+  LOG_INFO_VALUES(MSG_CURRENT_POSITION, "CURRENT POSITION: [X:% Y:% Z:% E:%]", new_x, new_y, new_z, new_e);
 }
 
 void Interpolation::resetPosOffset(){
@@ -94,6 +97,9 @@ void Interpolation::setInterpolation(Point p0, Point p1, float av) {
   }
   
   tmul = v / dist;
+  distmm = dist;
+  arcSweep = 0;
+  trapezoid = false;
   
   xStartmm = p0.xmm;
   yStartmm = p0.ymm;
@@ -110,6 +116,115 @@ void Interpolation::setInterpolation(Point p0, Point p1, float av) {
   startTime = micros();
 }
 
+void Interpolation::setArcInterpolation(Point p1, float i, float j, bool clockwise, float av) {
+  Point p0;
+  p0.xmm = xStartmm + xDelta;
+  p0.ymm = yStartmm + yDelta;
+  p0.zmm = zStartmm + zDelta;
+  p0.emm = eStartmm + eDelta;
+
+  float cx = p0.xmm + i;
+  float cy = p0.ymm + j;
+  float r0 = hypot(p0.xmm - cx, p0.ymm - cy);
+  float r1 = hypot(p1.xmm - cx, p1.ymm - cy);
+  if (r0 < 0.01) {
+    // Centro sobre el punto de partida: se degrada a un movimiento lineal
+    setInterpolation(p0, p1, av);
+    return;
+  }
+
+  float a0 = atan2(p0.ymm - cy, p0.xmm - cx);
+  float a1 = atan2(p1.ymm - cy, p1.xmm - cx);
+  float sweep = a1 - a0;
+  // Mismo punto de inicio y fin = círculo completo
+  if (clockwise) {
+    if (sweep >= 0) sweep -= 2 * PI;
+  } else {
+    if (sweep <= 0) sweep += 2 * PI;
+  }
+
+  // Longitud de la hélice (el radio puede variar levemente por redondeo)
+  float planar = abs(sweep) * (r0 + r1) * 0.5;
+  float c = p1.zmm - p0.zmm;
+  float dist = sqrt(planar * planar + c * c);
+  float e = abs(p1.emm - p0.emm);
+  if (dist < e) {
+    dist = e;
+  }
+
+  v = av;
+  if (v < 5) { //includes 0 = default value
+    v = sqrt(dist) * 10;
+  }
+  if (v < 5) {
+     v = 5;
+  }
+  tmul = v / dist;
+  distmm = dist;
+  trapezoid = false;
+
+  xStartmm = p0.xmm;
+  yStartmm = p0.ymm;
+  zStartmm = p0.zmm;
+  eStartmm = p0.emm;
+
+  xDelta = (p1.xmm - p0.xmm);
+  yDelta = (p1.ymm - p0.ymm);
+  zDelta = (p1.zmm - p0.zmm);
+  eDelta = (p1.emm - p0.emm);
+
+  arcCenterX = cx;
+  arcCenterY = cy;
+  arcRadius0 = r0;
+  arcRadiusDelta = r1 - r0;
+  arcStartAngle = a0;
+  arcSweep = sweep;
+
+  state = 0;
+
+  startTime = micros();
+}
+
+void Interpolation::setTrapezoid(float vEntry, float vExit, float accel) {
+  float vc = v;
+  float da = (vc * vc - vEntry * vEntry) / (2 * accel);
+  float dd = (vc * vc - vExit * vExit) / (2 * accel);
+  if (da + dd > distmm) {
+    // No llega a la velocidad de crucero: perfil triangular
+    vc = sqrt((2 * accel * distmm + vEntry * vEntry + vExit * vExit) * 0.5);
+    if (vc < vEntry) vc = vEntry;
+    if (vc < vExit) vc = vExit;
+    da = (vc * vc - vEntry * vEntry) / (2 * accel);
+    dd = (vc * vc - vExit * vExit) / (2 * accel);
+    if (da + dd > distmm) dd = distmm - da;
+  }
+  trapV0 = vEntry;
+  trapVc = vc;
+  trapAccel = accel;
+  trapDa = da;
+  trapDc = distmm - dd;
+  trapTa = (vc - vEntry) / accel;
+  trapTc = trapTa + (trapDc - da) / vc;
+  trapTotal = trapTc + (vc - vExit) / accel;
+  trapezoid = true;
+  startTime = micros();
+}
+
+Point Interpolation::getTargetmm() const {
+  Point p;
+  p.xmm = xStartmm + xDelta;
+  p.ymm = yStartmm + yDelta;
+  p.zmm = zStartmm + zDelta;
+  p.emm = eStartmm + eDelta;
+  return p;
+}
+
+bool Interpolation::consumeLimitHit() {
+  bool hit = limitHit;
+  limitHit = false;
+  return hit;
+}
+
 void Interpolation::setCurrentPos(Point p) {
   xStartmm = p.xmm;
   yStartmm = p.ymm;
@@ -128,34 +243,61 @@ void Interpolation::updateActualPosition() {
   long microsek = micros();
   float t = (microsek - startTime) / 1000000.0;
   float progress;
-  switch (SPEED_PROFILE){
-    // FLAT SPEED CURVE
-    case 0:
-      progress = t * tmul;
-      if (progress >= 1.0){
-        progress = 1.0;
-        state = 1;
-      }
-      break;
-    // ARCTAN APPROX
-    case 1:
-      progress = atan((PI * t * tmul) - (PI * 0.5)) * 0.5 + 0.5;
-      if (progress >= 1.0) {
-        progress = 1.0; 
-        state = 1;
-      }
-      break;
-    // COSIN APPROX
-    case 2:
-      progress = -cos(t * tmul * PI) * 0.5 + 0.5;
-      if ((t * tmul) >= 1.0) {
-        progress = 1.0; 
-        state = 1;
-      }
-      break;
+  if (trapezoid) {
+    // Distancia recorrida según el perfil trapezoidal
+    float dist;
+    if (t >= trapTotal) {
+      dist = distmm;
+    } else if (t < trapTa) {
+      dist = trapV0 * t + 0.5 * trapAccel * t * t;
+    } else if (t < trapTc) {
+      dist = trapDa + trapVc * (t - trapTa);
+    } else {
+      float u = t - trapTc;
+      dist = trapDc + trapVc * u - 0.5 * trapAccel * u * u;
+    }
+    progress = distmm > 0 ? dist / distmm : 1.0;
+    if (t >= trapTotal || progress >= 1.0) {
+      progress = 1.0;
+      state = 1;
+    }
+  } else {
+    switch (SPEED_PROFILE){
+      // FLAT SPEED CURVE
+      case 0:
+        progress = t * tmul;
+        if (progress >= 1.0){
+          progress = 1.0;
+          state = 1;
+        }
+        break;
+      // ARCTAN APPROX
+      case 1:
+        progress = atan((PI * t * tmul) - (PI * 0.5)) * 0.5 + 0.5;
+        if (progress >= 1.0) {
+          progress = 1.0; 
+          state = 1;
+        }
+        break;
+      // COSIN APPROX
+      case 2:
+        progress = -cos(t * tmul * PI) * 0.5 + 0.5;
+        if ((t * tmul) >= 1.0) {
+          progress = 1.0; 
+          state = 1;
+        }
+        break;
+    }
+  }
+  if (arcSweep != 0 && progress < 1.0) {
+    float angle = arcStartAngle + progress * arcSweep;
+    float radius = arcRadius0 + progress * arcRadiusDelta;
+    pos_tracker[X_AXIS] = arcCenterX + radius * cos(angle);
+    pos_tracker[Y_AXIS] = arcCenterY + radius * sin(angle);
+  } else {
+    pos_tracker[X_AXIS] = xStartmm + progress * xDelta;
+    pos_tracker[Y_AXIS] = yStartmm + progress * yDelta;
   }
-  pos_tracker[X_AXIS] = xStartmm + progress * xDelta;
-  pos_tracker[Y_AXIS] = yStartmm + progress * yDelta;
   pos_tracker[Z_AXIS] = zStartmm + progress * zDelta;
   pos_tracker[E_AXIS] = eStartmm + progress * eDelta;
 
@@ -171,6 +313,9 @@ void Interpolation::updateActualPosition() {
     pos_tracker[E_AXIS] = ePosmm;
     state = 1;
     progress = 1.0;
+    arcSweep = 0;
+    trapezoid = false;
+    limitHit = true;
     xStartmm = xPosmm;
     yStartmm = yPosmm;
     zStartmm = zPosmm;
@@ -234,7 +379,7 @@ bool Interpolation::isAllowedPosition(float pos_tracker[4]) {
       );
   if(!retVal) {
     //Logger::logERROR("LIMIT REACHED: [X:" + String(pos_tracker[X_AXIS]) + " Y:" + String(pos_tracker[Y_AXIS]) + " Z:" + String(pos_tracker[Z_AXIS]) + " E:" + String(pos_tracker[E_AXIS]) + "]");
-    Logger::logERROR("POINT IS OUTSIDE OF WORKSPACE");  //respuesta en modo de operacion modificado
+    LOG_ERROR_MSG(MSG_OUTSIDE_WORKSPACE, "POINT IS OUTSIDE OF WORKSPACE");  //respuesta en modo de operacion modificado
   }
   return retVal;
 }
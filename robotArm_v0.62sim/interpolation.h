@@ -26,6 +26,12 @@ public:
   void setCurrentPos(Point p);
   void setInterpolation(Point p1, float v = 0);
   void setInterpolation(Point p0, Point p1, float v = 0);
+  // G2/G3: arco en el plano XY desde la posición actual hasta p1, centro en
+  // (inicio + i, inicio + j). Z y E se interpolan linealmente (hélice).
+  void setArcInterpolation(Point p1, float i, float j, bool clockwise, float v = 0);
+  // Perfil trapezoidal para el tramo recién configurado (planificador look-ahead):
+  // empieza a vEntry, crucero a la velocidad del tramo y termina a vExit.
+  void setTrapezoid(float vEntry, float vExit, float accel);
   
   void updateActualPosition();
   bool isFinished() const;
@@ -35,6 +41,8 @@ public:
   float getZPosmm() const;
   float getEPosmm() const;
   Point getPosmm() const;
+  Point getTargetmm() const;
+  bool consumeLimitHit();   // true una vez si el último tramo se cortó por límite
   bool isAllowedPosition(float pos_tracker[4]);
   void setPosOffset(float new_x, float new_y, float new_z, float new_e);
   void resetPosOffset();
@@ -61,6 +69,27 @@ private:
   float ePosmm;
   float v;
   float tmul;
+  float distmm;
+  bool limitHit;
+
+  // Perfil trapezoidal en curso
+  bool trapezoid;
+  float trapV0;
+  float trapVc;
+  float trapAccel;
+  float trapTa;      // fin de la aceleración (s)
+  float trapTc;      // fin del crucero (s)
+  float trapTotal;   // fin del tramo (s)
+  float trapDa;      // distancia acelerando
+  float trapDc;      // distancia al terminar el crucero
+
+  // Arco en curso (arcSweep = 0 para movimientos lineales)
+  float arcCenterX;
+  float arcCenterY;
+  float arcRadius0;
+  float arcRadiusDelta;
+  float arcStartAngle;
+  float arcSweep;
 };
 
 #endif
@@ -0,0 +1,47 @@
+#ifndef LOGCODES_H_
+#define LOGCODES_H_
+
+// Códigos numéricos de los mensajes del firmware. Con LOG_COMPACT se envía
+// solo "I<código>" / "E<código>" seguido de los valores, y el servidor
+// reconstruye el texto (Servidor/src/hardware/FirmwareLog.cpp: mantener
+// ambas tablas sincronizadas).
+
+// INFO
+#define MSG_ROBOT_ONLINE 1
+#define MSG_SEND_G28 2
+#define MSG_ROTATE_AND_SEND_G28 3
+#define MSG_HOME_MANUALLY 4
+#define MSG_HOMING_COMPLETE 5
+#define MSG_GRIPPER_ON 6
+#define MSG_GRIPPER_OFF 7
+#define MSG_GRIPPER_STOPPED 8
+#define MSG_QUICK_STOP 9
+#define MSG_MOTORS_ENABLED 10
+#define MSG_MOTORS_DISABLED 11
+#define MSG_FAN_ENABLED 12
+#define MSG_FAN_DISABLED 13
+#define MSG_RELATIVE_MODE 14
+#define MSG_ABSOLUTE_MODE 15
+#define MSG_RELATIVE_MODE_ON 16
+#define MSG_ABSOLUTE_MODE_ON 17
+#define MSG_LINEAR_MOVE 20     // X Y Z E
+#define MSG_CW_ARC_MOVE 21     // X Y Z I J
+#define MSG_CCW_ARC_MOVE 22    // X Y Z I J
+#define MSG_CURRENT_POSITION 23 // X Y Z E
+#define MSG_POSITION_OFFSET 24 // X Y Z E
+#define MSG_ENDSTOP_STATE 25   // X Y Z
+
+// ERROR
+#define MSG_COMMAND_NOT_RECOGNIZED 50
+#define MSG_OUTSIDE_WORKSPACE 51
+#define MSG_ARC_WITHOUT_CENTER 52
+#define MSG_ROBOT_FAILURE 53
+#define MSG_DWELL_NOT_IMPLEMENTED 54
+#define MSG_PUMP_ON_NOT_IMPLEMENTED 55
+#define MSG_PUMP_OFF_NOT_IMPLEMENTED 56
+#define MSG_LASER_ON_NOT_IMPLEMENTED 57
+#define MSG_LASER_OFF_NOT_IMPLEMENTED 58
+#define MSG_COMMAND_ABORTED 59   // G28/M3/M5 cortado por M410
+#define MSG_QUEUE_FULL 60   // comando descartado: el host no esperó el "OK"
+
+#endif
@@ -1,31 +1,42 @@
 #include "logger.h"
-#include "config.h"
 
-void Logger::log(String message, int level) {
-  if(LOG_LEVEL >= level) {
-    String logMsg;
-    switch(level) {
-      case LOG_ERROR:
-        logMsg = "ERROR: ";
-      break;
-      case LOG_INFO:
-        logMsg = "INFO: ";
-      break;
-      case LOG_DEBUG:
-        logMsg = "DEBUG: ";
-      break;
+void Logger::log(byte level, byte code, const __FlashStringHelper* text, const float* values, byte count) {
+  if (text == NULL) {
+    // Formato compacto: "I20 10.00 20.00 30.00 0.00"
+    Serial.print(level == LOG_ERROR ? 'E' : (level == LOG_INFO ? 'I' : 'D'));
+    Serial.print(code);
+    for (byte i = 0; i < count; i++) {
+      Serial.print(' ');
+      Serial.print(values[i], 2);
     }
-    //logMsg = logMsg + message;
-    Serial.print(logMsg);
-    Serial.println(message);
+    Serial.println();
+    return;
   }
-}
-void Logger::logERROR(String message) {
-  log(message, LOG_ERROR);
-}
-void Logger::logINFO(String message) {
-  log(message, LOG_INFO);
-}
-void Logger::logDEBUG(String message) {
-  log(message, LOG_DEBUG);
+
+  switch(level) {
+    case LOG_ERROR:
+      Serial.print(F("ERROR: "));
+    break;
+    case LOG_INFO:
+      Serial.print(F("INFO: "));
+    break;
+    case LOG_DEBUG:
+      Serial.print(F("DEBUG: "));
+    break;
+  }
+  // Recorre la plantilla en flash sin copiarla a RAM
+  const char* p = (const char*)text;
+  byte next = 0;
+  for (char c = pgm_read_byte(p); c != '\0'; c = pgm_read_byte(++p)) {
+    if ((c == '%' || c == '#') && next < count) {
+      if (c == '%') {
+        Serial.print(values[next++], 2);
+      } else {
+        Serial.print((long)values[next++]);
+      }
+    } else {
+      Serial.print(c);
+    }
+  }
+  Serial.println();
 }
@@ -2,6 +2,8 @@
 #define LOGGER_H_
 
 #include <Arduino.h>
+#include "config.h"
+#include "logCodes.h"
 
 #define LOG_ERROR 0
 #define LOG_INFO 1
@@ -9,9 +11,40 @@
 
 class Logger {
   public:
-    static void log(String message, int level);
-    static void logINFO(String message);
-    static void logERROR(String message);
-    static void logDEBUG(String message);
+    // text: plantilla en flash (NULL con LOG_COMPACT). Cada '%' se reemplaza
+    // por el siguiente valor con 2 decimales y cada '#' por un entero.
+    static void log(byte level, byte code, const __FlashStringHelper* text, const float* values = NULL, byte count = 0);
 };
+
+// Con LOG_COMPACT el texto ni siquiera llega a la flash
+#if LOG_COMPACT
+ #define LOG_TEXT(text) NULL
+#else
+ #define LOG_TEXT(text) F(text)
+#endif
+
+#define LOG_MSG(level, code, text) Logger::log(level, code, LOG_TEXT(text))
+#define LOG_VALUES(level, code, text, ...) do { \
+    const float logValues[] = {__VA_ARGS__}; \
+    Logger::log(level, code, LOG_TEXT(text), logValues, sizeof(logValues) / sizeof(logValues[0])); \
+  } while (0)
+
+// Los niveles por encima de LOG_LEVEL se eliminan en compilación
+#define LOG_ERROR_MSG(code, text) LOG_MSG(LOG_ERROR, code, text)
+#define LOG_ERROR_VALUES(code, text, ...) LOG_VALUES(LOG_ERROR, code, text, __VA_ARGS__)
+#if LOG_LEVEL >= LOG_INFO
+ #define LOG_INFO_MSG(code, text) LOG_MSG(LOG_INFO, code, text)
+ #define LOG_INFO_VALUES(code, text, ...) LOG_VALUES(LOG_INFO, code, text, __VA_ARGS__)
+#else
+ #define LOG_INFO_MSG(code, text) do {} while (0)
+ #define LOG_INFO_VALUES(code, text, ...) do {} while (0)
+#endif
+#if LOG_LEVEL >= LOG_DEBUG
+ #define LOG_DEBUG_MSG(code, text) LOG_MSG(LOG_DEBUG, code, text)
+ #define LOG_DEBUG_VALUES(code, text, ...) LOG_VALUES(LOG_DEBUG, code, text, __VA_ARGS__)
+#else
+ #define LOG_DEBUG_MSG(code, text) do {} while (0)
+ #define LOG_DEBUG_VALUES(code, text, ...) do {} while (0)
+#endif
+
 #endif
@@ -0,0 +1,129 @@
+#include "planner.h"
+
+Planner::Planner() {
+  head = 0;
+  count = 0;
+  endPos.xmm = INITIAL_X;
+  endPos.ymm = INITIAL_Y;
+  endPos.zmm = INITIAL_Z;
+  endPos.emm = INITIAL_E0;
+}
+
+void Planner::reset(Point pos) {
+  head = 0;
+  count = 0;
+  endPos = pos;
+}
+
+bool Planner::isFull() const {
+  return count >= PLANNER_WINDOW;
+}
+
+bool Planner::isEmpty() const {
+  return count == 0;
+}
+
+Point Planner::getEndPos() const {
+  return endPos;
+}
+
+// Desvío de unión (junction deviation): velocidad máxima en el vértice tal que
+// un arco tangente a ambos tramos se aparte JUNCTION_DEVIATION mm del vértice.
+float Planner::junctionSpeed(const PlannerBlock &prev, const PlannerBlock &cur) const {
+  float vmax = min(prev.vNominal, cur.vNominal);
+  float cosTheta = -(prev.unit[0] * cur.unit[0] + prev.unit[1] * cur.unit[1] + prev.unit[2] * cur.unit[2]);
+  if (cosTheta > 0.999) {
+    return 0;      // vuelta atrás: parar
+  }
+  if (cosTheta < -0.999) {
+    return vmax;   // sigue en línea recta
+  }
+  float sinHalf = sqrt(0.5 * (1.0 - cosTheta));
+  float v = sqrt(MAX_ACCEL * JUNCTION_DEVIATION * sinHalf / (1.0 - sinHalf));
+  return min(v, vmax);
+}
+
+bool Planner::addLinear(Point target, float feed) {
+  float dx = target.xmm - endPos.xmm;
+  float dy = target.ymm - endPos.ymm;
+  float dz = target.zmm - endPos.zmm;
+  float de = abs(target.emm - endPos.emm);
+  float xyz = sqrt(dx*dx + dy*dy + dz*dz);
+  float length = xyz < de ? de : xyz;
+  if (length < 0.001) {
+    endPos = target;
+    return false;
+  }
+
+  PlannerBlock &b = blocks[(head + count) % PLANNER_WINDOW];
+  b.target = target;
+  b.length = length;
+  b.unit[0] = xyz > 0 ? dx / xyz : 0;
+  b.unit[1] = xyz > 0 ? dy / xyz : 0;
+  b.unit[2] = xyz > 0 ? dz / xyz : 0;
+
+  // Misma regla de velocidad por defecto que Interpolation::setInterpolation
+  float v = feed;
+  if (v < 5) {
+    v = sqrt(length) * 10;
+  }
+  if (v < 5) {
+    v = 5;
+  }
+  b.vNominal = v;
+
+  if (count == 0) {
+    // Lo anterior ya se entregó (o no hay nada): termina en reposo
+    b.vEntryMax = 0;
+    b.vEntry = 0;
+    b.entryFixed = true;
+  } else {
+    b.vEntryMax = junctionSpeed(blocks[(head + count - 1) % PLANNER_WINDOW], b);
+    b.vEntry = b.vEntryMax;
+    b.entryFixed = false;
+  }
+  count++;
+  endPos = target;
+  recalculate();
+  return true;
+}
+
+void Planner::recalculate() {
+  // Hacia atrás: cada tramo debe poder frenar hasta la entrada del siguiente
+  float nextEntry = 0;
+  for (int k = count - 1; k >= 0; k--) {
+    PlannerBlock &b = blocks[(head + k) % PLANNER_WINDOW];
+    if (!b.entryFixed) {
+      b.vEntry = min(b.vEntryMax, sqrt(nextEntry * nextEntry + 2 * MAX_ACCEL * b.length));
+    }
+    nextEntry = b.vEntry;
+  }
+  // Hacia adelante: y acelerar desde su propia entrada
+  for (int k = 0; k + 1 < count; k++) {
+    PlannerBlock &b = blocks[(head + k) % PLANNER_WINDOW];
+    PlannerBlock &n = blocks[(head + k + 1) % PLANNER_WINDOW];
+    if (!n.entryFixed) {
+      float v = sqrt(b.vEntry * b.vEntry + 2 * MAX_ACCEL * b.length);
+      if (v < n.vEntry) {
+        n.vEntry = v;
+      }
+    }
+  }
+}
+
+bool Planner::next(PlannerBlock &block, float &vExit) {
+  if (count == 0) {
+    return false;
+  }
+  block = blocks[head];
+  head = (head + 1) % PLANNER_WINDOW;
+  count--;
+  if (count > 0) {
+    // La salida del tramo entregado queda fija como entrada del siguiente
+    blocks[head].entryFixed = true;
+    vExit = blocks[head].vEntry;
+  } else {
+    vExit = 0;
+  }
+  return true;
+}
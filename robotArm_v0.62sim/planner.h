@@ -0,0 +1,43 @@
+#ifndef PLANNER_H_
+#define PLANNER_H_
+
+#include <Arduino.h>
+#include "config.h"
+#include "interpolation.h"
+
+// Tramo lineal pendiente de ejecutar, con sus velocidades ya planificadas
+struct PlannerBlock {
+  Point target;
+  float length;      // mm
+  float unit[3];     // dirección normalizada (X, Y, Z)
+  float vNominal;    // mm/s (F, o sqrt(dist)*10 como en Interpolation)
+  float vEntryMax;   // límite impuesto por el ángulo de la unión con el tramo anterior
+  float vEntry;      // velocidad planificada al empezar el tramo
+  bool entryFixed;   // el tramo anterior ya se entregó al interpolador con esta salida
+};
+
+// Planificador con anticipación (look-ahead) sobre una ventana de G0/G1.
+// Cada tramo nuevo recalcula las velocidades de unión de toda la ventana:
+// pasada hacia atrás (el último tramo termina en reposo) y hacia adelante
+// (límite de aceleración), igual que los planificadores de grbl/Marlin.
+class Planner {
+public:
+  Planner();
+  void reset(Point pos);                         // tras G28/G92/G2/G3 o un límite
+  bool addLinear(Point target, float feed);      // false si el tramo es nulo
+  bool next(PlannerBlock &block, float &vExit);  // saca el primer tramo
+  bool isFull() const;
+  bool isEmpty() const;
+  Point getEndPos() const;
+
+private:
+  void recalculate();
+  float junctionSpeed(const PlannerBlock &prev, const PlannerBlock &cur) const;
+
+  PlannerBlock blocks[PLANNER_WINDOW];
+  int head;
+  int count;
+  Point endPos;      // destino del último tramo agregado
+};
+
+#endif
@@ -7,6 +7,7 @@ public:
   ~Queue();
   bool push(Element elem);
   Element pop();
+  Element peek(int offset = 0) const;
   bool isFull() const;
   bool isEmpty() const;
   int getFreeSpace() const;
@@ -30,7 +31,7 @@ Queue<Element>::Queue(int alen) {
 
 template <typename Element>
 Queue<Element>::~Queue() {
-  delete data;
+  delete[] data;
 }
 
 template <typename Element>
@@ -38,18 +39,47 @@ Queue<Element>::Queue(Queue<Element>& q) {
   //nothing ever is allowed to do something here
 }
 
+// Los índices se pliegan con una resta en lugar de %: en AVR el módulo
+// es una división de 16 bits por cada acceso.
 template <typename Element>
 bool Queue<Element>::push(Element elem) {
-  data[(start + count++) % len] = elem;
+  if (isFull()) {
+    return false;
+  }
+  int i = start + count;
+  if (i >= len) {
+    i -= len;
+  }
+  data[i] = elem;
+  count++;
   return true;
 }
 
 template <typename Element>
 Element Queue<Element>::pop() {
+  if (isEmpty()) {
+    return Element();
+  }
+  Element elem = data[start];
+  start++;
+  if (start >= len) {
+    start = 0;
+  }
   count--;
-  int s = start;
-  start = (start + 1) % len;
-  return data[(s) % len];
+  return elem;
+}
+
+// Elemento en la posición offset desde el primero, sin sacarlo
+template <typename Element>
+Element Queue<Element>::peek(int offset) const {
+  if (offset < 0 || offset >= count) {
+    return Element();
+  }
+  int i = start + offset;
+  if (i >= len) {
+    i -= len;
+  }
+  return data[i];
 }
 
 template <typename Element>
@@ -14,6 +14,13 @@
 //V0.62sim ADAPTED FOR SIMULATION
 //      NON-FUNCTIONAL
 //      FOR Puma3D (Cesar Aranda)
+//      ADD G2/G3 ARC MOVES (I/J CENTER OFFSETS, XY PLANE)
+//      ADD LOOK-AHEAD PLANNER FOR G0/G1 (LOOKAHEAD IN config.h)
+//      ADD DDA STEP GENERATOR (STEP_GENERATOR IN config.h)
+//      ADD OPTIONAL FIXED-POINT IK WITH FLASH TABLES (FIXED_POINT_IK IN config.h, FLOAT BY DEFAULT)
+//      PACKED FIXED-POINT COMMAND QUEUE (QUEUE_BYTES IN config.h)
+//      NON-BLOCKING HOMING AND GRIPPER, IMMEDIATE M114 AND M410 (QUICK STOP)
+//      LINE NUMBER + CHECKSUM PROTOCOL WITH RESEND (LINE_CHECKSUM IN config.h)
 
 #include "config.h"
 
@@ -36,8 +43,10 @@
 #include "interpolation.h"
 #include "fanControl.h"
 #include "RampsStepper.h"
-#include "queue.h"
+#include "commandQueue.h"
 #include "command.h"
+#include "planner.h"
+#include "stepGenerator.h"
 #include "byj_gripper.h"
 #include "servo_gripper.h"
 #include "equipment.h"
@@ -68,8 +77,29 @@ FanControl fan(FAN_PIN, FAN_DELAY);
 //EXECUTION & COMMAND OBJECTS
 RobotGeometry geometry(END_EFFECTOR_OFFSET, LOW_SHANK_LENGTH, HIGH_SHANK_LENGTH);
 Interpolation interpolator;
-Queue<Cmd> queue(QUEUE_SIZE);
+CommandQueue queue(QUEUE_BYTES);
 Command command;
+Planner planner;
+//NON-BLOCKING OPERATIONS (HOMING STAGES)
+#define HOMING_IDLE 0
+#define HOMING_SIM_WAIT 1
+#define HOMING_SEEK_XY 2
+#define HOMING_OFFSET_Y 3
+#define HOMING_OFFSET_X 4
+#define HOMING_SEEK_Z 5
+#define HOMING_OFFSET_Z 6
+#define HOMING_SEEK_E0 7
+#define HOMING_OFFSET_E0 8
+byte homingStage = HOMING_IDLE;
+unsigned long homingStart;
+bool replyPending = false; // el "OK" de G28/M3/M5 sale cuando terminan
+// Comando leído con la cola llena: espera acá su lugar mientras se siguen
+// leyendo líneas, para que M114/M410 se atiendan aunque la cola no avance
+Cmd heldCmd;
+bool cmdHeld = false;
+
+StepGenerator stepGenerator(&stepperRotate, &stepperLower, &stepperHigher, &stepperRail);
+Point lastSegmentPos;
 
 void setup()
 {
@@ -105,39 +135,47 @@ void setup()
 //******* control de compilacion simplificada, para usar el firmware sólo como gestor de comandos
 #ifndef SIMULATION
   if (HOME_ON_BOOT) { //HOME DURING SETUP() IF HOME_ON_BOOT ENABLED
-    homeSequence(); 
-    Logger::logINFO("ROBOT ONLINE");
+    startHoming(); 
+    LOG_INFO_MSG(MSG_ROBOT_ONLINE, "ROBOT ONLINE");
   } else {
     setStepperEnable(false); //ROBOT ADJUSTABLE BY HAND AFTER TURNING ON
     if (HOME_X_STEPPER && HOME_Y_STEPPER && !HOME_Z_STEPPER){
-      Logger::logINFO("ROBOT ONLINE");
-      Logger::logINFO("ROTATE ROBOT TO FACE FRONT CENTRE & SEND G28 TO CALIBRATE");
+      LOG_INFO_MSG(MSG_ROBOT_ONLINE, "ROBOT ONLINE");
+      LOG_INFO_MSG(MSG_ROTATE_AND_SEND_G28, "ROTATE ROBOT TO FACE FRONT CENTRE & SEND G28 TO CALIBRATE");
     }
     if (HOME_X_STEPPER && HOME_Y_STEPPER && HOME_Z_STEPPER){
-      Logger::logINFO("ROBOT ONLINE");
-      Logger::logINFO("SEND G28 TO CALIBRATE");
+      LOG_INFO_MSG(MSG_ROBOT_ONLINE, "ROBOT ONLINE");
+      LOG_INFO_MSG(MSG_SEND_G28, "SEND G28 TO CALIBRATE");
     }
     if (!HOME_X_STEPPER && !HOME_Y_STEPPER){
-      Logger::logINFO("ROBOT ONLINE");
-      Logger::logINFO("HOME ROBOT MANUALLY & SEND G28 TO CALIBRATE");
+      LOG_INFO_MSG(MSG_ROBOT_ONLINE, "ROBOT ONLINE");
+      LOG_INFO_MSG(MSG_HOME_MANUALLY, "HOME ROBOT MANUALLY & SEND G28 TO CALIBRATE");
     }
   }
 #endif
   
     if (HOME_X_STEPPER && HOME_Y_STEPPER && HOME_Z_STEPPER){
-      Logger::logINFO("ROBOT ONLINE");
-      Logger::logINFO("SEND G28 TO CALIBRATE");
+      LOG_INFO_MSG(MSG_ROBOT_ONLINE, "ROBOT ONLINE");
+      LOG_INFO_MSG(MSG_SEND_G28, "SEND G28 TO CALIBRATE");
     }
 
   interpolator.setInterpolation(INITIAL_X, INITIAL_Y, INITIAL_Z, INITIAL_E0, INITIAL_X, INITIAL_Y, INITIAL_Z, INITIAL_E0);
+  planner.reset(interpolator.getTargetmm());
 }
 
 void loop() {
+//******* logica modificada, para usar el driver sólo como gestor de comandos (simulacion)
+
+#if STEP_GENERATOR
+  // IK solo en los bordes de subsegmento; entre bordes los pasos salen del DDA
+  if (stepGenerator.update()) {
+    interpolator.updateActualPosition();
+    loadStepSegment();
+  }
+#else
   // Actualizar posicion actual
   interpolator.updateActualPosition();
 
-//******* logica modificada, para usar el driver sólo como gestor de comandos (simulacion)
-  
   geometry.set(interpolator.getXPosmm(), interpolator.getYPosmm(), interpolator.getZPosmm());
   stepperRotate.stepToPositionRad(geometry.getRotRad());
   stepperLower.stepToPositionRad(geometry.getLowRad());
@@ -151,21 +189,77 @@ void loop() {
   if (RAIL){
     stepperRail.update();
   }
+#endif
   fan.update();
+  updateHoming();
+  byj_gripper.update();
+
+  if (cmdHeld && !queue.isFull()) {
+    queue.push(heldCmd);
+    cmdHeld = false;
+  }
 
-  if (!queue.isFull()) {
-    if (command.handleGcode()) {
-      queue.push(command.getCmd());
+  if (command.handleGcode()) {
+    Cmd cmd = command.getCmd();
+    // Estado y parada se atienden al llegar, aunque haya un homing en curso
+    // o la cola esté llena
+    if (isImmediate(cmd)) {
+      executeImmediate(cmd);
+    } else if (!queue.isFull()) {
+      queue.push(cmd);
+    } else if (!cmdHeld) {
+      heldCmd = cmd;
+      cmdHeld = true;
+    } else {
+      // El host no esperó el "OK" del comando retenido
+      LOG_ERROR_MSG(MSG_QUEUE_FULL, "QUEUE FULL, COMMAND DROPPED");
+      if (PRINT_REPLY) {
+        Serial.println(PRINT_REPLY_MSG);  // Imprime mensaje "OK"
+      }
     }
   }
 
-  // Ejecutar un nuevo comando si Queue no esté vacía y interpolador haya terminado
-  if ((!queue.isEmpty()) && interpolator.isFinished()) {
-    executeCommand(queue.pop());
+  if (replyPending && !isBusy()) {
+    replyPending = false;
+    Serial.println(PRINT_REPLY_MSG);  // Imprime mensaje "OK"
+  }
+
+#if LOOKAHEAD
+  // Los G0/G1 pasan de la cola al planificador apenas hay lugar; el resto de
+  // los comandos espera a que el planificador y el interpolador se vacíen.
+  // Durante un homing no se planifica: el punto de partida todavía no se conoce.
+  while (!isBusy() && !queue.isEmpty() && isLinearMove(queue.peek()) && !planner.isFull()) {
+    planLinearMove(queue.pop());
     if (PRINT_REPLY) {
       Serial.println(PRINT_REPLY_MSG);  // Imprime mensaje "OK"
     }
   }
+
+  if (interpolator.isFinished() && !isBusy()) {
+    if (interpolator.consumeLimitHit()) {
+      // Se salió del área de trabajo: lo planificado ya no parte de donde está el brazo
+      planner.reset(interpolator.getPosmm());
+    }
+    PlannerBlock block;
+    float vExit;
+    if (planner.next(block, vExit)) {
+      fan.enable(true);
+      interpolator.setInterpolation(block.target, block.vNominal);
+      interpolator.setTrapezoid(block.vEntry, vExit, MAX_ACCEL);
+    } else if (!queue.isEmpty()) {
+      executeCommand(queue.pop());
+      // G28, G92, G2/G3... pueden cambiar el punto de partida del próximo tramo
+      planner.reset(interpolator.getTargetmm());
+      reply();
+    }
+  }
+#else
+  // Ejecutar un nuevo comando si Queue no esté vacía y interpolador haya terminado
+  if ((!queue.isEmpty()) && interpolator.isFinished() && !isBusy()) {
+    executeCommand(queue.pop());
+    reply();
+  }
+#endif
   
 //  if (millis() % 500 < 250) {
 //    led.cmdOn();
@@ -175,6 +269,101 @@ void loop() {
 //  }
 }
 
+// Carga el próximo subsegmento del generador de pasos con la posición actual
+// del interpolador. En reposo no se repite la IK si el brazo no se movió.
+void loadStepSegment() {
+  Point pos = interpolator.getPosmm();
+  if (interpolator.isFinished() && pos.xmm == lastSegmentPos.xmm && pos.ymm == lastSegmentPos.ymm
+      && pos.zmm == lastSegmentPos.zmm && pos.emm == lastSegmentPos.emm) {
+    return;
+  }
+  lastSegmentPos = pos;
+
+  geometry.set(pos.xmm, pos.ymm, pos.zmm);
+  long targets[STEP_GEN_AXES];
+  targets[0] = stepperRotate.radToSteps(geometry.getRotRad());
+  targets[1] = stepperLower.radToSteps(geometry.getLowRad());
+  targets[2] = stepperHigher.radToSteps(geometry.getHighRad());
+  targets[3] = RAIL ? (long)(pos.emm * STEPS_PER_MM_RAIL) : stepperRail.getPosition();
+  stepGenerator.setSegment(targets, STEP_SEGMENT_US);
+}
+
+// Homing o pinza en curso: no se ejecutan otros comandos de la cola
+bool isBusy() {
+  return homingStage != HOMING_IDLE || byj_gripper.isBusy();
+}
+
+// "OK" del comando recién ejecutado; si quedó una operación en curso se
+// difiere hasta que termine, como cuando G28/M3/M5 eran bloqueantes.
+void reply() {
+  if (!PRINT_REPLY) {
+    return;
+  }
+  if (isBusy()) {
+    replyPending = true;
+  } else {
+    Serial.println(PRINT_REPLY_MSG);  // Imprime mensaje "OK"
+  }
+}
+
+bool isImmediate(const Cmd &cmd) {
+  return cmd.id == 'M' && (cmd.num == 114 || cmd.num == 410);
+}
+
+void executeImmediate(Cmd cmd) {
+  if (cmd.num == 410) {
+    quickStop();
+  } else {
+    executeCommand(cmd);
+  }
+  if (PRINT_REPLY) {
+    Serial.println(PRINT_REPLY_MSG);  // Imprime mensaje "OK"
+  }
+}
+
+// M410: corta homing, pinza y movimiento en curso y descarta la cola
+void quickStop() {
+  homingStage = HOMING_IDLE;
+  endstopX.abort();
+  endstopY.abort();
+  endstopZ.abort();
+  endstopE0.abort();
+  byj_gripper.stop();
+  cmdHeld = false;
+  while (!queue.isEmpty()) {
+    queue.pop();
+  }
+  Point pos = interpolator.getPosmm();
+  interpolator.setInterpolation(pos, pos);
+  planner.reset(pos);
+  LOG_INFO_MSG(MSG_QUICK_STOP, "QUICK STOP");
+  // El comando cortado todavía esperaba su respuesta: se cierra con error
+  // para que el host no lo dé por completado con el "OK" diferido
+  if (replyPending) {
+    replyPending = false;
+    LOG_ERROR_MSG(MSG_COMMAND_ABORTED, "COMMAND ABORTED BY QUICK STOP");
+    Serial.println(PRINT_REPLY_MSG);  // Imprime mensaje "OK"
+  }
+}
+
+bool isLinearMove(const Cmd &cmd) {
+  return cmd.id == 'G' && (cmd.num == 0 || cmd.num == 1);
+}
+
+// G0/G1 con look-ahead: el destino se resuelve contra el final de lo ya
+// planificado (no contra la posición actual, que todavía va en camino).
+void planLinearMove(Cmd cmd) {
+  Point posoffset = interpolator.getPosOffset();
+  cmdMove(cmd, planner.getEndPos(), posoffset, command.isRelativeCoord);
+  Point target;
+  target.xmm = cmd.valueX;
+  target.ymm = cmd.valueY;
+  target.zmm = cmd.valueZ;
+  target.emm = cmd.valueE;
+  planner.addLinear(target, cmd.valueF);
+  LOG_INFO_VALUES(MSG_LINEAR_MOVE, "LINEAR MOVE: [X:% Y:% Z:% E:%]", cmd.valueX-posoffset.xmm, cmd.valueY-posoffset.ymm, cmd.valueZ-posoffset.zmm, cmd.valueE-posoffset.emm);
+}
+
 void executeCommand(Cmd cmd) {
 
   if (cmd.id == -1) {
@@ -191,30 +380,38 @@ void executeCommand(Cmd cmd) {
       posoffset = interpolator.getPosOffset();      
       cmdMove(cmd, interpolator.getPosmm(), posoffset, command.isRelativeCoord);
       interpolator.setInterpolation(cmd.valueX, cmd.valueY, cmd.valueZ, cmd.valueE, cmd.valueF);
-      Logger::logINFO("LINEAR MOVE: [X:" + String(cmd.valueX-posoffset.xmm) + " Y:" + String(cmd.valueY-posoffset.ymm) + " Z:" + String(cmd.valueZ-posoffset.zmm) + " E:" + String(cmd.valueE-posoffset.emm) + "]");
+      LOG_INFO_VALUES(MSG_LINEAR_MOVE, "LINEAR MOVE: [X:% Y:% Z:% E:%]", cmd.valueX-posoffset.xmm, cmd.valueY-posoffset.ymm, cmd.valueZ-posoffset.zmm, cmd.valueE-posoffset.emm);
       break;
+    case 2:
+    case 3:
+    {
+      fan.enable(true);
+      Point arcoffset;
+      arcoffset = interpolator.getPosOffset();
+      if (!cmdArc(cmd, interpolator.getPosmm(), arcoffset, command.isRelativeCoord)) {
+        LOG_ERROR_MSG(MSG_ARC_WITHOUT_CENTER, "ARC WITHOUT CENTER (I/J)");
+        break;
+      }
+      Point target;
+      target.xmm = cmd.valueX;
+      target.ymm = cmd.valueY;
+      target.zmm = cmd.valueZ;
+      target.emm = cmd.valueE;
+      interpolator.setArcInterpolation(target, cmd.valueI, cmd.valueJ, cmd.num == 2, cmd.valueF);
+      if (cmd.num == 2) {
+        LOG_INFO_VALUES(MSG_CW_ARC_MOVE, "CW ARC MOVE: [X:% Y:% Z:% I:% J:%]", cmd.valueX-arcoffset.xmm, cmd.valueY-arcoffset.ymm, cmd.valueZ-arcoffset.zmm, cmd.valueI, cmd.valueJ);
+      } else {
+        LOG_INFO_VALUES(MSG_CCW_ARC_MOVE, "CCW ARC MOVE: [X:% Y:% Z:% I:% J:%]", cmd.valueX-arcoffset.xmm, cmd.valueY-arcoffset.ymm, cmd.valueZ-arcoffset.zmm, cmd.valueI, cmd.valueJ);
+      }
+      break;
+    }
     case 4: 
       cmdDwell(cmd); 
-      Logger::logERROR("SPEED DELAY NOT IMPLEMENTED");
+      LOG_ERROR_MSG(MSG_DWELL_NOT_IMPLEMENTED, "SPEED DELAY NOT IMPLEMENTED");
       break;
     case 28:
-      #if SIMULATION
-        interpolator.setInterpolation(INITIAL_X, INITIAL_Y, INITIAL_Z, INITIAL_E0, INITIAL_X, INITIAL_Y, INITIAL_Z, INITIAL_E0);
-        delay(3000);
-        Logger::logINFO("HOMING COMPLETE");
-        break;
-      #else
-        if  (USE_UNO){
-          homeSequence_UNO();
-          Logger::logINFO("HOMING COMPLETE");
-          break;
-        } else {
-          // HW default = MEGA
-          homeSequence();
-          Logger::logINFO("HOMING COMPLETE");
-          break;
-        }
-      #endif
+      startHoming();
+      break;
     case 90: command.cmdToAbsolute(); break; // ABSOLUTE COORDINATE MODE
     case 91: command.cmdToRelative(); break; // RELATIVE COORDINATE MODE
     case 92: 
@@ -230,11 +427,11 @@ void executeCommand(Cmd cmd) {
     switch (cmd.num) {
     case 1: 
       pump.cmdOn(); 
-      Logger::logERROR("PUMP ENABLED NOT IMPLEMENTED");  
+      LOG_ERROR_MSG(MSG_PUMP_ON_NOT_IMPLEMENTED, "PUMP ENABLED NOT IMPLEMENTED");  
       break;
     case 2: 
       pump.cmdOff(); 
-      Logger::logERROR("PUMP DISABLED NOT IMPLEMENTED");  
+      LOG_ERROR_MSG(MSG_PUMP_OFF_NOT_IMPLEMENTED, "PUMP DISABLED NOT IMPLEMENTED");  
       break;
     case 3: 
       if (GRIPPER == 0){
@@ -254,37 +451,30 @@ void executeCommand(Cmd cmd) {
       }
     case 6: 
       laser.cmdOn(); 
-      Logger::logERROR("LASER ENABLED NOT IMPLEMENTED");  
+      LOG_ERROR_MSG(MSG_LASER_ON_NOT_IMPLEMENTED, "LASER ENABLED NOT IMPLEMENTED");  
       break;
     case 7: 
       laser.cmdOff(); 
-      Logger::logERROR("LASER DISABLED NOT IMPLEMENTED");  
+      LOG_ERROR_MSG(MSG_LASER_OFF_NOT_IMPLEMENTED, "LASER DISABLED NOT IMPLEMENTED");  
       break;
     case 17: setStepperEnable(true); break;
     case 18: setStepperEnable(false); break;
     case 106: 
       fan.enable(true); 
-      Logger::logINFO("FAN ENABLED");  
+      LOG_INFO_MSG(MSG_FAN_ENABLED, "FAN ENABLED");  
       break;
     case 107: 
       fan.enable(false); 
-      Logger::logINFO("FAN DISABLED");  
+      LOG_INFO_MSG(MSG_FAN_DISABLED, "FAN DISABLED");  
       break;
     case 114: 
       command.cmdGetPosition(interpolator.getPosmm(), interpolator.getPosOffset(), stepperHigher.getPosition(), stepperLower.getPosition(), stepperRotate.getPosition(), fan.getState(), stepperRotate.getState()); 
       break;// Return the current positions of all axis and other info
     case 119:
     {
-      String endstopMsg = "ENDSTOP: [X:";
-      endstopMsg += String(endstopX.state());
-      endstopMsg += String(" Y:");
-      endstopMsg += String(endstopY.state());
-      endstopMsg += String(" Z:");
-      endstopMsg += String(endstopZ.state());
-      endstopMsg += String("]");
       //ORIGINAL LOG STRING UNDESIRABLE FOR UNO PROCESSING
       //Logger::logINFO("ENDSTOP STATE: [UPPER_SHANK(X):"+String(endstopX.state())+" LOWER_SHANK(Y):"+String(endstopY.state())+" ROTATE_GEAR(Z):"+String(endstopZ.state())+"]");
-      Logger::logINFO(endstopMsg);
+      LOG_INFO_VALUES(MSG_ENDSTOP_STATE, "ENDSTOP: [X:# Y:# Z:#]", endstopX.state(), endstopY.state(), endstopZ.state());
       break;
     }
     default:{ 
@@ -298,7 +488,6 @@ void executeCommand(Cmd cmd) {
 }
 
 void setStepperEnable(bool enable){
-  String mMsg = enable?"MOTORS ENABLED":"MOTORS DISABLED";
   stepperRotate.enable(enable);
   stepperLower.enable(enable);
   stepperHigher.enable(enable);
@@ -307,34 +496,125 @@ void setStepperEnable(bool enable){
   }
   fan.enable(enable);
   
-  Logger::logINFO(mMsg);
+  if (enable) {
+    LOG_INFO_MSG(MSG_MOTORS_ENABLED, "MOTORS ENABLED");
+  } else {
+    LOG_INFO_MSG(MSG_MOTORS_DISABLED, "MOTORS DISABLED");
+  }
+}
+
+// G28: arranca el homing; updateHoming() lo avanza desde loop(). Cada eje
+// busca su final de carrera y retrocede su offset: X/Y juntos, luego Z y E0.
+void startHoming(){
+#if SIMULATION
+  homingStage = HOMING_SIM_WAIT;
+  homingStart = millis();
+#else
+  if (!USE_UNO) {
+    setStepperEnable(false);
+    fan.enable(true);
+  }
+  // X/Y se buscan juntos: en la UNO CNC SHIELD un mismo pin EN sirve a los 3 motores
+  if (HOME_Y_STEPPER && HOME_X_STEPPER) {
+    endstopY.startSeek(!INVERSE_Y_STEPPER); //INDICATE STEPPER HOMING DIRECTION
+    endstopX.startSeek(!INVERSE_X_STEPPER); //INDICATE STEPPER HOMING DIRECTION
+    homingStage = HOMING_SEEK_XY;
+    return;
+  }
+  setStepperEnable(true);
+  endstopY.startOffset(!INVERSE_Y_STEPPER);
+  homingStage = HOMING_OFFSET_Y;
+#endif
 }
 
-// NO IMPORTA
-void homeSequence(){
-  setStepperEnable(false);
-  fan.enable(true);
-  if (!HOME_Y_STEPPER || !HOME_X_STEPPER){
-    setStepperEnable(true);
-    endstopY.homeOffset(!INVERSE_Y_STEPPER);
-    endstopX.homeOffset(!INVERSE_X_STEPPER);
+void startHomingZ(){
+  if (HOME_Z_STEPPER) {
+    endstopZ.startSeek(INVERSE_Z_STEPPER); //INDICATE STEPPER HOMING DIRECTION
+    homingStage = HOMING_SEEK_Z;
   } else {
-    if (HOME_Y_STEPPER){
-      endstopY.home(!INVERSE_Y_STEPPER); //INDICATE STEPPER HOMING DIRECTION
-    }
-    if (HOME_X_STEPPER){
-       endstopX.home(!INVERSE_X_STEPPER); //INDICATE STEPPER HOMING DIRECTION
-    }
+    startHomingE0();
   }
-  if (HOME_Z_STEPPER){
-    endstopZ.home(INVERSE_Z_STEPPER); //INDICATE STEPPER HOMING DIRECTION
+}
+
+void startHomingE0(){
+  if (!USE_UNO && RAIL && HOME_E0_STEPPER) {
+    endstopE0.startSeek(!INVERSE_E0_STEPPER);
+    homingStage = HOMING_SEEK_E0;
+  } else {
+    finishHoming();
   }
+}
 
-  if (RAIL){
-    if (HOME_E0_STEPPER){
-      endstopE0.home(!INVERSE_E0_STEPPER); //
+// Un final de carrera que no llegó a tiempo corta el homing: finishHoming()
+// informa la falla
+void updateHoming(){
+  switch (homingStage) {
+  case HOMING_SIM_WAIT:
+    if (millis() - homingStart >= 3000) {
+      finishHoming();
     }
+    break;
+  case HOMING_SEEK_XY:
+  {
+    bool seekingY = endstopY.update();
+    bool seekingX = endstopX.update();
+    if (!seekingY && !seekingX) {
+      if (endstopY.checkDelay() || endstopX.checkDelay()) {
+        finishHoming();
+      } else {
+        endstopY.startOffset(!INVERSE_Y_STEPPER);
+        homingStage = HOMING_OFFSET_Y;
+      }
+    }
+    break;
   }
+  case HOMING_OFFSET_Y:
+    if (!endstopY.update()) {
+      endstopX.startOffset(!INVERSE_X_STEPPER);
+      homingStage = HOMING_OFFSET_X;
+    }
+    break;
+  case HOMING_OFFSET_X:
+    if (!endstopX.update()) {
+      startHomingZ();
+    }
+    break;
+  case HOMING_SEEK_Z:
+    if (!endstopZ.update()) {
+      if (endstopZ.checkDelay()) {
+        finishHoming();
+      } else {
+        endstopZ.startOffset(INVERSE_Z_STEPPER);
+        homingStage = HOMING_OFFSET_Z;
+      }
+    }
+    break;
+  case HOMING_OFFSET_Z:
+    if (!endstopZ.update()) {
+      startHomingE0();
+    }
+    break;
+  case HOMING_SEEK_E0:
+    if (!endstopE0.update()) {
+      if (endstopE0.checkDelay()) {
+        finishHoming();
+      } else {
+        endstopE0.startOffset(!INVERSE_E0_STEPPER);
+        homingStage = HOMING_OFFSET_E0;
+      }
+    }
+    break;
+  case HOMING_OFFSET_E0:
+    if (!endstopE0.update()) {
+      finishHoming();
+    }
+    break;
+  }
+}
+
+void finishHoming(){
+  homingStage = HOMING_IDLE;
+#if !SIMULATION
   if((HOME_Y_STEPPER and endstopY.checkDelay())
     or (HOME_X_STEPPER and endstopX.checkDelay())
     or (HOME_Z_STEPPER and endstopZ.checkDelay())
@@ -342,30 +622,11 @@ void homeSequence(){
     while(!queue.isEmpty()) {
       queue.pop();
     }
-    Logger::logERROR("ROBOT FAILURE");
-  }else{
-    interpolator.setInterpolation(INITIAL_X, INITIAL_Y, INITIAL_Z, INITIAL_E0, INITIAL_X, INITIAL_Y, INITIAL_Z, INITIAL_E0);
-    Logger::logINFO("HOMING COMPLETE");
-  }
-}
-
-//DUE TO UNO CNC SHIELD LIMIT, 1 EN PIN SERVES 3 MOTORS, HENCE DIFFERENT HOMESEQUENCE IS REQUIRED
-void homeSequence_UNO(){
-  if (HOME_Y_STEPPER && HOME_X_STEPPER){
-    while (!endstopY.state() || !endstopX.state()){
-      endstopY.oneStepToEndstop(!INVERSE_Y_STEPPER);
-      endstopX.oneStepToEndstop(!INVERSE_X_STEPPER);
-    }
-    endstopY.homeOffset(!INVERSE_Y_STEPPER);
-    endstopX.homeOffset(!INVERSE_X_STEPPER);
-  } else {
-    setStepperEnable(true);
-    endstopY.homeOffset(!INVERSE_Y_STEPPER);
-    endstopX.homeOffset(!INVERSE_X_STEPPER);
-  }
-  if (HOME_Z_STEPPER){
-    endstopZ.home(INVERSE_Z_STEPPER); //INDICATE STEPPER HOMING DIRECTION
+    LOG_ERROR_MSG(MSG_ROBOT_FAILURE, "ROBOT FAILURE");
+    return;
   }
+#endif
   interpolator.setInterpolation(INITIAL_X, INITIAL_Y, INITIAL_Z, INITIAL_E0, INITIAL_X, INITIAL_Y, INITIAL_Z, INITIAL_E0);
-  Logger::logINFO("HOMING COMPLETE");
+  planner.reset(interpolator.getTargetmm());
+  LOG_INFO_MSG(MSG_HOMING_COMPLETE, "HOMING COMPLETE");
 }
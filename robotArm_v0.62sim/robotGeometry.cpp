@@ -1,8 +1,139 @@
 #include "robotGeometry.h"
+#include "config.h"
 
 #include <math.h>
 #include <Arduino.h>
 
+#if FIXED_POINT_IK
+// IK en punto fijo: longitudes en 1/128 mm, cocientes en Q14 y ángulos en
+// Q15 (radianes * 32768). asin/acos/atan salen de tablas en flash con
+// interpolación lineal; solo se usan enteros de 32 bits. Los cuadrados de
+// las longitudes entran en int32_t hasta unos 360 mm, más que el alcance
+// del brazo; con 1/64 mm el redondeo de rside llegaba a 4.3e-4 rad cerca
+// de la extensión máxima (tests/test_geometry.cpp).
+#define FX_MM_SHIFT 7
+#define FX_RATIO_BITS 14
+#define FX_ANGLE_ONE 32768.0
+#define FX_PI 102944L      // PI en Q15
+#define FX_HALF_PI 51472L
+
+// asin(i / 128) en Q15 para i = 0..64 (entrada de 0 a 0.5)
+const uint16_t ASIN_TABLE[65] PROGMEM = {
+  0, 256, 512, 768, 1024, 1280, 1537, 1793, 2049,
+  2306, 2563, 2819, 3077, 3334, 3591, 3849, 4107, 4365,
+  4623, 4882, 5141, 5400, 5660, 5920, 6181, 6441, 6703,
+  6964, 7226, 7489, 7752, 8016, 8280, 8545, 8810, 9076,
+  9342, 9609, 9877, 10145, 10414, 10684, 10955, 11226, 11499,
+  11772, 12045, 12320, 12596, 12873, 13150, 13429, 13708, 13989,
+  14271, 14554, 14838, 15123, 15410, 15698, 15987, 16277, 16569,
+  16862, 17157
+};
+
+// atan(i / 128) en Q15 para i = 0..128 (entrada de 0 a 1)
+const uint16_t ATAN_TABLE[129] PROGMEM = {
+  0, 256, 512, 768, 1024, 1279, 1535, 1790, 2045, 2300,
+  2555, 2809, 3063, 3317, 3570, 3823, 4075, 4327, 4578, 4829,
+  5079, 5329, 5578, 5826, 6073, 6320, 6567, 6812, 7057, 7301,
+  7544, 7786, 8027, 8268, 8508, 8746, 8984, 9221, 9456, 9691,
+  9925, 10158, 10389, 10620, 10849, 11078, 11305, 11531, 11756, 11980,
+  12203, 12424, 12645, 12864, 13082, 13298, 13514, 13728, 13941, 14153,
+  14363, 14573, 14781, 14987, 15193, 15397, 15600, 15801, 16002, 16201,
+  16398, 16595, 16790, 16984, 17176, 17368, 17557, 17746, 17933, 18119,
+  18304, 18488, 18670, 18851, 19030, 19209, 19386, 19561, 19736, 19909,
+  20081, 20252, 20421, 20589, 20756, 20922, 21086, 21249, 21411, 21572,
+  21732, 21890, 22047, 22203, 22358, 22512, 22664, 22815, 22966, 23115,
+  23262, 23409, 23555, 23699, 23842, 23985, 24126, 24266, 24405, 24542,
+  24679, 24815, 24950, 25083, 25216, 25347, 25478, 25607, 25736
+};
+
+static int32_t toFixedMm(float mm) {
+  return (int32_t)(mm * (1 << FX_MM_SHIFT) + (mm >= 0 ? 0.5 : -0.5));
+}
+
+// Raíz cuadrada entera redondeada al más cercano
+static uint32_t isqrt32(uint32_t value) {
+  uint32_t rest = value;
+  uint32_t root = 0;
+  uint32_t bit = 1UL << 30;
+  while (bit > rest) {
+    bit >>= 2;
+  }
+  while (bit != 0) {
+    if (rest >= root + bit) {
+      rest -= root + bit;
+      root = (root >> 1) + bit;
+    } else {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+  return rest > root ? root + 1 : root;
+}
+
+// r / d con `bits` bits fraccionarios (r < d), por división con restauración:
+// solo desplazamientos y restas, sin la división de 32 bits de la libc.
+static uint32_t fxDiv(uint32_t r, uint32_t d, byte bits) {
+  uint32_t q = 0;
+  for (byte i = 0; i < bits; i++) {
+    r <<= 1;
+    q <<= 1;
+    if (r >= d) {
+      r -= d;
+      q |= 1;
+    }
+  }
+  return q;
+}
+
+// Interpolación lineal en una tabla de paso 1/128 (x en Q14)
+static int32_t lookup(const uint16_t* table, byte last, uint32_t x) {
+  byte i = x >> 7;
+  if (i >= last) {
+    return pgm_read_word(&table[last]);
+  }
+  int32_t a = pgm_read_word(&table[i]);
+  int32_t b = pgm_read_word(&table[i + 1]);
+  return a + (((b - a) * (int32_t)(x & 127)) >> 7);
+}
+
+// acos(num / den) en Q15, para los cocientes de la ley de cosenos. Para
+// |num / den| > 0.5 se usa acos(c) = 2 asin(sqrt((1 - c) / 2)), con
+// (1 - c) / 2 calculado en 28 bits: acos tiene pendiente infinita en ±1.
+// Un cociente fuera de [-1, 1] (punto inalcanzable) se satura.
+static int32_t acosRatio(int32_t num, int32_t den) {
+  bool neg = num < 0;
+  uint32_t a = neg ? -num : num;
+  int32_t r;
+  if (den <= 0 || a >= (uint32_t)den) {
+    r = 0;
+  } else if (2 * a <= (uint32_t)den) {
+    r = FX_HALF_PI - lookup(ASIN_TABLE, 64, fxDiv(a, den, FX_RATIO_BITS));
+  } else {
+    r = 2 * lookup(ASIN_TABLE, 64, isqrt32(fxDiv(den - a, 2 * (uint32_t)den, 2 * FX_RATIO_BITS)));
+  }
+  return neg ? FX_PI - r : r;
+}
+
+// atan2(y, x) en Q15. Reemplaza a asin/acos de catetos sobre hipotenusa,
+// que pierden precisión cuando el ángulo se acerca a 0 o a ±PI/2.
+static int32_t atan2Fixed(int32_t y, int32_t x) {
+  uint32_t ay = y < 0 ? -y : y;
+  uint32_t ax = x < 0 ? -x : x;
+  int32_t r;
+  if (ay == ax) {
+    r = ax == 0 ? 0 : FX_PI / 4;
+  } else if (ay < ax) {
+    r = lookup(ATAN_TABLE, 128, fxDiv(ay, ax, FX_RATIO_BITS));
+  } else {
+    r = FX_HALF_PI - lookup(ATAN_TABLE, 128, fxDiv(ax, ay, FX_RATIO_BITS));
+  }
+  if (x < 0) {
+    r = FX_PI - r;
+  }
+  return y < 0 ? -r : r;
+}
+#endif
+
 RobotGeometry::RobotGeometry(float a_ee_offset, float a_low_shank_length, float a_high_shank_length) {
   ee_offset = a_ee_offset;
   low_shank_length = a_low_shank_length;
@@ -41,6 +172,35 @@ float RobotGeometry::getHighRad() const {
 }
 
 void RobotGeometry::calculateGrad() {
+#if FIXED_POINT_IK
+   int32_t x = toFixedMm(xmm);
+   int32_t y = toFixedMm(ymm);
+   int32_t z = toFixedMm(zmm);
+   int32_t lowLen = toFixedMm(low_shank_length);
+   int32_t highLen = toFixedMm(high_shank_length);
+
+   int32_t rrot_ee = isqrt32((uint32_t)(x * x) + (uint32_t)(y * y));
+   int32_t rrot = rrot_ee - toFixedMm(ee_offset); //radius from Top View
+   int32_t rside_2 = rrot * rrot + z * z;
+   int32_t rside = isqrt32(rside_2);  //radius from Side View
+   int32_t low_2 = lowLen * lowLen;
+   int32_t high_2 = highLen * highLen;
+
+   // asin(x / rrot_ee), acos(z / rside) y asin(rrot / rside) como atan2
+   int32_t rotQ = atan2Fixed(x, y < 0 ? -y : y);
+   int32_t highQ = FX_PI - acosRatio(low_2 + high_2 - rside_2, 2 * lowLen * highLen);
+   int32_t lowInner = acosRatio(low_2 - high_2 + rside_2, 2 * lowLen * rside);
+   int32_t lowQ;
+   if (z > 0) {
+     lowQ = atan2Fixed(rrot < 0 ? -rrot : rrot, z) - lowInner;
+   } else {
+     lowQ = FX_PI - atan2Fixed(rrot, -z) - lowInner;
+   }
+
+   rot = rotQ / FX_ANGLE_ONE;
+   low = lowQ / FX_ANGLE_ONE;
+   high = (highQ + lowQ) / FX_ANGLE_ONE;
+#else
    float rrot_ee =  hypot(xmm, ymm);    
    float rrot = rrot_ee - ee_offset; //radius from Top View
    float rside = hypot(rrot, zmm);  //radius from Side View. Use rrot instead of ymm..for everything
@@ -58,4 +218,5 @@ void RobotGeometry::calculateGrad() {
      low = PI - asin(rrot / rside) - acos((low_2 - high_2 + rside_2) / (2 * low_shank_length * rside));
    }
    high = high + low;
+#endif
 }
@@ -0,0 +1,67 @@
+#include "stepGenerator.h"
+
+StepGenerator::StepGenerator(RampsStepper* aRotate, RampsStepper* aLower, RampsStepper* aHigher, RampsStepper* aRail) {
+  steppers[0] = aRotate;
+  steppers[1] = aLower;
+  steppers[2] = aHigher;
+  steppers[3] = aRail;
+  for (int i = 0; i < STEP_GEN_AXES; i++) {
+    delta[i] = 0;
+    error[i] = 0;
+    forward[i] = true;
+  }
+  events = 0;
+  eventsDone = 0;
+  segmentStart = 0;
+  segmentDuration = 0;
+}
+
+void StepGenerator::setSegment(const long targets[STEP_GEN_AXES], unsigned long durationUs) {
+  events = 0;
+  for (int i = 0; i < STEP_GEN_AXES; i++) {
+    long d = targets[i] - steppers[i]->getPosition();
+    forward[i] = d >= 0;
+    delta[i] = forward[i] ? d : -d;
+    if (delta[i] > events) {
+      events = delta[i];
+    }
+  }
+  // Arrancar los acumuladores a mitad de rango reparte los pasos de los ejes
+  // lentos de forma simétrica dentro del subsegmento
+  for (int i = 0; i < STEP_GEN_AXES; i++) {
+    error[i] = events / 2;
+  }
+  eventsDone = 0;
+  segmentStart = micros();
+  segmentDuration = durationUs;
+}
+
+bool StepGenerator::update() {
+  if (eventsDone >= events) {
+    return true;
+  }
+
+  // Eventos que ya deberían haberse emitido según el tiempo transcurrido.
+  // events * elapsed entra en 32 bits para subsegmentos de algunos ms.
+  long due = events;
+  unsigned long elapsed = micros() - segmentStart;
+  if (elapsed < segmentDuration) {
+    due = (long)((unsigned long)events * elapsed / segmentDuration);
+  }
+
+  while (eventsDone < due) {
+    for (int i = 0; i < STEP_GEN_AXES; i++) {
+      error[i] += delta[i];
+      if (error[i] >= events) {
+        error[i] -= events;
+        steppers[i]->stepOnce(forward[i]);
+      }
+    }
+    eventsDone++;
+  }
+  return eventsDone >= events;
+}
+
+bool StepGenerator::isIdle() const {
+  return eventsDone >= events;
+}
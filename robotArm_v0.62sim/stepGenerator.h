@@ -0,0 +1,33 @@
+#ifndef STEPGENERATOR_H_
+#define STEPGENERATOR_H_
+
+#include <Arduino.h>
+#include "RampsStepper.h"
+
+#define STEP_GEN_AXES 4 // ROTATE, LOWER, HIGHER, RAIL
+
+// Generador de pasos por subsegmentos. La cinemática inversa se resuelve
+// solo en los bordes de cada subsegmento (setSegment); entre bordes los
+// pasos de todos los ejes salen de un DDA entero (Bresenham) coordinado
+// con el eje dominante y repartido en el tiempo del subsegmento.
+class StepGenerator {
+public:
+  StepGenerator(RampsStepper* aRotate, RampsStepper* aLower, RampsStepper* aHigher, RampsStepper* aRail);
+  // Objetivos absolutos en pasos de cada eje y duración del subsegmento (us)
+  void setSegment(const long targets[STEP_GEN_AXES], unsigned long durationUs);
+  // Emite los pasos que ya correspondan; true cuando el subsegmento terminó
+  bool update();
+  bool isIdle() const;
+
+private:
+  RampsStepper* steppers[STEP_GEN_AXES];
+  long delta[STEP_GEN_AXES];     // pasos a dar en el subsegmento (valor absoluto)
+  long error[STEP_GEN_AXES];     // acumulador del DDA
+  bool forward[STEP_GEN_AXES];
+  long events;                   // pasos del eje dominante
+  long eventsDone;
+  unsigned long segmentStart;
+  unsigned long segmentDuration;
+};
+
+#endif
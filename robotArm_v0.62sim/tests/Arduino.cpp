@@ -0,0 +1,79 @@
+#include "Arduino.h"
+
+#include <stdio.h>
+
+SerialShim Serial;
+
+static unsigned long relojMicros = 0;
+
+unsigned long micros() {
+  return relojMicros;
+}
+
+unsigned long millis() {
+  return relojMicros / 1000;
+}
+
+void delay(unsigned long ms) {
+  relojMicros += ms * 1000;
+}
+
+void shimFijarMicros(unsigned long us) {
+  relojMicros = us;
+}
+
+void shimAvanzarMicros(unsigned long us) {
+  relojMicros += us;
+}
+
+SerialShim::SerialShim() {
+  salida.reserve(4096);
+}
+
+int SerialShim::read() {
+  if (leidos >= entrada.size()) {
+    return -1;
+  }
+  return (unsigned char)entrada[leidos++];
+}
+
+void SerialShim::recibir(const char* texto) {
+  // Lo ya consumido se descarta para que la entrada no crezca sin límite
+  entrada.erase(0, leidos);
+  leidos = 0;
+  entrada += texto;
+}
+
+// clear() conserva la capacidad: imprimir no reserva memoria mientras la
+// salida no supere lo ya reservado (ver el test de memoria de Command)
+std::string SerialShim::tomarSalida() {
+  std::string texto = salida;
+  salida.clear();
+  return texto;
+}
+
+void SerialShim::print(const char* text) {
+  salida += text;
+}
+
+void SerialShim::print(char c) {
+  salida += c;
+}
+
+void SerialShim::print(long value) {
+  char buffer[24];
+  snprintf(buffer, sizeof(buffer), "%ld", value);
+  salida += buffer;
+}
+
+void SerialShim::print(unsigned long value) {
+  char buffer[24];
+  snprintf(buffer, sizeof(buffer), "%lu", value);
+  salida += buffer;
+}
+
+void SerialShim::print(double value, int digits) {
+  char buffer[48];
+  snprintf(buffer, sizeof(buffer), "%.*f", digits, value);
+  salida += buffer;
+}
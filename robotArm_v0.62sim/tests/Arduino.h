@@ -0,0 +1,82 @@
+#ifndef ARDUINO_H_SHIM_
+#define ARDUINO_H_SHIM_
+
+// Sustituto mínimo de Arduino.h para compilar en el host las partes del
+// firmware que no tocan hardware (cola, generador de pasos, IK, parser).
+// Solo declara lo que esas unidades usan; no es una emulación de la placa.
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <string>
+
+typedef uint8_t byte;
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+
+#ifndef PI
+#define PI 3.1415926535897932384626433832795
+#endif
+#define sq(x) ((x) * (x))
+
+// Flash: en el host las tablas PROGMEM son memoria normal
+#define PROGMEM
+#define pgm_read_byte(addr) (*(const uint8_t*)(addr))
+#define pgm_read_word(addr) (*(const uint16_t*)(addr))
+
+class __FlashStringHelper;
+#define F(text) (reinterpret_cast<const __FlashStringHelper*>(text))
+
+inline bool isDigit(int c) { return isdigit(c) != 0; }
+inline bool isAlpha(int c) { return isalpha(c) != 0; }
+
+// Reloj simulado: los tests lo avanzan a mano (shimAvanzarMicros)
+unsigned long micros();
+unsigned long millis();
+void delay(unsigned long ms);
+void shimFijarMicros(unsigned long us);
+void shimAvanzarMicros(unsigned long us);
+
+inline void pinMode(int, int) {}
+inline void digitalWrite(int, int) {}
+inline int digitalRead(int) { return LOW; }
+
+// Puerto serie en memoria: lo que se escribe queda en `salida` y read()
+// consume lo cargado con recibir()
+class SerialShim {
+public:
+  SerialShim();
+  void begin(unsigned long) {}
+  int available() const { return (int)(entrada.size() - leidos); }
+  int read();
+  void recibir(const char* texto);
+  std::string tomarSalida();
+
+  void print(const char* text);
+  void print(const __FlashStringHelper* text) { print(reinterpret_cast<const char*>(text)); }
+  void print(char c);
+  void print(unsigned char value) { print((unsigned long)value); }
+  void print(int value) { print((long)value); }
+  void print(unsigned int value) { print((unsigned long)value); }
+  void print(long value);
+  void print(unsigned long value);
+  void print(double value, int digits = 2);
+
+  template <typename T> void println(T value) { print(value); println(); }
+  void println(double value, int digits) { print(value, digits); println(); }
+  void println() { print("\r\n"); }
+
+private:
+  std::string entrada;
+  size_t leidos = 0;
+  std::string salida;
+};
+
+extern SerialShim Serial;
+
+#endif
@@ -0,0 +1,70 @@
+// Benchmark de la cinemática inversa: RobotGeometry::set() en punto fijo
+// (FIXED_POINT_IK) contra la versión float, sobre puntos del área de trabajo.
+//
+// Uso:
+//   make bench-ik
+//   ./bin/bench_ik [vueltas]   (por defecto, 20)
+//
+// Muestra ns por llamada en el host, donde la FPU hace que float gane. No
+// dice nada del AVR: por eso FIXED_POINT_IK queda en false hasta medirlo en
+// la placa.
+
+#include "Arduino.h"
+#include "config.h"
+#include "robotGeometryFloat.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+struct Punto {
+  float x, y, z;
+};
+
+static std::vector<Punto> puntosDelArea() {
+  std::vector<Punto> puntos;
+  const float alcance = R_MAX + END_EFFECTOR_OFFSET;
+  for (float x = -alcance; x <= alcance; x += 10) {
+    for (float y = -alcance; y <= alcance; y += 10) {
+      for (float z = Z_MIN; z <= Z_MAX; z += 10) {
+        float rrot_ee = hypot(x, y);
+        float modulo2 = sq(rrot_ee - END_EFFECTOR_OFFSET) + sq(z);
+        if (rrot_ee > 0 && modulo2 <= sq(R_MAX) && modulo2 >= sq(R_MIN)) {
+          puntos.push_back({x, y, z});
+        }
+      }
+    }
+  }
+  return puntos;
+}
+
+template <typename Geometria>
+static void medir(const char* nombre, const std::vector<Punto>& puntos, int vueltas) {
+  Geometria geometria(END_EFFECTOR_OFFSET, LOW_SHANK_LENGTH, HIGH_SHANK_LENGTH);
+  volatile float suma = 0;
+  const long llamadas = (long)puntos.size() * vueltas;
+
+  const auto t0 = std::chrono::steady_clock::now();
+  for (int v = 0; v < vueltas; v++) {
+    for (const Punto& p : puntos) {
+      geometria.set(p.x, p.y, p.z);
+      suma = suma + geometria.getRotRad() + geometria.getLowRad() + geometria.getHighRad();
+    }
+  }
+  const double segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+  printf("%-12s %10ld %12.1f\n", nombre, llamadas, segundos * 1e9 / llamadas);
+}
+
+int main(int argc, char** argv) {
+  int vueltas = argc > 1 ? atoi(argv[1]) : 20;
+  std::vector<Punto> puntos = puntosDelArea();
+
+  printf("%zu puntos del área de trabajo (grilla de 10 mm), %d vueltas\n\n", puntos.size(), vueltas);
+  printf("%-12s %10s %12s\n", "ik", "llamadas", "ns/llamada");
+
+  medir<RobotGeometryFloat>("float", puntos, vueltas);
+  medir<RobotGeometry>("punto_fijo", puntos, vueltas);
+  return 0;
+}
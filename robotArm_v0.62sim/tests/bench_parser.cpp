@@ -0,0 +1,110 @@
+// Benchmark del parser de G-code del firmware (Command::handleGcode y
+// Command::processMessage) con el Serial en memoria del sustituto de Arduino.
+//
+// Uso:
+//   make bench-parser
+//   ./bin/bench_parser [lineas]   (por defecto, 200000)
+//
+// Mide líneas/s del camino completo de recepción (byte a byte desde Serial,
+// con y sin marco "N<linea> ...*<checksum>") y de processMessage sobre un
+// buffer ya armado. Es tiempo de CPU del host: sirve para comparar cambios
+// del parser, no como tasa en el AVR (donde además manda el baudrate).
+
+#include "Arduino.h"
+#include "command.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+static const char* const LINEAS[] = {
+  "G1 X12.345 Y-67.89 Z100.5 F3000",
+  "G0 X0 Y170 Z120",
+  "G1 X-45.5 Y150.25 Z80 E12.5",
+  "M114",
+  "G2 X10 Y160 I5 J-2.5 F1200",
+};
+static const int NUM_LINEAS = sizeof(LINEAS) / sizeof(LINEAS[0]);
+
+static std::string enmarcar(long linea, const char* comando) {
+  char cuerpo[128];
+  snprintf(cuerpo, sizeof(cuerpo), "N%ld %s", linea, comando);
+  byte suma = 0;
+  for (const char* c = cuerpo; *c != '\0'; c++) {
+    suma ^= *c;
+  }
+  char trama[160];
+  snprintf(trama, sizeof(trama), "%s*%u\r", cuerpo, suma);
+  return trama;
+}
+
+static void mostrar(const char* nombre, long lineas, size_t bytes, double segundos) {
+  printf("%-20s %10ld %14.0f %12.1f %12.1f\n", nombre, lineas, lineas / segundos,
+         segundos * 1e9 / lineas, bytes / segundos / 1e6);
+}
+
+static void medirRecepcion(const char* nombre, long lineas, bool conMarco) {
+  std::string entrada;
+  if (conMarco) {
+    entrada += enmarcar(0, "M110");
+  }
+  for (long i = 0; i < lineas; i++) {
+    if (conMarco) {
+      entrada += enmarcar(i + 1, LINEAS[i % NUM_LINEAS]);
+    } else {
+      entrada += LINEAS[i % NUM_LINEAS];
+      entrada += '\r';
+    }
+  }
+
+  Command command;
+  Serial.recibir(entrada.c_str());
+  long comandos = 0;
+  const auto t0 = std::chrono::steady_clock::now();
+  while (Serial.available()) {
+    if (command.handleGcode()) {
+      comandos++;
+    }
+  }
+  const double segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  Serial.tomarSalida();
+
+  if (comandos != lineas) {
+    printf("%s: se esperaban %ld comandos y llegaron %ld\n", nombre, lineas, comandos);
+    exit(1);
+  }
+  mostrar(nombre, lineas, entrada.size(), segundos);
+}
+
+static void medirProcessMessage(long lineas) {
+  Command command;
+  char buffer[MAX_LINE_LENGTH + 1];
+  size_t bytes = 0;
+  volatile float suma = 0;
+  const auto t0 = std::chrono::steady_clock::now();
+  for (long i = 0; i < lineas; i++) {
+    // processMessage modifica el buffer (mayúsculas), así que se copia cada vez
+    const char* linea = LINEAS[i % NUM_LINEAS];
+    size_t largo = strlen(linea);
+    memcpy(buffer, linea, largo + 1);
+    bytes += largo;
+    command.processMessage(buffer);
+    suma = suma + command.getCmd().valueX;
+  }
+  const double segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  mostrar("processMessage", lineas, bytes, segundos);
+}
+
+int main(int argc, char** argv) {
+  long lineas = argc > 1 ? atol(argv[1]) : 200000;
+
+  printf("%ld líneas de G-code (%d modelos alternados)\n\n", lineas, NUM_LINEAS);
+  printf("%-20s %10s %14s %12s %12s\n", "camino", "lineas", "lineas/s", "ns/linea", "MB/s");
+  medirRecepcion("handleGcode", lineas, false);
+#if LINE_CHECKSUM
+  medirRecepcion("handleGcode+marco", lineas, true);
+#endif
+  medirProcessMessage(lineas);
+  return 0;
+}
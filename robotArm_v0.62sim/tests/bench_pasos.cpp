@@ -0,0 +1,176 @@
+// Benchmark de tasa de pasos: lazo anterior (IK en cada vuelta de loop())
+// contra el generador DDA (IK solo en los bordes de subsegmento).
+//
+// Uso:
+//   make bench-pasos
+//   ./bin/bench_pasos [repeticiones]   (por defecto, 20)
+//
+// Los dos lazos reproducen el cuerpo de loop() en robotArm_v0.62sim.ino
+// (ramas STEP_GENERATOR false y true) sobre la misma recta del área de
+// trabajo. El lazo anterior tiene que dar una vuelta por paso del eje
+// dominante para no agrupar pasos; el DDA avanza el reloj simulado lo justo
+// para emitir un evento por update(). La tasa es pasos / tiempo de CPU del
+// host: sirve para comparar los lazos, no como tasa absoluta en el AVR.
+
+#include "Arduino.h"
+#include "config.h"
+#include "robotGeometry.h"
+#include "stepGenerator.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+struct Punto {
+  float x, y, z;
+};
+
+static const Punto DESDE = {0, HIGH_SHANK_LENGTH + END_EFFECTOR_OFFSET, LOW_SHANK_LENGTH};
+static const Punto HASTA = {80, 130, 40};
+static const int PASOS_POR_SUBSEGMENTO = 20;   // del eje dominante
+
+static Punto interpolar(float t, bool ida) {
+  const Punto& a = ida ? DESDE : HASTA;
+  const Punto& b = ida ? HASTA : DESDE;
+  return {a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, a.z + (b.z - a.z) * t};
+}
+
+struct Brazo {
+  RampsStepper rotate{0, 0, 0, false};
+  RampsStepper lower{0, 0, 0, false};
+  RampsStepper higher{0, 0, 0, false};
+  RampsStepper rail{0, 0, 0, false};
+  RobotGeometry geometry{END_EFFECTOR_OFFSET, LOW_SHANK_LENGTH, HIGH_SHANK_LENGTH};
+
+  void objetivos(const Punto& p, long destino[STEP_GEN_AXES]) {
+    geometry.set(p.x, p.y, p.z);
+    destino[0] = rotate.radToSteps(geometry.getRotRad());
+    destino[1] = lower.radToSteps(geometry.getLowRad());
+    destino[2] = higher.radToSteps(geometry.getHighRad());
+    destino[3] = rail.getPosition();
+  }
+
+  void ubicar(const Punto& p) {
+    long destino[STEP_GEN_AXES];
+    objetivos(p, destino);
+    rotate.setPosition(destino[0]);
+    lower.setPosition(destino[1]);
+    higher.setPosition(destino[2]);
+  }
+
+  // Pasos dados desde la posición guardada en `antes`, que se actualiza
+  long pasosDesde(long antes[3]) const {
+    const long ahora[3] = {rotate.getPosition(), lower.getPosition(), higher.getPosition()};
+    long pasos = 0;
+    for (int i = 0; i < 3; i++) {
+      pasos += labs(ahora[i] - antes[i]);
+      antes[i] = ahora[i];
+    }
+    return pasos;
+  }
+};
+
+// Pasos del eje dominante en la recta: define la resolución de ambos lazos
+static long pasosDominantes() {
+  Brazo brazo;
+  long a[STEP_GEN_AXES];
+  long b[STEP_GEN_AXES];
+  brazo.objetivos(DESDE, a);
+  brazo.objetivos(HASTA, b);
+  long dominante = 0;
+  for (int i = 0; i < STEP_GEN_AXES; i++) {
+    dominante = labs(b[i] - a[i]) > dominante ? labs(b[i] - a[i]) : dominante;
+  }
+  return dominante;
+}
+
+struct Resultado {
+  double segundos = 0;
+  long pasos = 0;
+  long vueltas = 0;   // vueltas de loop() (o update() del DDA)
+  long ik = 0;
+};
+
+// STEP_GENERATOR false: IK y stepToPositionRad en cada vuelta
+static Resultado lazoAnterior(int repeticiones, long vueltasPorTramo) {
+  Brazo brazo;
+  brazo.ubicar(DESDE);
+  Resultado r;
+  long pasos = 0;
+  long posiciones[3] = {brazo.rotate.getPosition(), brazo.lower.getPosition(), brazo.higher.getPosition()};
+  const auto t0 = std::chrono::steady_clock::now();
+  for (int rep = 0; rep < repeticiones; rep++) {
+    bool ida = rep % 2 == 0;
+    for (long k = 1; k <= vueltasPorTramo; k++) {
+      Punto p = interpolar((float)k / vueltasPorTramo, ida);
+      brazo.geometry.set(p.x, p.y, p.z);
+      brazo.rotate.stepToPositionRad(brazo.geometry.getRotRad());
+      brazo.lower.stepToPositionRad(brazo.geometry.getLowRad());
+      brazo.higher.stepToPositionRad(brazo.geometry.getHighRad());
+      brazo.rotate.update();
+      brazo.lower.update();
+      brazo.higher.update();
+      pasos += brazo.pasosDesde(posiciones);
+      r.ik++;
+      r.vueltas++;
+    }
+  }
+  r.segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  r.pasos = pasos;
+  return r;
+}
+
+// STEP_GENERATOR true: IK por subsegmento y pasos del DDA entre bordes
+static Resultado lazoDDA(int repeticiones, long pasosPorTramo) {
+  Brazo brazo;
+  brazo.ubicar(DESDE);
+  StepGenerator generador(&brazo.rotate, &brazo.lower, &brazo.higher, &brazo.rail);
+  const long subsegmentos = (pasosPorTramo + PASOS_POR_SUBSEGMENTO - 1) / PASOS_POR_SUBSEGMENTO;
+  const unsigned long tickUs = STEP_SEGMENT_US / PASOS_POR_SUBSEGMENTO;
+  shimFijarMicros(0);
+
+  Resultado r;
+  long pasos = 0;
+  long posiciones[3] = {brazo.rotate.getPosition(), brazo.lower.getPosition(), brazo.higher.getPosition()};
+  const auto t0 = std::chrono::steady_clock::now();
+  for (int rep = 0; rep < repeticiones; rep++) {
+    bool ida = rep % 2 == 0;
+    for (long s = 1; s <= subsegmentos; s++) {
+      long destino[STEP_GEN_AXES];
+      brazo.objetivos(interpolar((float)s / subsegmentos, ida), destino);
+      generador.setSegment(destino, STEP_SEGMENT_US);
+      r.ik++;
+      do {
+        shimAvanzarMicros(tickUs);
+        r.vueltas++;
+      } while (!generador.update());
+      pasos += brazo.pasosDesde(posiciones);
+    }
+  }
+  r.segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  r.pasos = pasos;
+  return r;
+}
+
+static void mostrar(const char* nombre, const Resultado& r) {
+  printf("%-16s %10ld %10ld %10ld %12.1f %14.0f\n", nombre, r.vueltas, r.ik, r.pasos,
+         r.segundos * 1e9 / r.vueltas, r.pasos / r.segundos);
+}
+
+int main(int argc, char** argv) {
+  int repeticiones = argc > 1 ? atoi(argv[1]) : 20;
+  long dominantes = pasosDominantes();
+
+  printf("Recta (%.0f, %.0f, %.0f) -> (%.0f, %.0f, %.0f), %ld pasos del eje dominante, %d repeticiones\n",
+         DESDE.x, DESDE.y, DESDE.z, HASTA.x, HASTA.y, HASTA.z, dominantes, repeticiones);
+  printf("IK: %s\n\n", FIXED_POINT_IK ? "punto fijo (FIXED_POINT_IK)" : "float");
+  printf("%-16s %10s %10s %10s %12s %14s\n", "lazo", "vueltas", "ik", "pasos", "ns/vuelta", "pasos/s");
+
+  Resultado anterior = lazoAnterior(repeticiones, dominantes);
+  Resultado dda = lazoDDA(repeticiones, dominantes);
+  mostrar("ik_por_vuelta", anterior);
+  mostrar("dda", dda);
+  printf("\nTasa de pasos DDA / anterior: %.1fx\n",
+         (dda.pasos / dda.segundos) / (anterior.pasos / anterior.segundos));
+  return 0;
+}
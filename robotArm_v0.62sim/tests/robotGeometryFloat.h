@@ -0,0 +1,14 @@
+#ifndef ROBOTGEOMETRYFLOAT_H_
+#define ROBOTGEOMETRYFLOAT_H_
+
+// Las dos variantes de la IK en el mismo binario: robotGeometry.cpp se
+// compila una segunda vez con FIXED_POINT_IK=false y la clase renombrada a
+// RobotGeometryFloat (ver robotGeometry_float.o en el Makefile).
+#include "robotGeometry.h"
+
+#define RobotGeometry RobotGeometryFloat
+#undef ROBOTGEOMETRY_H_
+#include "robotGeometry.h"
+#undef RobotGeometry
+
+#endif
@@ -0,0 +1,169 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "command.h"
+
+#include <stdio.h>
+
+// Memoria dinámica: el binario se enlaza con -Wl,--wrap para malloc, calloc,
+// realloc y operator new, así que toda reserva de los objetos del firmware
+// (y del test) pasa por estos contadores.
+static bool contando = false;
+static long reservas = 0;
+
+extern "C" {
+void* __real_malloc(size_t n);
+void* __real_calloc(size_t n, size_t m);
+void* __real_realloc(void* p, size_t n);
+void* __real__Znwm(size_t n);
+void* __real__Znam(size_t n);
+
+void* __wrap_malloc(size_t n) {
+  if (contando) reservas++;
+  return __real_malloc(n);
+}
+void* __wrap_calloc(size_t n, size_t m) {
+  if (contando) reservas++;
+  return __real_calloc(n, m);
+}
+void* __wrap_realloc(void* p, size_t n) {
+  if (contando) reservas++;
+  return __real_realloc(p, n);
+}
+void* __wrap__Znwm(size_t n) {
+  if (contando) reservas++;
+  return __real__Znwm(n);
+}
+void* __wrap__Znam(size_t n) {
+  if (contando) reservas++;
+  return __real__Znam(n);
+}
+}
+
+// "N<linea> <comando>*<checksum>\r", como SerialCom::frameLine en el servidor
+static std::string enmarcar(long linea, const char* comando) {
+  char cuerpo[128];
+  snprintf(cuerpo, sizeof(cuerpo), "N%ld %s", linea, comando);
+  byte suma = 0;
+  for (const char* c = cuerpo; *c != '\0'; c++) {
+    suma ^= *c;
+  }
+  char trama[160];
+  snprintf(trama, sizeof(trama), "%s*%u\r", cuerpo, suma);
+  return trama;
+}
+
+// Procesa todo lo recibido; devuelve cuántas líneas llegaron como comando
+static int procesarEntrada(Command& command) {
+  int comandos = 0;
+  while (Serial.available()) {
+    if (command.handleGcode()) {
+      comandos++;
+    }
+  }
+  return comandos;
+}
+
+TEST_SUITE("Command") {
+
+  TEST_CASE("Campos de una línea sin marco") {
+    Command command;
+    Serial.tomarSalida();
+    Serial.recibir("g1 x12.5 Y-3 z.25 F1500 e7\r\n");
+    REQUIRE(procesarEntrada(command) == 1);
+
+    Cmd cmd = command.getCmd();
+    CHECK(cmd.id == 'G');
+    CHECK(cmd.num == 1);
+    CHECK(cmd.valueX == doctest::Approx(12.5));
+    CHECK(cmd.valueY == doctest::Approx(-3));
+    CHECK(cmd.valueZ == doctest::Approx(0.25));
+    CHECK(cmd.valueF == doctest::Approx(1500));
+    CHECK(cmd.valueE == doctest::Approx(7));
+    CHECK(isnan(cmd.valueI));
+    CHECK(Serial.tomarSalida().empty());
+  }
+
+#if LINE_CHECKSUM
+  TEST_CASE("Marco con número de línea y checksum") {
+    Command command;
+    Serial.tomarSalida();
+
+    Serial.recibir(enmarcar(0, "M110").c_str());
+    CHECK(procesarEntrada(command) == 0);
+    CHECK(Serial.tomarSalida() == "OK\r\n");
+
+    Serial.recibir(enmarcar(1, "G1 X5").c_str());
+    CHECK(procesarEntrada(command) == 1);
+    CHECK(command.getCmd().valueX == doctest::Approx(5));
+
+    // Duplicada: OK sin ejecutar; salto de línea o checksum dañado: RS
+    Serial.recibir(enmarcar(1, "G1 X5").c_str());
+    CHECK(procesarEntrada(command) == 0);
+    CHECK(Serial.tomarSalida() == "OK\r\n");
+    Serial.recibir(enmarcar(3, "G1 X7").c_str());
+    CHECK(procesarEntrada(command) == 0);
+    CHECK(Serial.tomarSalida() == "RS 2\r\n");
+    Serial.recibir("N2 G1 X6*0\r");
+    CHECK(procesarEntrada(command) == 0);
+    CHECK(Serial.tomarSalida() == "RS 2\r\n");
+  }
+#endif
+
+  TEST_CASE("Línea más larga que el buffer: rechazada entera") {
+    Command command;
+    Serial.tomarSalida();
+    std::string larga = "G1 X1";
+    larga.append(MAX_LINE_LENGTH, ' ');
+    larga += "Y2\r";
+    Serial.recibir(larga.c_str());
+    CHECK(procesarEntrada(command) == 0);
+    CHECK(Serial.tomarSalida() == "E50\r\nOK\r\n");
+
+    // La siguiente línea se procesa normalmente
+    Serial.recibir("G0 Z3\r");
+    CHECK(procesarEntrada(command) == 1);
+    CHECK(command.getCmd().valueZ == doctest::Approx(3));
+  }
+
+  TEST_CASE("Sin memoria dinámica en handleGcode y processMessage") {
+    Command command;
+    Serial.tomarSalida();
+
+    // Toda la entrada se carga antes de empezar a contar
+    std::string entrada;
+#if LINE_CHECKSUM
+    entrada += enmarcar(0, "M110");
+    for (long linea = 1; linea <= 200; linea++) {
+      entrada += enmarcar(linea, linea % 2 ? "G1 X10.5 Y-20.25 Z30 F3000" : "M114");
+    }
+    entrada += enmarcar(200, "M114");        // duplicada
+    entrada += enmarcar(205, "G1 X1");       // fuera de orden
+#else
+    for (int i = 0; i < 200; i++) {
+      entrada += "G1 X10.5 Y-20.25 Z30 F3000\r";
+    }
+#endif
+    entrada += "X10\r";                      // no reconocido
+    Serial.recibir(entrada.c_str());
+
+    // Control: los contadores sí ven una reserva hecha en este objeto
+    reservas = 0;
+    contando = true;
+    std::string* control = new std::string(64, 'x');
+    contando = false;
+    delete control;
+    CHECK(reservas >= 1);
+
+    char mensaje[] = "G2 X10 Y10 I5 J0 F1200";
+    reservas = 0;
+    contando = true;
+    int comandos = procesarEntrada(command);
+    bool procesado = command.processMessage(mensaje);
+    contando = false;
+
+    CHECK(comandos == 200);
+    CHECK(procesado);
+    CHECK(reservas == 0);
+    CHECK_FALSE(Serial.tomarSalida().empty());
+  }
+}
@@ -0,0 +1,71 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "Arduino.h"
+#include "config.h"
+#include "robotGeometryFloat.h"
+
+#include <algorithm>
+#include <vector>
+
+// Error máximo de la IK en punto fijo contra la de float, en radianes
+// (unos 0.65 pasos de motor con MICROSTEPS 16 y la reducción 32:9)
+static const double MAX_ERROR_RAD = 3.6e-4;
+
+// Mismo criterio que Interpolation al validar un destino
+static bool alcanzable(float x, float y, float z) {
+  float rrot_ee = hypot(x, y);
+  if (rrot_ee == 0) {
+    return false;
+  }
+  float rrot = rrot_ee - END_EFFECTOR_OFFSET;
+  float modulo2 = sq(rrot) + sq(z);
+  return modulo2 <= sq(R_MAX) && modulo2 >= sq(R_MIN) && z >= Z_MIN && z <= Z_MAX;
+}
+
+TEST_SUITE("RobotGeometry") {
+
+  TEST_CASE("Punto fijo contra float en una grilla del área de trabajo") {
+    RobotGeometry fija(END_EFFECTOR_OFFSET, LOW_SHANK_LENGTH, HIGH_SHANK_LENGTH);
+    RobotGeometryFloat referencia(END_EFFECTOR_OFFSET, LOW_SHANK_LENGTH, HIGH_SHANK_LENGTH);
+    const float alcance = R_MAX + END_EFFECTOR_OFFSET;
+
+    std::vector<double> errores;
+    double peor = 0;
+    float peorX = 0, peorY = 0, peorZ = 0;
+    for (float x = -alcance; x <= alcance; x += 5) {
+      for (float y = -alcance; y <= alcance; y += 5) {
+        for (float z = Z_MIN; z <= Z_MAX; z += 5) {
+          if (!alcanzable(x, y, z)) {
+            continue;
+          }
+          fija.set(x, y, z);
+          referencia.set(x, y, z);
+          double error = std::max({fabs(fija.getRotRad() - referencia.getRotRad()),
+                                   fabs(fija.getLowRad() - referencia.getLowRad()),
+                                   fabs(fija.getHighRad() - referencia.getHighRad())});
+          errores.push_back(error);
+          if (error > peor) {
+            peor = error;
+            peorX = x;
+            peorY = y;
+            peorZ = z;
+          }
+        }
+      }
+    }
+
+    REQUIRE(errores.size() > 100000);
+    std::nth_element(errores.begin(), errores.begin() + errores.size() / 2, errores.end());
+    MESSAGE(errores.size() << " puntos, error máximo " << peor << " rad en (" << peorX << ", "
+            << peorY << ", " << peorZ << "), mediana " << errores[errores.size() / 2] << " rad");
+    CHECK(peor <= MAX_ERROR_RAD);
+  }
+
+  TEST_CASE("Posición inicial: brazo inferior vertical y superior horizontal") {
+    RobotGeometry fija(END_EFFECTOR_OFFSET, LOW_SHANK_LENGTH, HIGH_SHANK_LENGTH);
+    fija.set(INITIAL_X, INITIAL_Y, INITIAL_Z);
+    CHECK(fabs(fija.getRotRad()) <= MAX_ERROR_RAD);
+    CHECK(fabs(fija.getLowRad()) <= MAX_ERROR_RAD);
+    CHECK(fabs(fija.getHighRad() - PI / 2) <= MAX_ERROR_RAD);
+  }
+}
@@ -0,0 +1,153 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "queue.h"
+#include "commandQueue.h"
+
+static Cmd comando(char id, int num, float x, float y, float z, float f) {
+  Cmd cmd;
+  cmd.id = id;
+  cmd.num = num;
+  cmd.valueX = x;
+  cmd.valueY = y;
+  cmd.valueZ = z;
+  cmd.valueE = NAN;
+  cmd.valueF = f;
+  cmd.valueS = 0;
+  cmd.valueI = NAN;
+  cmd.valueJ = NAN;
+  return cmd;
+}
+
+TEST_SUITE("Queue") {
+
+  TEST_CASE("Vuelta del anillo") {
+    Queue<int> q(4);
+    for (int i = 1; i <= 4; i++) {
+      CHECK(q.push(i));
+    }
+    CHECK(q.isFull());
+    CHECK(q.pop() == 1);
+    CHECK(q.pop() == 2);
+
+    // Los dos siguientes quedan al principio del arreglo
+    CHECK(q.push(5));
+    CHECK(q.push(6));
+    CHECK(q.isFull());
+    CHECK(q.peek(0) == 3);
+    CHECK(q.peek(3) == 6);
+    CHECK(q.peek(4) == 0);   // fuera de rango: elemento por defecto
+
+    for (int esperado = 3; esperado <= 6; esperado++) {
+      CHECK(q.pop() == esperado);
+    }
+    CHECK(q.isEmpty());
+    CHECK(q.pop() == 0);
+    CHECK(q.getFreeSpace() == 4);
+  }
+
+  TEST_CASE("Orden FIFO en muchas vueltas") {
+    Queue<int> q(3);
+    int siguiente = 0;
+    int esperado = 0;
+    for (int vuelta = 0; vuelta < 1000; vuelta++) {
+      while (!q.isFull()) {
+        q.push(siguiente++);
+      }
+      CHECK(q.getUsedSpace() == 3);
+      // Se sacan menos de los que entran para que el inicio vaya rotando
+      for (int i = 0; i < 1 + vuelta % 3; i++) {
+        REQUIRE(q.pop() == esperado++);
+      }
+    }
+  }
+
+  TEST_CASE("Push con la cola llena no pisa el primero") {
+    Queue<int> q(2);
+    CHECK(q.push(10));
+    CHECK(q.push(20));
+    CHECK_FALSE(q.push(30));
+    CHECK(q.getUsedSpace() == 2);
+    CHECK(q.pop() == 10);
+    CHECK(q.pop() == 20);
+    CHECK(q.isEmpty());
+  }
+
+  TEST_CASE("Destructor con delete[]") {
+    // Con AddressSanitizer, liberar con delete lo reservado con new[]
+    // (alloc-dealloc-mismatch) aborta el test
+    Queue<Cmd>* q = new Queue<Cmd>(8);
+    q->push(comando('G', 1, 1, 2, 3, 0));
+    delete q;
+    CHECK(true);
+  }
+}
+
+TEST_SUITE("CommandQueue") {
+
+  TEST_CASE("Campos en punto fijo") {
+    CommandQueue q(128);
+    CHECK(q.push(comando('G', 1, 12.3456f, -7.5f, 100, 25.04f)));
+    Cmd cmd = q.pop();
+    CHECK(cmd.id == 'G');
+    CHECK(cmd.num == 1);
+    CHECK(cmd.valueX == doctest::Approx(12.346).epsilon(1e-6));
+    CHECK(cmd.valueY == doctest::Approx(-7.5));
+    CHECK(cmd.valueZ == doctest::Approx(100));
+    CHECK(cmd.valueF == doctest::Approx(25.0));
+    CHECK(isnan(cmd.valueE));
+    CHECK(isnan(cmd.valueI));
+    CHECK(cmd.valueS == 0);
+    CHECK(q.isEmpty());
+  }
+
+  TEST_CASE("Cola llena: push falla sin corromper lo encolado") {
+    // Entran comandos mientras queden PACKED_CMD_MAX_BYTES libres
+    CommandQueue q(3 * PACKED_CMD_MAX_BYTES);
+    int encolados = 0;
+    while (q.push(comando('G', 1, encolados, 0, 0, 0))) {
+      encolados++;
+      REQUIRE(encolados < 100);
+    }
+    CHECK(q.isFull());
+    CHECK(encolados == q.getUsedSpace());
+    CHECK_FALSE(q.push(comando('M', 5, NAN, NAN, NAN, 0)));
+
+    for (int i = 0; i < encolados; i++) {
+      Cmd cmd = q.pop();
+      CHECK(cmd.id == 'G');
+      CHECK(cmd.valueX == doctest::Approx(i));
+    }
+    CHECK(q.isEmpty());
+  }
+
+  TEST_CASE("Comandos partidos por la vuelta del anillo") {
+    // Tamaño que no es múltiplo de ningún comando: las cabeceras y los
+    // campos terminan cortados entre el final y el principio del arreglo
+    CommandQueue q(2 * PACKED_CMD_MAX_BYTES + 7);
+    int siguiente = 0;
+    int esperado = 0;
+    for (int vuelta = 0; vuelta < 500; vuelta++) {
+      while (!q.isFull()) {
+        float x = siguiente * 0.125f;
+        // Alterna comandos de distinto largo
+        if (siguiente % 2) {
+          q.push(comando('G', 1, x, -x, 50, 10));
+        } else {
+          q.push(comando('G', 0, x, NAN, NAN, 0));
+        }
+        siguiente++;
+      }
+      Cmd cmd = q.pop();
+      float x = esperado * 0.125f;
+      REQUIRE(cmd.num == esperado % 2);
+      REQUIRE(cmd.valueX == doctest::Approx(x));
+      if (esperado % 2) {
+        REQUIRE(cmd.valueY == doctest::Approx(-x));
+        REQUIRE(cmd.valueF == doctest::Approx(10));
+      } else {
+        REQUIRE(isnan(cmd.valueY));
+      }
+      esperado++;
+    }
+  }
+}
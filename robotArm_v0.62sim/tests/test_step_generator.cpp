@@ -0,0 +1,96 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "stepGenerator.h"
+
+// Los pines no importan: con SIMULATION los pasos solo mueven la posición
+struct Ejes {
+  RampsStepper rotate{0, 0, 0, false};
+  RampsStepper lower{0, 0, 0, false};
+  RampsStepper higher{0, 0, 0, false};
+  RampsStepper rail{0, 0, 0, false};
+  StepGenerator generador{&rotate, &lower, &higher, &rail};
+
+  long posicion(int eje) const {
+    const RampsStepper* s[STEP_GEN_AXES] = {&rotate, &lower, &higher, &rail};
+    return s[eje]->getPosition();
+  }
+};
+
+TEST_SUITE("StepGenerator") {
+
+  TEST_CASE("Pasos y sentido por eje en un subsegmento") {
+    shimFijarMicros(1000);
+    Ejes ejes;
+    ejes.lower.setPosition(50);
+    const long objetivos[STEP_GEN_AXES] = {120, -17, 0, 7};   // lower: 50 -> -17
+    ejes.generador.setSegment(objetivos, 1000);
+
+    CHECK(ejes.generador.update() == false);   // sin tiempo transcurrido no hay pasos
+    CHECK(ejes.posicion(0) == 0);
+
+    long anterior[STEP_GEN_AXES] = {0, 50, 0, 0};
+    bool terminado = false;
+    for (int t = 0; t < 100 && !terminado; t++) {
+      shimAvanzarMicros(10);
+      terminado = ejes.generador.update();
+      // Cada eje avanza siempre hacia su objetivo, nunca en contra
+      CHECK(ejes.posicion(0) >= anterior[0]);
+      CHECK(ejes.posicion(1) <= anterior[1]);
+      CHECK(ejes.posicion(2) == 0);
+      CHECK(ejes.posicion(3) >= anterior[3]);
+      for (int i = 0; i < STEP_GEN_AXES; i++) {
+        anterior[i] = ejes.posicion(i);
+      }
+    }
+
+    CHECK(terminado);
+    CHECK(ejes.generador.isIdle());
+    for (int i = 0; i < STEP_GEN_AXES; i++) {
+      CHECK(ejes.posicion(i) == objetivos[i]);
+    }
+  }
+
+  TEST_CASE("Pasos repartidos en el tiempo del subsegmento") {
+    shimFijarMicros(0);
+    Ejes ejes;
+    const long objetivos[STEP_GEN_AXES] = {200, 60, -200, 0};
+    ejes.generador.setSegment(objetivos, 2000);
+
+    // A mitad de tiempo cada eje dio la mitad de sus pasos (±1 por el DDA)
+    shimAvanzarMicros(1000);
+    ejes.generador.update();
+    CHECK(ejes.posicion(0) == 100);
+    CHECK(ejes.posicion(2) == -100);
+    CHECK(labs(ejes.posicion(1) - 30) <= 1);
+
+    // Un update tardío emite de una vez todo lo que falta
+    shimAvanzarMicros(5000);
+    CHECK(ejes.generador.update());
+    CHECK(ejes.posicion(0) == 200);
+    CHECK(ejes.posicion(1) == 60);
+    CHECK(ejes.posicion(2) == -200);
+  }
+
+  TEST_CASE("Subsegmentos consecutivos desde la posición alcanzada") {
+    shimFijarMicros(0);
+    Ejes ejes;
+    const long tramos[3][STEP_GEN_AXES] = {{10, 20, 30, 0}, {5, 25, 30, 0}, {-40, 25, 0, 3}};
+    for (const auto& objetivos : tramos) {
+      ejes.generador.setSegment(objetivos, 500);
+      shimAvanzarMicros(500);
+      CHECK(ejes.generador.update());
+      for (int i = 0; i < STEP_GEN_AXES; i++) {
+        CHECK(ejes.posicion(i) == objetivos[i]);
+      }
+    }
+  }
+
+  TEST_CASE("Subsegmento vacío: termina sin pasos") {
+    shimFijarMicros(0);
+    Ejes ejes;
+    const long objetivos[STEP_GEN_AXES] = {0, 0, 0, 0};
+    ejes.generador.setSegment(objetivos, 5000);
+    CHECK(ejes.generador.update());
+    CHECK(ejes.generador.isIdle());
+  }
+}